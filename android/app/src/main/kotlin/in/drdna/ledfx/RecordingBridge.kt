@@ -2,10 +2,17 @@ package `in`.drdna.ledfx
 
 import io.flutter.plugin.common.EventChannel
 import io.flutter.plugin.common.MethodChannel
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 object RecordingBridge {
     private var eventSink: EventChannel.EventSink? = null
 
+    // Binary audio event header, see src/ledfx/audio_packet.h
+    private const val AUDIO_PACKET_VERSION = 1
+    private const val AUDIO_PACKET_HEADER_SIZE = 16
+    private var audioSequence = 0
+
     fun setup(methodChannel: MethodChannel, eventChannel: EventChannel) {
         // methodChannel.setMethodCallHandler { call, result ->
         //     when (call.method) {
@@ -29,8 +36,19 @@ object RecordingBridge {
 
     // ===== Helpers to send events back to Flutter =====
 
-    fun sendAudio(doubles: List<Double>) {
-        eventSink?.success(mapOf("type" to "audio", "data" to doubles))
+    // Sends [header, samples] so the codec writes a Uint8List and a Float32List
+    // instead of one boxed Double per sample.
+    fun sendAudio(samples: FloatArray, timestampUs: Long, channels: Int = 1, flags: Int = 0) {
+        val header =
+                ByteBuffer.allocate(AUDIO_PACKET_HEADER_SIZE)
+                        .order(ByteOrder.LITTLE_ENDIAN)
+                        .put(AUDIO_PACKET_VERSION.toByte())
+                        .put(channels.toByte())
+                        .putShort(flags.toShort())
+                        .putInt(audioSequence++)
+                        .putLong(timestampUs)
+                        .array()
+        eventSink?.success(listOf(header, samples))
     }
 
     fun sendState(state: String) {
@@ -157,7 +157,8 @@ class RecordingService : Service(), CoroutineScope by MainScope() {
                         audioRecord!!.startRecording()
                         Log.i(TAG, "Loopback recording started")
 
-                        val accumulator = ArrayDeque<Double>()
+                        var block = FloatArray(blockSize)
+                        var blockFill = 0
                         val tempBuffer = FloatArray(blockSize * numChannels)
 
                         while (isRecording && isActive) {
@@ -169,24 +170,24 @@ class RecordingService : Service(), CoroutineScope by MainScope() {
                                             AudioRecord.READ_BLOCKING
                                     )
                             if (readCount > 0) {
-                                if (numChannels == 2) {
-                                    for (i in 0 until readCount step 2) {
-                                        val mono =
-                                                ((tempBuffer[i] + tempBuffer[i + 1]) * 0.5)
-                                                        .toDouble()
-                                        accumulator.add(mono)
+                                val timestampUs = System.nanoTime() / 1000
+                                val step = if (numChannels == 2) 2 else 1
+                                for (i in 0 until readCount - step + 1 step step) {
+                                    block[blockFill++] =
+                                            if (numChannels == 2)
+                                                    (tempBuffer[i] + tempBuffer[i + 1]) * 0.5f
+                                            else tempBuffer[i]
+
+                                    if (blockFill == blockSize) {
+                                        // Hand the filled block to the main thread and start
+                                        // a fresh one; the bridge sends it as a Float32List.
+                                        val out = block
+                                        block = FloatArray(blockSize)
+                                        blockFill = 0
+                                        withContext(Dispatchers.Main) {
+                                            RecordingBridge.sendAudio(out, timestampUs)
+                                        }
                                     }
-                                } else {
-                                    for (i in 0 until readCount) {
-                                        accumulator.add(tempBuffer[i].toDouble())
-                                    }
-                                }
-
-                                while (accumulator.size >= blockSize) {
-                                    val out = ArrayList<Double>(blockSize)
-                                    repeat(blockSize) { out.add(accumulator.removeFirst()) }
-
-                                    withContext(Dispatchers.Main) { RecordingBridge.sendAudio(out) }
                                 }
                             }
                         }
@@ -247,7 +248,8 @@ class RecordingService : Service(), CoroutineScope by MainScope() {
                         audioRecord!!.startRecording()
                         Log.i(TAG, "Mic recording started")
 
-                        val accumulator = ArrayDeque<Double>()
+                        var block = FloatArray(blockSize)
+                        var blockFill = 0
                         val tempBuffer = FloatArray(blockSize * numChannels)
 
                         while (isRecording && isActive) {
@@ -259,24 +261,24 @@ class RecordingService : Service(), CoroutineScope by MainScope() {
                                             AudioRecord.READ_BLOCKING
                                     )
                             if (readCount > 0) {
-                                if (numChannels == 2) {
-                                    for (i in 0 until readCount step 2) {
-                                        val mono =
-                                                ((tempBuffer[i] + tempBuffer[i + 1]) * 0.5)
-                                                        .toDouble()
-                                        accumulator.add(mono)
+                                val timestampUs = System.nanoTime() / 1000
+                                val step = if (numChannels == 2) 2 else 1
+                                for (i in 0 until readCount - step + 1 step step) {
+                                    block[blockFill++] =
+                                            if (numChannels == 2)
+                                                    (tempBuffer[i] + tempBuffer[i + 1]) * 0.5f
+                                            else tempBuffer[i]
+
+                                    if (blockFill == blockSize) {
+                                        // Hand the filled block to the main thread and start
+                                        // a fresh one; the bridge sends it as a Float32List.
+                                        val out = block
+                                        block = FloatArray(blockSize)
+                                        blockFill = 0
+                                        withContext(Dispatchers.Main) {
+                                            RecordingBridge.sendAudio(out, timestampUs)
+                                        }
                                     }
-                                } else {
-                                    for (i in 0 until readCount) {
-                                        accumulator.add(tempBuffer[i].toDouble())
-                                    }
-                                }
-
-                                while (accumulator.size >= blockSize) {
-                                    val out = ArrayList<Double>(blockSize)
-                                    repeat(blockSize) { out.add(accumulator.removeFirst()) }
-
-                                    withContext(Dispatchers.Main) { RecordingBridge.sendAudio(out) }
                                 }
                             }
                         }
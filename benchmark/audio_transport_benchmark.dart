@@ -0,0 +1,92 @@
+// Microbenchmark for the audio event transport.
+//
+// Compares the legacy `{"type": "audio", "data": [double, ...]}` event with
+// the binary `[Uint8List header, Float32List samples]` packet, measuring the
+// StandardMethodCodec encode + decode round trip and the AudioEvent
+// construction for one second of 48 kHz audio delivered in 60 blocks.
+//
+// Run with:
+//   flutter test benchmark/audio_transport_benchmark.dart
+
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:ledfx/src/platform/audio_bridge.dart';
+
+const int sampleRate = 48000;
+const int blocksPerSecond = 60;
+const int blockSize = sampleRate ~/ blocksPerSecond;
+const int warmupSeconds = 20;
+const int measuredSeconds = 200;
+
+const codec = StandardMethodCodec();
+
+Float64List _legacyRoundTrip(List<double> block) {
+  final encoded = codec.encodeSuccessEnvelope({"type": "audio", "data": block});
+  final event = codec.decodeEnvelope(encoded) as Map;
+  // Mirrors the previous AudioEvent constructor.
+  return Float64List.fromList(
+    (event["data"] as List<Object?>).map((e) {
+      return (e == null) ? 0.0 : e as double;
+    }).toList(),
+  );
+}
+
+Float64List _binaryRoundTrip(Uint8List header, Float32List block) {
+  final encoded = codec.encodeSuccessEnvelope([header, block]);
+  final event = codec.decodeEnvelope(encoded) as List;
+  return AudioEvent.fromPacket(event[0], event[1]).data;
+}
+
+Uint8List _header(int sequence) {
+  final bd = ByteData(AudioEvent.headerSize)
+    ..setUint8(0, AudioEvent.version)
+    ..setUint8(1, 1)
+    ..setUint16(2, 0, Endian.little)
+    ..setUint32(4, sequence, Endian.little)
+    ..setUint64(8, sequence * 1000000 ~/ blocksPerSecond, Endian.little);
+  return bd.buffer.asUint8List();
+}
+
+/// Returns the mean microseconds spent per second of audio.
+double _measure(void Function(int block) runBlock) {
+  for (int i = 0; i < warmupSeconds * blocksPerSecond; i++) {
+    runBlock(i);
+  }
+  final sw = Stopwatch()..start();
+  for (int i = 0; i < measuredSeconds * blocksPerSecond; i++) {
+    runBlock(i);
+  }
+  sw.stop();
+  return sw.elapsedMicroseconds / measuredSeconds;
+}
+
+void main() {
+  test('audio transport: encode/decode cost per 1 s of audio', () {
+    final floats = Float32List(blockSize);
+    for (int i = 0; i < blockSize; i++) {
+      floats[i] = (i % 200) / 100.0 - 1.0;
+    }
+    final doubles = List<double>.generate(blockSize, (i) => floats[i]);
+
+    double checksum = 0;
+    final legacyUs = _measure((i) => checksum += _legacyRoundTrip(doubles)[0]);
+    final binaryUs = _measure(
+      (i) => checksum += _binaryRoundTrip(_header(i), floats)[0],
+    );
+
+    // ignore: avoid_print
+    print(
+      'audio transport ($blocksPerSecond x $blockSize samples/s): '
+      'legacy ${legacyUs.toStringAsFixed(0)} us/s, '
+      'binary ${binaryUs.toStringAsFixed(0)} us/s, '
+      'speedup ${(legacyUs / binaryUs).toStringAsFixed(1)}x '
+      '(checksum $checksum)',
+    );
+
+    final decoded = _binaryRoundTrip(_header(7), floats);
+    expect(decoded.length, blockSize);
+    expect(decoded[1], closeTo(floats[1], 1e-7));
+  });
+}
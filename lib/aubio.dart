@@ -56,6 +56,13 @@ class Aubio {
     }
   }
 
+  /// The loaded native library, also used by the ledfx bindings which are
+  /// built into the same library.
+  static ffi.DynamicLibrary get library {
+    bindings;
+    return _dylib!;
+  }
+
   /// Cleanup resources
   static void dispose() {
     _bindings = null;
@@ -142,10 +149,9 @@ class Aubio {
     bindings.aubio_pvoc_rdo(pvoc, fftGrain, outputVec);
 
     // Convert to Dart Float64List
-    final result = Float64List(hopSize);
-    for (int i = 0; i < hopSize; i++) {
-      result[i] = bindings.fvec_get_sample(outputVec, i);
-    }
+    final result = Float64List.fromList(
+      outputVec.ref.data.asTypedList(hopSize),
+    );
 
     bindings.del_fvec(outputVec);
     return result;
@@ -157,13 +163,10 @@ class Aubio {
     int windowSize,
   ) {
     final length = (windowSize ~/ 2) + 1;
-    final magnitudes = Float64List(length);
-    final phases = Float64List(length);
-
-    for (int i = 0; i < length; i++) {
-      magnitudes[i] = bindings.cvec_norm_get_sample(fftGrain, i);
-      phases[i] = bindings.cvec_phas_get_sample(fftGrain, i);
-    }
+    final magnitudes = Float64List.fromList(
+      fftGrain.ref.norm.asTypedList(length),
+    );
+    final phases = Float64List.fromList(fftGrain.ref.phas.asTypedList(length));
 
     return (magnitudes, phases);
   }
@@ -175,10 +178,8 @@ class Aubio {
     Float64List phases,
   ) {
     final length = magnitudes.length;
-    for (int i = 0; i < length; i++) {
-      bindings.cvec_norm_set_sample(fftGrain, magnitudes[i], i);
-      bindings.cvec_norm_set_sample(fftGrain, phases[i], i);
-    }
+    fftGrain.ref.norm.asTypedList(length).setAll(0, magnitudes);
+    fftGrain.ref.phas.asTypedList(length).setAll(0, phases);
   }
 
   // Create and manage complex vectors
@@ -269,11 +270,7 @@ class Aubio {
   // Helper method to create fvec from Flutter data
   static Pointer<fvec_t> createFvecFromFloat64List(Float64List data) {
     final vec = bindings.new_fvec(data.length);
-
-    for (int i = 0; i < data.length; i++) {
-      bindings.fvec_set_sample(vec, data[i], i);
-    }
-
+    vec.ref.data.asTypedList(data.length).setAll(0, data);
     return vec;
   }
 
@@ -281,10 +278,7 @@ class Aubio {
     final int n = inputFrame.length;
     final ffi.Pointer<fvec_t> inputVec = bindings.new_fvec(n);
     try {
-      final ptrIn = bindings.fvec_get_data(inputVec);
-      for (var i = 0; i < n; i++) {
-        ptrIn[i] = inputFrame[i];
-      }
+      inputVec.ref.data.asTypedList(n).setAll(0, inputFrame);
       return bindings.aubio_db_spl(inputVec);
     } finally {
       bindings.del_fvec(inputVec);
@@ -321,20 +315,13 @@ extension DigitalFilterExt on Pointer<aubio_filter_t> {
       final outputData = Aubio.bindings.fvec_get_data(outputVec);
 
       // Copy Float64List data to aubio input vector
-      for (int i = 0; i < frameSize; i++) {
-        inputData[i] = inputFrame[i];
-      }
+      inputData.asTypedList(frameSize).setAll(0, inputFrame);
 
       // Process audio through the filter (out-of-place processing)
       Aubio.bindings.aubio_filter_do_outplace(cast(), inputVec, outputVec);
 
       // Create output Float64List and copy processed data
-      final outputFrame = Float64List(frameSize);
-      for (int i = 0; i < frameSize; i++) {
-        outputFrame[i] = outputData[i];
-      }
-
-      return outputFrame;
+      return Float64List.fromList(outputData.asTypedList(frameSize));
     } catch (e) {
       debugPrint('Error processing audio frame: $e');
       return null;
@@ -384,14 +371,19 @@ extension PhaseVocoderExt on Pointer<aubio_pvoc_t> {
     Aubio.bindings.aubio_pvoc_rdo(cast(), fftGrain, outputVec);
 
     // Convert to Dart Float64List
-    final result = Float64List(hopSize);
-    for (int i = 0; i < hopSize; i++) {
-      result[i] = Aubio.bindings.fvec_get_sample(outputVec, i);
-    }
+    final result = Float64List.fromList(
+      outputVec.ref.data.asTypedList(hopSize),
+    );
 
     Aubio.bindings.del_fvec(outputVec);
     return result;
   }
+
+  /// Synthesises [fftGrain] into [output] in place, e.g. a vector from a
+  /// `LedfxArena`, without allocating.
+  void synthesiseInto(Pointer<cvec_t> fftGrain, Pointer<fvec_t> output) {
+    Aubio.bindings.aubio_pvoc_rdo(cast(), fftGrain, output);
+  }
 }
 
 extension CVecExt on Pointer<cvec_t> {
@@ -415,10 +407,7 @@ extension FilterbankExt on Pointer<aubio_filterbank_t> {
       throw StateError('Could not allocate freq vector');
     }
     try {
-      final data = Aubio.bindings.fvec_get_data(ptrFreqs);
-      for (var i = 0; i < n; i++) {
-        data[i] = freqs[i];
-      }
+      ptrFreqs.ref.data.asTypedList(n).setAll(0, freqs);
       final res = Aubio.bindings.aubio_filterbank_set_triangle_bands(
         cast(),
         ptrFreqs,
@@ -437,14 +426,16 @@ extension FilterbankExt on Pointer<aubio_filterbank_t> {
     // Run mel-filterbank
     Aubio.bindings.aubio_filterbank_do(cast(), freqDomain, _outVec);
     // Read out mel-band energies
-    final ptrOut = Aubio.bindings.fvec_get_data(_outVec);
-    final out = Float64List(outLen);
-    for (var i = 0; i < outLen; i++) {
-      out[i] = ptrOut[i];
-    }
+    final out = Float64List.fromList(_outVec.ref.data.asTypedList(outLen));
     Aubio.bindings.del_fvec(_outVec);
     return out;
   }
+
+  /// Processes [freqDomain] into [output] in place, e.g. a vector from a
+  /// `LedfxArena`, without allocating.
+  void processInto(Pointer<cvec_t> freqDomain, Pointer<fvec_t> output) {
+    Aubio.bindings.aubio_filterbank_do(cast(), freqDomain, output);
+  }
 }
 
 extension ResamplerExt on Pointer<aubio_resampler_t> {
@@ -456,26 +447,27 @@ extension ResamplerExt on Pointer<aubio_resampler_t> {
     final outVec = Aubio.bindings.new_fvec(outLen);
     final inVec = Aubio.bindings.new_fvec(frame.length);
 
-    // Get data pointers from fvec_t structures
-    final inData = Aubio.bindings.fvec_get_data(inVec);
-    final outData = Aubio.bindings.fvec_get_data(outVec);
     // Copy Float64List data to aubio input vector
-    for (int i = 0; i < frame.length; i++) {
-      inData[i] = frame[i];
-    }
+    inVec.ref.data.asTypedList(frame.length).setAll(0, frame);
 
     // Process audio through the filter (out-of-place processing)
     Aubio.bindings.aubio_resampler_do(cast(), inVec, outVec);
 
     // Create output Float64List and copy processed data
-    final outputFrame = Float64List(outLen);
-    for (int i = 0; i < outLen; i++) {
-      outputFrame[i] = outData[i];
-    }
+    final outputFrame = Float64List.fromList(
+      outVec.ref.data.asTypedList(outLen),
+    );
 
     Aubio.bindings.del_fvec(inVec);
     Aubio.bindings.del_fvec(outVec);
 
     return outputFrame;
   }
+
+  /// Resamples [input] into [output] in place, e.g. vectors from a
+  /// `LedfxArena`, without allocating. [output] must hold
+  /// `input.length * ratio` samples.
+  void processInto(Pointer<fvec_t> input, Pointer<fvec_t> output) {
+    Aubio.bindings.aubio_resampler_do(cast(), input, output);
+  }
 }
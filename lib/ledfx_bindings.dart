@@ -0,0 +1,2977 @@
+// Generated FFI bindings for the ledfx native processing layer
+//
+// This file contains the low-level FFI bindings for src/ledfx/ledfx.h.
+// Use the higher-level classes in ledfx_native.dart for a more convenient API.
+
+// AUTO GENERATED FILE, DO NOT EDIT.
+//
+// Generated by `package:ffigen`.
+// ignore_for_file: type=lint
+import 'dart:ffi' as ffi;
+import 'package:ledfx/aubio_bindings.dart' as aubio;
+
+/// generates ledfx native bindings
+class LedfxBindings {
+  /// Holds the symbol lookup function.
+  final ffi.Pointer<T> Function<T extends ffi.NativeType>(String symbolName)
+  _lookup;
+
+  /// The symbols are looked up in [dynamicLibrary].
+  LedfxBindings(ffi.DynamicLibrary dynamicLibrary)
+    : _lookup = dynamicLibrary.lookup;
+
+  /// The symbols are looked up with [lookup].
+  LedfxBindings.fromLookup(
+    ffi.Pointer<T> Function<T extends ffi.NativeType>(String symbolName) lookup,
+  ) : _lookup = lookup;
+
+  /// create audio front-end
+  ///
+  /// \param win_s phase vocoder window size
+  /// \param hop_s number of input samples per call to ledfx_frontend_do()
+  ///
+  /// \return newly created object, or NULL on invalid parameters
+  ffi.Pointer<ledfx_frontend_t> new_ledfx_frontend(int win_s, int hop_s) {
+    return _new_ledfx_frontend(win_s, hop_s);
+  }
+
+  late final _new_ledfx_frontendPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_frontend_t> Function(aubio.uint_t, aubio.uint_t)
+        >
+      >('new_ledfx_frontend');
+  late final _new_ledfx_frontend = _new_ledfx_frontendPtr
+      .asFunction<ffi.Pointer<ledfx_frontend_t> Function(int, int)>();
+
+  /// delete audio front-end
+  ///
+  /// \param f object to delete, as returned by new_ledfx_frontend()
+  void del_ledfx_frontend(ffi.Pointer<ledfx_frontend_t> f) {
+    return _del_ledfx_frontend(f);
+  }
+
+  late final _del_ledfx_frontendPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_frontend_t>)
+        >
+      >('del_ledfx_frontend');
+  late final _del_ledfx_frontend = _del_ledfx_frontendPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_frontend_t>)>();
+
+  /// process the current input buffer
+  ///
+  /// \param f front-end object
+  ///
+  /// \return 1 if the spectrum was computed, 0 if it was zeroed by the volume
+  /// gate
+  int ledfx_frontend_do(ffi.Pointer<ledfx_frontend_t> f) {
+    return _ledfx_frontend_do(f);
+  }
+
+  late final _ledfx_frontend_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_frontend_t>)
+        >
+      >('ledfx_frontend_do');
+  late final _ledfx_frontend_do = _ledfx_frontend_doPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_frontend_t>)>();
+
+  /// set pre-emphasis biquad coefficients
+  ///
+  /// \param f front-end object
+  /// \param b0 forward filter coefficient
+  /// \param b1 forward filter coefficient
+  /// \param b2 forward filter coefficient
+  /// \param a1 feedback filter coefficient
+  /// \param a2 feedback filter coefficient
+  ///
+  /// \return 0 on success, non-zero otherwise
+  int ledfx_frontend_set_biquad(
+    ffi.Pointer<ledfx_frontend_t> f,
+    double b0,
+    double b1,
+    double b2,
+    double a1,
+    double a2,
+  ) {
+    return _ledfx_frontend_set_biquad(f, b0, b1, b2, a1, a2);
+  }
+
+  late final _ledfx_frontend_set_biquadPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_frontend_t>,
+            aubio.lsmp_t,
+            aubio.lsmp_t,
+            aubio.lsmp_t,
+            aubio.lsmp_t,
+            aubio.lsmp_t,
+          )
+        >
+      >('ledfx_frontend_set_biquad');
+  late final _ledfx_frontend_set_biquad = _ledfx_frontend_set_biquadPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_frontend_t>,
+          double,
+          double,
+          double,
+          double,
+          double,
+        )
+      >();
+
+  /// set the smoothed volume below which the spectrum is zeroed
+  ///
+  /// \param f front-end object
+  /// \param min_volume volume threshold, between 0 and 1
+  void ledfx_frontend_set_min_volume(
+    ffi.Pointer<ledfx_frontend_t> f,
+    double min_volume,
+  ) {
+    return _ledfx_frontend_set_min_volume(f, min_volume);
+  }
+
+  late final _ledfx_frontend_set_min_volumePtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_frontend_t>, aubio.smpl_t)
+        >
+      >('ledfx_frontend_set_min_volume');
+  late final _ledfx_frontend_set_min_volume = _ledfx_frontend_set_min_volumePtr
+      .asFunction<void Function(ffi.Pointer<ledfx_frontend_t>, double)>();
+
+  /// get input buffer
+  ///
+  /// \param f front-end object
+  ///
+  /// \return buffer of hop_s samples to fill before ledfx_frontend_do()
+  ffi.Pointer<aubio.fvec_t> ledfx_frontend_get_input(
+    ffi.Pointer<ledfx_frontend_t> f,
+  ) {
+    return _ledfx_frontend_get_input(f);
+  }
+
+  late final _ledfx_frontend_get_inputPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.fvec_t> Function(ffi.Pointer<ledfx_frontend_t>)
+        >
+      >('ledfx_frontend_get_input');
+  late final _ledfx_frontend_get_input = _ledfx_frontend_get_inputPtr
+      .asFunction<
+        ffi.Pointer<aubio.fvec_t> Function(
+          ffi.Pointer<ledfx_frontend_t>,
+        )
+      >();
+
+  /// get pre-emphasised buffer
+  ///
+  /// \param f front-end object
+  ///
+  /// \return hop_s samples from the last call that passed the volume gate
+  ffi.Pointer<aubio.fvec_t> ledfx_frontend_get_filtered(
+    ffi.Pointer<ledfx_frontend_t> f,
+  ) {
+    return _ledfx_frontend_get_filtered(f);
+  }
+
+  late final _ledfx_frontend_get_filteredPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.fvec_t> Function(ffi.Pointer<ledfx_frontend_t>)
+        >
+      >('ledfx_frontend_get_filtered');
+  late final _ledfx_frontend_get_filtered = _ledfx_frontend_get_filteredPtr
+      .asFunction<
+        ffi.Pointer<aubio.fvec_t> Function(
+          ffi.Pointer<ledfx_frontend_t>,
+        )
+      >();
+
+  /// get spectrum
+  ///
+  /// \param f front-end object
+  ///
+  /// \return spectrum of length win_s / 2 + 1; the pointer, and its norm and
+  /// phas arrays, stay the same for the lifetime of the object
+  ffi.Pointer<aubio.cvec_t> ledfx_frontend_get_spectrum(
+    ffi.Pointer<ledfx_frontend_t> f,
+  ) {
+    return _ledfx_frontend_get_spectrum(f);
+  }
+
+  late final _ledfx_frontend_get_spectrumPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.cvec_t> Function(ffi.Pointer<ledfx_frontend_t>)
+        >
+      >('ledfx_frontend_get_spectrum');
+  late final _ledfx_frontend_get_spectrum = _ledfx_frontend_get_spectrumPtr
+      .asFunction<
+        ffi.Pointer<aubio.cvec_t> Function(
+          ffi.Pointer<ledfx_frontend_t>,
+        )
+      >();
+
+  /// get level of the last input, in dB SPL
+  ///
+  /// \param f front-end object
+  double ledfx_frontend_get_db(ffi.Pointer<ledfx_frontend_t> f) {
+    return _ledfx_frontend_get_db(f);
+  }
+
+  late final _ledfx_frontend_get_dbPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.smpl_t Function(ffi.Pointer<ledfx_frontend_t>)
+        >
+      >('ledfx_frontend_get_db');
+  late final _ledfx_frontend_get_db = _ledfx_frontend_get_dbPtr
+      .asFunction<double Function(ffi.Pointer<ledfx_frontend_t>)>();
+
+  /// get volume of the last input
+  ///
+  /// \param f front-end object
+  /// \param filtered non-zero for the smoothed volume, 0 for the raw volume
+  ///
+  /// \return volume, mapped from dB SPL to [0, 1]
+  double ledfx_frontend_get_volume(
+    ffi.Pointer<ledfx_frontend_t> f,
+    int filtered,
+  ) {
+    return _ledfx_frontend_get_volume(f, filtered);
+  }
+
+  late final _ledfx_frontend_get_volumePtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.smpl_t Function(ffi.Pointer<ledfx_frontend_t>, aubio.uint_t)
+        >
+      >('ledfx_frontend_get_volume');
+  late final _ledfx_frontend_get_volume = _ledfx_frontend_get_volumePtr
+      .asFunction<double Function(ffi.Pointer<ledfx_frontend_t>, int)>();
+
+  /// create an empty sparse filterbank
+  ///
+  /// \param win_s window size of the spectra to process; each filter spans
+  /// win_s / 2 + 1 bins
+  ///
+  /// \return newly created object, or NULL on invalid parameters
+  ffi.Pointer<ledfx_filterbank_t> new_ledfx_filterbank(int win_s) {
+    return _new_ledfx_filterbank(win_s);
+  }
+
+  late final _new_ledfx_filterbankPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_filterbank_t> Function(aubio.uint_t)
+        >
+      >('new_ledfx_filterbank');
+  late final _new_ledfx_filterbank = _new_ledfx_filterbankPtr
+      .asFunction<ffi.Pointer<ledfx_filterbank_t> Function(int)>();
+
+  /// delete sparse filterbank
+  ///
+  /// \param fb object to delete, as returned by new_ledfx_filterbank()
+  void del_ledfx_filterbank(ffi.Pointer<ledfx_filterbank_t> fb) {
+    return _del_ledfx_filterbank(fb);
+  }
+
+  late final _del_ledfx_filterbankPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_filterbank_t>)
+        >
+      >('del_ledfx_filterbank');
+  late final _del_ledfx_filterbank = _del_ledfx_filterbankPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_filterbank_t>)>();
+
+  /// add a bank from a dense coefficient matrix
+  ///
+  /// \param fb sparse filterbank
+  /// \param coeffs matrix of n_filters rows of win_s / 2 + 1 weights, e.g. as
+  /// returned by aubio_filterbank_get_coeffs()
+  ///
+  /// \return index of the new bank, or -1 on error
+  int ledfx_filterbank_add_coeffs(
+    ffi.Pointer<ledfx_filterbank_t> fb,
+    ffi.Pointer<aubio.fmat_t> coeffs,
+  ) {
+    return _ledfx_filterbank_add_coeffs(fb, coeffs);
+  }
+
+  late final _ledfx_filterbank_add_coeffsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.sint_t Function(
+            ffi.Pointer<ledfx_filterbank_t>,
+            ffi.Pointer<aubio.fmat_t>,
+          )
+        >
+      >('ledfx_filterbank_add_coeffs');
+  late final _ledfx_filterbank_add_coeffs = _ledfx_filterbank_add_coeffsPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_filterbank_t>,
+          ffi.Pointer<aubio.fmat_t>,
+        )
+      >();
+
+  /// add a bank of triangular filters
+  ///
+  /// \param fb sparse filterbank
+  /// \param freqs band edges in Hz; freqs->length - 2 filters are created,
+  /// see aubio_filterbank_set_triangle_bands()
+  /// \param samplerate sampling rate of the analysed signal
+  ///
+  /// \return index of the new bank, or -1 on error
+  int ledfx_filterbank_add_triangle_bands(
+    ffi.Pointer<ledfx_filterbank_t> fb,
+    ffi.Pointer<aubio.fvec_t> freqs,
+    double samplerate,
+  ) {
+    return _ledfx_filterbank_add_triangle_bands(fb, freqs, samplerate);
+  }
+
+  late final _ledfx_filterbank_add_triangle_bandsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.sint_t Function(
+            ffi.Pointer<ledfx_filterbank_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            aubio.smpl_t,
+          )
+        >
+      >('ledfx_filterbank_add_triangle_bands');
+  late final _ledfx_filterbank_add_triangle_bands =
+      _ledfx_filterbank_add_triangle_bandsPtr
+          .asFunction<
+            int Function(
+              ffi.Pointer<ledfx_filterbank_t>,
+              ffi.Pointer<aubio.fvec_t>,
+              double,
+            )
+          >();
+
+  /// compute the output of every bank
+  ///
+  /// \param fb sparse filterbank
+  /// \param in input spectrum, of length win_s / 2 + 1
+  ///
+  /// Results are written to the buffers returned by
+  /// ledfx_filterbank_get_output().
+  void ledfx_filterbank_do(
+    ffi.Pointer<ledfx_filterbank_t> fb,
+    ffi.Pointer<aubio.cvec_t> in$,
+  ) {
+    return _ledfx_filterbank_do(fb, in$);
+  }
+
+  late final _ledfx_filterbank_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(
+            ffi.Pointer<ledfx_filterbank_t>,
+            ffi.Pointer<aubio.cvec_t>,
+          )
+        >
+      >('ledfx_filterbank_do');
+  late final _ledfx_filterbank_do = _ledfx_filterbank_doPtr
+      .asFunction<
+        void Function(
+          ffi.Pointer<ledfx_filterbank_t>,
+          ffi.Pointer<aubio.cvec_t>,
+        )
+      >();
+
+  /// compute the output of a single bank
+  ///
+  /// \param fb sparse filterbank
+  /// \param bank index of the bank, as returned when it was added
+  /// \param in input spectrum, of length win_s / 2 + 1
+  /// \param out output vector; at most out->length filters are computed
+  void ledfx_filterbank_do_bank(
+    ffi.Pointer<ledfx_filterbank_t> fb,
+    int bank,
+    ffi.Pointer<aubio.cvec_t> in$,
+    ffi.Pointer<aubio.fvec_t> out,
+  ) {
+    return _ledfx_filterbank_do_bank(fb, bank, in$, out);
+  }
+
+  late final _ledfx_filterbank_do_bankPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(
+            ffi.Pointer<ledfx_filterbank_t>,
+            aubio.uint_t,
+            ffi.Pointer<aubio.cvec_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_filterbank_do_bank');
+  late final _ledfx_filterbank_do_bank = _ledfx_filterbank_do_bankPtr
+      .asFunction<
+        void Function(
+          ffi.Pointer<ledfx_filterbank_t>,
+          int,
+          ffi.Pointer<aubio.cvec_t>,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// get the output buffer of a bank
+  ///
+  /// \param fb sparse filterbank
+  /// \param bank index of the bank
+  ///
+  /// \return buffer of one value per filter, updated by ledfx_filterbank_do(),
+  /// or NULL if the bank does not exist
+  ffi.Pointer<aubio.fvec_t> ledfx_filterbank_get_output(
+    ffi.Pointer<ledfx_filterbank_t> fb,
+    int bank,
+  ) {
+    return _ledfx_filterbank_get_output(fb, bank);
+  }
+
+  late final _ledfx_filterbank_get_outputPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.fvec_t> Function(
+            ffi.Pointer<ledfx_filterbank_t>,
+            aubio.uint_t,
+          )
+        >
+      >('ledfx_filterbank_get_output');
+  late final _ledfx_filterbank_get_output = _ledfx_filterbank_get_outputPtr
+      .asFunction<
+        ffi.Pointer<aubio.fvec_t> Function(
+          ffi.Pointer<ledfx_filterbank_t>,
+          int,
+        )
+      >();
+
+  /// get the number of banks
+  ///
+  /// \param fb sparse filterbank
+  int ledfx_filterbank_get_n_banks(ffi.Pointer<ledfx_filterbank_t> fb) {
+    return _ledfx_filterbank_get_n_banks(fb);
+  }
+
+  late final _ledfx_filterbank_get_n_banksPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_filterbank_t>)
+        >
+      >('ledfx_filterbank_get_n_banks');
+  late final _ledfx_filterbank_get_n_banks = _ledfx_filterbank_get_n_banksPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_filterbank_t>)>();
+
+  /// get the number of filters in a bank
+  ///
+  /// \param fb sparse filterbank
+  /// \param bank index of the bank
+  int ledfx_filterbank_get_n_filters(
+    ffi.Pointer<ledfx_filterbank_t> fb,
+    int bank,
+  ) {
+    return _ledfx_filterbank_get_n_filters(fb, bank);
+  }
+
+  late final _ledfx_filterbank_get_n_filtersPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_filterbank_t>, aubio.uint_t)
+        >
+      >('ledfx_filterbank_get_n_filters');
+  late final _ledfx_filterbank_get_n_filters =
+      _ledfx_filterbank_get_n_filtersPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_filterbank_t>, int)>();
+
+  /// get the number of stored weights, summed over all banks
+  ///
+  /// \param fb sparse filterbank
+  int ledfx_filterbank_get_n_weights(ffi.Pointer<ledfx_filterbank_t> fb) {
+    return _ledfx_filterbank_get_n_weights(fb);
+  }
+
+  late final _ledfx_filterbank_get_n_weightsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_filterbank_t>)
+        >
+      >('ledfx_filterbank_get_n_weights');
+  late final _ledfx_filterbank_get_n_weights =
+      _ledfx_filterbank_get_n_weightsPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_filterbank_t>)>();
+
+  /// create melbank post-processing
+  ///
+  /// \param n_bands number of bands of the melbank
+  /// \param power exponent applied to every band
+  ///
+  /// \return newly created object, or NULL on invalid parameters
+  ffi.Pointer<ledfx_melbank_t> new_ledfx_melbank(int n_bands, double power) {
+    return _new_ledfx_melbank(n_bands, power);
+  }
+
+  late final _new_ledfx_melbankPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_melbank_t> Function(aubio.uint_t, aubio.smpl_t)
+        >
+      >('new_ledfx_melbank');
+  late final _new_ledfx_melbank = _new_ledfx_melbankPtr
+      .asFunction<ffi.Pointer<ledfx_melbank_t> Function(int, double)>();
+
+  /// delete melbank post-processing
+  ///
+  /// \param m object to delete, as returned by new_ledfx_melbank()
+  void del_ledfx_melbank(ffi.Pointer<ledfx_melbank_t> m) {
+    return _del_ledfx_melbank(m);
+  }
+
+  late final _del_ledfx_melbankPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_melbank_t>)
+        >
+      >('del_ledfx_melbank');
+  late final _del_ledfx_melbank = _del_ledfx_melbankPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_melbank_t>)>();
+
+  /// process one hop
+  ///
+  /// \param m melbank object
+  /// \param in filterbank output, at least n_bands long
+  /// \param raw output, smoothed and gain normalised melbank, n_bands long
+  /// \param filtered output, smoothed difference to the moving average,
+  /// n_bands long
+  ///
+  /// \return 0 on success, non-zero if a buffer is too short
+  int ledfx_melbank_do(
+    ffi.Pointer<ledfx_melbank_t> m,
+    ffi.Pointer<aubio.fvec_t> in$,
+    ffi.Pointer<aubio.fvec_t> raw,
+    ffi.Pointer<aubio.fvec_t> filtered,
+  ) {
+    return _ledfx_melbank_do(m, in$, raw, filtered);
+  }
+
+  late final _ledfx_melbank_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_melbank_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_melbank_do');
+  late final _ledfx_melbank_do = _ledfx_melbank_doPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_melbank_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// forget the filter state; the next call primes the filters again
+  ///
+  /// \param m melbank object
+  void ledfx_melbank_reset(ffi.Pointer<ledfx_melbank_t> m) {
+    return _ledfx_melbank_reset(m);
+  }
+
+  late final _ledfx_melbank_resetPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_melbank_t>)
+        >
+      >('ledfx_melbank_reset');
+  late final _ledfx_melbank_reset = _ledfx_melbank_resetPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_melbank_t>)>();
+
+  /// get current gain
+  ///
+  /// \param m melbank object
+  ///
+  /// \return smoothed maximum of the blurred bands of the last call
+  double ledfx_melbank_get_gain(ffi.Pointer<ledfx_melbank_t> m) {
+    return _ledfx_melbank_get_gain(m);
+  }
+
+  late final _ledfx_melbank_get_gainPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.smpl_t Function(ffi.Pointer<ledfx_melbank_t>)
+        >
+      >('ledfx_melbank_get_gain');
+  late final _ledfx_melbank_get_gain = _ledfx_melbank_get_gainPtr
+      .asFunction<double Function(ffi.Pointer<ledfx_melbank_t>)>();
+
+  /// get number of bands
+  ///
+  /// \param m melbank object
+  int ledfx_melbank_get_n_bands(ffi.Pointer<ledfx_melbank_t> m) {
+    return _ledfx_melbank_get_n_bands(m);
+  }
+
+  late final _ledfx_melbank_get_n_bandsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_melbank_t>)
+        >
+      >('ledfx_melbank_get_n_bands');
+  late final _ledfx_melbank_get_n_bands = _ledfx_melbank_get_n_bandsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_melbank_t>)>();
+
+  /// create vector arena
+  ///
+  /// \param block_size size in bytes of the blocks requested from the system,
+  /// or 0 for the default of 64 KiB; larger vectors get a block of their own
+  ///
+  /// \return newly created arena, or NULL on failure
+  ffi.Pointer<ledfx_arena_t> new_ledfx_arena(int block_size) {
+    return _new_ledfx_arena(block_size);
+  }
+
+  late final _new_ledfx_arenaPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_arena_t> Function(aubio.uint_t)
+        >
+      >('new_ledfx_arena');
+  late final _new_ledfx_arena = _new_ledfx_arenaPtr
+      .asFunction<ffi.Pointer<ledfx_arena_t> Function(int)>();
+
+  /// delete vector arena and every vector allocated from it
+  ///
+  /// \param a arena to delete, as returned by new_ledfx_arena()
+  void del_ledfx_arena(ffi.Pointer<ledfx_arena_t> a) {
+    return _del_ledfx_arena(a);
+  }
+
+  late final _del_ledfx_arenaPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_arena_t>)
+        >
+      >('del_ledfx_arena');
+  late final _del_ledfx_arena = _del_ledfx_arenaPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_arena_t>)>();
+
+  /// allocate a vector from the arena
+  ///
+  /// \param a arena
+  /// \param length number of samples
+  ///
+  /// \return zeroed vector owned by the arena, or NULL on failure
+  ffi.Pointer<aubio.fvec_t> ledfx_arena_new_fvec(
+    ffi.Pointer<ledfx_arena_t> a,
+    int length,
+  ) {
+    return _ledfx_arena_new_fvec(a, length);
+  }
+
+  late final _ledfx_arena_new_fvecPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.fvec_t> Function(
+            ffi.Pointer<ledfx_arena_t>,
+            aubio.uint_t,
+          )
+        >
+      >('ledfx_arena_new_fvec');
+  late final _ledfx_arena_new_fvec = _ledfx_arena_new_fvecPtr
+      .asFunction<
+        ffi.Pointer<aubio.fvec_t> Function(
+          ffi.Pointer<ledfx_arena_t>,
+          int,
+        )
+      >();
+
+  /// allocate a spectrum from the arena
+  ///
+  /// \param a arena
+  /// \param win_s window size; norm and phas hold win_s / 2 + 1 samples, as
+  /// with new_cvec()
+  ///
+  /// \return zeroed spectrum owned by the arena, or NULL on failure
+  ffi.Pointer<aubio.cvec_t> ledfx_arena_new_cvec(
+    ffi.Pointer<ledfx_arena_t> a,
+    int win_s,
+  ) {
+    return _ledfx_arena_new_cvec(a, win_s);
+  }
+
+  late final _ledfx_arena_new_cvecPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.cvec_t> Function(
+            ffi.Pointer<ledfx_arena_t>,
+            aubio.uint_t,
+          )
+        >
+      >('ledfx_arena_new_cvec');
+  late final _ledfx_arena_new_cvec = _ledfx_arena_new_cvecPtr
+      .asFunction<
+        ffi.Pointer<aubio.cvec_t> Function(
+          ffi.Pointer<ledfx_arena_t>,
+          int,
+        )
+      >();
+
+  /// get the number of bytes handed out by the arena
+  ///
+  /// \param a arena
+  ///
+  /// \return bytes used by the vectors and their data, including alignment
+  int ledfx_arena_get_size(ffi.Pointer<ledfx_arena_t> a) {
+    return _ledfx_arena_get_size(a);
+  }
+
+  late final _ledfx_arena_get_sizePtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_arena_t>)
+        >
+      >('ledfx_arena_get_size');
+  late final _ledfx_arena_get_size = _ledfx_arena_get_sizePtr
+      .asFunction<int Function(ffi.Pointer<ledfx_arena_t>)>();
+
+  /// get the number of blocks requested from the system
+  ///
+  /// \param a arena
+  int ledfx_arena_get_n_blocks(ffi.Pointer<ledfx_arena_t> a) {
+    return _ledfx_arena_get_n_blocks(a);
+  }
+
+  late final _ledfx_arena_get_n_blocksPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_arena_t>)
+        >
+      >('ledfx_arena_get_n_blocks');
+  late final _ledfx_arena_get_n_blocks = _ledfx_arena_get_n_blocksPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_arena_t>)>();
+
+  /// create phase vocoder
+  ///
+  /// \param win_s window size, a power of two
+  /// \param hop_s number of input samples per call to ledfx_pvoc_do(), at most
+  /// win_s
+  ///
+  /// \return newly created object, or NULL on invalid parameters
+  ffi.Pointer<ledfx_pvoc_t> new_ledfx_pvoc(int win_s, int hop_s) {
+    return _new_ledfx_pvoc(win_s, hop_s);
+  }
+
+  late final _new_ledfx_pvocPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_pvoc_t> Function(aubio.uint_t, aubio.uint_t)
+        >
+      >('new_ledfx_pvoc');
+  late final _new_ledfx_pvoc = _new_ledfx_pvocPtr
+      .asFunction<ffi.Pointer<ledfx_pvoc_t> Function(int, int)>();
+
+  /// delete phase vocoder
+  ///
+  /// \param pv object to delete, as returned by new_ledfx_pvoc()
+  void del_ledfx_pvoc(ffi.Pointer<ledfx_pvoc_t> pv) {
+    return _del_ledfx_pvoc(pv);
+  }
+
+  late final _del_ledfx_pvocPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_pvoc_t>)>>(
+        'del_ledfx_pvoc',
+      );
+  late final _del_ledfx_pvoc = _del_ledfx_pvocPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_pvoc_t>)>();
+
+  /// slide in one hop and compute its spectrum
+  ///
+  /// \param pv phase vocoder object
+  /// \param in hop_s new samples
+  /// \param fftgrain output spectrum, of length win_s / 2 + 1
+  void ledfx_pvoc_do(
+    ffi.Pointer<ledfx_pvoc_t> pv,
+    ffi.Pointer<aubio.fvec_t> in$,
+    ffi.Pointer<aubio.cvec_t> fftgrain,
+  ) {
+    return _ledfx_pvoc_do(pv, in$, fftgrain);
+  }
+
+  late final _ledfx_pvoc_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(
+            ffi.Pointer<ledfx_pvoc_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<aubio.cvec_t>,
+          )
+        >
+      >('ledfx_pvoc_do');
+  late final _ledfx_pvoc_do = _ledfx_pvoc_doPtr
+      .asFunction<
+        void Function(
+          ffi.Pointer<ledfx_pvoc_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<aubio.cvec_t>,
+        )
+      >();
+
+  /// get the current frame
+  ///
+  /// \param pv phase vocoder object
+  ///
+  /// \return the last win_s input samples, before windowing
+  ffi.Pointer<aubio.fvec_t> ledfx_pvoc_get_frame(ffi.Pointer<ledfx_pvoc_t> pv) {
+    return _ledfx_pvoc_get_frame(pv);
+  }
+
+  late final _ledfx_pvoc_get_framePtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.fvec_t> Function(ffi.Pointer<ledfx_pvoc_t>)
+        >
+      >('ledfx_pvoc_get_frame');
+  late final _ledfx_pvoc_get_frame = _ledfx_pvoc_get_framePtr
+      .asFunction<
+        ffi.Pointer<aubio.fvec_t> Function(
+          ffi.Pointer<ledfx_pvoc_t>,
+        )
+      >();
+
+  /// get window size
+  ///
+  /// \param pv phase vocoder object
+  int ledfx_pvoc_get_win(ffi.Pointer<ledfx_pvoc_t> pv) {
+    return _ledfx_pvoc_get_win(pv);
+  }
+
+  late final _ledfx_pvoc_get_winPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_pvoc_t>)
+        >
+      >('ledfx_pvoc_get_win');
+  late final _ledfx_pvoc_get_win = _ledfx_pvoc_get_winPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pvoc_t>)>();
+
+  /// get hop size
+  ///
+  /// \param pv phase vocoder object
+  int ledfx_pvoc_get_hop(ffi.Pointer<ledfx_pvoc_t> pv) {
+    return _ledfx_pvoc_get_hop(pv);
+  }
+
+  late final _ledfx_pvoc_get_hopPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_pvoc_t>)
+        >
+      >('ledfx_pvoc_get_hop');
+  late final _ledfx_pvoc_get_hop = _ledfx_pvoc_get_hopPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pvoc_t>)>();
+
+  /// create analysis
+  ///
+  /// \param onset_method onset detection function, "energy", "hfc",
+  /// "complex" or "default" (hfc)
+  /// \param win_s phase vocoder window size, a power of two
+  /// \param hop_s number of input samples per call to ledfx_analysis_do(), at
+  /// most win_s
+  /// \param samplerate sampling rate of the input
+  ///
+  /// \return newly created object, or NULL on invalid parameters
+  ffi.Pointer<ledfx_analysis_t> new_ledfx_analysis(
+    ffi.Pointer<aubio.char_t> onset_method,
+    int win_s,
+    int hop_s,
+    int samplerate,
+  ) {
+    return _new_ledfx_analysis(onset_method, win_s, hop_s, samplerate);
+  }
+
+  late final _new_ledfx_analysisPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_analysis_t> Function(
+            ffi.Pointer<aubio.char_t>,
+            aubio.uint_t,
+            aubio.uint_t,
+            aubio.uint_t,
+          )
+        >
+      >('new_ledfx_analysis');
+  late final _new_ledfx_analysis = _new_ledfx_analysisPtr
+      .asFunction<
+        ffi.Pointer<ledfx_analysis_t> Function(
+          ffi.Pointer<aubio.char_t>,
+          int,
+          int,
+          int,
+        )
+      >();
+
+  /// delete analysis
+  ///
+  /// \param a object to delete, as returned by new_ledfx_analysis()
+  void del_ledfx_analysis(ffi.Pointer<ledfx_analysis_t> a) {
+    return _del_ledfx_analysis(a);
+  }
+
+  late final _del_ledfx_analysisPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_analysis_t>)
+        >
+      >('del_ledfx_analysis');
+  late final _del_ledfx_analysis = _del_ledfx_analysisPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_analysis_t>)>();
+
+  /// analyse one hop
+  ///
+  /// \param a analysis object
+  /// \param input hop_s new samples
+  /// \param result output, overwritten for every hop
+  void ledfx_analysis_do(
+    ffi.Pointer<ledfx_analysis_t> a,
+    ffi.Pointer<aubio.fvec_t> input,
+    ffi.Pointer<ledfx_analysis_result_t> result,
+  ) {
+    return _ledfx_analysis_do(a, input, result);
+  }
+
+  late final _ledfx_analysis_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(
+            ffi.Pointer<ledfx_analysis_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<ledfx_analysis_result_t>,
+          )
+        >
+      >('ledfx_analysis_do');
+  late final _ledfx_analysis_do = _ledfx_analysis_doPtr
+      .asFunction<
+        void Function(
+          ffi.Pointer<ledfx_analysis_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<ledfx_analysis_result_t>,
+        )
+      >();
+
+  /// set the peak picking threshold of the onset detection
+  ///
+  /// \param a analysis object
+  /// \param threshold new threshold, 0.058 for hfc by default
+  ///
+  /// \return 0 on success, non-zero otherwise
+  int ledfx_analysis_set_onset_threshold(
+    ffi.Pointer<ledfx_analysis_t> a,
+    double threshold,
+  ) {
+    return _ledfx_analysis_set_onset_threshold(a, threshold);
+  }
+
+  late final _ledfx_analysis_set_onset_thresholdPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_analysis_t>, aubio.smpl_t)
+        >
+      >('ledfx_analysis_set_onset_threshold');
+  late final _ledfx_analysis_set_onset_threshold =
+      _ledfx_analysis_set_onset_thresholdPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_analysis_t>, double)>();
+
+  /// set the yinfast tolerance of the pitch detection
+  ///
+  /// \param a analysis object
+  /// \param tolerance new tolerance, 0.15 by default
+  ///
+  /// \return 0 on success, non-zero otherwise
+  int ledfx_analysis_set_pitch_tolerance(
+    ffi.Pointer<ledfx_analysis_t> a,
+    double tolerance,
+  ) {
+    return _ledfx_analysis_set_pitch_tolerance(a, tolerance);
+  }
+
+  late final _ledfx_analysis_set_pitch_tolerancePtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_analysis_t>, aubio.smpl_t)
+        >
+      >('ledfx_analysis_set_pitch_tolerance');
+  late final _ledfx_analysis_set_pitch_tolerance =
+      _ledfx_analysis_set_pitch_tolerancePtr
+          .asFunction<int Function(ffi.Pointer<ledfx_analysis_t>, double)>();
+
+  /// create gradient
+  ///
+  /// \param length number of entries of the colour curve
+  ///
+  /// \return newly created object, black until ledfx_gradient_set_colors() is
+  /// called, or NULL on invalid parameters
+  ffi.Pointer<ledfx_gradient_t> new_ledfx_gradient(int length) {
+    return _new_ledfx_gradient(length);
+  }
+
+  late final _new_ledfx_gradientPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_gradient_t> Function(aubio.uint_t)
+        >
+      >('new_ledfx_gradient');
+  late final _new_ledfx_gradient = _new_ledfx_gradientPtr
+      .asFunction<ffi.Pointer<ledfx_gradient_t> Function(int)>();
+
+  /// delete gradient
+  ///
+  /// \param g object to delete, as returned by new_ledfx_gradient()
+  void del_ledfx_gradient(ffi.Pointer<ledfx_gradient_t> g) {
+    return _del_ledfx_gradient(g);
+  }
+
+  late final _del_ledfx_gradientPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_gradient_t>)
+        >
+      >('del_ledfx_gradient');
+  late final _del_ledfx_gradient = _del_ledfx_gradientPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_gradient_t>)>();
+
+  /// generate the colour curve from colour stops
+  ///
+  /// Stops missing at 0 or 1 repeat the first or last colour there. Resets the
+  /// roll.
+  ///
+  /// \param g gradient object
+  /// \param colors n_colors interleaved r, g, b triplets
+  /// \param positions n_colors stop positions in [0, 1], in ascending order
+  /// \param n_colors number of stops, at least 1
+  ///
+  /// \return 0 on success, non-zero on invalid parameters
+  int ledfx_gradient_set_colors(
+    ffi.Pointer<ledfx_gradient_t> g,
+    ffi.Pointer<aubio.smpl_t> colors,
+    ffi.Pointer<aubio.smpl_t> positions,
+    int n_colors,
+  ) {
+    return _ledfx_gradient_set_colors(g, colors, positions, n_colors);
+  }
+
+  late final _ledfx_gradient_set_colorsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_gradient_t>,
+            ffi.Pointer<aubio.smpl_t>,
+            ffi.Pointer<aubio.smpl_t>,
+            aubio.uint_t,
+          )
+        >
+      >('ledfx_gradient_set_colors');
+  late final _ledfx_gradient_set_colors = _ledfx_gradient_set_colorsPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_gradient_t>,
+          ffi.Pointer<aubio.smpl_t>,
+          ffi.Pointer<aubio.smpl_t>,
+          int,
+        )
+      >();
+
+  /// set the roll speed
+  ///
+  /// \param g gradient object
+  /// \param roll pixels of an n pixel strip the gradient moves per frame; the
+  /// sign gives the direction, 0 stops it
+  void ledfx_gradient_set_roll(ffi.Pointer<ledfx_gradient_t> g, double roll) {
+    return _ledfx_gradient_set_roll(g, roll);
+  }
+
+  late final _ledfx_gradient_set_rollPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_gradient_t>, aubio.smpl_t)
+        >
+      >('ledfx_gradient_set_roll');
+  late final _ledfx_gradient_set_roll = _ledfx_gradient_set_rollPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_gradient_t>, double)>();
+
+  /// colour one frame and advance the roll
+  ///
+  /// \param g gradient object
+  /// \param intensity per-pixel intensity, n pixels long
+  /// \param rgb output, at least 3 n long, interleaved r, g, b per pixel
+  ///
+  /// \return 0 on success, non-zero if rgb is too short
+  int ledfx_gradient_do(
+    ffi.Pointer<ledfx_gradient_t> g,
+    ffi.Pointer<aubio.fvec_t> intensity,
+    ffi.Pointer<aubio.fvec_t> rgb,
+  ) {
+    return _ledfx_gradient_do(g, intensity, rgb);
+  }
+
+  late final _ledfx_gradient_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_gradient_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_gradient_do');
+  late final _ledfx_gradient_do = _ledfx_gradient_doPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_gradient_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// get number of entries of the colour curve
+  ///
+  /// \param g gradient object
+  int ledfx_gradient_get_length(ffi.Pointer<ledfx_gradient_t> g) {
+    return _ledfx_gradient_get_length(g);
+  }
+
+  late final _ledfx_gradient_get_lengthPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_gradient_t>)
+        >
+      >('ledfx_gradient_get_length');
+  late final _ledfx_gradient_get_length = _ledfx_gradient_get_lengthPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_gradient_t>)>();
+
+  /// get the colour curve
+  ///
+  /// \param g gradient object
+  ///
+  /// \return length interleaved r, g, b triplets, unrolled, owned by the object
+  ffi.Pointer<aubio.smpl_t> ledfx_gradient_get_curve(
+    ffi.Pointer<ledfx_gradient_t> g,
+  ) {
+    return _ledfx_gradient_get_curve(g);
+  }
+
+  late final _ledfx_gradient_get_curvePtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.smpl_t> Function(ffi.Pointer<ledfx_gradient_t>)
+        >
+      >('ledfx_gradient_get_curve');
+  late final _ledfx_gradient_get_curve = _ledfx_gradient_get_curvePtr
+      .asFunction<
+        ffi.Pointer<aubio.smpl_t> Function(ffi.Pointer<ledfx_gradient_t>)
+      >();
+
+  /// create post-processing
+  ///
+  /// \param n_pixels number of pixels of the strip
+  ///
+  /// \return newly created object, with no flip, no mirror, brightness 1 and
+  /// no blur, or NULL on invalid parameters
+  ffi.Pointer<ledfx_postprocess_t> new_ledfx_postprocess(int n_pixels) {
+    return _new_ledfx_postprocess(n_pixels);
+  }
+
+  late final _new_ledfx_postprocessPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_postprocess_t> Function(aubio.uint_t)
+        >
+      >('new_ledfx_postprocess');
+  late final _new_ledfx_postprocess = _new_ledfx_postprocessPtr
+      .asFunction<ffi.Pointer<ledfx_postprocess_t> Function(int)>();
+
+  /// delete post-processing
+  ///
+  /// \param p object to delete, as returned by new_ledfx_postprocess()
+  void del_ledfx_postprocess(ffi.Pointer<ledfx_postprocess_t> p) {
+    return _del_ledfx_postprocess(p);
+  }
+
+  late final _del_ledfx_postprocessPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_postprocess_t>)
+        >
+      >('del_ledfx_postprocess');
+  late final _del_ledfx_postprocess = _del_ledfx_postprocessPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_postprocess_t>)>();
+
+  /// set flip
+  ///
+  /// \param p post-processing object
+  /// \param flip 1 to reverse the strip, 0 otherwise
+  void ledfx_postprocess_set_flip(
+    ffi.Pointer<ledfx_postprocess_t> p,
+    int flip,
+  ) {
+    return _ledfx_postprocess_set_flip(p, flip);
+  }
+
+  late final _ledfx_postprocess_set_flipPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_postprocess_t>, aubio.uint_t)
+        >
+      >('ledfx_postprocess_set_flip');
+  late final _ledfx_postprocess_set_flip = _ledfx_postprocess_set_flipPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_postprocess_t>, int)>();
+
+  /// set mirror
+  ///
+  /// \param p post-processing object
+  /// \param mirror 1 to mirror the strip, 0 otherwise
+  void ledfx_postprocess_set_mirror(
+    ffi.Pointer<ledfx_postprocess_t> p,
+    int mirror,
+  ) {
+    return _ledfx_postprocess_set_mirror(p, mirror);
+  }
+
+  late final _ledfx_postprocess_set_mirrorPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_postprocess_t>, aubio.uint_t)
+        >
+      >('ledfx_postprocess_set_mirror');
+  late final _ledfx_postprocess_set_mirror = _ledfx_postprocess_set_mirrorPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_postprocess_t>, int)>();
+
+  /// set brightness
+  ///
+  /// \param p post-processing object
+  /// \param brightness factor applied to every value
+  void ledfx_postprocess_set_brightness(
+    ffi.Pointer<ledfx_postprocess_t> p,
+    double brightness,
+  ) {
+    return _ledfx_postprocess_set_brightness(p, brightness);
+  }
+
+  late final _ledfx_postprocess_set_brightnessPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(ffi.Pointer<ledfx_postprocess_t>, aubio.smpl_t)
+        >
+      >('ledfx_postprocess_set_brightness');
+  late final _ledfx_postprocess_set_brightness =
+      _ledfx_postprocess_set_brightnessPtr
+          .asFunction<
+            void Function(ffi.Pointer<ledfx_postprocess_t>, double)
+          >();
+
+  /// set blur
+  ///
+  /// Strips of 3 pixels or less are never blurred.
+  ///
+  /// \param p post-processing object
+  /// \param sigma standard deviation of the Gaussian in pixels, 0 to disable
+  ///
+  /// \return 0 on success, non-zero if sigma is negative
+  int ledfx_postprocess_set_blur(
+    ffi.Pointer<ledfx_postprocess_t> p,
+    double sigma,
+  ) {
+    return _ledfx_postprocess_set_blur(p, sigma);
+  }
+
+  late final _ledfx_postprocess_set_blurPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_postprocess_t>, aubio.smpl_t)
+        >
+      >('ledfx_postprocess_set_blur');
+  late final _ledfx_postprocess_set_blur = _ledfx_postprocess_set_blurPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_postprocess_t>, double)>();
+
+  /// process one frame
+  ///
+  /// \param p post-processing object
+  /// \param in input, 3 n_pixels interleaved r, g, b values
+  /// \param out output, 3 n_pixels long; may be the same vector as in
+  ///
+  /// \return 0 on success, non-zero if a buffer has the wrong length
+  int ledfx_postprocess_do(
+    ffi.Pointer<ledfx_postprocess_t> p,
+    ffi.Pointer<aubio.fvec_t> in$,
+    ffi.Pointer<aubio.fvec_t> out,
+  ) {
+    return _ledfx_postprocess_do(p, in$, out);
+  }
+
+  late final _ledfx_postprocess_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_postprocess_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_postprocess_do');
+  late final _ledfx_postprocess_do = _ledfx_postprocess_doPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_postprocess_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// get number of pixels
+  ///
+  /// \param p post-processing object
+  int ledfx_postprocess_get_n_pixels(ffi.Pointer<ledfx_postprocess_t> p) {
+    return _ledfx_postprocess_get_n_pixels(p);
+  }
+
+  late final _ledfx_postprocess_get_n_pixelsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_postprocess_t>)
+        >
+      >('ledfx_postprocess_get_n_pixels');
+  late final _ledfx_postprocess_get_n_pixels =
+      _ledfx_postprocess_get_n_pixelsPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_postprocess_t>)>();
+
+  /// compile a mapping
+  ///
+  /// Each segment is ::LEDFX_MAPPING_SEGMENT_LEN values: its first physical
+  /// pixel in the virtual (ignored with ::LEDFX_MAPPING_COPY), its first and
+  /// last device pixels, inclusive, and non-zero if it is inverted.
+  ///
+  /// \param mode one of ::ledfx_mapping_mode_t
+  /// \param n_in effective pixels of the frame
+  /// \param n_virtual physical pixels of the virtual
+  /// \param n_out pixels of the device
+  /// \param group_size physical pixels per effective pixel, 1 or more
+  /// \param center_offset pixels the device frame is rotated by
+  /// \param segments n_segments segments, as described above
+  /// \param n_segments number of segments on this device
+  ///
+  /// \return newly created mapping, or NULL if a parameter is invalid or a
+  /// segment does not fit on the device
+  ffi.Pointer<ledfx_mapping_t> new_ledfx_mapping(
+    int mode,
+    int n_in,
+    int n_virtual,
+    int n_out,
+    int group_size,
+    int center_offset,
+    ffi.Pointer<aubio.uint_t> segments,
+    int n_segments,
+  ) {
+    return _new_ledfx_mapping(
+      mode,
+      n_in,
+      n_virtual,
+      n_out,
+      group_size,
+      center_offset,
+      segments,
+      n_segments,
+    );
+  }
+
+  late final _new_ledfx_mappingPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_mapping_t> Function(
+            aubio.uint_t,
+            aubio.uint_t,
+            aubio.uint_t,
+            aubio.uint_t,
+            aubio.uint_t,
+            aubio.uint_t,
+            ffi.Pointer<aubio.uint_t>,
+            aubio.uint_t,
+          )
+        >
+      >('new_ledfx_mapping');
+  late final _new_ledfx_mapping = _new_ledfx_mappingPtr
+      .asFunction<
+        ffi.Pointer<ledfx_mapping_t> Function(
+          int,
+          int,
+          int,
+          int,
+          int,
+          int,
+          ffi.Pointer<aubio.uint_t>,
+          int,
+        )
+      >();
+
+  /// delete a mapping
+  ///
+  /// \param m mapping to delete, as returned by new_ledfx_mapping()
+  void del_ledfx_mapping(ffi.Pointer<ledfx_mapping_t> m) {
+    return _del_ledfx_mapping(m);
+  }
+
+  late final _del_ledfx_mappingPtr =
+      _lookup<
+        ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_mapping_t>)>
+      >('del_ledfx_mapping');
+  late final _del_ledfx_mapping = _del_ledfx_mappingPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_mapping_t>)>();
+
+  /// write a frame onto the device
+  ///
+  /// \param m mapping
+  /// \param in frame, 3 n_in interleaved r, g, b values
+  /// \param out device pixels, 3 n_out interleaved r, g, b values
+  ///
+  /// \return 0 on success, non-zero if in or out has the wrong length
+  int ledfx_mapping_do(
+    ffi.Pointer<ledfx_mapping_t> m,
+    ffi.Pointer<aubio.fvec_t> in$,
+    ffi.Pointer<aubio.fvec_t> out,
+  ) {
+    return _ledfx_mapping_do(m, in$, out);
+  }
+
+  late final _ledfx_mapping_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_mapping_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_mapping_do');
+  late final _ledfx_mapping_do = _ledfx_mapping_doPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_mapping_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// get number of effective pixels of the frame
+  ///
+  /// \param m mapping
+  int ledfx_mapping_get_n_in(ffi.Pointer<ledfx_mapping_t> m) {
+    return _ledfx_mapping_get_n_in(m);
+  }
+
+  late final _ledfx_mapping_get_n_inPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_mapping_t>)>
+      >('ledfx_mapping_get_n_in');
+  late final _ledfx_mapping_get_n_in = _ledfx_mapping_get_n_inPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_mapping_t>)>();
+
+  /// get number of pixels of the device
+  ///
+  /// \param m mapping
+  int ledfx_mapping_get_n_out(ffi.Pointer<ledfx_mapping_t> m) {
+    return _ledfx_mapping_get_n_out(m);
+  }
+
+  late final _ledfx_mapping_get_n_outPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_mapping_t>)>
+      >('ledfx_mapping_get_n_out');
+  late final _ledfx_mapping_get_n_out = _ledfx_mapping_get_n_outPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_mapping_t>)>();
+
+  /// get number of device pixels written by ledfx_mapping_do()
+  ///
+  /// \param m mapping
+  int ledfx_mapping_get_n_mapped(ffi.Pointer<ledfx_mapping_t> m) {
+    return _ledfx_mapping_get_n_mapped(m);
+  }
+
+  late final _ledfx_mapping_get_n_mappedPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_mapping_t>)>
+      >('ledfx_mapping_get_n_mapped');
+  late final _ledfx_mapping_get_n_mapped = _ledfx_mapping_get_n_mappedPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_mapping_t>)>();
+
+  /// get number of contiguous runs of device pixels, one gather each
+  ///
+  /// \param m mapping
+  int ledfx_mapping_get_n_runs(ffi.Pointer<ledfx_mapping_t> m) {
+    return _ledfx_mapping_get_n_runs(m);
+  }
+
+  late final _ledfx_mapping_get_n_runsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_mapping_t>)>
+      >('ledfx_mapping_get_n_runs');
+  late final _ledfx_mapping_get_n_runs = _ledfx_mapping_get_n_runsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_mapping_t>)>();
+
+  /// create a UDP sender
+  ///
+  /// \param host destination, IPv4 or IPv6 address or host name
+  /// \param port destination port
+  ///
+  /// \return newly created sender, or NULL if host can not be resolved or the
+  /// socket can not be created
+  ffi.Pointer<ledfx_udp_t> new_ledfx_udp(
+    ffi.Pointer<aubio.char_t> host,
+    int port,
+  ) {
+    return _new_ledfx_udp(host, port);
+  }
+
+  late final _new_ledfx_udpPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_udp_t> Function(
+            ffi.Pointer<aubio.char_t>,
+            aubio.uint_t,
+          )
+        >
+      >('new_ledfx_udp');
+  late final _new_ledfx_udp = _new_ledfx_udpPtr
+      .asFunction<
+        ffi.Pointer<ledfx_udp_t> Function(ffi.Pointer<aubio.char_t>, int)
+      >();
+
+  /// delete a UDP sender
+  ///
+  /// \param u sender to delete, as returned by new_ledfx_udp()
+  void del_ledfx_udp(ffi.Pointer<ledfx_udp_t> u) {
+    return _del_ledfx_udp(u);
+  }
+
+  late final _del_ledfx_udpPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_udp_t>)>>(
+        'del_ledfx_udp',
+      );
+  late final _del_ledfx_udp = _del_ledfx_udpPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_udp_t>)>();
+
+  /// send packets
+  ///
+  /// \param u UDP sender
+  /// \param packets packet payloads, n_packets of them
+  /// \param lengths length of each payload in bytes
+  /// \param n_packets number of packets to send
+  ///
+  /// \return number of packets queued by the kernel; packets that could not be
+  /// sent are counted by ledfx_udp_get_n_dropped()
+  int ledfx_udp_send(
+    ffi.Pointer<ledfx_udp_t> u,
+    ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>> packets,
+    ffi.Pointer<aubio.uint_t> lengths,
+    int n_packets,
+  ) {
+    return _ledfx_udp_send(u, packets, lengths, n_packets);
+  }
+
+  late final _ledfx_udp_sendPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_udp_t>,
+            ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>>,
+            ffi.Pointer<aubio.uint_t>,
+            aubio.uint_t,
+          )
+        >
+      >('ledfx_udp_send');
+  late final _ledfx_udp_send = _ledfx_udp_sendPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_udp_t>,
+          ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>>,
+          ffi.Pointer<aubio.uint_t>,
+          int,
+        )
+      >();
+
+  /// get number of packets sent since creation
+  ///
+  /// \param u UDP sender
+  int ledfx_udp_get_n_sent(ffi.Pointer<ledfx_udp_t> u) {
+    return _ledfx_udp_get_n_sent(u);
+  }
+
+  late final _ledfx_udp_get_n_sentPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_udp_t>)>
+      >('ledfx_udp_get_n_sent');
+  late final _ledfx_udp_get_n_sent = _ledfx_udp_get_n_sentPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_udp_t>)>();
+
+  /// get number of packets dropped since creation
+  ///
+  /// \param u UDP sender
+  int ledfx_udp_get_n_dropped(ffi.Pointer<ledfx_udp_t> u) {
+    return _ledfx_udp_get_n_dropped(u);
+  }
+
+  late final _ledfx_udp_get_n_droppedPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_udp_t>)>
+      >('ledfx_udp_get_n_dropped');
+  late final _ledfx_udp_get_n_dropped = _ledfx_udp_get_n_droppedPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_udp_t>)>();
+
+  /// get number of send calls made since creation
+  ///
+  /// Each call to ledfx_udp_send() makes one call per batch with sendmmsg(),
+  /// or one per packet without.
+  ///
+  /// \param u UDP sender
+  int ledfx_udp_get_n_syscalls(ffi.Pointer<ledfx_udp_t> u) {
+    return _ledfx_udp_get_n_syscalls(u);
+  }
+
+  late final _ledfx_udp_get_n_syscallsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_udp_t>)>
+      >('ledfx_udp_get_n_syscalls');
+  late final _ledfx_udp_get_n_syscalls = _ledfx_udp_get_n_syscallsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_udp_t>)>();
+
+  /// create a DDP packetizer
+  ///
+  /// \param n_pixels number of pixels of the strip
+  ///
+  /// \return newly created object, or NULL on invalid parameters
+  ffi.Pointer<ledfx_ddp_t> new_ledfx_ddp(int n_pixels) {
+    return _new_ledfx_ddp(n_pixels);
+  }
+
+  late final _new_ledfx_ddpPtr =
+      _lookup<
+        ffi.NativeFunction<ffi.Pointer<ledfx_ddp_t> Function(aubio.uint_t)>
+      >('new_ledfx_ddp');
+  late final _new_ledfx_ddp = _new_ledfx_ddpPtr
+      .asFunction<ffi.Pointer<ledfx_ddp_t> Function(int)>();
+
+  /// delete a DDP packetizer
+  ///
+  /// \param d object to delete, as returned by new_ledfx_ddp()
+  void del_ledfx_ddp(ffi.Pointer<ledfx_ddp_t> d) {
+    return _del_ledfx_ddp(d);
+  }
+
+  late final _del_ledfx_ddpPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_ddp_t>)>>(
+        'del_ledfx_ddp',
+      );
+  late final _del_ledfx_ddp = _del_ledfx_ddpPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_ddp_t>)>();
+
+  /// encode one frame and advance the sequence number
+  ///
+  /// \param d DDP packetizer
+  /// \param rgb 3 n_pixels interleaved r, g, b values
+  ///
+  /// \return 0 on success, non-zero if rgb has the wrong length
+  int ledfx_ddp_do(ffi.Pointer<ledfx_ddp_t> d, ffi.Pointer<aubio.fvec_t> rgb) {
+    return _ledfx_ddp_do(d, rgb);
+  }
+
+  late final _ledfx_ddp_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_ddp_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_ddp_do');
+  late final _ledfx_ddp_do = _ledfx_ddp_doPtr
+      .asFunction<
+        int Function(ffi.Pointer<ledfx_ddp_t>, ffi.Pointer<aubio.fvec_t>)
+      >();
+
+  /// send the packets of the last frame
+  ///
+  /// \param d DDP packetizer
+  /// \param u UDP sender connected to the receiver
+  ///
+  /// \return number of packets queued by the kernel
+  int ledfx_ddp_send(ffi.Pointer<ledfx_ddp_t> d, ffi.Pointer<ledfx_udp_t> u) {
+    return _ledfx_ddp_send(d, u);
+  }
+
+  late final _ledfx_ddp_sendPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_ddp_t>,
+            ffi.Pointer<ledfx_udp_t>,
+          )
+        >
+      >('ledfx_ddp_send');
+  late final _ledfx_ddp_send = _ledfx_ddp_sendPtr
+      .asFunction<
+        int Function(ffi.Pointer<ledfx_ddp_t>, ffi.Pointer<ledfx_udp_t>)
+      >();
+
+  /// get number of packets per frame
+  ///
+  /// \param d DDP packetizer
+  int ledfx_ddp_get_n_packets(ffi.Pointer<ledfx_ddp_t> d) {
+    return _ledfx_ddp_get_n_packets(d);
+  }
+
+  late final _ledfx_ddp_get_n_packetsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_ddp_t>)>
+      >('ledfx_ddp_get_n_packets');
+  late final _ledfx_ddp_get_n_packets = _ledfx_ddp_get_n_packetsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_ddp_t>)>();
+
+  /// get the packets of the last frame
+  ///
+  /// \param d DDP packetizer
+  ///
+  /// \return ledfx_ddp_get_n_packets() pointers to the packets, header first
+  ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>> ledfx_ddp_get_packets(
+    ffi.Pointer<ledfx_ddp_t> d,
+  ) {
+    return _ledfx_ddp_get_packets(d);
+  }
+
+  late final _ledfx_ddp_get_packetsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>> Function(
+            ffi.Pointer<ledfx_ddp_t>,
+          )
+        >
+      >('ledfx_ddp_get_packets');
+  late final _ledfx_ddp_get_packets = _ledfx_ddp_get_packetsPtr
+      .asFunction<
+        ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>> Function(
+          ffi.Pointer<ledfx_ddp_t>,
+        )
+      >();
+
+  /// get the length of the packets, header included
+  ///
+  /// \param d DDP packetizer
+  ///
+  /// \return ledfx_ddp_get_n_packets() lengths in bytes
+  ffi.Pointer<aubio.uint_t> ledfx_ddp_get_lengths(ffi.Pointer<ledfx_ddp_t> d) {
+    return _ledfx_ddp_get_lengths(d);
+  }
+
+  late final _ledfx_ddp_get_lengthsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.uint_t> Function(ffi.Pointer<ledfx_ddp_t>)
+        >
+      >('ledfx_ddp_get_lengths');
+  late final _ledfx_ddp_get_lengths = _ledfx_ddp_get_lengthsPtr
+      .asFunction<
+        ffi.Pointer<aubio.uint_t> Function(ffi.Pointer<ledfx_ddp_t>)
+      >();
+
+  /// get number of pixels
+  ///
+  /// \param d DDP packetizer
+  int ledfx_ddp_get_n_pixels(ffi.Pointer<ledfx_ddp_t> d) {
+    return _ledfx_ddp_get_n_pixels(d);
+  }
+
+  late final _ledfx_ddp_get_n_pixelsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_ddp_t>)>
+      >('ledfx_ddp_get_n_pixels');
+  late final _ledfx_ddp_get_n_pixels = _ledfx_ddp_get_n_pixelsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_ddp_t>)>();
+
+  /// create a WLED realtime encoder
+  ///
+  /// \param protocol one of ::ledfx_wled_protocol_t
+  /// \param n_pixels number of pixels of the strip
+  ///
+  /// \return newly created object, or NULL if protocol is unknown or can not
+  /// address n_pixels LEDs
+  ffi.Pointer<ledfx_wled_t> new_ledfx_wled(int protocol, int n_pixels) {
+    return _new_ledfx_wled(protocol, n_pixels);
+  }
+
+  late final _new_ledfx_wledPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_wled_t> Function(aubio.uint_t, aubio.uint_t)
+        >
+      >('new_ledfx_wled');
+  late final _new_ledfx_wled = _new_ledfx_wledPtr
+      .asFunction<ffi.Pointer<ledfx_wled_t> Function(int, int)>();
+
+  /// delete a WLED realtime encoder
+  ///
+  /// \param w object to delete, as returned by new_ledfx_wled()
+  void del_ledfx_wled(ffi.Pointer<ledfx_wled_t> w) {
+    return _del_ledfx_wled(w);
+  }
+
+  late final _del_ledfx_wledPtr =
+      _lookup<
+        ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_wled_t>)>
+      >('del_ledfx_wled');
+  late final _del_ledfx_wled = _del_ledfx_wledPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_wled_t>)>();
+
+  /// set the timeout written in every packet
+  ///
+  /// \param w WLED realtime encoder
+  /// \param timeout seconds, 1 to ::LEDFX_WLED_TIMEOUT_FOREVER; 1 by default
+  ///
+  /// \return 0 on success, non-zero if timeout is out of range
+  int ledfx_wled_set_timeout(ffi.Pointer<ledfx_wled_t> w, int timeout) {
+    return _ledfx_wled_set_timeout(w, timeout);
+  }
+
+  late final _ledfx_wled_set_timeoutPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_wled_t>, aubio.uint_t)
+        >
+      >('ledfx_wled_set_timeout');
+  late final _ledfx_wled_set_timeout = _ledfx_wled_set_timeoutPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_wled_t>, int)>();
+
+  /// get the timeout written in every packet
+  ///
+  /// \param w WLED realtime encoder
+  int ledfx_wled_get_timeout(ffi.Pointer<ledfx_wled_t> w) {
+    return _ledfx_wled_get_timeout(w);
+  }
+
+  late final _ledfx_wled_get_timeoutPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_wled_t>)>
+      >('ledfx_wled_get_timeout');
+  late final _ledfx_wled_get_timeout = _ledfx_wled_get_timeoutPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_wled_t>)>();
+
+  /// encode one frame
+  ///
+  /// \param w WLED realtime encoder
+  /// \param rgb 3 n_pixels interleaved r, g, b values
+  ///
+  /// \return 0 on success, non-zero if rgb has the wrong length
+  int ledfx_wled_do(
+    ffi.Pointer<ledfx_wled_t> w,
+    ffi.Pointer<aubio.fvec_t> rgb,
+  ) {
+    return _ledfx_wled_do(w, rgb);
+  }
+
+  late final _ledfx_wled_doPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_wled_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_wled_do');
+  late final _ledfx_wled_do = _ledfx_wled_doPtr
+      .asFunction<
+        int Function(ffi.Pointer<ledfx_wled_t>, ffi.Pointer<aubio.fvec_t>)
+      >();
+
+  /// send all the packets of the last frame
+  ///
+  /// Same as ledfx_wled_send_changed() with all set.
+  ///
+  /// \param w WLED realtime encoder
+  /// \param u UDP sender connected to the receiver
+  ///
+  /// \return number of packets queued by the kernel
+  int ledfx_wled_send(
+    ffi.Pointer<ledfx_wled_t> w,
+    ffi.Pointer<ledfx_udp_t> u,
+  ) {
+    return _ledfx_wled_send(w, u);
+  }
+
+  late final _ledfx_wled_sendPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_wled_t>,
+            ffi.Pointer<ledfx_udp_t>,
+          )
+        >
+      >('ledfx_wled_send');
+  late final _ledfx_wled_send = _ledfx_wled_sendPtr
+      .asFunction<
+        int Function(ffi.Pointer<ledfx_wled_t>, ffi.Pointer<ledfx_udp_t>)
+      >();
+
+  /// send the packets of the last frame that changed since they were sent
+  ///
+  /// Every packet is sent on the first call, and when all is non-zero, as
+  /// needed for keepalives.
+  ///
+  /// \param w WLED realtime encoder
+  /// \param u UDP sender connected to the receiver
+  /// \param all if non-zero, send unchanged packets too
+  ///
+  /// \return number of packets queued by the kernel
+  int ledfx_wled_send_changed(
+    ffi.Pointer<ledfx_wled_t> w,
+    ffi.Pointer<ledfx_udp_t> u,
+    int all,
+  ) {
+    return _ledfx_wled_send_changed(w, u, all);
+  }
+
+  late final _ledfx_wled_send_changedPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_wled_t>,
+            ffi.Pointer<ledfx_udp_t>,
+            aubio.uint_t,
+          )
+        >
+      >('ledfx_wled_send_changed');
+  late final _ledfx_wled_send_changed = _ledfx_wled_send_changedPtr
+      .asFunction<
+        int Function(ffi.Pointer<ledfx_wled_t>, ffi.Pointer<ledfx_udp_t>, int)
+      >();
+
+  /// get number of packets left out as unchanged since creation
+  ///
+  /// \param w WLED realtime encoder
+  int ledfx_wled_get_n_skipped_packets(ffi.Pointer<ledfx_wled_t> w) {
+    return _ledfx_wled_get_n_skipped_packets(w);
+  }
+
+  late final _ledfx_wled_get_n_skipped_packetsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_wled_t>)>
+      >('ledfx_wled_get_n_skipped_packets');
+  late final _ledfx_wled_get_n_skipped_packets =
+      _ledfx_wled_get_n_skipped_packetsPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_wled_t>)>();
+
+  /// get number of bytes left out as unchanged since creation, headers
+  /// included
+  ///
+  /// \param w WLED realtime encoder
+  int ledfx_wled_get_n_skipped_bytes(ffi.Pointer<ledfx_wled_t> w) {
+    return _ledfx_wled_get_n_skipped_bytes(w);
+  }
+
+  late final _ledfx_wled_get_n_skipped_bytesPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_wled_t>)>
+      >('ledfx_wled_get_n_skipped_bytes');
+  late final _ledfx_wled_get_n_skipped_bytes =
+      _ledfx_wled_get_n_skipped_bytesPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_wled_t>)>();
+
+  /// get the protocol of the encoder
+  ///
+  /// \param w WLED realtime encoder
+  int ledfx_wled_get_protocol(ffi.Pointer<ledfx_wled_t> w) {
+    return _ledfx_wled_get_protocol(w);
+  }
+
+  late final _ledfx_wled_get_protocolPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_wled_t>)>
+      >('ledfx_wled_get_protocol');
+  late final _ledfx_wled_get_protocol = _ledfx_wled_get_protocolPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_wled_t>)>();
+
+  /// get number of packets per frame
+  ///
+  /// \param w WLED realtime encoder
+  int ledfx_wled_get_n_packets(ffi.Pointer<ledfx_wled_t> w) {
+    return _ledfx_wled_get_n_packets(w);
+  }
+
+  late final _ledfx_wled_get_n_packetsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_wled_t>)>
+      >('ledfx_wled_get_n_packets');
+  late final _ledfx_wled_get_n_packets = _ledfx_wled_get_n_packetsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_wled_t>)>();
+
+  /// get the packets of the last frame
+  ///
+  /// \param w WLED realtime encoder
+  ///
+  /// \return ledfx_wled_get_n_packets() pointers to the packets, header first
+  ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>> ledfx_wled_get_packets(
+    ffi.Pointer<ledfx_wled_t> w,
+  ) {
+    return _ledfx_wled_get_packets(w);
+  }
+
+  late final _ledfx_wled_get_packetsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>> Function(
+            ffi.Pointer<ledfx_wled_t>,
+          )
+        >
+      >('ledfx_wled_get_packets');
+  late final _ledfx_wled_get_packets = _ledfx_wled_get_packetsPtr
+      .asFunction<
+        ffi.Pointer<ffi.Pointer<ffi.UnsignedChar>> Function(
+          ffi.Pointer<ledfx_wled_t>,
+        )
+      >();
+
+  /// get the length of the packets, header included
+  ///
+  /// \param w WLED realtime encoder
+  ///
+  /// \return ledfx_wled_get_n_packets() lengths in bytes
+  ffi.Pointer<aubio.uint_t> ledfx_wled_get_lengths(
+    ffi.Pointer<ledfx_wled_t> w,
+  ) {
+    return _ledfx_wled_get_lengths(w);
+  }
+
+  late final _ledfx_wled_get_lengthsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<aubio.uint_t> Function(ffi.Pointer<ledfx_wled_t>)
+        >
+      >('ledfx_wled_get_lengths');
+  late final _ledfx_wled_get_lengths = _ledfx_wled_get_lengthsPtr
+      .asFunction<
+        ffi.Pointer<aubio.uint_t> Function(ffi.Pointer<ledfx_wled_t>)
+      >();
+
+  /// get number of pixels
+  ///
+  /// \param w WLED realtime encoder
+  int ledfx_wled_get_n_pixels(ffi.Pointer<ledfx_wled_t> w) {
+    return _ledfx_wled_get_n_pixels(w);
+  }
+
+  late final _ledfx_wled_get_n_pixelsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_wled_t>)>
+      >('ledfx_wled_get_n_pixels');
+  late final _ledfx_wled_get_n_pixels = _ledfx_wled_get_n_pixelsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_wled_t>)>();
+
+  /// create an output scheduler and start its thread
+  ///
+  /// \return newly created object, or NULL if the thread could not be started
+  ffi.Pointer<ledfx_scheduler_t> new_ledfx_scheduler() {
+    return _new_ledfx_scheduler();
+  }
+
+  late final _new_ledfx_schedulerPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ledfx_scheduler_t> Function()>>(
+        'new_ledfx_scheduler',
+      );
+  late final _new_ledfx_scheduler = _new_ledfx_schedulerPtr
+      .asFunction<ffi.Pointer<ledfx_scheduler_t> Function()>();
+
+  /// stop the thread and delete an output scheduler
+  ///
+  /// The encoders and UDP senders of the remaining outputs are not deleted.
+  ///
+  /// \param s object to delete, as returned by new_ledfx_scheduler()
+  void del_ledfx_scheduler(ffi.Pointer<ledfx_scheduler_t> s) {
+    return _del_ledfx_scheduler(s);
+  }
+
+  late final _del_ledfx_schedulerPtr =
+      _lookup<
+        ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_scheduler_t>)>
+      >('del_ledfx_scheduler');
+  late final _del_ledfx_scheduler = _del_ledfx_schedulerPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_scheduler_t>)>();
+
+  /// add a DDP device
+  ///
+  /// \param s output scheduler
+  /// \param d DDP packetizer of the device
+  /// \param u UDP sender connected to the device
+  /// \param rate frames per second, 1 to ::LEDFX_SCHEDULER_MAX_RATE
+  ///
+  /// \return index of the new output, or -1 if a parameter is invalid or the
+  /// scheduler is full
+  int ledfx_scheduler_add_ddp(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    ffi.Pointer<ledfx_ddp_t> d,
+    ffi.Pointer<ledfx_udp_t> u,
+    double rate,
+  ) {
+    return _ledfx_scheduler_add_ddp(s, d, u, rate);
+  }
+
+  late final _ledfx_scheduler_add_ddpPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.sint_t Function(
+            ffi.Pointer<ledfx_scheduler_t>,
+            ffi.Pointer<ledfx_ddp_t>,
+            ffi.Pointer<ledfx_udp_t>,
+            aubio.smpl_t,
+          )
+        >
+      >('ledfx_scheduler_add_ddp');
+  late final _ledfx_scheduler_add_ddp = _ledfx_scheduler_add_ddpPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_scheduler_t>,
+          ffi.Pointer<ledfx_ddp_t>,
+          ffi.Pointer<ledfx_udp_t>,
+          double,
+        )
+      >();
+
+  /// add a WLED realtime device
+  ///
+  /// Only the packets that changed since they were last sent go out, see
+  /// ledfx_wled_send_changed(), except every keepalive seconds when the whole
+  /// frame is sent to keep WLED in realtime mode.
+  ///
+  /// \param s output scheduler
+  /// \param w WLED realtime encoder of the device
+  /// \param u UDP sender connected to the device
+  /// \param rate frames per second, 1 to ::LEDFX_SCHEDULER_MAX_RATE
+  /// \param keepalive seconds between whole frames, 0 to always send the whole
+  /// frame
+  ///
+  /// \return index of the new output, or -1 if a parameter is invalid or the
+  /// scheduler is full
+  int ledfx_scheduler_add_wled(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    ffi.Pointer<ledfx_wled_t> w,
+    ffi.Pointer<ledfx_udp_t> u,
+    double rate,
+    double keepalive,
+  ) {
+    return _ledfx_scheduler_add_wled(s, w, u, rate, keepalive);
+  }
+
+  late final _ledfx_scheduler_add_wledPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.sint_t Function(
+            ffi.Pointer<ledfx_scheduler_t>,
+            ffi.Pointer<ledfx_wled_t>,
+            ffi.Pointer<ledfx_udp_t>,
+            aubio.smpl_t,
+            aubio.smpl_t,
+          )
+        >
+      >('ledfx_scheduler_add_wled');
+  late final _ledfx_scheduler_add_wled = _ledfx_scheduler_add_wledPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_scheduler_t>,
+          ffi.Pointer<ledfx_wled_t>,
+          ffi.Pointer<ledfx_udp_t>,
+          double,
+          double,
+        )
+      >();
+
+  /// remove an output
+  ///
+  /// Returns once the scheduler thread is done with the output's encoder and
+  /// UDP sender, which the caller can then delete.
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  ///
+  /// \return 0 on success, non-zero if output is not in use
+  int ledfx_scheduler_remove(ffi.Pointer<ledfx_scheduler_t> s, int output) {
+    return _ledfx_scheduler_remove(s, output);
+  }
+
+  late final _ledfx_scheduler_removePtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_remove');
+  late final _ledfx_scheduler_remove = _ledfx_scheduler_removePtr
+      .asFunction<int Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// submit the latest frame of an output
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  /// \param rgb 3 n_pixels interleaved r, g, b values, copied
+  ///
+  /// \return 0 on success, non-zero if output is not in use or rgb has the
+  /// wrong length
+  int ledfx_scheduler_submit(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+    ffi.Pointer<aubio.fvec_t> rgb,
+  ) {
+    return _ledfx_scheduler_submit(s, output, rgb);
+  }
+
+  late final _ledfx_scheduler_submitPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_scheduler_t>,
+            aubio.uint_t,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_scheduler_submit');
+  late final _ledfx_scheduler_submit = _ledfx_scheduler_submitPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_scheduler_t>,
+          int,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// get number of deadlines reached by an output
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  int ledfx_scheduler_get_n_ticks(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+  ) {
+    return _ledfx_scheduler_get_n_ticks(s, output);
+  }
+
+  late final _ledfx_scheduler_get_n_ticksPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_get_n_ticks');
+  late final _ledfx_scheduler_get_n_ticks = _ledfx_scheduler_get_n_ticksPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// get number of frames sent by an output
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  int ledfx_scheduler_get_n_frames(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+  ) {
+    return _ledfx_scheduler_get_n_frames(s, output);
+  }
+
+  late final _ledfx_scheduler_get_n_framesPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_get_n_frames');
+  late final _ledfx_scheduler_get_n_frames = _ledfx_scheduler_get_n_framesPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// get number of deadlines of an output missed as the thread woke too late
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  int ledfx_scheduler_get_n_missed(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+  ) {
+    return _ledfx_scheduler_get_n_missed(s, output);
+  }
+
+  late final _ledfx_scheduler_get_n_missedPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_get_n_missed');
+  late final _ledfx_scheduler_get_n_missed = _ledfx_scheduler_get_n_missedPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// get mean lateness of the deadlines of an output, in milliseconds
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  double ledfx_scheduler_get_jitter_mean_ms(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+  ) {
+    return _ledfx_scheduler_get_jitter_mean_ms(s, output);
+  }
+
+  late final _ledfx_scheduler_get_jitter_mean_msPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.smpl_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_get_jitter_mean_ms');
+  late final _ledfx_scheduler_get_jitter_mean_ms =
+      _ledfx_scheduler_get_jitter_mean_msPtr
+          .asFunction<double Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// get largest lateness of the deadlines of an output, in milliseconds
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  double ledfx_scheduler_get_jitter_max_ms(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+  ) {
+    return _ledfx_scheduler_get_jitter_max_ms(s, output);
+  }
+
+  late final _ledfx_scheduler_get_jitter_max_msPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.smpl_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_get_jitter_max_ms');
+  late final _ledfx_scheduler_get_jitter_max_ms =
+      _ledfx_scheduler_get_jitter_max_msPtr
+          .asFunction<double Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// get number of packets of a WLED output left out as unchanged
+  ///
+  /// Reads ledfx_wled_get_n_skipped_packets() of the output's encoder between
+  /// two sends of the scheduler thread.
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  ///
+  /// \return packets skipped since the encoder was created, 0 for a DDP
+  /// output
+  int ledfx_scheduler_get_n_skipped_packets(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+  ) {
+    return _ledfx_scheduler_get_n_skipped_packets(s, output);
+  }
+
+  late final _ledfx_scheduler_get_n_skipped_packetsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_get_n_skipped_packets');
+  late final _ledfx_scheduler_get_n_skipped_packets =
+      _ledfx_scheduler_get_n_skipped_packetsPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// get number of bytes of a WLED output left out as unchanged
+  ///
+  /// Reads ledfx_wled_get_n_skipped_bytes() of the output's encoder between
+  /// two sends of the scheduler thread.
+  ///
+  /// \param s output scheduler
+  /// \param output index returned when the output was added
+  ///
+  /// \return bytes skipped since the encoder was created, 0 for a DDP output
+  int ledfx_scheduler_get_n_skipped_bytes(
+    ffi.Pointer<ledfx_scheduler_t> s,
+    int output,
+  ) {
+    return _ledfx_scheduler_get_n_skipped_bytes(s, output);
+  }
+
+  late final _ledfx_scheduler_get_n_skipped_bytesPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(ffi.Pointer<ledfx_scheduler_t>, aubio.uint_t)
+        >
+      >('ledfx_scheduler_get_n_skipped_bytes');
+  late final _ledfx_scheduler_get_n_skipped_bytes =
+      _ledfx_scheduler_get_n_skipped_bytesPtr
+          .asFunction<int Function(ffi.Pointer<ledfx_scheduler_t>, int)>();
+
+  /// create a worker pool and start its threads
+  ///
+  /// \param n_threads number of worker threads, 0 to
+  /// ::LEDFX_POOL_MAX_THREADS; the thread calling ledfx_pool_run() takes part
+  /// too, so 0 runs every batch on that thread alone
+  ///
+  /// \return newly created object, or NULL if n_threads is too large or a
+  /// thread could not be started
+  ffi.Pointer<ledfx_pool_t> new_ledfx_pool(int n_threads) {
+    return _new_ledfx_pool(n_threads);
+  }
+
+  late final _new_ledfx_poolPtr =
+      _lookup<
+        ffi.NativeFunction<ffi.Pointer<ledfx_pool_t> Function(aubio.uint_t)>
+      >('new_ledfx_pool');
+  late final _new_ledfx_pool = _new_ledfx_poolPtr
+      .asFunction<ffi.Pointer<ledfx_pool_t> Function(int)>();
+
+  /// stop the threads and delete a worker pool
+  ///
+  /// \param p object to delete, as returned by new_ledfx_pool()
+  void del_ledfx_pool(ffi.Pointer<ledfx_pool_t> p) {
+    return _del_ledfx_pool(p);
+  }
+
+  late final _del_ledfx_poolPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_pool_t>)>>(
+        'del_ledfx_pool',
+      );
+  late final _del_ledfx_pool = _del_ledfx_poolPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_pool_t>)>();
+
+  /// get number of worker threads
+  ///
+  /// \param p worker pool
+  int ledfx_pool_get_n_threads(ffi.Pointer<ledfx_pool_t> p) {
+    return _ledfx_pool_get_n_threads(p);
+  }
+
+  late final _ledfx_pool_get_n_threadsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_pool_t>)>
+      >('ledfx_pool_get_n_threads');
+  late final _ledfx_pool_get_n_threads = _ledfx_pool_get_n_threadsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pool_t>)>();
+
+  /// get number of tasks run by another thread than the one dealt them,
+  /// since creation
+  ///
+  /// \param p worker pool
+  int ledfx_pool_get_n_stolen(ffi.Pointer<ledfx_pool_t> p) {
+    return _ledfx_pool_get_n_stolen(p);
+  }
+
+  late final _ledfx_pool_get_n_stolenPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_pool_t>)>
+      >('ledfx_pool_get_n_stolen');
+  late final _ledfx_pool_get_n_stolen = _ledfx_pool_get_n_stolenPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pool_t>)>();
+
+  /// create an empty render task
+  ///
+  /// \return newly created object, with no frame and no target
+  ffi.Pointer<ledfx_render_t> new_ledfx_render() {
+    return _new_ledfx_render();
+  }
+
+  late final _new_ledfx_renderPtr =
+      _lookup<ffi.NativeFunction<ffi.Pointer<ledfx_render_t> Function()>>(
+        'new_ledfx_render',
+      );
+  late final _new_ledfx_render = _new_ledfx_renderPtr
+      .asFunction<ffi.Pointer<ledfx_render_t> Function()>();
+
+  /// delete a render task
+  ///
+  /// \param r object to delete, as returned by new_ledfx_render()
+  void del_ledfx_render(ffi.Pointer<ledfx_render_t> r) {
+    return _del_ledfx_render(r);
+  }
+
+  late final _del_ledfx_renderPtr =
+      _lookup<
+        ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_render_t>)>
+      >('del_ledfx_render');
+  late final _del_ledfx_render = _del_ledfx_renderPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_render_t>)>();
+
+  /// set the frame of the next renders, and remove all targets
+  ///
+  /// \param r render task
+  /// \param post post-processing run on frame in place, or NULL for none
+  /// \param frame effect frame, 3 n_pixels interleaved r, g, b values
+  ///
+  /// \return 0 on success, non-zero if frame does not match post
+  int ledfx_render_set_frame(
+    ffi.Pointer<ledfx_render_t> r,
+    ffi.Pointer<ledfx_postprocess_t> post,
+    ffi.Pointer<aubio.fvec_t> frame,
+  ) {
+    return _ledfx_render_set_frame(r, post, frame);
+  }
+
+  late final _ledfx_render_set_framePtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_render_t>,
+            ffi.Pointer<ledfx_postprocess_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_render_set_frame');
+  late final _ledfx_render_set_frame = _ledfx_render_set_framePtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_render_t>,
+          ffi.Pointer<ledfx_postprocess_t>,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// add a device to write the frame onto
+  ///
+  /// \param r render task
+  /// \param m mapping of the virtual onto the device
+  /// \param pixels pixels of the device, 3 ledfx_mapping_get_n_out() values
+  ///
+  /// \return 0 on success, non-zero if m does not match the frame or pixels
+  int ledfx_render_add_target(
+    ffi.Pointer<ledfx_render_t> r,
+    ffi.Pointer<ledfx_mapping_t> m,
+    ffi.Pointer<aubio.fvec_t> pixels,
+  ) {
+    return _ledfx_render_add_target(r, m, pixels);
+  }
+
+  late final _ledfx_render_add_targetPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_render_t>,
+            ffi.Pointer<ledfx_mapping_t>,
+            ffi.Pointer<aubio.fvec_t>,
+          )
+        >
+      >('ledfx_render_add_target');
+  late final _ledfx_render_add_target = _ledfx_render_add_targetPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_render_t>,
+          ffi.Pointer<ledfx_mapping_t>,
+          ffi.Pointer<aubio.fvec_t>,
+        )
+      >();
+
+  /// run a render task on the calling thread
+  ///
+  /// \param r render task
+  ///
+  /// \return 0 on success, non-zero if no frame is set
+  int ledfx_render_do(ffi.Pointer<ledfx_render_t> r) {
+    return _ledfx_render_do(r);
+  }
+
+  late final _ledfx_render_doPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_render_t>)>
+      >('ledfx_render_do');
+  late final _ledfx_render_do = _ledfx_render_doPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_render_t>)>();
+
+  /// run render tasks on a pool and wait for all of them
+  ///
+  /// \param p worker pool
+  /// \param renders n_renders tasks, with distinct frames
+  /// \param n_renders number of tasks, up to ::LEDFX_POOL_MAX_TASKS
+  ///
+  /// \return 0 on success, non-zero if n_renders is too large or a task has
+  /// no frame, in which case no task is run
+  int ledfx_render_run(
+    ffi.Pointer<ledfx_pool_t> p,
+    ffi.Pointer<ffi.Pointer<ledfx_render_t>> renders,
+    int n_renders,
+  ) {
+    return _ledfx_render_run(p, renders, n_renders);
+  }
+
+  late final _ledfx_render_runPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_pool_t>,
+            ffi.Pointer<ffi.Pointer<ledfx_render_t>>,
+            aubio.uint_t,
+          )
+        >
+      >('ledfx_render_run');
+  late final _ledfx_render_run = _ledfx_render_runPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_pool_t>,
+          ffi.Pointer<ffi.Pointer<ledfx_render_t>>,
+          int,
+        )
+      >();
+
+  /// get number of devices the frame is written onto
+  ///
+  /// \param r render task
+  int ledfx_render_get_n_targets(ffi.Pointer<ledfx_render_t> r) {
+    return _ledfx_render_get_n_targets(r);
+  }
+
+  late final _ledfx_render_get_n_targetsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_render_t>)>
+      >('ledfx_render_get_n_targets');
+  late final _ledfx_render_get_n_targets = _ledfx_render_get_n_targetsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_render_t>)>();
+
+  /// create a PCM sink
+  ///
+  /// \param hop_s number of samples per hop
+  /// \param samplerate sample rate of the pushed blocks, in Hz
+  /// \param max_hops number of hops that can wait for ledfx_pcm_pop()
+  ///
+  /// \return newly created object, or NULL on invalid parameters
+  ffi.Pointer<ledfx_pcm_t> new_ledfx_pcm(
+    int hop_s,
+    int samplerate,
+    int max_hops,
+  ) {
+    return _new_ledfx_pcm(hop_s, samplerate, max_hops);
+  }
+
+  late final _new_ledfx_pcmPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Pointer<ledfx_pcm_t> Function(
+            aubio.uint_t,
+            aubio.uint_t,
+            aubio.uint_t,
+          )
+        >
+      >('new_ledfx_pcm');
+  late final _new_ledfx_pcm = _new_ledfx_pcmPtr
+      .asFunction<ffi.Pointer<ledfx_pcm_t> Function(int, int, int)>();
+
+  /// delete a PCM sink
+  ///
+  /// \param p object to delete, as returned by new_ledfx_pcm()
+  void del_ledfx_pcm(ffi.Pointer<ledfx_pcm_t> p) {
+    return _del_ledfx_pcm(p);
+  }
+
+  late final _del_ledfx_pcmPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_pcm_t>)>>(
+        'del_ledfx_pcm',
+      );
+  late final _del_ledfx_pcm = _del_ledfx_pcmPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_pcm_t>)>();
+
+  /// push a block of captured samples
+  ///
+  /// \param p PCM sink
+  /// \param samples frames interleaved frames of channels samples each, or
+  /// NULL for frames of silence
+  /// \param frames number of frames
+  /// \param channels number of channels, 1 to ::LEDFX_PCM_MAX_CHANNELS
+  /// \param timestamp_us capture time of the first frame in microseconds, 0 if
+  /// unknown
+  ///
+  /// \return 0 on success, non-zero if channels is out of range
+  int ledfx_pcm_push(
+    ffi.Pointer<ledfx_pcm_t> p,
+    ffi.Pointer<ffi.Float> samples,
+    int frames,
+    int channels,
+    int timestamp_us,
+  ) {
+    return _ledfx_pcm_push(p, samples, frames, channels, timestamp_us);
+  }
+
+  late final _ledfx_pcm_pushPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_pcm_t>,
+            ffi.Pointer<ffi.Float>,
+            aubio.uint_t,
+            aubio.uint_t,
+            ffi.UnsignedLongLong,
+          )
+        >
+      >('ledfx_pcm_push');
+  late final _ledfx_pcm_push = _ledfx_pcm_pushPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_pcm_t>,
+          ffi.Pointer<ffi.Float>,
+          int,
+          int,
+          int,
+        )
+      >();
+
+  /// take the oldest hop
+  ///
+  /// \param p PCM sink
+  /// \param hop output, hop_s samples
+  /// \param timestamp_us if not NULL, set to the capture time of the first
+  /// sample of the hop, 0 if unknown
+  /// \param flags if not NULL, set to the ::LEDFX_PCM_SILENT and
+  /// ::LEDFX_PCM_DISCONTINUITY flags of the hop
+  ///
+  /// \return 1 if a hop was taken, 0 if none is waiting or hop has the wrong
+  /// length
+  int ledfx_pcm_pop(
+    ffi.Pointer<ledfx_pcm_t> p,
+    ffi.Pointer<aubio.fvec_t> hop,
+    ffi.Pointer<ffi.UnsignedLongLong> timestamp_us,
+    ffi.Pointer<aubio.uint_t> flags,
+  ) {
+    return _ledfx_pcm_pop(p, hop, timestamp_us, flags);
+  }
+
+  late final _ledfx_pcm_popPtr =
+      _lookup<
+        ffi.NativeFunction<
+          aubio.uint_t Function(
+            ffi.Pointer<ledfx_pcm_t>,
+            ffi.Pointer<aubio.fvec_t>,
+            ffi.Pointer<ffi.UnsignedLongLong>,
+            ffi.Pointer<aubio.uint_t>,
+          )
+        >
+      >('ledfx_pcm_pop');
+  late final _ledfx_pcm_pop = _ledfx_pcm_popPtr
+      .asFunction<
+        int Function(
+          ffi.Pointer<ledfx_pcm_t>,
+          ffi.Pointer<aubio.fvec_t>,
+          ffi.Pointer<ffi.UnsignedLongLong>,
+          ffi.Pointer<aubio.uint_t>,
+        )
+      >();
+
+  /// drop the waiting hops and the samples of the hop being filled, e.g.
+  /// when the capture restarts
+  ///
+  /// \param p PCM sink
+  void ledfx_pcm_reset(ffi.Pointer<ledfx_pcm_t> p) {
+    return _ledfx_pcm_reset(p);
+  }
+
+  late final _ledfx_pcm_resetPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Pointer<ledfx_pcm_t>)>>(
+        'ledfx_pcm_reset',
+      );
+  late final _ledfx_pcm_reset = _ledfx_pcm_resetPtr
+      .asFunction<void Function(ffi.Pointer<ledfx_pcm_t>)>();
+
+  /// get number of samples per hop
+  ///
+  /// \param p PCM sink
+  int ledfx_pcm_get_hop_size(ffi.Pointer<ledfx_pcm_t> p) {
+    return _ledfx_pcm_get_hop_size(p);
+  }
+
+  late final _ledfx_pcm_get_hop_sizePtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_pcm_t>)>
+      >('ledfx_pcm_get_hop_size');
+  late final _ledfx_pcm_get_hop_size = _ledfx_pcm_get_hop_sizePtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pcm_t>)>();
+
+  /// get number of hops waiting for ledfx_pcm_pop()
+  ///
+  /// \param p PCM sink
+  int ledfx_pcm_get_n_queued(ffi.Pointer<ledfx_pcm_t> p) {
+    return _ledfx_pcm_get_n_queued(p);
+  }
+
+  late final _ledfx_pcm_get_n_queuedPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_pcm_t>)>
+      >('ledfx_pcm_get_n_queued');
+  late final _ledfx_pcm_get_n_queued = _ledfx_pcm_get_n_queuedPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pcm_t>)>();
+
+  /// get number of hops completed since creation
+  ///
+  /// \param p PCM sink
+  int ledfx_pcm_get_n_hops(ffi.Pointer<ledfx_pcm_t> p) {
+    return _ledfx_pcm_get_n_hops(p);
+  }
+
+  late final _ledfx_pcm_get_n_hopsPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_pcm_t>)>
+      >('ledfx_pcm_get_n_hops');
+  late final _ledfx_pcm_get_n_hops = _ledfx_pcm_get_n_hopsPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pcm_t>)>();
+
+  /// get number of hops dropped because the queue was full, since creation
+  ///
+  /// \param p PCM sink
+  int ledfx_pcm_get_n_dropped(ffi.Pointer<ledfx_pcm_t> p) {
+    return _ledfx_pcm_get_n_dropped(p);
+  }
+
+  late final _ledfx_pcm_get_n_droppedPtr =
+      _lookup<
+        ffi.NativeFunction<aubio.uint_t Function(ffi.Pointer<ledfx_pcm_t>)>
+      >('ledfx_pcm_get_n_dropped');
+  late final _ledfx_pcm_get_n_dropped = _ledfx_pcm_get_n_droppedPtr
+      .asFunction<int Function(ffi.Pointer<ledfx_pcm_t>)>();
+}
+
+/// audio front-end object
+final class _ledfx_frontend_t extends ffi.Opaque {}
+
+/// audio front-end object
+typedef ledfx_frontend_t = _ledfx_frontend_t;
+
+/// sparse filterbank object
+final class _ledfx_filterbank_t extends ffi.Opaque {}
+
+/// sparse filterbank object
+typedef ledfx_filterbank_t = _ledfx_filterbank_t;
+
+/// melbank post-processing object
+final class _ledfx_melbank_t extends ffi.Opaque {}
+
+/// melbank post-processing object
+typedef ledfx_melbank_t = _ledfx_melbank_t;
+
+/// vector arena object
+final class _ledfx_arena_t extends ffi.Opaque {}
+
+/// vector arena object
+typedef ledfx_arena_t = _ledfx_arena_t;
+
+/// phase vocoder object
+final class _ledfx_pvoc_t extends ffi.Opaque {}
+
+/// phase vocoder object
+typedef ledfx_pvoc_t = _ledfx_pvoc_t;
+
+/// analysis object
+final class _ledfx_analysis_t extends ffi.Opaque {}
+
+/// analysis object
+typedef ledfx_analysis_t = _ledfx_analysis_t;
+
+/// gradient object
+final class _ledfx_gradient_t extends ffi.Opaque {}
+
+/// gradient object
+typedef ledfx_gradient_t = _ledfx_gradient_t;
+
+/// post-processing object
+final class _ledfx_postprocess_t extends ffi.Opaque {}
+
+/// post-processing object
+typedef ledfx_postprocess_t = _ledfx_postprocess_t;
+
+/// virtual to device mapping object
+final class _ledfx_mapping_t extends ffi.Opaque {}
+
+/// virtual to device mapping object
+typedef ledfx_mapping_t = _ledfx_mapping_t;
+
+/// UDP sender object
+final class _ledfx_udp_t extends ffi.Opaque {}
+
+/// UDP sender object
+typedef ledfx_udp_t = _ledfx_udp_t;
+
+/// DDP packetizer object
+final class _ledfx_ddp_t extends ffi.Opaque {}
+
+/// DDP packetizer object
+typedef ledfx_ddp_t = _ledfx_ddp_t;
+
+/// WLED realtime encoder object
+final class _ledfx_wled_t extends ffi.Opaque {}
+
+/// WLED realtime encoder object
+typedef ledfx_wled_t = _ledfx_wled_t;
+
+/// output scheduler object
+final class _ledfx_scheduler_t extends ffi.Opaque {}
+
+/// output scheduler object
+typedef ledfx_scheduler_t = _ledfx_scheduler_t;
+
+/// worker pool object
+final class _ledfx_pool_t extends ffi.Opaque {}
+
+/// worker pool object
+typedef ledfx_pool_t = _ledfx_pool_t;
+
+/// virtual render task object
+final class _ledfx_render_t extends ffi.Opaque {}
+
+/// virtual render task object
+typedef ledfx_render_t = _ledfx_render_t;
+
+/// PCM sink object
+final class _ledfx_pcm_t extends ffi.Opaque {}
+
+/// PCM sink object
+typedef ledfx_pcm_t = _ledfx_pcm_t;
+
+/// analysis of one hop
+final class ledfx_analysis_result_t extends ffi.Struct {
+  /// < 1 if an onset was detected in this hop
+  @aubio.uint_t()
+  external int onset;
+
+  /// < 1 if a beat falls in this hop
+  @aubio.uint_t()
+  external int beat;
+
+  /// < onset detection function
+  @aubio.smpl_t()
+  external double onset_value;
+
+  /// < tempo estimate, 0 until one is found
+  @aubio.smpl_t()
+  external double bpm;
+
+  /// < confidence of the tempo, between 0 and 1
+  @aubio.smpl_t()
+  external double tempo_confidence;
+
+  /// < pitch in Hz, 0 if unvoiced or silent
+  @aubio.smpl_t()
+  external double pitch;
+
+  /// < confidence of the pitch, between 0 and 1
+  @aubio.smpl_t()
+  external double pitch_confidence;
+
+  /// < level of the hop in dB SPL
+  @aubio.smpl_t()
+  external double db;
+}
+
+const int LEDFX_POOL_MAX_THREADS = 64;
+
+const int LEDFX_POOL_MAX_TASKS = 1024;
+
+const int LEDFX_PCM_MAX_CHANNELS = 32;
+
+const int LEDFX_PCM_SILENT = 1;
+
+const int LEDFX_PCM_DISCONTINUITY = 2;
@@ -0,0 +1,1232 @@
+import 'dart:ffi';
+import 'dart:io' show Platform;
+import 'dart:math' show ln2, log, max, min;
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+import 'package:ledfx/aubio.dart';
+import 'package:ledfx/aubio_bindings.dart';
+import 'package:ledfx/ledfx_bindings.dart';
+
+/// Access to the ledfx native processing layer.
+///
+/// The native objects are compiled into the aubio library, so this shares
+/// the library loaded by [Aubio].
+class Ledfx {
+  static LedfxBindings? _bindings;
+
+  static LedfxBindings get bindings {
+    return _bindings ??= LedfxBindings(Aubio.library);
+  }
+}
+
+/// Audio front-end running pre-emphasis, the volume gate and the phase
+/// vocoder in a single native call per hop.
+///
+/// [input], [filtered] and [norm] are views on native memory owned by this
+/// object; they stay valid until [dispose] is called.
+class LedfxFrontend {
+  final int windowSize;
+  final int hopSize;
+  final Pointer<ledfx_frontend_t> _frontend;
+
+  /// Samples for the next call to [process], written in place.
+  late final Float32List input;
+
+  /// Native vector behind [input], to run other analyses on the same hop.
+  late final Pointer<fvec_t> inputVector;
+
+  /// Pre-emphasised samples from the last hop that passed the volume gate.
+  late final Float32List filtered;
+
+  /// Spectrum of the last hop, the same pointer for the object's lifetime.
+  late final Pointer<cvec_t> spectrum;
+
+  /// Magnitudes of [spectrum], length `windowSize ~/ 2 + 1`.
+  late final Float32List norm;
+
+  LedfxFrontend._(this.windowSize, this.hopSize, this._frontend) {
+    final b = Ledfx.bindings;
+    inputVector = b.ledfx_frontend_get_input(_frontend);
+    final filteredVec = b.ledfx_frontend_get_filtered(_frontend);
+    input = inputVector.ref.data.asTypedList(hopSize);
+    filtered = filteredVec.ref.data.asTypedList(hopSize);
+    spectrum = b.ledfx_frontend_get_spectrum(_frontend);
+    norm = spectrum.ref.norm.asTypedList(spectrum.ref.length);
+  }
+
+  factory LedfxFrontend(int windowSize, int hopSize) {
+    final frontend = Ledfx.bindings.new_ledfx_frontend(windowSize, hopSize);
+    if (frontend == nullptr) {
+      throw StateError('Could not create audio front-end');
+    }
+    return LedfxFrontend._(windowSize, hopSize, frontend);
+  }
+
+  bool setBiquad(double b0, double b1, double b2, double a1, double a2) {
+    final b = Ledfx.bindings;
+    return b.ledfx_frontend_set_biquad(_frontend, b0, b1, b2, a1, a2) == 0;
+  }
+
+  set minVolume(double value) {
+    Ledfx.bindings.ledfx_frontend_set_min_volume(_frontend, value);
+  }
+
+  /// Processes [input]. Returns false when the volume gate zeroed the
+  /// spectrum.
+  bool process() => Ledfx.bindings.ledfx_frontend_do(_frontend) != 0;
+
+  /// Copies one hop into [input] and processes it.
+  bool processSamples(List<double> samples) {
+    input.setAll(0, samples);
+    return process();
+  }
+
+  double get db => Ledfx.bindings.ledfx_frontend_get_db(_frontend);
+
+  double volume({bool filtered = true}) {
+    final b = Ledfx.bindings;
+    return b.ledfx_frontend_get_volume(_frontend, filtered ? 1 : 0);
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_frontend(_frontend);
+  }
+}
+
+/// Onset, tempo and pitch analysis sharing one native phase vocoder per hop.
+///
+/// [result] is overwritten by every call to [process]; it lives in native
+/// memory owned by this object and stays valid until [dispose] is called.
+class LedfxAnalysis {
+  final int windowSize;
+  final int hopSize;
+  final Pointer<ledfx_analysis_t> _analysis;
+  final Pointer<ledfx_analysis_result_t> _result;
+
+  LedfxAnalysis._(this.windowSize, this.hopSize, this._analysis, this._result);
+
+  /// [onsetMethod] is one of "energy", "hfc", "complex" or "default".
+  factory LedfxAnalysis({
+    String onsetMethod = 'default',
+    required int windowSize,
+    required int hopSize,
+    required int sampleRate,
+  }) {
+    final methodPtr = onsetMethod.toNativeUtf8();
+    final analysis = Ledfx.bindings.new_ledfx_analysis(
+      methodPtr.cast<Char>(),
+      windowSize,
+      hopSize,
+      sampleRate,
+    );
+    calloc.free(methodPtr);
+    if (analysis == nullptr) {
+      throw StateError('Could not create $onsetMethod analysis');
+    }
+    return LedfxAnalysis._(
+      windowSize,
+      hopSize,
+      analysis,
+      calloc<ledfx_analysis_result_t>(),
+    );
+  }
+
+  /// Analysis of the last hop.
+  ledfx_analysis_result_t get result => _result.ref;
+
+  bool get onset => _result.ref.onset != 0;
+
+  bool get beat => _result.ref.beat != 0;
+
+  /// Pitch of the last hop in MIDI notes, 0 if unvoiced or silent.
+  double get pitchMidi {
+    final hz = _result.ref.pitch;
+    return hz > 0 ? 69 + 12 * log(hz / 440) / ln2 : 0;
+  }
+
+  set onsetThreshold(double value) {
+    Ledfx.bindings.ledfx_analysis_set_onset_threshold(_analysis, value);
+  }
+
+  set pitchTolerance(double value) {
+    Ledfx.bindings.ledfx_analysis_set_pitch_tolerance(_analysis, value);
+  }
+
+  /// Analyses one hop of [hopSize] samples, such as
+  /// [LedfxFrontend.inputVector].
+  void process(Pointer<fvec_t> input) {
+    Ledfx.bindings.ledfx_analysis_do(_analysis, input, _result);
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_analysis(_analysis);
+    calloc.free(_result);
+  }
+}
+
+/// Sparse triangular filterbank holding several filter sets ("banks") and
+/// evaluating all of them in one native call per spectrum.
+///
+/// The buffers returned by [output] are views on native memory owned by this
+/// object; they stay valid until [dispose] is called.
+class LedfxFilterbank {
+  final int windowSize;
+  final Pointer<ledfx_filterbank_t> _filterbank;
+  final List<Pointer<fvec_t>> _outputVectors = [];
+  final List<Float32List> _outputs = [];
+
+  LedfxFilterbank._(this.windowSize, this._filterbank);
+
+  factory LedfxFilterbank(int windowSize) {
+    final filterbank = Ledfx.bindings.new_ledfx_filterbank(windowSize);
+    if (filterbank == nullptr) {
+      throw StateError('Could not create filterbank');
+    }
+    return LedfxFilterbank._(windowSize, filterbank);
+  }
+
+  int get bankCount => _outputs.length;
+
+  /// Adds triangular bands between consecutive [freqs] edges (in Hz), the
+  /// same filters as `FilterbankExt.setTriangleBandsF32`. Returns the index
+  /// of the new bank, with `freqs.length - 2` filters.
+  int addTriangleBands({required List<double> freqs, required int sampleRate}) {
+    final edges = Aubio.bindings.new_fvec(freqs.length);
+    if (edges == nullptr) {
+      throw StateError('Could not allocate freq vector');
+    }
+    try {
+      edges.ref.data.asTypedList(freqs.length).setAll(0, freqs);
+      final bank = Ledfx.bindings.ledfx_filterbank_add_triangle_bands(
+        _filterbank,
+        edges,
+        sampleRate.toDouble(),
+      );
+      if (bank < 0) {
+        throw StateError('Could not set triangle bands');
+      }
+      _addOutput(bank);
+      return bank;
+    } finally {
+      Aubio.bindings.del_fvec(edges);
+    }
+  }
+
+  /// Adds a bank with the coefficients of an existing aubio filterbank.
+  int addFilterbank(Pointer<aubio_filterbank_t> filterbank) {
+    final bank = Ledfx.bindings.ledfx_filterbank_add_coeffs(
+      _filterbank,
+      Aubio.bindings.aubio_filterbank_get_coeffs(filterbank),
+    );
+    if (bank < 0) {
+      throw StateError('Could not add filterbank coefficients');
+    }
+    _addOutput(bank);
+    return bank;
+  }
+
+  void _addOutput(int bank) {
+    final b = Ledfx.bindings;
+    final n = b.ledfx_filterbank_get_n_filters(_filterbank, bank);
+    final vector = b.ledfx_filterbank_get_output(_filterbank, bank);
+    _outputVectors.add(vector);
+    _outputs.add(vector.ref.data.asTypedList(n));
+  }
+
+  /// Computes every bank for [spectrum]; read the results with [output].
+  void process(Pointer<cvec_t> spectrum) {
+    Ledfx.bindings.ledfx_filterbank_do(_filterbank, spectrum);
+  }
+
+  /// Computes a single bank for [spectrum] and returns its output.
+  Float32List processBank(int bank, Pointer<cvec_t> spectrum) {
+    final b = Ledfx.bindings;
+    b.ledfx_filterbank_do_bank(
+      _filterbank,
+      bank,
+      spectrum,
+      _outputVectors[bank],
+    );
+    return _outputs[bank];
+  }
+
+  /// Output of [bank] from the last [process] call.
+  Float32List output(int bank) => _outputs[bank];
+
+  /// Native vector behind [output], for passing to other native objects.
+  Pointer<fvec_t> outputVector(int bank) => _outputVectors[bank];
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_filterbank(_filterbank);
+    _outputVectors.clear();
+    _outputs.clear();
+  }
+}
+
+/// Post-processing of one melbank: power law, gain normalisation, smoothing
+/// and the difference filter, in a single native call per hop.
+///
+/// [raw] and [filtered] are views on native memory owned by this object;
+/// they stay valid until [dispose] is called.
+class LedfxMelbank {
+  final int bands;
+  final Pointer<ledfx_melbank_t> _melbank;
+  final Pointer<fvec_t> _raw;
+  final Pointer<fvec_t> _filtered;
+
+  /// Smoothed, gain normalised melbank of the last hop.
+  late final Float32List raw;
+
+  /// Smoothed difference of [raw] to its moving average.
+  late final Float32List filtered;
+
+  LedfxMelbank._(this.bands, this._melbank, this._raw, this._filtered) {
+    raw = _raw.ref.data.asTypedList(bands);
+    filtered = _filtered.ref.data.asTypedList(bands);
+  }
+
+  factory LedfxMelbank(int bands, double power) {
+    final melbank = Ledfx.bindings.new_ledfx_melbank(bands, power);
+    if (melbank == nullptr) {
+      throw StateError('Could not create melbank');
+    }
+    final raw = Aubio.bindings.new_fvec(bands);
+    final filtered = Aubio.bindings.new_fvec(bands);
+    if (raw == nullptr || filtered == nullptr) {
+      if (raw != nullptr) Aubio.bindings.del_fvec(raw);
+      if (filtered != nullptr) Aubio.bindings.del_fvec(filtered);
+      Ledfx.bindings.del_ledfx_melbank(melbank);
+      throw StateError('Could not allocate melbank buffers');
+    }
+    return LedfxMelbank._(bands, melbank, raw, filtered);
+  }
+
+  /// Processes one hop of filterbank output, e.g.
+  /// [LedfxFilterbank.outputVector], into [raw] and [filtered].
+  void process(Pointer<fvec_t> bands) {
+    Ledfx.bindings.ledfx_melbank_do(_melbank, bands, _raw, _filtered);
+  }
+
+  double get gain => Ledfx.bindings.ledfx_melbank_get_gain(_melbank);
+
+  void reset() => Ledfx.bindings.ledfx_melbank_reset(_melbank);
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_melbank(_melbank);
+    Aubio.bindings.del_fvec(_raw);
+    Aubio.bindings.del_fvec(_filtered);
+  }
+}
+
+/// Gradient colouring of an intensity strip: curve lookup, intensity and
+/// roll in a single native call per frame, see src/ledfx/gradient.h.
+///
+/// [intensity] and [rgb] are views on native memory owned by this object,
+/// sized by [setPixelCount]; they stay valid until the pixel count changes
+/// or [dispose] is called.
+class LedfxGradient {
+  /// Number of entries of the colour curve.
+  final int length;
+  final Pointer<ledfx_gradient_t> _gradient;
+  Pointer<fvec_t> _intensity = nullptr;
+  Pointer<fvec_t> _rgb = nullptr;
+
+  /// Intensity of each pixel for the next call to [process].
+  Float32List intensity = Float32List(0);
+
+  /// Output of the last [process] call, interleaved r, g, b per pixel.
+  Float32List rgb = Float32List(0);
+
+  LedfxGradient._(this.length, this._gradient);
+
+  factory LedfxGradient(int length) {
+    final gradient = Ledfx.bindings.new_ledfx_gradient(length);
+    if (gradient == nullptr) {
+      throw StateError('Could not create gradient of length $length');
+    }
+    return LedfxGradient._(length, gradient);
+  }
+
+  int get pixelCount => intensity.length;
+
+  /// Generates the colour curve from [colors], interleaved r, g, b, with a
+  /// stop at each of [positions] (0 to 1, ascending). Resets the roll.
+  void setColors(List<double> colors, List<double> positions) {
+    final n = positions.length;
+    if (n == 0 || colors.length != 3 * n) {
+      throw ArgumentError('Expected 3 color values per position');
+    }
+    final colorsPtr = calloc<Float>(3 * n);
+    final positionsPtr = calloc<Float>(n);
+    try {
+      colorsPtr.asTypedList(3 * n).setAll(0, colors);
+      positionsPtr.asTypedList(n).setAll(0, positions);
+      final b = Ledfx.bindings;
+      if (b.ledfx_gradient_set_colors(
+            _gradient,
+            colorsPtr,
+            positionsPtr,
+            n,
+          ) !=
+          0) {
+        throw StateError('Could not set gradient colors');
+      }
+    } finally {
+      calloc.free(colorsPtr);
+      calloc.free(positionsPtr);
+    }
+  }
+
+  /// Pixels the gradient moves per frame; the sign gives the direction.
+  set roll(double value) {
+    Ledfx.bindings.ledfx_gradient_set_roll(_gradient, value);
+  }
+
+  /// Sizes [intensity] and [rgb] for strips of [count] pixels. Does nothing
+  /// if the count is unchanged.
+  void setPixelCount(int count) {
+    if (count == pixelCount && _intensity != nullptr) return;
+    _freeBuffers();
+    final intensityVec = Aubio.bindings.new_fvec(count);
+    final rgbVec = Aubio.bindings.new_fvec(3 * count);
+    if (intensityVec == nullptr || rgbVec == nullptr) {
+      if (intensityVec != nullptr) Aubio.bindings.del_fvec(intensityVec);
+      if (rgbVec != nullptr) Aubio.bindings.del_fvec(rgbVec);
+      throw StateError('Could not allocate gradient buffers');
+    }
+    _intensity = intensityVec;
+    _rgb = rgbVec;
+    intensity = intensityVec.ref.data.asTypedList(count);
+    rgb = rgbVec.ref.data.asTypedList(3 * count);
+  }
+
+  /// Colours [intensity] into [rgb] and advances the roll.
+  Float32List process() {
+    if (_intensity == nullptr) {
+      throw StateError('Gradient pixel count not set');
+    }
+    Ledfx.bindings.ledfx_gradient_do(_gradient, _intensity, _rgb);
+    return rgb;
+  }
+
+  void _freeBuffers() {
+    if (_intensity != nullptr) Aubio.bindings.del_fvec(_intensity);
+    if (_rgb != nullptr) Aubio.bindings.del_fvec(_rgb);
+    _intensity = nullptr;
+    _rgb = nullptr;
+    intensity = Float32List(0);
+    rgb = Float32List(0);
+  }
+
+  void dispose() {
+    _freeBuffers();
+    Ledfx.bindings.del_ledfx_gradient(_gradient);
+  }
+}
+
+/// Flip, mirror, brightness and blur of an effect frame in a single native
+/// call, see src/ledfx/postprocess.h.
+///
+/// [frame] is a view on native memory owned by this object, interleaved
+/// r, g, b per pixel; it stays valid until [dispose] is called.
+class LedfxPostprocess {
+  final int pixelCount;
+  final Pointer<ledfx_postprocess_t> _postprocess;
+  final Pointer<fvec_t> _frame;
+  bool _flip = false;
+  bool _mirror = false;
+  double _brightness = 1.0;
+  double _blur = 0.0;
+
+  /// Frame processed in place by [process].
+  late final Float32List frame;
+
+  LedfxPostprocess._(this.pixelCount, this._postprocess, this._frame) {
+    frame = _frame.ref.data.asTypedList(3 * pixelCount);
+  }
+
+  factory LedfxPostprocess(int pixelCount) {
+    final postprocess = Ledfx.bindings.new_ledfx_postprocess(pixelCount);
+    if (postprocess == nullptr) {
+      throw StateError('Could not create post-processing of $pixelCount');
+    }
+    final frame = Aubio.bindings.new_fvec(3 * pixelCount);
+    if (frame == nullptr) {
+      Ledfx.bindings.del_ledfx_postprocess(postprocess);
+      throw StateError('Could not allocate post-processing frame');
+    }
+    return LedfxPostprocess._(pixelCount, postprocess, frame);
+  }
+
+  set flip(bool value) {
+    if (value == _flip) return;
+    _flip = value;
+    Ledfx.bindings.ledfx_postprocess_set_flip(_postprocess, value ? 1 : 0);
+  }
+
+  set mirror(bool value) {
+    if (value == _mirror) return;
+    _mirror = value;
+    Ledfx.bindings.ledfx_postprocess_set_mirror(_postprocess, value ? 1 : 0);
+  }
+
+  set brightness(double value) {
+    if (value == _brightness) return;
+    _brightness = value;
+    Ledfx.bindings.ledfx_postprocess_set_brightness(_postprocess, value);
+  }
+
+  /// Standard deviation of the Gaussian blur in pixels, 0 for none. The
+  /// kernel is only rebuilt when the value changes.
+  set blur(double value) {
+    if (value == _blur) return;
+    if (Ledfx.bindings.ledfx_postprocess_set_blur(_postprocess, value) != 0) {
+      throw ArgumentError.value(value, 'blur', 'must not be negative');
+    }
+    _blur = value;
+  }
+
+  /// Post-processes [frame] in place.
+  void process() {
+    Ledfx.bindings.ledfx_postprocess_do(_postprocess, _frame, _frame);
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_postprocess(_postprocess);
+    Aubio.bindings.del_fvec(_frame);
+  }
+}
+
+/// Pixels in native memory, interleaved r, g, b, for frames that native
+/// code reads or writes in place: the frame a virtual maps, the pixels of a
+/// device.
+///
+/// [data] stays valid until [dispose] is called.
+class LedfxPixels {
+  final int pixelCount;
+  final Pointer<fvec_t> pointer;
+
+  /// The pixels, zeroed on creation.
+  late final Float32List data;
+
+  LedfxPixels._(this.pixelCount, this.pointer) {
+    data = pointer.ref.data.asTypedList(3 * pixelCount);
+  }
+
+  factory LedfxPixels(int pixelCount) {
+    final pixels = Aubio.bindings.new_fvec(3 * pixelCount);
+    if (pixels == nullptr) {
+      throw StateError('Could not allocate $pixelCount pixels');
+    }
+    return LedfxPixels._(pixelCount, pixels);
+  }
+
+  void dispose() {
+    Aubio.bindings.del_fvec(pointer);
+  }
+}
+
+/// How the segments of a virtual share its pixels, see src/ledfx/mapping.h.
+enum LedfxMappingMode {
+  /// Segments split the virtual's pixels.
+  span(0),
+
+  /// Each segment shows the whole virtual.
+  copy(1);
+
+  const LedfxMappingMode(this.value);
+
+  final int value;
+}
+
+/// One segment of a virtual on a device: its first physical pixel in the
+/// virtual, its first and last device pixels, inclusive, and whether it
+/// runs backwards.
+typedef LedfxMappingSegment = (
+  int virtualStart,
+  int deviceStart,
+  int deviceEnd,
+  bool inverted,
+);
+
+/// Segments, grouping and center offset of a virtual on one device,
+/// compiled into gather tables once, see src/ledfx/mapping.h. [apply] then
+/// writes a frame onto the device in a single native call.
+class LedfxMapping {
+  /// Effective pixels of the frames passed to [apply].
+  final int inputPixels;
+
+  /// Pixels of the device.
+  final int outputPixels;
+  final Pointer<ledfx_mapping_t> _mapping;
+
+  LedfxMapping._(this.inputPixels, this.outputPixels, this._mapping);
+
+  factory LedfxMapping({
+    required LedfxMappingMode mode,
+    required int inputPixels,
+    required int virtualPixels,
+    required int outputPixels,
+    required List<LedfxMappingSegment> segments,
+    int groupSize = 1,
+    int centerOffset = 0,
+  }) {
+    final table = calloc<UnsignedInt>(max(1, 4 * segments.length));
+    for (int i = 0; i < segments.length; i++) {
+      final (virtualStart, deviceStart, deviceEnd, inverted) = segments[i];
+      table[4 * i] = virtualStart;
+      table[4 * i + 1] = deviceStart;
+      table[4 * i + 2] = deviceEnd;
+      table[4 * i + 3] = inverted ? 1 : 0;
+    }
+    final mapping = Ledfx.bindings.new_ledfx_mapping(
+      mode.value,
+      inputPixels,
+      virtualPixels,
+      outputPixels,
+      groupSize,
+      centerOffset,
+      table,
+      segments.length,
+    );
+    calloc.free(table);
+    if (mapping == nullptr) {
+      throw StateError('Could not map $segments onto $outputPixels pixels');
+    }
+    return LedfxMapping._(inputPixels, outputPixels, mapping);
+  }
+
+  /// Device pixels written by [apply].
+  int get mappedPixels => Ledfx.bindings.ledfx_mapping_get_n_mapped(_mapping);
+
+  /// Writes [input], [inputPixels] long, onto [output], [outputPixels] long.
+  void apply(LedfxPixels input, LedfxPixels output) {
+    final result = Ledfx.bindings.ledfx_mapping_do(
+      _mapping,
+      input.pointer,
+      output.pointer,
+    );
+    if (result != 0) {
+      throw ArgumentError(
+        'Expected $inputPixels and $outputPixels pixels, got '
+        '${input.pixelCount} and ${output.pixelCount}',
+      );
+    }
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_mapping(_mapping);
+  }
+}
+
+/// Connected UDP socket sending the packets of a frame in batches, see
+/// src/ledfx/udp.h. The destination is resolved once, on creation.
+class LedfxUdp {
+  final String host;
+  final int port;
+  final Pointer<ledfx_udp_t> _udp;
+
+  LedfxUdp._(this.host, this.port, this._udp);
+
+  factory LedfxUdp(String host, int port) {
+    final hostPtr = host.toNativeUtf8();
+    final udp = Ledfx.bindings.new_ledfx_udp(hostPtr.cast<Char>(), port);
+    calloc.free(hostPtr);
+    if (udp == nullptr) {
+      throw StateError('Could not open UDP socket to $host:$port');
+    }
+    return LedfxUdp._(host, port, udp);
+  }
+
+  Pointer<ledfx_udp_t> get pointer => _udp;
+
+  /// Packets queued by the kernel since creation.
+  int get sent => Ledfx.bindings.ledfx_udp_get_n_sent(_udp);
+
+  /// Packets that could not be sent since creation.
+  int get dropped => Ledfx.bindings.ledfx_udp_get_n_dropped(_udp);
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_udp(_udp);
+  }
+}
+
+/// DDP packetizer, see src/ledfx/ddp.h: encodes [rgb] into preallocated
+/// packets with their headers and sends them through a [LedfxUdp].
+///
+/// [rgb] is a view on native memory owned by this object, interleaved
+/// r, g, b per pixel; it stays valid until [dispose] is called.
+class LedfxDdp {
+  final int pixelCount;
+  final Pointer<ledfx_ddp_t> _ddp;
+  final Pointer<fvec_t> _rgb;
+
+  /// Frame encoded by [send], or by the scheduler once submitted, see
+  /// [LedfxScheduler.addDdp].
+  late final Float32List rgb;
+
+  LedfxDdp._(this.pixelCount, this._ddp, this._rgb) {
+    rgb = _rgb.ref.data.asTypedList(3 * pixelCount);
+  }
+
+  factory LedfxDdp(int pixelCount) {
+    final ddp = Ledfx.bindings.new_ledfx_ddp(pixelCount);
+    if (ddp == nullptr) {
+      throw StateError('Could not create DDP packetizer of $pixelCount');
+    }
+    final rgb = Aubio.bindings.new_fvec(3 * pixelCount);
+    if (rgb == nullptr) {
+      Ledfx.bindings.del_ledfx_ddp(ddp);
+      throw StateError('Could not allocate DDP frame');
+    }
+    return LedfxDdp._(pixelCount, ddp, rgb);
+  }
+
+  int get packetCount => Ledfx.bindings.ledfx_ddp_get_n_packets(_ddp);
+
+  /// Encodes [rgb] with the next sequence number and sends its packets
+  /// through [udp]. Returns the number of packets queued.
+  int send(LedfxUdp udp) {
+    Ledfx.bindings.ledfx_ddp_do(_ddp, _rgb);
+    return Ledfx.bindings.ledfx_ddp_send(_ddp, udp.pointer);
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_ddp(_ddp);
+    Aubio.bindings.del_fvec(_rgb);
+  }
+}
+
+/// WLED realtime UDP protocols, valued as their first packet byte, see
+/// src/ledfx/wled.h.
+enum LedfxWledProtocol {
+  /// Index and r, g, b per LED, up to [maxPixels] LEDs.
+  warls(1, 255),
+
+  /// r, g, b per LED in a single packet, up to [maxPixels] LEDs.
+  drgb(2, 490),
+
+  /// r, g, b per LED from a start index, 489 LEDs per packet.
+  dnrgb(4, 65535);
+
+  const LedfxWledProtocol(this.value, this.maxPixels);
+
+  final int value;
+
+  /// Largest strip the protocol can address.
+  final int maxPixels;
+}
+
+/// WLED realtime encoder, see src/ledfx/wled.h: clamps [rgb] to bytes
+/// straight into preallocated packets behind their headers, splitting DNRGB
+/// frames every 489 LEDs, and sends them through a [LedfxUdp].
+///
+/// [rgb] is a view on native memory owned by this object, interleaved
+/// r, g, b per pixel; it stays valid until [dispose] is called.
+class LedfxWled {
+  final LedfxWledProtocol protocol;
+  final int pixelCount;
+  final Pointer<ledfx_wled_t> _wled;
+  final Pointer<fvec_t> _rgb;
+
+  /// Frame encoded by [encode], or by the scheduler once submitted, see
+  /// [LedfxScheduler.addWled].
+  late final Float32List rgb;
+
+  LedfxWled._(this.protocol, this.pixelCount, this._wled, this._rgb) {
+    rgb = _rgb.ref.data.asTypedList(3 * pixelCount);
+  }
+
+  factory LedfxWled(LedfxWledProtocol protocol, int pixelCount) {
+    final wled = Ledfx.bindings.new_ledfx_wled(protocol.value, pixelCount);
+    if (wled == nullptr) {
+      throw StateError(
+        'Could not create ${protocol.name} encoder of $pixelCount',
+      );
+    }
+    final rgb = Aubio.bindings.new_fvec(3 * pixelCount);
+    if (rgb == nullptr) {
+      Ledfx.bindings.del_ledfx_wled(wled);
+      throw StateError('Could not allocate WLED frame');
+    }
+    return LedfxWled._(protocol, pixelCount, wled, rgb);
+  }
+
+  int get packetCount => Ledfx.bindings.ledfx_wled_get_n_packets(_wled);
+
+  /// Seconds WLED waits for the next packet before going back to its own
+  /// effects, 1 to 255; 255 keeps it in realtime mode.
+  int get timeout => Ledfx.bindings.ledfx_wled_get_timeout(_wled);
+
+  set timeout(int value) {
+    if (Ledfx.bindings.ledfx_wled_set_timeout(_wled, value) != 0) {
+      throw RangeError.range(value, 1, 255, 'timeout');
+    }
+  }
+
+  /// Encodes [rgb] into the packets sent by [send].
+  void encode() {
+    Ledfx.bindings.ledfx_wled_do(_wled, _rgb);
+  }
+
+  /// Sends the packets of the last [encode] through [udp]. Returns the
+  /// number of packets queued.
+  int send(LedfxUdp udp) {
+    return Ledfx.bindings.ledfx_wled_send(_wled, udp.pointer);
+  }
+
+  /// Sends only the packets of the last [encode] whose bytes differ from
+  /// when they were last sent, or all of them if [all] is set. Returns the
+  /// number of packets queued, 0 for an unchanged frame.
+  int sendChanged(LedfxUdp udp, {bool all = false}) {
+    return Ledfx.bindings.ledfx_wled_send_changed(
+      _wled,
+      udp.pointer,
+      all ? 1 : 0,
+    );
+  }
+
+  /// Packets left out by [sendChanged] as unchanged since creation.
+  int get skippedPackets =>
+      Ledfx.bindings.ledfx_wled_get_n_skipped_packets(_wled);
+
+  /// Bytes of those packets, headers included.
+  int get skippedBytes => Ledfx.bindings.ledfx_wled_get_n_skipped_bytes(_wled);
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_wled(_wled);
+    Aubio.bindings.del_fvec(_rgb);
+  }
+}
+
+/// Native thread sending the frames of every device at the device's own
+/// refresh rate, see src/ledfx/scheduler.h. It sleeps on an absolute
+/// monotonic clock until the earliest deadline, so the rates do not drift
+/// with the wakeup latency, and measures each output's jitter and missed
+/// deadlines.
+class LedfxScheduler {
+  final Pointer<ledfx_scheduler_t> _scheduler;
+
+  LedfxScheduler._(this._scheduler);
+
+  factory LedfxScheduler() {
+    final scheduler = Ledfx.bindings.new_ledfx_scheduler();
+    if (scheduler == nullptr) {
+      throw StateError('Could not start output scheduler');
+    }
+    return LedfxScheduler._(scheduler);
+  }
+
+  static LedfxScheduler? _shared;
+
+  /// Scheduler of all the devices, started on first use.
+  static LedfxScheduler get shared => _shared ??= LedfxScheduler();
+
+  /// Paces [ddp] at [rate] frames per second through [udp]. Both belong to
+  /// the scheduler thread until [LedfxOutput.remove]: only [LedfxDdp.rgb]
+  /// may be written meanwhile.
+  LedfxOutput addDdp(LedfxDdp ddp, LedfxUdp udp, int rate) {
+    final index = Ledfx.bindings.ledfx_scheduler_add_ddp(
+      _scheduler,
+      ddp._ddp,
+      udp.pointer,
+      rate.toDouble(),
+    );
+    if (index < 0) {
+      throw StateError('Could not schedule DDP output at $rate fps');
+    }
+    return LedfxOutput._(this, index, ddp._rgb);
+  }
+
+  /// Paces [wled] at [rate] frames per second through [udp], sending only
+  /// the packets that changed except for a whole frame every [keepalive]
+  /// seconds; 0 always sends the whole frame. Both belong to the scheduler
+  /// thread until [LedfxOutput.remove]: only [LedfxWled.rgb] may be written
+  /// meanwhile.
+  LedfxOutput addWled(
+    LedfxWled wled,
+    LedfxUdp udp,
+    int rate, {
+    double keepalive = 0,
+  }) {
+    final index = Ledfx.bindings.ledfx_scheduler_add_wled(
+      _scheduler,
+      wled._wled,
+      udp.pointer,
+      rate.toDouble(),
+      keepalive,
+    );
+    if (index < 0) {
+      throw StateError('Could not schedule WLED output at $rate fps');
+    }
+    return LedfxOutput._(this, index, wled._rgb);
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_scheduler(_scheduler);
+    if (identical(this, _shared)) _shared = null;
+  }
+}
+
+/// One device paced by a [LedfxScheduler].
+class LedfxOutput {
+  final LedfxScheduler scheduler;
+  final int _index;
+  final Pointer<fvec_t> _rgb;
+
+  LedfxOutput._(this.scheduler, this._index, this._rgb);
+
+  /// Hands the encoder's frame to the scheduler, which sends it at the next
+  /// deadline unless a newer frame is submitted before.
+  void submit() {
+    Ledfx.bindings.ledfx_scheduler_submit(scheduler._scheduler, _index, _rgb);
+  }
+
+  /// Deadlines reached.
+  int get ticks =>
+      Ledfx.bindings.ledfx_scheduler_get_n_ticks(scheduler._scheduler, _index);
+
+  /// Frames sent.
+  int get frames => Ledfx.bindings.ledfx_scheduler_get_n_frames(
+    scheduler._scheduler,
+    _index,
+  );
+
+  /// Deadlines missed as the scheduler thread woke too late.
+  int get missed => Ledfx.bindings.ledfx_scheduler_get_n_missed(
+    scheduler._scheduler,
+    _index,
+  );
+
+  /// Mean lateness of the deadlines, in milliseconds.
+  double get jitterMeanMs => Ledfx.bindings
+      .ledfx_scheduler_get_jitter_mean_ms(scheduler._scheduler, _index);
+
+  /// Largest lateness of the deadlines, in milliseconds.
+  double get jitterMaxMs => Ledfx.bindings.ledfx_scheduler_get_jitter_max_ms(
+    scheduler._scheduler,
+    _index,
+  );
+
+  /// WLED packets left out as unchanged, read safely while the scheduler
+  /// thread sends; 0 for DDP.
+  int get skippedPackets => Ledfx.bindings
+      .ledfx_scheduler_get_n_skipped_packets(scheduler._scheduler, _index);
+
+  /// Bytes of those packets, headers included.
+  int get skippedBytes => Ledfx.bindings.ledfx_scheduler_get_n_skipped_bytes(
+    scheduler._scheduler,
+    _index,
+  );
+
+  /// Stops pacing the device. Once this returns, its encoder and sender
+  /// can be used or disposed again.
+  void remove() {
+    Ledfx.bindings.ledfx_scheduler_remove(scheduler._scheduler, _index);
+  }
+}
+
+/// What is left to do natively once an effect has drawn a frame: post-process
+/// it, clamp it to 0..255 and write it onto each device of the virtual, see
+/// src/ledfx/render.h. [LedfxPool.run] runs those of many virtuals at once.
+class LedfxRender {
+  final Pointer<ledfx_render_t> _render;
+
+  LedfxRender._(this._render);
+
+  factory LedfxRender() {
+    final render = Ledfx.bindings.new_ledfx_render();
+    if (render == nullptr) {
+      throw StateError('Could not create render task');
+    }
+    return LedfxRender._(render);
+  }
+
+  /// Renders the [LedfxPostprocess.frame] of [post] next, processed in
+  /// place, onto no device until [addTarget].
+  void setFrame(LedfxPostprocess post) {
+    Ledfx.bindings.ledfx_render_set_frame(
+      _render,
+      post._postprocess,
+      post._frame,
+    );
+  }
+
+  /// Writes the frame onto [output] through [mapping] as well.
+  void addTarget(LedfxMapping mapping, LedfxPixels output) {
+    final result = Ledfx.bindings.ledfx_render_add_target(
+      _render,
+      mapping._mapping,
+      output.pointer,
+    );
+    if (result != 0) {
+      throw ArgumentError(
+        'Mapping of ${mapping.inputPixels} onto ${mapping.outputPixels} '
+        'pixels does not fit ${output.pixelCount} device pixels',
+      );
+    }
+  }
+
+  /// Devices the frame is written onto.
+  int get targets => Ledfx.bindings.ledfx_render_get_n_targets(_render);
+
+  /// Renders on the calling thread.
+  void run() {
+    if (Ledfx.bindings.ledfx_render_do(_render) != 0) {
+      throw StateError('Render task has no frame');
+    }
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_render(_render);
+  }
+}
+
+/// Fixed pool of native worker threads, see src/ledfx/pool.h. [run] hands
+/// it the render tasks of every virtual due at a tick, spreads them over
+/// the threads with work stealing and returns once all are done.
+class LedfxPool {
+  final Pointer<ledfx_pool_t> _pool;
+  Pointer<Pointer<ledfx_render_t>> _renders = nullptr;
+  int _capacity = 0;
+
+  LedfxPool._(this._pool);
+
+  /// Starts [threads] workers; the thread calling [run] works too.
+  factory LedfxPool(int threads) {
+    final pool = Ledfx.bindings.new_ledfx_pool(threads);
+    if (pool == nullptr) {
+      throw StateError('Could not start a pool of $threads threads');
+    }
+    return LedfxPool._(pool);
+  }
+
+  static LedfxPool? _shared;
+
+  /// Pool of all the virtuals, started on first use with one worker per
+  /// processor besides the calling thread.
+  static LedfxPool get shared => _shared ??= LedfxPool(
+    min(Platform.numberOfProcessors - 1, LEDFX_POOL_MAX_THREADS),
+  );
+
+  /// Worker threads.
+  int get threads => Ledfx.bindings.ledfx_pool_get_n_threads(_pool);
+
+  /// Tasks run by another thread than the one dealt them.
+  int get stolen => Ledfx.bindings.ledfx_pool_get_n_stolen(_pool);
+
+  /// Runs [renders] in parallel and returns once all are done. Renders
+  /// writing onto a same device are run one after the other, in order.
+  void run(List<LedfxRender> renders) {
+    if (renders.isEmpty) return;
+    if (renders.length > _capacity) {
+      if (_renders != nullptr) calloc.free(_renders);
+      _capacity = max(renders.length, 2 * _capacity);
+      _renders = calloc<Pointer<ledfx_render_t>>(_capacity);
+    }
+    for (int i = 0; i < renders.length; i++) {
+      _renders[i] = renders[i]._render;
+    }
+    final result = Ledfx.bindings.ledfx_render_run(
+      _pool,
+      _renders,
+      renders.length,
+    );
+    if (result != 0) {
+      throw StateError(
+        'Could not run ${renders.length} render tasks, at most '
+        '$LEDFX_POOL_MAX_TASKS with a frame each',
+      );
+    }
+  }
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_pool(_pool);
+    if (_renders != nullptr) calloc.free(_renders);
+    _renders = nullptr;
+    _capacity = 0;
+    if (identical(this, _shared)) _shared = null;
+  }
+}
+
+/// Native sink for captured audio, see src/ledfx/pcm.h. Any capture
+/// producer pushes interleaved float blocks of any size and channel count;
+/// the sink averages them down to mono and cuts them into hops of
+/// [hopSize] samples, each dated with the capture time of its first sample,
+/// for [popInto] to hand to the analysis.
+///
+/// Producers on another thread, in the same process, call
+/// `ledfx_pcm_push` from the native library on [address].
+class LedfxPcm {
+  final int hopSize;
+  final Pointer<ledfx_pcm_t> _pcm;
+  final Pointer<UnsignedLongLong> _timestamp = calloc<UnsignedLongLong>();
+  final Pointer<UnsignedInt> _flags = calloc<UnsignedInt>();
+  Pointer<Float> _block = nullptr;
+  int _capacity = 0;
+
+  LedfxPcm._(this.hopSize, this._pcm);
+
+  /// Queues up to [maxHops] hops of [hopSize] samples captured at
+  /// [sampleRate] Hz, dropping the oldest when full.
+  factory LedfxPcm(int hopSize, int sampleRate, {int maxHops = 16}) {
+    final pcm = Ledfx.bindings.new_ledfx_pcm(hopSize, sampleRate, maxHops);
+    if (pcm == nullptr) {
+      throw ArgumentError(
+        'Could not create PCM sink of $maxHops hops of $hopSize samples at '
+        '$sampleRate Hz',
+      );
+    }
+    return LedfxPcm._(hopSize, pcm);
+  }
+
+  /// Native handle, for producers pushing from native code.
+  int get address => _pcm.address;
+
+  /// Capture time of the last hop taken, in microseconds, 0 if unknown.
+  int get timestampUs => _timestamp.value;
+
+  /// Whether the last hop taken was pushed as silence.
+  bool get silent => _flags.value & LEDFX_PCM_SILENT != 0;
+
+  /// Whether hops were dropped before the last hop taken.
+  bool get discontinuity => _flags.value & LEDFX_PCM_DISCONTINUITY != 0;
+
+  /// Hops waiting for [popInto].
+  int get queued => Ledfx.bindings.ledfx_pcm_get_n_queued(_pcm);
+
+  /// Hops dropped because the queue was full.
+  int get dropped => Ledfx.bindings.ledfx_pcm_get_n_dropped(_pcm);
+
+  /// Pushes [samples], interleaved frames of [channels] samples, captured
+  /// at [timestampUs]; 0 if unknown.
+  void push(Float32List samples, int channels, {int timestampUs = 0}) {
+    if (samples.length > _capacity) {
+      if (_block != nullptr) calloc.free(_block);
+      _capacity = max(samples.length, 2 * _capacity);
+      _block = calloc<Float>(_capacity);
+    }
+    _block.asTypedList(samples.length).setAll(0, samples);
+    final result = Ledfx.bindings.ledfx_pcm_push(
+      _pcm,
+      _block,
+      samples.length ~/ channels,
+      channels,
+      timestampUs,
+    );
+    if (result != 0) {
+      throw ArgumentError(
+        'Got $channels channels, expected 1 to $LEDFX_PCM_MAX_CHANNELS',
+      );
+    }
+  }
+
+  /// Moves the oldest hop into the [LedfxFrontend.input] of [frontend], of
+  /// [hopSize] samples. Returns false when no hop is waiting.
+  bool popInto(LedfxFrontend frontend) =>
+      Ledfx.bindings.ledfx_pcm_pop(
+        _pcm,
+        frontend.inputVector,
+        _timestamp,
+        _flags,
+      ) !=
+      0;
+
+  /// Drops the waiting hops and the partial one, e.g. on a device change.
+  void reset() => Ledfx.bindings.ledfx_pcm_reset(_pcm);
+
+  void dispose() {
+    Ledfx.bindings.del_ledfx_pcm(_pcm);
+    calloc.free(_timestamp);
+    calloc.free(_flags);
+    if (_block != nullptr) calloc.free(_block);
+    _block = nullptr;
+    _capacity = 0;
+  }
+}
+
+/// A native vector allocated from a [LedfxArena].
+///
+/// [data] is a view on the native storage: writes are seen by native code
+/// reading [pointer] and vice versa, without copies. Both stay valid until
+/// the arena is disposed and must not be used afterwards.
+class LedfxVector {
+  final Pointer<fvec_t> pointer;
+  final Float32List data;
+
+  LedfxVector._(this.pointer)
+    : data = pointer.ref.data.asTypedList(pointer.ref.length);
+
+  int get length => data.length;
+}
+
+/// A native spectrum allocated from a [LedfxArena], with views on its
+/// magnitudes and phases. See [LedfxVector] for the lifetime rules.
+class LedfxSpectrum {
+  final Pointer<cvec_t> pointer;
+  final Float32List norm;
+  final Float32List phas;
+
+  LedfxSpectrum._(this.pointer)
+    : norm = pointer.ref.norm.asTypedList(pointer.ref.length),
+      phas = pointer.ref.phas.asTypedList(pointer.ref.length);
+
+  int get length => norm.length;
+}
+
+/// Arena of long-lived native vectors shared with Dart as typed-data views,
+/// see src/ledfx/arena.h.
+///
+/// Allocate the buffers of a pipeline when it is set up and read or write
+/// them in place every hop. The arena owns every vector it hands out: never
+/// pass them to `del_fvec`/`del_cvec`, and drop all [LedfxVector] and
+/// [LedfxSpectrum] references before calling [dispose], which frees them
+/// all at once.
+class LedfxArena {
+  final Pointer<ledfx_arena_t> _arena;
+  bool _disposed = false;
+
+  LedfxArena._(this._arena);
+
+  factory LedfxArena({int blockSize = 0}) {
+    final arena = Ledfx.bindings.new_ledfx_arena(blockSize);
+    if (arena == nullptr) {
+      throw StateError('Could not create vector arena');
+    }
+    return LedfxArena._(arena);
+  }
+
+  /// Allocates a zeroed vector of [length] samples.
+  LedfxVector vector(int length) {
+    _checkAlive();
+    final vector = Ledfx.bindings.ledfx_arena_new_fvec(_arena, length);
+    if (vector == nullptr) {
+      throw StateError('Could not allocate vector of length $length');
+    }
+    return LedfxVector._(vector);
+  }
+
+  /// Allocates a zeroed spectrum for a window of [windowSize] samples.
+  LedfxSpectrum spectrum(int windowSize) {
+    _checkAlive();
+    final spectrum = Ledfx.bindings.ledfx_arena_new_cvec(_arena, windowSize);
+    if (spectrum == nullptr) {
+      throw StateError('Could not allocate spectrum of size $windowSize');
+    }
+    return LedfxSpectrum._(spectrum);
+  }
+
+  /// Bytes handed out so far.
+  int get size => Ledfx.bindings.ledfx_arena_get_size(_arena);
+
+  void _checkAlive() {
+    if (_disposed) throw StateError('Vector arena used after dispose');
+  }
+
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    Ledfx.bindings.del_ledfx_arena(_arena);
+  }
+}
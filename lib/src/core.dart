@@ -1,11 +1,13 @@
+import 'dart:typed_data';
+
 import 'package:flutter/foundation.dart';
 import 'package:ledfx/src/devices/device.dart';
 import 'package:ledfx/src/effects/audio.dart';
 import 'package:ledfx/src/effects/effect.dart';
 import 'package:ledfx/src/effects/melbank.dart';
 import 'package:ledfx/src/events.dart';
+import 'package:ledfx/src/pixel_frame.dart';
 import 'package:ledfx/src/virtual.dart';
-import 'package:n_dimensional_array/domain/models/nd_array.dart';
 
 enum Transmission { base64Compressed, uncompressed }
 
@@ -68,43 +70,37 @@ class LEDFx {
       //TODO: implement virtuals
       final rows = 1;
 
-      List<Float64List> pixels = isDevice
+      final PixelFrame frame = isDevice
           ? (event as DeviceUpdateEvent).pixels
           : (event as VirtualUpdateEvent).pixels;
-      final pixelsLen = pixels.length;
+      final pixelsLen = frame.length;
       List<int> shape = [rows, (pixelsLen / rows).toInt()];
+      List<Float32List> pixels = [];
 
       if (pixelsLen > maxLen) {}
 
       if (config.transmissionMode == Transmission.base64Compressed) {
       } else {
-        if (pixels.isEmpty || pixels[0].isEmpty) {
+        if (frame.isEmpty) {
           return;
         }
 
-        final List<int> pixelsShape = NdArray.fromList(pixels).shape;
-
-        List<List<double>> transposedAndCasted = List.generate(
-          pixelsShape[1],
-          (j) => List<double>.filled(pixelsShape[0], 0),
-        );
-
-        for (int i = 0; i < pixelsShape[0]; i++) {
-          for (int j = 0; j < pixelsShape[1]; j++) {
-            // Get the value, ensure it's clamped and converted to 0-255 integer (uint8)
-            double val = pixels[i][j];
-
-            // Clamp values between 0 and 255 and cast to int
-            // int uint8Value = val.clamp(0.0, 255.0).round().toInt();
-            double uint8Value = val.clamp(0.0, 255.0);
-
-            // Place into the transposed position
-            transposedAndCasted[j][i] = uint8Value;
+        // Transpose to one row per channel, clamped to 0-255, in a single
+        // buffer.
+        final planes = Float32List(3 * pixelsLen);
+        final data = frame.data;
+        for (int i = 0; i < pixelsLen; i++) {
+          for (int j = 0; j < 3; j++) {
+            planes[j * pixelsLen + i] = data[3 * i + j].clamp(0.0, 255.0);
           }
         }
         pixels = List.generate(
-          transposedAndCasted.length,
-          (i) => Float64List.fromList(transposedAndCasted[i]),
+          3,
+          (j) => Float32List.sublistView(
+            planes,
+            j * pixelsLen,
+            (j + 1) * pixelsLen,
+          ),
         );
       }
 
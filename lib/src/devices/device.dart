@@ -1,12 +1,14 @@
 import 'dart:math';
 
 import 'package:flutter/foundation.dart';
+import 'package:ledfx/ledfx_native.dart';
 import 'package:ledfx/src/core.dart';
 import 'package:ledfx/src/devices/dummy.dart';
 import 'package:ledfx/src/devices/utils.dart';
 import 'package:ledfx/src/devices/wled.dart';
-import 'package:ledfx/src/effects/utils.dart';
 import 'package:ledfx/src/events.dart';
+import 'package:ledfx/src/pixel_frame.dart';
+import 'package:ledfx/src/platform/pipeline_stats.dart';
 import 'package:ledfx/src/virtual.dart';
 import 'package:ledfx/utils.dart';
 import 'package:nanoid/nanoid.dart';
@@ -248,7 +250,10 @@ abstract class Device {
   bool _online = true;
   bool get isOnline => _online;
 
-  List<Float64List>? _pixels;
+  // Pixels as sent, already rotated by centerOffset: virtuals write into
+  // them natively through their LedfxMapping. _pixels is a view on _output.
+  LedfxPixels? _output;
+  PixelFrame? _pixels;
 
   List<Virtual>? _cachedVirtualsObjs;
   List<Virtual> get _virtualObjs => () {
@@ -274,7 +279,9 @@ abstract class Device {
   List<SegmentConfig> _segments = [];
 
   void activate() {
-    _pixels = List.filled(pixelCount, Float64List(3));
+    _output?.dispose();
+    final output = _output = LedfxPixels(pixelCount);
+    _pixels = PixelFrame.view(output.data);
     _active = true;
   }
 
@@ -284,6 +291,8 @@ abstract class Device {
 
   void deactivate() {
     _pixels = null;
+    _output?.dispose();
+    _output = null;
     _active = false;
   }
 
@@ -301,7 +310,7 @@ abstract class Device {
 
   ///Flushes the provided data to the device. This abstract method must be
   ///overwritten by the device implementation.
-  void flush(List<Float64List> data) {
+  void flush(PixelFrame data) {
     return;
   }
 
@@ -351,54 +360,55 @@ abstract class Device {
     return;
   }
 
+  /// Writes [pixels], the frame of the virtual [virtualID], onto this
+  /// device through [mapping], then flushes if that virtual drives the
+  /// device.
   void updatePixels(
     String virtualID,
-    List<(List<Float64List>, int, int)> data,
+    LedfxMapping mapping,
+    LedfxPixels pixels,
   ) {
-    if (_active == false) {
-      debugPrint("Can't update inactive device: $name");
-      return;
-    }
-
-    for (final (pixels, start, end) in data) {
-      if (pixels.isNotEmpty && _pixels != null && _pixels!.isNotEmpty) {
-        if (pixels[0].length == 3 ||
-            ((pixels.length < end && _pixels!.length < end) &&
-                pixels[start].length == _pixels![start].length)) {
-          for (int i = start; i < end + 1; i++) {
-            _pixels![i] = pixels[i];
-          }
-        }
-      }
-
-      // final ndArr = NdArray.fromList(pixels);
-      // if (ndArr.shape.isNotEmpty && ndArr.shape[0] != 0) {
+    final output = targetFor(virtualID, mapping);
+    if (output == null) return;
+    mapping.apply(pixels, output);
+    flushPixels(virtualID);
+  }
 
-      //   if (ndArr.shape.first == 3 ||
-      //       (_pixels != null &&
-      //           NdArray.fromList(_pixels!).shape == ndArr.shape)) {
-      //     _pixels = pixels;
-      //   }
-      // }
+  /// The pixels the virtual [virtualID] writes onto through [mapping], or
+  /// null if the device is inactive or [mapping] does not fit it.
+  LedfxPixels? targetFor(String virtualID, LedfxMapping mapping) {
+    final output = _output;
+    if (_active == false || output == null) {
+      debugPrint("Can't update inactive device: $name");
+      return null;
     }
-
-    if (priorityVirtual != null) {
-      if (virtualID == priorityVirtual!.id) {
-        final frame = assembleFrame();
-        if (frame == null) return;
-        flush(frame);
-        ledfx.events.fireEvent(DeviceUpdateEvent(id, frame));
-      }
+    if (mapping.outputPixels != output.pixelCount) {
+      debugPrint("Mapping of $virtualID does not fit device: $name");
+      return null;
     }
+    return output;
   }
 
-  List<Float64List>? assembleFrame() {
-    if (_pixels == null) return null;
-    List<Float64List> frame = _pixels!;
-    if (centerOffset > 0) frame = rollList(frame, centerOffset);
-    return frame;
+  /// Flushes the pixels written so far if the virtual [virtualID] drives
+  /// the device. Devices paced by the native scheduler only submit the frame
+  /// here, so the [PipelineStage.submitted] age recorded does not include
+  /// the wait for the next deadline or the network send.
+  void flushPixels(String virtualID) {
+    if (priorityVirtual == null || virtualID != priorityVirtual!.id) return;
+    final frame = assembleFrame();
+    if (frame == null) return;
+    flush(frame);
+    PipelineProbe.record(
+      PipelineStage.submitted,
+      ledfx.audio?.lastCaptureUs ?? 0,
+    );
+    ledfx.events.fireEvent(DeviceUpdateEvent(id, frame));
   }
 
+  /// The pixels to send. Virtuals write them already rotated by
+  /// [centerOffset], so no copy is needed.
+  PixelFrame? assembleFrame() => _pixels;
+
   // Returns the first virtual that has the highest refresh rate of all virtuals
   // associated with this device
   Virtual? _cachedPriorityVirtual;
@@ -459,10 +469,7 @@ abstract class Device {
         newSegments.add(segment);
       } else {
         if (_pixels != null && ledfx.config.flushOnDeactivate) {
-          for (int i = segment.start; i <= segment.end; i++) {
-            final Float64List zeroRow = Float64List(3);
-            _pixels![i] = zeroRow;
-          }
+          _clearRotated(segment.start, segment.end + 1);
         }
       }
     }
@@ -472,6 +479,22 @@ abstract class Device {
     }
   }
 
+  // Clears device pixels [start] to [end] (exclusive), as placed in
+  // _pixels after the rotation by centerOffset.
+  void _clearRotated(int start, int end) {
+    final pixels = _pixels!;
+    final int n = pixels.length;
+    if (n == 0 || start >= end) return;
+    final int shift = centerOffset > 0 ? centerOffset % n : 0;
+    final int from = (start + shift) % n, count = min(end - start, n);
+    if (from + count <= n) {
+      pixels.clear(from, from + count);
+    } else {
+      pixels.clear(from, n);
+      pixels.clear(0, from + count - n);
+    }
+  }
+
   void clearSegments() {
     _segments = [];
     invalidateCache();
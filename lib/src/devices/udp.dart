@@ -1,10 +1,8 @@
 import 'dart:developer' show log;
-import 'dart:io';
-import 'dart:math' show min;
-import 'dart:typed_data';
 
+import 'package:ledfx/ledfx_native.dart';
 import 'package:ledfx/src/devices/device.dart';
-import 'package:ledfx/src/devices/packets.dart';
+import 'package:ledfx/src/pixel_frame.dart';
 
 abstract class UDPDevice extends NetworkedDevice implements AsyncInitDevice {
   UDPDevice({
@@ -17,23 +15,12 @@ abstract class UDPDevice extends NetworkedDevice implements AsyncInitDevice {
   });
 
   int port;
-
-  RawDatagramSocket? _socket;
-  RawDatagramSocket? get socket => _socket;
-
-  @override
-  Future<void> activate() async {
-    _socket = await RawDatagramSocket.bind(InternetAddress.anyIPv4, 0);
-    super.activate();
-  }
-
-  @override
-  void deactivate() {
-    super.deactivate();
-    _socket = null;
-  }
 }
 
+/// Streams frames with one of WLED's realtime UDP protocols. Frames are
+/// clamped to bytes and packetized natively (src/ledfx/wled.h) and go out
+/// through a connected socket, resolved once per destination. The shared
+/// [LedfxScheduler] sends the latest frame at [maxRefreshRate].
 class RealtimeUDPDevice extends UDPDevice {
   RealtimeUDPDevice({
     required super.ipAddr,
@@ -45,117 +32,129 @@ class RealtimeUDPDevice extends UDPDevice {
     required super.id,
     required super.ledfx,
     required super.config,
-  }) : lastFrame = List.filled(
-         config.pixelCount,
-         Float64List.fromList(List.filled(3, -1)),
-       ),
-       lastFrameSendTime = DateTime.now().millisecondsSinceEpoch,
-       deviceType = "UDP Device";
+  }) : deviceType = "UDP Device";
 
   String deviceType;
   String udpPacketType;
   int timeout;
+
+  /// Send only the packets whose bytes changed since they were last sent,
+  /// with the whole frame resent halfway through WLED's timeout.
   bool minimizeTraffic;
 
-  late List<Float64List> lastFrame;
-  late int lastFrameSendTime;
+  LedfxWled? _wled;
+  LedfxUdp? _udp;
+  LedfxOutput? _scheduled;
+  double? _keepalive;
+  int _skippedPackets = 0;
+  int _skippedBytes = 0;
+
+  /// Scheduler output of the device while it streams, for its pacing
+  /// statistics.
+  LedfxOutput? get output => _scheduled;
+
+  /// Packets left out as unchanged by [minimizeTraffic]. The counters of
+  /// a scheduled encoder are read through the scheduler, which updates them
+  /// on its thread.
+  int get skippedPackets => _skippedPackets + (_scheduled?.skippedPackets ?? 0);
+
+  /// Bytes of those packets, headers included.
+  int get skippedBytes => _skippedBytes + (_scheduled?.skippedBytes ?? 0);
 
   @override
-  void flush(List<Float64List> data) {
+  void flush(PixelFrame data) {
     try {
       chooseAndSend(data);
-      lastFrame = data;
     } catch (e) {
       log("Error: ${e.toString()}");
       activate();
     }
   }
 
-  List<Uint8List> clampToByte(List<Float64List> data) {
-    return data
-        .map(
-          (e) => Uint8List.fromList(
-            e.map((i) => i.toInt().clamp(0, 255)).toList(),
-          ),
-        )
-        .toList();
-  }
-
-  void chooseAndSend(List<Float64List> floatData) {
-    final int frameSize = floatData.length;
-    final bool frameIsSame = minimizeTraffic && floatData == lastFrame;
-
-    final data = clampToByte(floatData);
+  /// Protocol for a strip of [frameSize] LEDs: the configured one when it
+  /// can address the strip, else DRGB for short strips and DNRGB for long
+  /// ones.
+  LedfxWledProtocol protocolFor(int frameSize) {
     switch ((udpPacketType, frameSize)) {
       case ("DRGB", <= 490):
-        final udpData = Packets.buidDRGBpacket(data, timeout);
-        transmitPacket(udpData, frameIsSame);
-        break;
+        return LedfxWledProtocol.drgb;
       case ("WARLS", <= 255):
-        final udpData = Packets.buildWARLSpacket(data, timeout);
-        transmitPacket(udpData, frameIsSame);
-        break;
+        return LedfxWledProtocol.warls;
       case ("DNRGB", _):
-        final numberOfPackets = (frameSize / 489).ceil();
-        for (int i = 0; i < numberOfPackets; i++) {
-          int start = i * 489;
-          int end = start + 489;
-          end = min(end, data.length);
-          final udpData = Packets.buidDNRGBpacket(
-            data.sublist(start, end),
-            start,
-            timeout,
-          );
-          transmitPacket(udpData, frameIsSame);
-        }
-        break;
+        return LedfxWledProtocol.dnrgb;
       default:
         log(
           """UDP packet is configured incorrectly (please choose a packet that supports $pixelCount LEDs): 
           https://kno.wled.ge/interfaces/udp-realtime/#udp-realtime \n Falling back to supported udp packet.""",
         );
+        return frameSize < 255
+            ? LedfxWledProtocol.drgb
+            : LedfxWledProtocol.dnrgb;
+    }
+  }
 
-        if (frameSize < 255) {
-          //DRGB
-          final udpData = Packets.buidDRGBpacket(data, timeout);
-          transmitPacket(udpData, frameIsSame);
-        } else {
-          // DNRGB
-          final numberOfPackets = (frameSize / 489).ceil();
-          for (int i = 0; i < numberOfPackets; i++) {
-            int start = i * 489;
-            int end = start + 489;
-            final udpData = Packets.buidDNRGBpacket(
-              data.getRange(start, end).toList(),
-              start,
-              timeout,
-            );
-            transmitPacket(udpData, frameIsSame);
-          }
-        }
+  void chooseAndSend(PixelFrame floatData) {
+    if (destination == null) return;
+    final output = _output(destination!, floatData.length);
+    _wled!.rgb.setAll(0, floatData.data);
+    output.submit();
+  }
+
+  /// Seconds between whole frames with [minimizeTraffic]: half of WLED's
+  /// timeout, in whole frames at [maxRefreshRate]. 0 sends every frame
+  /// whole.
+  double get keepalive {
+    if (!minimizeTraffic) return 0;
+    final rate = maxRefreshRate;
+    return (((timeout * rate) - 1) ~/ 2) / rate;
+  }
+
+  // Output for the current destination, protocol, size, timeout and
+  // keepalive, rebuilt only when one of them changes.
+  LedfxOutput _output(String dest, int frameSize) {
+    final protocol = protocolFor(frameSize);
+    final keepalive = this.keepalive;
+    final output = _scheduled;
+    final wled = _wled;
+    if (output != null &&
+        wled != null &&
+        _udp!.host == dest &&
+        _udp!.port == port &&
+        wled.protocol == protocol &&
+        wled.pixelCount == frameSize &&
+        wled.timeout == timeout &&
+        _keepalive == keepalive) {
+      return output;
     }
+    _unschedule();
+    final udp = _udp = LedfxUdp(dest, port);
+    final encoder = _wled = LedfxWled(protocol, frameSize)..timeout = timeout;
+    _keepalive = keepalive;
+    return _scheduled = LedfxScheduler.shared.addWled(
+      encoder,
+      udp,
+      maxRefreshRate,
+      keepalive: keepalive,
+    );
   }
 
-  void transmitPacket(List<int> packet, bool frameIsSame) {
-    final timestamp = DateTime.now().millisecondsSinceEpoch;
-    if (frameIsSame) {
-      final halfTimeout =
-          ((((timeout * refreshRate) - 1) ~/ 2) / refreshRate) * 1000;
-
-      if (timestamp > lastFrameSendTime + halfTimeout) {
-        if (destination != null) {
-          // _socket!.send(packet, InternetAddress("192.168.0.150"), 12345);
-          _socket!.send(packet, InternetAddress(destination!), port);
-          lastFrameSendTime = timestamp;
-        }
-      }
-    } else {
-      if (destination != null) {
-        // _socket!.send(packet, InternetAddress("192.168.0.150"), 12345);
-
-        _socket!.send(packet, InternetAddress(destination!), port);
-        lastFrameSendTime = timestamp;
-      }
+  void _unschedule() {
+    _scheduled?.remove();
+    _scheduled = null;
+    final wled = _wled;
+    if (wled != null) {
+      _skippedPackets += wled.skippedPackets;
+      _skippedBytes += wled.skippedBytes;
+      wled.dispose();
+      _wled = null;
     }
+    _udp?.dispose();
+    _udp = null;
+  }
+
+  @override
+  void deactivate() {
+    _unschedule();
+    super.deactivate();
   }
 }
@@ -7,6 +7,7 @@ import 'package:ledfx/src/devices/ddp.dart';
 import 'package:ledfx/src/devices/device.dart';
 import 'package:http/http.dart' as http;
 import 'package:ledfx/src/devices/udp.dart';
+import 'package:ledfx/src/pixel_frame.dart';
 import 'package:nanoid/nanoid.dart';
 
 enum WLEDSyncMode { udp, ddp, e131 }
@@ -32,7 +33,7 @@ class WLEDDevice extends NetworkedDevice {
   WLED? wled;
 
   @override
-  void flush(List<Float64List> data) {
+  void flush(PixelFrame data) {
     subdevice?.flush(data);
   }
 
@@ -1,14 +1,13 @@
 import 'dart:async' show StreamSubscription, Timer;
 import 'dart:ffi';
-import 'dart:math' show max, min;
 
 import 'package:flutter/foundation.dart';
 import 'package:ledfx/aubio.dart';
 import 'package:ledfx/aubio_bindings.dart';
+import 'package:ledfx/ledfx_native.dart';
 import 'package:ledfx/src/platform/audio_bridge.dart';
 import 'package:ledfx/src/core.dart';
 import 'package:ledfx/src/effects/const.dart';
-import 'package:ledfx/src/effects/dsp.dart';
 import 'package:ledfx/src/effects/math.dart';
 import 'package:ledfx/src/effects/melbank.dart';
 import 'package:ledfx/src/effects/utils.dart'
@@ -21,7 +20,6 @@ abstract class AudioInputSource {
   final double minVolume;
   final Duration delay;
 
-  late AudioDSP dsp;
   AudioBridge? _audio;
 
   AudioInputSource({
@@ -41,33 +39,45 @@ abstract class AudioInputSource {
   Timer? _timer;
   int _subscriberThreshould = 0;
 
-  late Pointer<cvec_t> _freqDomainNull;
-  late Pointer<cvec_t> _freqDomain;
-  Pointer<cvec_t> get freqDomain => _freqDomain;
+  // Native pre-emphasis + volume gate + phase vocoder, see src/ledfx/frontend.h
+  LedfxFrontend? _frontend;
+  LedfxFrontend get frontend => _frontend!;
 
-  late Float64List _rawAudioSample;
-  late Float64List _processedAudioSample;
-  Float64List audioSample({bool raw = false}) {
-    return raw ? _rawAudioSample : _processedAudioSample;
+  /// Spectrum of the last hop; zeroed while below [minVolume]. The pointer
+  /// is stable for as long as the source is active.
+  Pointer<cvec_t> get freqDomain => frontend.spectrum;
+
+  late List<double> _rawAudioSample;
+  List<double> audioSample({bool raw = false}) {
+    return raw ? _rawAudioSample : frontend.filtered;
   }
 
-  double _volume = -90.0;
-  final ExpFilter _volumeFilter = ExpFilter(
-    val: -90.0,
-    alphaDecay: 0.99,
-    alphaRise: 0.99,
-  );
   double volume({bool filtered = true}) {
-    return filtered ? _volumeFilter.value : _volume;
+    return frontend.volume(filtered: filtered);
   }
 
-  late Pointer<aubio_filter_t> preEmphasis;
-  late Pointer<aubio_pvoc_t> phaseVocoder;
   Pointer<aubio_resampler_t>? resampler;
   FixedSizeQueue? delayQueue;
 
+  /// Capture timestamp of the last analysed hop, on the clock of
+  /// [AudioEvent.timestampUs]; 0 until one arrives.
+  int lastCaptureUs = 0;
+
+  // Long-lived native buffers of the audio path, freed in deactivate()
+  LedfxArena? _arena;
+  LedfxVector? _resampleIn;
+  LedfxVector? _resampleOut;
+  // Vectors never change length: one input per device block size seen
+  final Map<int, LedfxVector> _resampleInputs = {};
+
+  // Where the runner pushes captured hops, when it supports it
+  LedfxPcm? _pcm;
+
   final List<double> _audioEventBuffer = [];
   void activate() {
+    // Every subscribe() runs this until capture has started, so only the
+    // first one sets up the stream
+    if (_streamSub != null) return;
     // setup audio bridge event stream
     _audio ??= AudioBridge.instance;
     _streamSub = _audio!.events.listen((event) {
@@ -93,13 +103,23 @@ abstract class AudioInputSource {
           debugPrint(message);
           break;
 
-        case AudioEvent(:final Float64List data):
+        case final AudioEvent audio:
           // Convert and accumulate into frames
           // final frames = processAudioByteChunk(data);
           // for (final frame in frames) {
           //   audioSampleCallback(frame);
           // }
-          audioSampleCallback(data);
+          if (audio.isPcmSink) {
+            _drainPcmSink();
+          } else {
+            // Coalesced by the runner into several blocks: analyse each in
+            // order
+            for (final block in audio.blocks) {
+              audioSampleCallback(block);
+            }
+            lastCaptureUs = audio.timestampUs;
+          }
+          PipelineProbe.record(PipelineStage.analysed, lastCaptureUs);
           break;
         case DevicesInfoEvent(:final audioDevices):
           this.audioDevices = audioDevices;
@@ -110,25 +130,25 @@ abstract class AudioInputSource {
     // get devices list
     _audio!.getDevices();
 
+    _frontend?.dispose();
+    _frontend = LedfxFrontend(FFT_SIZE, MIC_RATE ~/ sampleRate)
+      ..minVolume = minVolume;
+    _releaseResampler();
+    _arena = LedfxArena();
+
     // Setup a pre-emphasis filter to balance the input volume of lows to highs
-    preEmphasis = Aubio.digitalFilter(3);
     final selectedCoeff =
         ledfx.config.melbankConfig?.coeffType ?? CoeffType.mattmel;
     switch (selectedCoeff) {
       case CoeffType.mattmel:
-        preEmphasis.setBiquad(0.8268, -1.6536, 0.8268, -1.6536, 0.6536);
+        frontend.setBiquad(0.8268, -1.6536, 0.8268, -1.6536, 0.6536);
       // default:
-      //   preEmphasis.setBiquad(0, 0.85870, -1.71740, 0.85870, -1.71605, 0.71874);
+      //   frontend.setBiquad(0, 0.85870, -1.71740, 0.85870, -1.71605, 0.71874);
     }
     _rawAudioSample = Float64List.fromList(
       List.filled(MIC_RATE ~/ sampleRate, 0),
     );
 
-    phaseVocoder = Aubio.createPhaseVocoder(FFT_SIZE, MIC_RATE ~/ sampleRate);
-
-    _freqDomainNull = Aubio.createComplexVector(FFT_SIZE);
-    _freqDomain = _freqDomainNull;
-
     final samplesToDelay = (0.001 * delay.inMilliseconds * sampleRate).toInt();
     if (samplesToDelay > 0) {
       delayQueue = FixedSizeQueue(samplesToDelay);
@@ -141,13 +161,22 @@ abstract class AudioInputSource {
     _streamSub?.cancel();
     _streamSub = null;
     _audioStreamActive = false;
+    _detachPcmSink();
 
     // Clear Pointers
-    preEmphasis.delete();
-    phaseVocoder.delete();
+    _frontend?.dispose();
+    _frontend = null;
+    _releaseResampler();
+  }
+
+  void _releaseResampler() {
     if (resampler != null) resampler!.delete();
     resampler = null;
-    _freqDomain.delete();
+    _resampleIn = null;
+    _resampleOut = null;
+    _resampleInputs.clear();
+    _arena?.dispose();
+    _arena = null;
   }
 
   void queryDevices() {
@@ -168,6 +197,7 @@ abstract class AudioInputSource {
     if (deviceIndex != null) setActiveDevice(deviceIndex);
 
     if (audioDevices!.length > activeAudioDeviceIndex) {
+      await _attachPcmSink();
       print(
         "starting audio capture with device -- ${audioDevices![activeAudioDeviceIndex].name}",
       );
@@ -182,8 +212,16 @@ abstract class AudioInputSource {
         "blockSize":
             audioDevices![activeAudioDeviceIndex].defaultSampleRate ~/
             sampleRate,
+        // Platforms that resample natively send hops of exactly this size,
+        // which audioSampleCallback passes through without resampling.
+        "targetSampleRate": MIC_RATE,
+        "hopSize": MIC_RATE ~/ sampleRate,
       });
-      if (success ?? false) _audioStreamActive = true;
+      if (success ?? false) {
+        _audioStreamActive = true;
+      } else {
+        _detachPcmSink();
+      }
       return;
     }
   }
@@ -192,6 +230,41 @@ abstract class AudioInputSource {
     if (_audioStreamActive && _audio != null) {
       _audio!.stop();
       _audioStreamActive = false;
+      _detachPcmSink();
+    }
+  }
+
+  // Hops then stay in native memory from the capture thread to the
+  // frontend instead of crossing the event channel
+  Future<void> _attachPcmSink() async {
+    if (_pcm != null) return;
+    final pcm = LedfxPcm(MIC_RATE ~/ sampleRate, MIC_RATE);
+    if (await _audio!.setPcmSink(pcm.address)) {
+      _pcm = pcm;
+    } else {
+      pcm.dispose();
+    }
+  }
+
+  void _detachPcmSink() {
+    final pcm = _pcm;
+    _pcm = null;
+    if (pcm == null) return;
+    // Freed once the runner has let go of it
+    _audio!.setPcmSink(0).whenComplete(pcm.dispose);
+  }
+
+  void _drainPcmSink() {
+    final pcm = _pcm;
+    if (pcm == null) return;
+    while (pcm.popInto(frontend)) {
+      lastCaptureUs = pcm.timestampUs;
+      // Queued frames must outlive the next hop
+      audioSampleCallback(
+        delayQueue != null
+            ? Float32List.fromList(frontend.input)
+            : frontend.input,
+      );
     }
   }
 
@@ -222,18 +295,33 @@ abstract class AudioInputSource {
   int inLen = 0;
   int outLen = 0;
 
-  void audioSampleCallback(Float64List inRaw) {
+  void audioSampleCallback(List<double> inRaw) {
     final int outLen = MIC_RATE ~/ sampleRate;
-    Float64List processed = Float64List(outLen);
+    List<double> processed;
     if (inRaw.length != outLen) {
-      if (resampler == null || resampler == nullptr) {
+      if (resampler == null ||
+          resampler == nullptr ||
+          _resampleIn!.length != inRaw.length) {
+        if (resampler != null && resampler != nullptr) resampler!.delete();
         resampler = Aubio.createResampler(
           ResamplerType.SRC_SINC_FASTEST,
           inRaw.length,
           outLen,
         );
+        // Allocated once per block size, so switching back and forth
+        // between devices does not grow the arena
+        _resampleIn = _resampleInputs[inRaw.length] ??= _arena!.vector(
+          inRaw.length,
+        );
+        _resampleOut ??= _arena!.vector(outLen);
       }
-      processed = resampler!.process(inRaw, outLen);
+      // Resample in place in the native buffers, without copies through
+      // temporary vectors
+      _resampleIn!.data.setAll(0, inRaw);
+      resampler!.processInto(_resampleIn!.pointer, _resampleOut!.pointer);
+      processed = _resampleOut!.data;
+      // Queued frames must outlive the next hop
+      if (delayQueue != null) processed = Float32List.fromList(processed);
     } else {
       processed = inRaw;
     }
@@ -306,31 +394,14 @@ abstract class AudioInputSource {
   // should be done here. Everything else should be deferred until
   // queried by an effect.
   void preProcessAudio() {
-    //Calculate the current volume for silence detection
-    final db = Aubio.dbSPL(_rawAudioSample);
-
-    _volume = 1 + db / 100;
-    _volume = max(0, min(1, _volume));
-    _volumeFilter.update(_volume);
-
-    // print("db: $db, vol: ${_volumeFilter.value}");
-
-    // Calculate the frequency domain from the filtered data and
-    // force all zeros when below the volume threshold
-    if ((_volumeFilter.value as double) > minVolume) {
-      _processedAudioSample = _rawAudioSample;
-      // pre-emphasis
-      _processedAudioSample =
-          preEmphasis.processAudioFrame(_rawAudioSample) ?? _rawAudioSample;
-      //Pass into the phase vocoder to get a windowed FFT
-      _freqDomain = phaseVocoder.analyse(_processedAudioSample);
-    } else {
-      _freqDomain = _freqDomainNull;
-    }
+    // Level/volume for silence detection, pre-emphasis and the phase
+    // vocoder run natively in one call; the spectrum is forced to zeros
+    // when below the volume threshold.
+    frontend.processSamples(_rawAudioSample);
   }
 }
 
-enum PitchMethod { yinfft }
+enum PitchMethod { yinfast }
 
 enum OnsetMethod { energy, hfc, complex }
 
@@ -347,6 +418,8 @@ class AudioAnalysisSource extends AudioInputSource {
   final double pitchTolerance;
 
   late Melbanks melbanks;
+  // Native onset, tempo and pitch, see src/ledfx/analysis.h
+  LedfxAnalysis? analysis;
   //bar oscillator
   late int beatCounter;
   //beat oscillator
@@ -366,16 +439,17 @@ class AudioAnalysisSource extends AudioInputSource {
 
   AudioAnalysisSource({
     required super.ledfx,
-    this.pitchMethod = PitchMethod.yinfft,
+    this.pitchMethod = PitchMethod.yinfast,
     this.tempoMethod = TempoMethod.simple,
     this.onsetMethod = OnsetMethod.hfc,
-    this.pitchTolerance = 0.8,
+    this.pitchTolerance = 0.15,
   }) {
     initialiseAnalysis();
 
-    subscribe(melbanks.execute);
-    // subscribe(setPitch);
-    // subscribe(setOnset);
+    // Through the field, as activate() replaces melbanks freed by
+    // deactivate()
+    subscribe(() => melbanks.execute());
+    subscribe(analyse);
     // subscribe(barOscillator);
     // subscribe(volumeBeatNow);
     // subscribe(freqPower);
@@ -383,22 +457,34 @@ class AudioAnalysisSource extends AudioInputSource {
     _subscriberThreshould = _callbacks.length;
   }
 
+  @override
+  void activate() {
+    if (_streamSub != null) return;
+    super.activate();
+    if (melbanks.isDisposed) {
+      melbanks = Melbanks(ledfx: ledfx, audio: this);
+    }
+    analysis?.dispose();
+    analysis = LedfxAnalysis(
+      onsetMethod: onsetMethod.name,
+      windowSize: fftSize,
+      hopSize: MIC_RATE ~/ sampleRate,
+      sampleRate: MIC_RATE,
+    )..pitchTolerance = pitchTolerance;
+  }
+
   @override
   void deactivate() {
     super.deactivate();
     // Clean Pointers
-    for (var m in melbanks.melbankProcessors) {
-      m.filterBank.delete();
-    }
+    analysis?.dispose();
+    analysis = null;
+    melbanks.dispose();
   }
 
   void initialiseAnalysis() {
     melbanks = Melbanks(ledfx: ledfx, audio: this);
 
-    super.dsp = AudioDSP(fftSize, MIC_RATE ~/ sampleRate, sampleRate)
-      ..pitchUnit = PitchUnit.midi
-      ..pitchTolerance = pitchTolerance;
-
     //bar oscillator
     beatCounter = 0;
     //beat oscillator
@@ -437,31 +523,25 @@ class AudioAnalysisSource extends AudioInputSource {
 
   @override
   void invalidateCaches() {
-    // _pitch = null;
-    // _onset = null;
+    // The analysis results are overwritten in place once per hop
   }
 
-  // double? _pitch;
-  // double? get pitch => _pitch;
-  // void setPitch() {
-  //   try {
-  //     _pitch = dsp.detectPitch(audioSample(raw: true));
-  //   } catch (e) {
-  //     debugPrint(e.toString());
-  //     _pitch = null;
-  //   }
-  // }
-
-  // bool? _onset;
-  // bool? get onset => _onset;
-  // void setOnset() {
-  //   try {
-  //     _onset = dsp.detectOnset(audioSample(raw: true));
-  //   } catch (e) {
-  //     debugPrint(e.toString());
-  //     _onset = null;
-  //   }
-  // }
+  // Runs onset, tempo and pitch on the raw hop held by the front-end
+  void analyse() {
+    analysis?.process(frontend.inputVector);
+  }
+
+  /// Pitch of the last hop in MIDI notes, 0 if unvoiced or silent.
+  double get pitch => analysis?.pitchMidi ?? 0;
+
+  /// Whether an onset was detected in the last hop.
+  bool get onset => analysis?.onset ?? false;
+
+  /// Whether a beat falls in the last hop.
+  bool get beat => analysis?.beat ?? false;
+
+  /// Tempo estimate in beats per minute, 0 until one is found.
+  double get bpm => analysis?.result.bpm ?? 0;
 
   // void barOscillator() {}
 
@@ -187,144 +187,3 @@ class DigitalFilter {
     }
   }
 }
-
-enum PitchUnit { midi, hz }
-
-/// ---------- DSP CLASS ----------
-class AudioDSP {
-  final int fftSize;
-  final int hopSize;
-  final int sampleRate;
-  final List<double> window;
-
-  // Stores recent audio samples, size is typically >= fftSize
-  final Float64List _buffer;
-
-  // Pitch params
-  double pitchTolerance = 0.15;
-  PitchUnit pitchUnit = PitchUnit.hz;
-  // Onset state
-  List<double>? prevMag;
-  // Tempo state
-  final List<int> onsetFrames = [];
-  AudioDSP(this.fftSize, this.hopSize, this.sampleRate)
-    : window = Window.hann(fftSize),
-      // Initialize the buffer to be large enough (e.g., fftSize) and filled with zeros
-      _buffer = Float64List(fftSize);
-
-  /// Phase vocoder frame -> cvec
-  Cvec pvoc(Float64List frame) {
-    if (frame.length != hopSize) {
-      throw Exception(
-        "Input frame size must equal the declared hopSize ($hopSize)",
-      );
-    }
-    _buffer.setAll(0, _buffer.sublist(hopSize));
-    final int samplesToKeep = fftSize - hopSize;
-    _buffer.setAll(samplesToKeep, frame);
-
-    var currentWindow = _buffer.toList();
-
-    var windowed = List.generate(fftSize, (i) => currentWindow[i] * window[i]);
-
-    var spectrum = FFTUtils.fft(windowed);
-
-    var cvec = Cvec(fftSize ~/ 2 + 1);
-    cvec.fromSpectrum(spectrum.sublist(0, fftSize ~/ 2 + 1));
-    return cvec;
-  }
-
-  /// Pitch detection (yinfft style)
-  double detectPitch() {
-    List<double> frame = _buffer;
-    int n = frame.length; // n = fftSize
-    var yin = List.filled(n ~/ 2, 0.0);
-    for (int tau = 1; tau < n ~/ 2; tau++) {
-      double sum = 0;
-      for (int i = 0; i < n ~/ 2; i++) {
-        double d = frame[i] - frame[i + tau];
-        sum += d * d;
-      }
-      yin[tau] = sum;
-    }
-    var cmnd = List.filled(n ~/ 2, 0.0);
-    cmnd[0] = 1.0;
-    double runningSum = 0.0;
-    int tauEstimate = -1;
-    for (int tau = 1; tau < n ~/ 2; tau++) {
-      runningSum += yin[tau];
-      cmnd[tau] = yin[tau] * tau / (runningSum == 0 ? 1 : runningSum);
-      if (tau > 2 && cmnd[tau] < pitchTolerance) {
-        tauEstimate = tau;
-        while (tau + 1 < n ~/ 2 && cmnd[tau + 1] < cmnd[tau]) {
-          tau++;
-        }
-        break;
-      }
-    }
-    if (tauEstimate == -1) return 0.0;
-    double freq = sampleRate / tauEstimate;
-    return (pitchUnit == PitchUnit.midi) ? hzToMidi(freq) : freq;
-  }
-
-  static double hzToMidi(double hz) =>
-      (hz > 0) ? 69 + 12 * log(hz / 440.0) / ln2 : 0.0;
-
-  /// Onset detection (spectral flux)
-  bool detectOnset(Cvec cvec) {
-    var mags = cvec.norm;
-    if (prevMag == null) {
-      prevMag = mags;
-      return false;
-    }
-    double flux = 0.0;
-    for (int i = 0; i < mags.length; i++) {
-      double diff = mags[i] - prevMag![i];
-      if (diff > 0) flux += diff;
-    }
-    prevMag = mags;
-    return flux > 5.0; // threshold
-  }
-
-  /// Tempo estimation (BPM from onsets)
-  double estimateTempo(bool onsetDetected, int frameIndex) {
-    if (onsetDetected) onsetFrames.add(frameIndex);
-    if (onsetFrames.length < 2) return 0.0;
-    var intervals = <int>[];
-    for (int i = 1; i < onsetFrames.length; i++) {
-      intervals.add(onsetFrames[i] - onsetFrames[i - 1]);
-    }
-    double avgHopCount = intervals.reduce((a, b) => a + b) / intervals.length;
-
-    // The time for one hop is hopSize / sampleRate
-    double secPerHop = hopSize / sampleRate;
-    double secPerBeat = avgHopCount * secPerHop;
-
-    return 60.0 / secPerBeat;
-  }
-
-  /// Analyze frame: returns pitch, onset, tempo, energy, dbSPL
-  /// The input frame is the hopSize chunk.
-  Map<String, dynamic> analyzeFrame(Float64List hopFrame, int frameIndex) {
-    // 1. Run PVOC (updates buffer, runs FFT, gets Cvec)
-    var cvec = pvoc(hopFrame);
-
-    // 2. Detect Onset (needs Cvec result)
-    var onset = detectOnset(cvec);
-
-    // 3. Estimate Tempo (needs onset result and frame index)
-    var tempo = estimateTempo(onset, frameIndex);
-
-    // 4. Detect Pitch (needs buffer updated by pvoc)
-    var pitch = detectPitch();
-
-    // 5. Energy and dbSPL are calculated directly on the hop frame
-    return {
-      "pitch": pitch,
-      "onset": onset,
-      "tempo": tempo,
-      "energy": Energy.rms(hopFrame),
-      "dbSpl": Energy.dbSpl(hopFrame),
-    };
-  }
-}
@@ -1,9 +1,7 @@
-import 'dart:math';
-
-import 'package:flutter/foundation.dart';
 import 'package:flutter/material.dart';
+import 'package:ledfx/ledfx_native.dart';
 import 'package:ledfx/src/core.dart';
-import 'package:ledfx/src/effects/utils.dart';
+import 'package:ledfx/src/pixel_frame.dart';
 import 'package:ledfx/src/virtual.dart';
 
 class EffectConfig {
@@ -46,9 +44,9 @@ abstract class Effect {
   bool _active = false;
   bool get isActive => _active;
 
-  List<Float64List>? _pixels;
-  List<Float64List>? get pixels => _pixels;
-  set pixels(List<Float64List>? pixels) {
+  PixelFrame? _pixels;
+  PixelFrame? get pixels => _pixels;
+  set pixels(PixelFrame? pixels) {
     _pixels = pixels;
   }
 
@@ -57,10 +55,16 @@ abstract class Effect {
   Virtual? _virtual;
   Virtual? get virtual => _virtual;
 
+  // Native flip, mirror, brightness and blur for getPixels and
+  // preparePixels, reused while the pixel count holds. processedPixels is a
+  // view on its frame.
+  LedfxPostprocess? _postprocess;
+  PixelFrame _processedPixels = PixelFrame.empty;
+
   Effect({required this.ledfx, required this.config});
   void activate(Virtual virtual) {
     _virtual = virtual;
-    _pixels = List.filled(virtual.effectivePixelCount, Float64List(3));
+    _pixels = PixelFrame(virtual.effectivePixelCount);
 
     if (this is EffectMixin) {
       (this as EffectMixin).onActivate(virtual.effectivePixelCount);
@@ -75,95 +79,56 @@ abstract class Effect {
   void deactivate() {
     _pixels = null;
     _active = false;
+    _postprocess?.dispose();
+    _postprocess = null;
+    _processedPixels = PixelFrame.empty;
   }
 
   void render() {}
 
-  List<Float64List>? getPixels() {
+  /// Post-processed copy of [pixels]. The frame is reused by the next call.
+  PixelFrame? getPixels() {
+    if (virtual == null || pixels == null) return null;
+    final post = preparePixels();
+    if (post == null) return PixelFrame.empty;
+    post.process();
+    return _processedPixels;
+  }
+
+  /// Copies [pixels] into the native post-processing frame, set up from
+  /// [config], without processing it: a [LedfxRender] does, and
+  /// [processedPixels] then views the result. Null if there are no pixels.
+  LedfxPostprocess? preparePixels() {
     if (virtual == null) return null;
-    List<Float64List> tmpPixels = List.filled(
-      virtual!.effectivePixelCount,
-      Float64List(3),
-    );
-    if (pixels != null) {
-      copyListContents(tmpPixels, pixels!);
-      if (config.flip) tmpPixels = tmpPixels.reversed.toList();
-
-      if (config.mirror) {
-        List<Float64List> reversedPixels = tmpPixels.reversed.toList();
-        List<Float64List> mirroredPixels = [...reversedPixels, ...tmpPixels];
-        int outputRows = mirroredPixels.length ~/ 2;
-        List<Float64List> finalPixels = List<Float64List>.generate(outputRows, (
-          i,
-        ) {
-          // Get the two corresponding rows: one from the even index, one from the odd index
-          Float64List evenRow =
-              mirroredPixels[2 * i]; // mirrored_pixels[::2] element
-          Float64List oddRow =
-              mirroredPixels[2 * i + 1]; // mirrored_pixels[1::2] element
-
-          // Create the result row for the maximums
-          Float64List maxRow = Float64List(3);
-
-          // Element-wise maximum (loop through columns)
-          for (int j = 0; j < 3; j++) {
-            maxRow[j] = max(evenRow[j], oddRow[j]); // np.maximum equivalent
-          }
-
-          return maxRow;
-        });
-
-        tmpPixels = finalPixels;
-      }
-
-      if (config.useBG) {
-        for (final row in tmpPixels) {
-          for (int j = 0; j < 3; j++) {
-            // TODO: change o into bgColor[j]
-            row[j] += 0;
-          }
-        }
-      }
-      // Brightness
-      for (final row in tmpPixels) {
-        for (int j = 0; j < 3; j++) {
-          row[j] *= config.brightness;
-        }
-      }
-
-      // TODO: Blur
-
-      if (config.blur != 0 && pixelCount > 3) {
-        final List<double> kernel = gaussianKernel1d(
-          config.blur,
-          0,
-          tmpPixels.length,
-        );
-
-        // R channel
-        // Python: pixels[:, 0] = np.convolve(pixels[:, 0], kernel, mode="same")
-        List<double> rValues = getColumn(tmpPixels, 0);
-        List<double> blurredR = convolveSame(rValues, kernel);
-        setColumn(tmpPixels, 0, blurredR);
-
-        // G channel (Column 1)
-        // Python: pixels[:, 1] = np.convolve(pixels[:, 1], kernel, mode="same")
-        List<double> gValues = getColumn(tmpPixels, 1);
-        List<double> blurredG = convolveSame(gValues, kernel);
-        setColumn(tmpPixels, 1, blurredG);
-
-        // B channel (Column 2)
-        // Python: pixels[:, 2] = np.convolve(pixels[:, 2], kernel, mode="same")
-        List<double> bValues = getColumn(tmpPixels, 2);
-        List<double> blurredB = convolveSame(bValues, kernel);
-        setColumn(tmpPixels, 2, blurredB);
-      }
-
-      return tmpPixels;
+    final pixels = this.pixels;
+    if (pixels == null) return null;
+    final int n = virtual!.effectivePixelCount;
+    if (pixels.length != n) {
+      throw ArgumentError(
+        'Effect has ${pixels.length} pixels, virtual expects $n.',
+      );
     }
+    if (n == 0) return null;
 
-    return null;
+    var post = _postprocess;
+    if (post == null || post.pixelCount != n) {
+      post?.dispose();
+      post = _postprocess = LedfxPostprocess(n);
+      _processedPixels = PixelFrame.view(post.frame);
+    }
+    // TODO: background colour (config.useBG)
+    post
+      ..flip = config.flip
+      ..mirror = config.mirror
+      ..brightness = config.brightness
+      ..blur = config.blur;
+
+    _processedPixels.setFrom(pixels);
+    return post;
   }
+
+  /// The frame of the last [getPixels] or [preparePixels].
+  PixelFrame get processedPixels => _processedPixels;
 }
 
 class Effects {
@@ -1,14 +1,10 @@
-import 'dart:ffi';
 import 'dart:math';
 import 'dart:typed_data';
 
-import 'package:ledfx/aubio.dart';
-import 'package:ledfx/aubio_bindings.dart';
+import 'package:ledfx/ledfx_native.dart';
 import 'package:ledfx/src/core.dart';
 import 'package:ledfx/src/effects/audio.dart';
 import 'package:ledfx/src/effects/const.dart';
-import 'package:ledfx/src/effects/math.dart';
-import 'package:ledfx/src/effects/mel_utils.dart';
 import 'package:ledfx/src/effects/utils.dart';
 
 class MelbankConfig {
@@ -45,13 +41,16 @@ class Melbanks {
 
   late List<Map<String, dynamic>> melbankCollection;
   late List<Melbank> melbankProcessors;
+  // Sparse filters of every melbank, evaluated in one pass per hop
+  late LedfxFilterbank filterbanks;
   late MelbankConfig melbankConfig;
 
   late int melCount;
   late int melLength;
 
-  late List<Float64List> melbanks;
-  late List<Float64List> melbanksFiltered;
+  // Views on the native outputs of each melbank processor
+  late List<Float32List> melbanks;
+  late List<Float32List> melbanksFiltered;
   late double minVolume;
 
   Melbanks({
@@ -65,6 +64,7 @@ class Melbanks {
   }) {
     melbankCollection = ledfx.config.melbankCollection ?? [];
     melbankProcessors = [];
+    filterbanks = LedfxFilterbank(FFT_SIZE);
     melbankConfig = MelbankConfig(name: "", maxFreq: MAX_FREQ)
       ..peakIsolation = peakIsolation
       ..coeffType = coeffType
@@ -78,7 +78,11 @@ class Melbanks {
           ..coeffType = coeffType
           ..samples = samples
           ..maxFreqs = maxFreqs;
-        final melbank = Melbank(audio: audio, config: melbankConfig);
+        final melbank = Melbank(
+          audio: audio,
+          config: melbankConfig,
+          filterbanks: filterbanks,
+        );
         melbankProcessors.add(melbank);
         melbankCollection.add({
           "id": generateId(melbank.config.name),
@@ -92,7 +96,13 @@ class Melbanks {
           ..coeffType = coeffType
           ..samples = samples
           ..maxFreqs = maxFreqs;
-        melbankProcessors.add(Melbank(audio: audio, config: melbankConfig));
+        melbankProcessors.add(
+          Melbank(
+            audio: audio,
+            config: melbankConfig,
+            filterbanks: filterbanks,
+          ),
+        );
       }
     }
 
@@ -100,25 +110,38 @@ class Melbanks {
     melCount = maxFreqs.length;
     melLength = samples;
 
-    melbanks = List<Float64List>.generate(
-      melCount,
-      (_) => Float64List(melLength),
-    );
-    melbanksFiltered = List<Float64List>.generate(
-      melCount,
-      (_) => Float64List(melLength),
-    );
+    melbanks = [for (final proc in melbankProcessors) proc.processor.raw];
+    melbanksFiltered = [
+      for (final proc in melbankProcessors) proc.processor.filtered,
+    ];
 
     minVolume = audio.minVolume;
   }
 
+  bool _disposed = false;
+
+  /// Whether [dispose] freed the native filterbanks.
+  bool get isDisposed => _disposed;
+
+  /// Frees the native filterbanks and melbank processors; [melbanks] and
+  /// [melbanksFiltered] must not be read afterwards. Safe to call twice.
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+    for (final proc in melbankProcessors) {
+      proc.dispose();
+    }
+    filterbanks.dispose();
+  }
+
   execute() {
     final freqDomain = audio.freqDomain;
     final volumeThreshould = (audio.volume(filtered: true) > minVolume);
 
     if (volumeThreshould) {
-      for (final (i, proc) in melbankProcessors.indexed) {
-        proc.execute(freqDomain, melbanks[i], melbanksFiltered[i]);
+      filterbanks.process(freqDomain);
+      for (final proc in melbankProcessors) {
+        proc.execute();
       }
     } else {
       for (final melbank in melbanks) {
@@ -135,9 +158,11 @@ class Melbanks {
 class Melbank {
   final AudioAnalysisSource audio;
   final MelbankConfig config;
+  final LedfxFilterbank filterbanks;
 
   late double powerFactor;
-  late Pointer<aubio_filterbank_t> filterBank;
+  // Index of this melbank's filters in [filterbanks]
+  late int bank;
   late Float64List melbankFreqsFloat;
   late Int32List melbankFreqs;
 
@@ -145,12 +170,14 @@ class Melbank {
   late int midsIndex;
   late int highsIndex;
 
-  late ExpFilter melGain;
-  late ExpFilter melSmoothing;
-  late ExpFilter commonFilter;
-  late ExpFilter diffFilter;
+  // Power law, gain and smoothing filters, writing the melbank outputs
+  late LedfxMelbank processor;
 
-  Melbank({required this.audio, required this.config}) {
+  Melbank({
+    required this.audio,
+    required this.config,
+    required this.filterbanks,
+  }) {
     powerFactor = tan(0.5 * pi * (config.peakIsolation + 1) / 2);
     switch (config.coeffType) {
       case CoeffType.mattmel:
@@ -163,8 +190,7 @@ class Melbank {
           melbankMatt.map((mel) => mattTOhz(mel)).toList(),
         );
 
-        filterBank = Aubio.createFilterBank(config.samples, FFT_SIZE);
-        filterBank.setTriangleBandsF32(
+        bank = filterbanks.addTriangleBands(
           freqs: melbankFreqsFloat,
           sampleRate: MIC_RATE,
         );
@@ -192,46 +218,17 @@ class Melbank {
       }
     }
 
-    // setup some of the common filters
-    melGain = ExpFilter(alphaDecay: 0.01, alphaRise: 0.99);
-    melSmoothing = ExpFilter(alphaDecay: 0.7, alphaRise: 0.99);
-    commonFilter = ExpFilter(alphaDecay: 0.99, alphaRise: 0.01);
-    diffFilter = ExpFilter(alphaDecay: 0.15, alphaRise: 0.99);
+    processor = LedfxMelbank(config.samples, powerFactor);
+  }
+  // computes the melbank curve from the filterbank output of the
+  // current hop (see Melbanks.execute) into processor.raw and
+  // processor.filtered.
+  void execute() {
+    processor.process(filterbanks.outputVector(bank));
   }
-  // computes the melbank curve for frequency domain .
-  void execute(
-    Pointer<cvec_t> freqDomain,
-    Float64List melbank,
-    Float64List filteredMelbank,
-  ) {
-    // copyListContents(melbank, filterBank.process(freqDomain, melbank.length));
-    melbank.setAll(0, filterBank.process(freqDomain, melbank.length));
-
-    for (int i = 0; i < melbank.length; i++) {
-      melbank[i] = pow(melbank[i], powerFactor).toDouble();
-    }
-    melGain.update(maxOfList(fastBlurArray(melbank, 1.0)));
-
-    final double gainValue = melGain.value.toDouble();
-    for (int i = 0; i < melbank.length; i++) {
-      // Check for near-zero division, which is crucial for stability
-      if (gainValue.abs() > 1e-9) {
-        melbank[i] /= gainValue;
-      } else {
-        melbank[i] = 0.0; // Prevent division by zero
-      }
-    }
-
-    List<double> smoothedBanks = melSmoothing.update(melbank);
-    copyListContents(melbank, smoothedBanks);
-
-    commonFilter.update(melbank);
 
-    List<double> differenceArray = List<double>.generate(melbank.length, (i) {
-      return melbank[i] - commonFilter.value[i];
-    });
-    List<double> diffFiltered = diffFilter.update(differenceArray);
-    copyListContents(filteredMelbank, diffFiltered);
+  void dispose() {
+    processor.dispose();
   }
 }
 
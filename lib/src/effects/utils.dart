@@ -1,5 +1,6 @@
 import 'dart:math';
-import 'dart:typed_data';
+
+import 'package:ledfx/src/pixel_frame.dart';
 
 List<double> equallySpacedDoublesList(double start, double end, int count) {
   if (count <= 0) return <double>[];
@@ -33,90 +34,6 @@ void copyListContents<T>(List<T> destination, List<T> source) {
   }
 }
 
-/// Implements the circular shift functionality, equivalent to numpy.roll(array, shift, axis=0).
-/// Shifts the elements of a list by 'offset' places.
-List<T> rollList<T>(List<T> list, int offset) {
-  if (list.isEmpty) {
-    return [];
-  }
-
-  // Calculate the actual effective shift
-  int effectiveShift = offset % list.length;
-  if (effectiveShift == 0) {
-    return List<T>.from(list); // No shift needed, return a copy
-  }
-
-  // Create a new list for the rolled result
-  List<T> rolled = List<T>.filled(list.length, list[0]);
-
-  // Determine the split point and copy the parts in reversed order
-  for (int i = 0; i < list.length; i++) {
-    // New index = (current index - shift) % length
-    // Dart's % operator can return negative results, so we use the helper to ensure a positive index.
-    int newIndex = (i + effectiveShift) % list.length;
-
-    // Ensure the index is positive (crucial for Dart's modulo behavior)
-    if (newIndex < 0) {
-      newIndex += list.length;
-    }
-
-    rolled[newIndex] = list[i];
-  }
-
-  return rolled;
-}
-
-// T is used to represent the inner type (Float64List or List<double>)
-List<T> getSlice<T>(List<T> data, int start, int stop, int step) {
-  if (step == 0) {
-    throw ArgumentError('Step cannot be zero.');
-  }
-
-  // Normalize the indices to handle negative values and bounds,
-  // similar to how Python handles slicing.
-  int N = data.length;
-
-  // Default Python start/stop behavior
-  if (start < 0) start += N;
-  if (stop < 0) stop += N;
-
-  // Python slicing allows stop indices past the end of the list.
-  if (stop > N) stop = N;
-  if (start > N) start = N;
-
-  // Ensure start/stop are not negative after normalization
-  if (start < 0) start = 0;
-  if (stop < 0) stop = 0;
-
-  // Determine the direction of the loop
-  if (step > 0) {
-    // Standard forward slice (e.g., [1:10:2])
-    // Ensure start is less than stop
-    if (start >= stop) return [];
-
-    return List<T>.generate(
-      ((stop - start - 1) ~/ step) + 1, // Calculate the number of elements
-      (i) => data[start + i * step],
-    );
-  } else {
-    // Reverse slice (e.g., [10:1:-1])
-    // Ensure start is greater than stop
-    if (start <= stop) return [];
-
-    // The logic is slightly complex for negative step; a simpler while loop is clearer.
-    List<T> result = [];
-    int i = start;
-
-    while (i > stop) {
-      if (i >= 0 && i < N) {
-        result.add(data[i]);
-      }
-      i += step;
-    }
-    return result;
-  }
-}
-
 // Utility function to simulate numpy.linspace
 List<double> linspace(double start, double end, int num) {
   if (num <= 1) {
@@ -171,45 +88,6 @@ List<double> interp(List<double> x, List<double> xp, List<double> fp) {
   return result;
 }
 
-List<Float64List> repeatAndTruncatePixels(
-  List<Float64List> effectivePixels,
-  int groupSize,
-  int pixelCount,
-) {
-  if (effectivePixels.isEmpty || groupSize <= 0) {
-    return [];
-  }
-
-  // 1. Repetition (Equivalent to np.repeat(..., axis=0))
-  List<Float64List> repeatedPixels = [];
-
-  // Iterate through each row in the original array
-  for (final Float64List row in effectivePixels) {
-    // Repeat the current row 'groupSize' times
-    for (int i = 0; i < groupSize; i++) {
-      // Add a reference to the row.
-      // NOTE: This creates a shallow copy (a new list of references
-      // to the same Float64List objects), which matches NumPy's behavior
-      // after a repeat operation if the result isn't explicitly copied/modified.
-      repeatedPixels.add(row);
-    }
-  }
-
-  // 2. Truncation (Equivalent to [:pixel_count, :])
-  // Slice the resulting array to only keep the first 'pixel_count' rows.
-  // The Dart List.sublist method handles this perfectly.
-
-  int actualLength = repeatedPixels.length;
-
-  if (pixelCount >= actualLength) {
-    // If pixel_count is larger than the repeated array size, return the full repeated array.
-    return repeatedPixels;
-  } else {
-    // Return only the first 'pixel_count' rows.
-    return repeatedPixels.sublist(0, pixelCount);
-  }
-}
-
 /// A fixed-size, auto-dropping circular buffer (like Python's
 /// collections.deque(maxlen=...)).
 class CircularBuffer<T extends Object> {
@@ -350,16 +228,20 @@ class FixedSizeQueue<T> {
 ///   hues (List<double>): Array of hue values (0 to 1).
 ///   saturation (double between 0 and 1): The saturation.
 ///   value (double between 0 and 1): The value.
+///   out (PixelFrame, optional): Frame of hues.length pixels to write into.
 ///
 /// Returns:
-///   List<Float64List>: An array of RGB values where each RGB value is in the range 0 to 255.
-List<Float64List> hsvToRgb(List<double> hues, double saturation, double value) {
-  if (hues.isEmpty) {
-    return [];
-  }
-
+///   PixelFrame: An array of RGB values where each RGB value is in the range 0 to 255.
+PixelFrame hsvToRgb(
+  List<double> hues,
+  double saturation,
+  double value, [
+  PixelFrame? out,
+]) {
   int pixelCount = hues.length;
-  List<Float64List> rgbArray = List.generate(pixelCount, (_) => Float64List(3));
+  final PixelFrame rgbArray = (out != null && out.length == pixelCount)
+      ? out
+      : PixelFrame(pixelCount);
 
   // The six possible values for R, G, B channels based on intermediate calculation
   final double p = value * (1.0 - saturation);
@@ -450,20 +332,18 @@ List<Float64List> hsvToRgb(List<double> hues, double saturation, double value) {
     }
 
     // 5. Scale to 0-255 range and store (Equivalent to return rgb * 255)
-    rgbArray[idx][0] = R * 255.0;
-    rgbArray[idx][1] = G * 255.0;
-    rgbArray[idx][2] = B * 255.0;
+    rgbArray.setPixel(idx, R * 255.0, G * 255.0, B * 255.0);
   }
 
   return rgbArray;
 }
 
-List<Float64List> fillRainbow(
-  List<Float64List> pixels,
+PixelFrame fillRainbow(
+  PixelFrame pixels,
   double initialHue,
   double deltaHue,
 ) {
-  // The input 'pixels' array is used only to determine the final size (pixelCount).
+  // The rainbow is written over 'pixels', which also gives the final size (pixelCount).
   final int pixelCount = pixels.length;
 
   const double sat = 0.95;
@@ -482,9 +362,8 @@ List<Float64List> fillRainbow(
   }
 
   // --- Convert to RGB ---
-  // The hsvToRgb function is expected to return the final List<Float64List>
-  // with dimensions [pixelCount, 3].
-  return hsvToRgb(hues, sat, val);
+  // The hsvToRgb function fills the [pixelCount, 3] frame in place.
+  return hsvToRgb(hues, sat, val, pixels);
 }
 
 // Simplified Polynomial class for the required functionality for kernel
@@ -657,13 +536,16 @@ List<double> convolveSame(List<double> array, List<double> kernel) {
 }
 
 // A helper function to extract a column (R=0, G=1, B=2)
-List<double> getColumn(List<Float64List> pixels, int colIndex) {
-  return pixels.map((row) => row[colIndex]).toList();
+List<double> getColumn(PixelFrame pixels, int colIndex) {
+  return List<double>.generate(
+    pixels.length,
+    (i) => pixels.data[3 * i + colIndex],
+  );
 }
 
 // A helper function to update a column with convolved values
-void setColumn(List<Float64List> pixels, int colIndex, List<double> newValues) {
+void setColumn(PixelFrame pixels, int colIndex, List<double> newValues) {
   for (int i = 0; i < pixels.length; i++) {
-    pixels[i][colIndex] = newValues[i];
+    pixels.data[3 * i + colIndex] = newValues[i];
   }
 }
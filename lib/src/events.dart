@@ -4,6 +4,7 @@ import 'dart:typed_data';
 
 import 'package:flutter/painting.dart';
 import 'package:ledfx/src/core.dart';
+import 'package:ledfx/src/pixel_frame.dart';
 
 sealed class LEDFxEvent {
   static const CORE_SHUTDOWN = 'shutdown';
@@ -112,7 +113,7 @@ class DevicesUpdatedEvent extends LEDFxEvent {
 
 class DeviceUpdateEvent extends LEDFxEvent {
   final String deviceID;
-  final List<Float64List> pixels;
+  final PixelFrame pixels;
   const DeviceUpdateEvent(this.deviceID, this.pixels)
     : super(LEDFxEvent.DEVICE_UPDATE);
 
@@ -124,7 +125,7 @@ class DeviceUpdateEvent extends LEDFxEvent {
 
 class VirtualUpdateEvent extends LEDFxEvent {
   final String virtualID;
-  final List<Float64List> pixels;
+  final PixelFrame pixels;
   const VirtualUpdateEvent(this.virtualID, this.pixels)
     : super(LEDFxEvent.VIRTUAL_UPDATE);
   @override
@@ -136,7 +137,8 @@ class VirtualUpdateEvent extends LEDFxEvent {
 class VisualisationUpdateEvent extends LEDFxEvent {
   final bool isDevice;
   final String visID;
-  final List<Float64List> pixels;
+  // One row per channel, r, g, b, each one value per pixel.
+  final List<Float32List> pixels;
   final List<int> shape;
 
   VisualisationUpdateEvent(this.visID, this.pixels, this.shape, this.isDevice)
@@ -0,0 +1,142 @@
+import 'dart:typed_data';
+
+/// A strip of RGB pixels stored in a single contiguous buffer, interleaved
+/// r, g, b per pixel: 12 bytes a pixel and one heap object per frame, rather
+/// than a `Float64List(3)` per pixel.
+///
+/// [data] is a plain [Float32List], so a frame can wrap native memory (the
+/// `frame` of a LedfxPostprocess, the `rgb` of a LedfxGradient) and be handed
+/// to native code without copies. [view] slices without copying, [setFrom]
+/// and the other helpers copy in bulk.
+class PixelFrame {
+  final Float32List data;
+
+  /// A frame of [length] black pixels.
+  PixelFrame(int length) : data = Float32List(3 * length);
+
+  /// Wraps [data], 3 values per pixel. Writes go to [data] and vice versa.
+  PixelFrame.view(this.data) {
+    if (data.length % 3 != 0) {
+      throw ArgumentError('Expected 3 values per pixel, got ${data.length}');
+    }
+  }
+
+  /// A copy of [other] in its own buffer.
+  PixelFrame.from(PixelFrame other) : data = Float32List.fromList(other.data);
+
+  static final PixelFrame empty = PixelFrame(0);
+
+  int get length => data.length ~/ 3;
+  bool get isEmpty => data.isEmpty;
+  bool get isNotEmpty => data.isNotEmpty;
+
+  double red(int i) => data[3 * i];
+  double green(int i) => data[3 * i + 1];
+  double blue(int i) => data[3 * i + 2];
+
+  void setPixel(int i, double r, double g, double b) {
+    data[3 * i] = r;
+    data[3 * i + 1] = g;
+    data[3 * i + 2] = b;
+  }
+
+  /// Pixels [start] to [end] (exclusive), sharing this frame's buffer.
+  PixelFrame view(int start, [int? end]) {
+    end = RangeError.checkValidRange(start, end, length);
+    return PixelFrame.view(Float32List.sublistView(data, 3 * start, 3 * end));
+  }
+
+  /// Copies all of [source] over the pixels starting at [at].
+  void setFrom(PixelFrame source, [int at = 0]) {
+    data.setRange(3 * at, 3 * (at + source.length), source.data);
+  }
+
+  /// Copies [source] in reverse pixel order over the pixels starting at [at].
+  void setReversed(PixelFrame source, [int at = 0]) {
+    final s = source.data, d = data;
+    final int n = source.length;
+    for (int i = 0; i < n; i++) {
+      final int from = 3 * (n - 1 - i), to = 3 * (at + i);
+      d[to] = s[from];
+      d[to + 1] = s[from + 1];
+      d[to + 2] = s[from + 2];
+    }
+  }
+
+  /// Sets pixels [start] to [end] (exclusive), all of them by default, to
+  /// one colour.
+  void fill(double r, double g, double b, [int start = 0, int? end]) {
+    end = RangeError.checkValidRange(start, end, length);
+    for (int i = 3 * start; i < 3 * end; i += 3) {
+      data[i] = r;
+      data[i + 1] = g;
+      data[i + 2] = b;
+    }
+  }
+
+  /// Sets pixels [start] to [end] (exclusive), all of them by default, to
+  /// black.
+  void clear([int start = 0, int? end]) {
+    end = RangeError.checkValidRange(start, end, length);
+    data.fillRange(3 * start, 3 * end, 0.0);
+  }
+
+  /// Limits every value to [lower]..[upper] in place.
+  void clamp(double lower, double upper) {
+    final d = data;
+    for (int i = 0; i < d.length; i++) {
+      final v = d[i];
+      if (v < lower) {
+        d[i] = lower;
+      } else if (v > upper) {
+        d[i] = upper;
+      }
+    }
+  }
+
+  /// Writes this frame moved forward by [offset] pixels, wrapping around,
+  /// into [out] (numpy.roll along the pixels). [out] must have the same
+  /// length and another buffer.
+  PixelFrame rollInto(PixelFrame out, int offset) {
+    final int n = length;
+    if (out.length != n) {
+      throw ArgumentError('Expected $n pixels, got ${out.length}');
+    }
+    if (n == 0) return out;
+    final int shift = offset % n;
+    out.data
+      ..setRange(3 * shift, 3 * n, data)
+      ..setRange(0, 3 * shift, data, 3 * (n - shift));
+    return out;
+  }
+
+  /// Writes each pixel [groupSize] times into [out], truncated to the length
+  /// of [out] (numpy.repeat then a slice). Pixels past the repeated strip
+  /// are left as they are.
+  PixelFrame repeatInto(PixelFrame out, int groupSize) {
+    final s = data, d = out.data;
+    final int n = out.length;
+    int to = 0;
+    for (int i = 0; i < length && to < n; i++) {
+      final r = s[3 * i], g = s[3 * i + 1], b = s[3 * i + 2];
+      for (int k = 0; k < groupSize && to < n; k++, to++) {
+        d[3 * to] = r;
+        d[3 * to + 1] = g;
+        d[3 * to + 2] = b;
+      }
+    }
+    return out;
+  }
+
+  /// Converts to bytes, truncated and clamped to 0..255, into [out] if it
+  /// has 3 [length] bytes or a new list otherwise.
+  Uint8List toBytes([Uint8List? out]) {
+    final d = data;
+    if (out == null || out.length != d.length) out = Uint8List(d.length);
+    for (int i = 0; i < d.length; i++) {
+      final v = d[i];
+      out[i] = v <= 0.0 ? 0 : (v >= 255.0 ? 255 : v.toInt());
+    }
+    return out;
+  }
+}
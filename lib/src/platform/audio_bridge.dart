@@ -5,19 +5,108 @@ import 'package:equatable/equatable.dart';
 import 'package:flutter/services.dart';
 import 'package:permission_handler/permission_handler.dart';
 
+import 'pipeline_stats.dart';
+
+export 'pipeline_stats.dart';
+
 /// Sealed union of all events from the native bridge
 sealed class RecordingEvent {
   const RecordingEvent();
 }
 
+/// Binary audio packet sent by the platform runners as `[header, samples]`.
+///
+/// The header is [headerSize] little-endian bytes (layout shared with
+/// `src/ledfx/audio_packet.h`): u8 version, u8 channels, u16 flags,
+/// u32 sequence, u64 capture timestamp in microseconds.
+///
+/// A runner that coalesces blocks sends `[header, samples, lengths]`:
+/// [samples] then holds the blocks back to back, [hopLengths] their sample
+/// counts, the header describing the first.
 class AudioEvent extends RecordingEvent {
-  final Float64List data;
-  AudioEvent(List<Object?> adata)
-    : data = Float64List.fromList(
-        adata.map((e) {
-          return (e == null) ? 0.0 : e as double;
-        }).toList(),
-      );
+  static const int version = 1;
+  static const int headerSize = 16;
+
+  /// The device reported the block as silent.
+  static const int flagSilent = 1 << 0;
+
+  /// Samples were lost between this block and the previous one.
+  static const int flagDiscontinuity = 1 << 1;
+
+  /// The samples went to the sink registered with [AudioBridge.setPcmSink]
+  /// and the event carries none.
+  static const int flagPcmSink = 1 << 2;
+
+  final Float32List samples;
+  final int channels;
+  final int flags;
+  final int sequence;
+  final int timestampUs;
+
+  /// Sample count of each block in [samples], null for a single block.
+  final Int32List? hopLengths;
+
+  AudioEvent(
+    this.samples, {
+    this.channels = 1,
+    this.flags = 0,
+    this.sequence = 0,
+    this.timestampUs = 0,
+    this.hopLengths,
+  });
+
+  /// Decodes a `[Uint8List header, Float32List samples, Int32List? lengths]`
+  /// event.
+  factory AudioEvent.fromPacket(
+    Uint8List header,
+    Float32List samples, [
+    Int32List? hopLengths,
+  ]) {
+    if (header.lengthInBytes < headerSize || header[0] != version) {
+      throw FormatException("Unsupported audio packet header");
+    }
+    if (hopLengths != null &&
+        (hopLengths.isEmpty ||
+            hopLengths.any((length) => length < 0) ||
+            hopLengths.fold<int>(0, (sum, length) => sum + length) !=
+                samples.length)) {
+      throw FormatException("Malformed coalesced audio packet");
+    }
+    final bd = ByteData.sublistView(header);
+    return AudioEvent(
+      samples,
+      channels: bd.getUint8(1),
+      flags: bd.getUint16(2, Endian.little),
+      sequence: bd.getUint32(4, Endian.little),
+      timestampUs: bd.getUint64(8, Endian.little),
+      hopLengths: hopLengths,
+    );
+  }
+
+  /// Number of blocks in [samples].
+  int get hops => hopLengths?.length ?? 1;
+
+  /// Blocks of [samples] in order, as views.
+  Iterable<Float32List> get blocks sync* {
+    final lengths = hopLengths;
+    if (lengths == null) {
+      yield samples;
+      return;
+    }
+    var start = 0;
+    for (final length in lengths) {
+      yield Float32List.sublistView(samples, start, start + length);
+      start += length;
+    }
+  }
+
+  bool get isSilent => (flags & flagSilent) != 0;
+  bool get isDiscontinuity => (flags & flagDiscontinuity) != 0;
+  bool get isPcmSink => (flags & flagPcmSink) != 0;
+
+  /// Samples widened to double precision, converted once on first use.
+  late final Float64List data = Float64List(samples.length)
+    ..setAll(0, samples);
 }
 
 class DevicesInfoEvent extends RecordingEvent {
@@ -71,6 +160,11 @@ enum AudioDeviceType { input, output }
 
 enum AudioCaptureType { microphone, systemAudio }
 
+/// What the runner does with audio blocks queued while the platform thread
+/// was busy: send them all, send the newest few, or send the newest few in
+/// one event.
+enum AudioDeliveryMode { deliverAll, dropOldest, coalesce }
+
 class StateEvent extends RecordingEvent {
   /// e.g. "started", "paused", "resumed", "stopped"
   final String state;
@@ -85,11 +179,22 @@ class ErrorEvent extends RecordingEvent {
 class AudioBridge {
   AudioBridge._() {
     _event.receiveBroadcastStream().listen((event) {
-      if (event is Map) {
+      if (event is List) {
+        // Audio is the only high-rate event and is sent as a bare
+        // [header, samples] list to skip the map and per-sample boxing.
+        try {
+          _controller.add(
+            AudioEvent.fromPacket(
+              event[0],
+              event[1],
+              event.length > 2 ? event[2] : null,
+            ),
+          );
+        } on FormatException catch (e) {
+          _controller.add(ErrorEvent(e.message));
+        }
+      } else if (event is Map) {
         switch (event["type"]) {
-          case "audio":
-            _controller.add(AudioEvent(event["data"]));
-            break;
           case "state":
             _controller.add(StateEvent(event["value"]));
             break;
@@ -167,6 +272,72 @@ class AudioBridge {
   }
 
   Future<bool?> stop() async => await _method.invokeMethod('stopRecording');
+
+  /// Sets how the runner delivers audio blocks that piled up while the
+  /// platform thread was busy. Windows only; returns false elsewhere.
+  Future<bool> setDeliveryPolicy(
+    AudioDeliveryMode mode, {
+    int? maxDepth,
+    int? coalesceHops,
+  }) async {
+    try {
+      await _method.invokeMethod('setAudioDeliveryPolicy', {
+        "mode": mode.name,
+        if (maxDepth != null) "maxDepth": maxDepth,
+        if (coalesceHops != null) "coalesceHops": coalesceHops,
+      });
+      return true;
+    } on MissingPluginException {
+      return false;
+    }
+  }
+
+  /// Has the runner push captured audio into the native PCM sink at
+  /// [address] (`LedfxPcm.address`), 0 to stop. Audio events then carry no
+  /// samples and only signal that hops are waiting in the sink. Once the
+  /// future completes the runner no longer uses the previous sink. Windows
+  /// only; returns false elsewhere.
+  Future<bool> setPcmSink(int address) async {
+    try {
+      await _method.invokeMethod('setPcmSink', {"address": address});
+      return true;
+    } on MissingPluginException {
+      return false;
+    } on PlatformException {
+      return false;
+    }
+  }
+
+  /// Latency of each pipeline stage since the last reset, or null where not
+  /// supported. [reset] clears the histograms after reading them.
+  Future<Map<PipelineStage, LatencySummary>?> getPipelineStats({
+    bool reset = false,
+  }) async {
+    try {
+      final stats = await _method.invokeMethod<Map>('getPipelineStats', {
+        "reset": reset,
+      });
+      if (stats == null) return null;
+      return {
+        for (final stage in PipelineStage.values)
+          stage: LatencySummary.fromMap(stats[stage.name] ?? const {}),
+      };
+    } on MissingPluginException {
+      return null;
+    }
+  }
+
+  /// Delivery counters of the runner (queued, messages, delivered,
+  /// droppedOldest, droppedOverflow, coalesced, wakeups, highWater), or null
+  /// where not supported.
+  Future<Map<String, int>?> getDeliveryStats() async {
+    try {
+      final stats = await _method.invokeMethod<Map>('getAudioDeliveryStats');
+      return stats?.cast<String, int>();
+    } on MissingPluginException {
+      return null;
+    }
+  }
   Future<bool?> pause() async => await _method.invokeMethod('pauseRecording');
   Future<bool?> resume() async => await _method.invokeMethod('resumeRecording');
 
@@ -0,0 +1,64 @@
+import 'dart:ffi';
+import 'dart:io' show Platform;
+
+/// Points of the audio path at which the age of a hop is measured, from its
+/// capture timestamp. Indices are shared with `src/ledfx/pipeline_stats.h`.
+///
+/// [submitted] is when a device frame is handed to the native output
+/// scheduler, not when it goes out on the network: the scheduler sends it
+/// at the device's next deadline, up to one refresh period later.
+enum PipelineStage { queued, sent, analysed, submitted }
+
+/// Latency distribution of one [PipelineStage], in microseconds.
+class LatencySummary {
+  final int count;
+  final int p50Us;
+  final int p99Us;
+  final int maxUs;
+  final int meanUs;
+
+  const LatencySummary({
+    this.count = 0,
+    this.p50Us = 0,
+    this.p99Us = 0,
+    this.maxUs = 0,
+    this.meanUs = 0,
+  });
+
+  factory LatencySummary.fromMap(Map map) => LatencySummary(
+    count: map["count"] ?? 0,
+    p50Us: map["p50Us"] ?? 0,
+    p99Us: map["p99Us"] ?? 0,
+    maxUs: map["maxUs"] ?? 0,
+    meanUs: map["meanUs"] ?? 0,
+  );
+
+  @override
+  String toString() =>
+      "n=$count p50=${p50Us}us p99=${p99Us}us max=${maxUs}us";
+}
+
+/// Records the stages measured in Dart into the histograms of the runner,
+/// which exports `ledfx_pipeline_record` from its executable. A no-op where
+/// the runner does not (everywhere but Windows).
+class PipelineProbe {
+  static final void Function(int, int)? _record = _lookup();
+
+  static void Function(int, int)? _lookup() {
+    if (!Platform.isWindows) return null;
+    try {
+      return DynamicLibrary.executable()
+          .lookupFunction<Void Function(Int32, Int64), void Function(int, int)>(
+            'ledfx_pipeline_record',
+          );
+    } on ArgumentError {
+      return null;
+    }
+  }
+
+  /// Records that a hop captured at [captureUs] (the timestamp of its
+  /// AudioEvent) reached [stage] now.
+  static void record(PipelineStage stage, int captureUs) {
+    if (captureUs != 0) _record?.call(stage.index, captureUs);
+  }
+}
@@ -2,12 +2,13 @@ import 'dart:async';
 import 'dart:math';
 
 import 'package:flutter/foundation.dart';
+import 'package:ledfx/ledfx_native.dart';
 import 'package:ledfx/src/core.dart';
 import 'package:ledfx/src/devices/device.dart' show Device;
 import 'package:ledfx/src/effects/const.dart';
 import 'package:ledfx/src/effects/effect.dart';
-import 'package:ledfx/src/effects/utils.dart';
 import 'package:ledfx/src/events.dart';
+import 'package:ledfx/src/pixel_frame.dart';
 import 'package:nanoid/nanoid.dart';
 
 enum TransitionMode { add }
@@ -177,7 +178,7 @@ class Virtual {
         step = 1;
       } else {
         start = dataStart + segWidth - 1;
-        stop = (dataStart == 0) ? 0 : dataStart - 1;
+        stop = dataStart - 1;
         step = -1;
       }
 
@@ -194,6 +195,11 @@ class Virtual {
     return _cachedSegmentByDevice!;
   }();
 
+  // Segments of each device compiled into gather tables, and the frame they
+  // read from, in native memory.
+  Map<String, LedfxMapping>? _cachedMappings;
+  LedfxPixels? _flushPixels;
+
   int? _cachedEffectivePixelCount;
   int get effectivePixelCount => () {
     if (_cachedEffectivePixelCount != null) return _cachedEffectivePixelCount!;
@@ -221,9 +227,14 @@ class Virtual {
     _active = false;
   }
 
-  Timer? _frameTimer;
-  double _frameInterval = 0.001; // Calculated sleep time
-  double fpsToSleepInterval(int fps) => max(0.001, 1 / fps);
+  // Frames are rendered on absolute deadlines, _frameIntervalUs apart on
+  // the render clock of Virtuals, which renders every virtual due at once.
+  int _frameIntervalUs = 1000;
+  int _nextFrameUs = 0;
+
+  // Native part of each frame, and the devices it was written onto.
+  LedfxRender? _render;
+  final List<Device> _renderedDevices = [];
   void activate() {
     if (devices.isEmpty) {
       print("no devices setup");
@@ -245,68 +256,79 @@ class Virtual {
       }
       _osActive = false; // Reset OS active flag
     }
-    // Calculate the base interval needed for the desired FPS
-    _frameInterval = fpsToSleepInterval(refreshRate);
+    _frameIntervalUs = max(1000, (1000000 / refreshRate).round());
     print("starting virtual loop");
-    _frameTimer = Timer.periodic(
-      Duration(milliseconds: (_frameInterval * 1000).round()),
-      _virtualLoop,
-    );
+    _nextFrameUs = ledfx.virtuals._renderClock.elapsedMicroseconds;
+    _advanceFrame(_nextFrameUs);
+    ledfx.virtuals._scheduleRender();
+  }
+
+  void _advanceFrame(int now) {
+    _nextFrameUs += _frameIntervalUs;
+    if (_nextFrameUs <= now) {
+      // Skip the deadlines already past rather than rendering a burst.
+      final late = now - _nextFrameUs;
+      _nextFrameUs += (late ~/ _frameIntervalUs + 1) * _frameIntervalUs;
+    }
   }
 
   void deactivate() {
     _active = false;
-    _frameTimer?.cancel();
-    _frameTimer = null;
     _osActive = false;
 
     deactivateSegments();
+    _disposeMappings();
+    _flushPixels?.dispose();
+    _flushPixels = null;
+    _render?.dispose();
+    _render = null;
+    _renderedDevices.clear();
     ledfx.events.fireEvent(VirtualPauseEvent(id));
     ledfx.virtuals.checkAndDeactivateDevices();
   }
 
-  void _virtualLoop(Timer timer) {
-    if (!_active) {
-      timer.cancel();
-      return;
-    }
-
-    // final startTime = DateTime.now().microsecondsSinceEpoch;
-
+  /// Renders the effect and sets up the native rest of the frame: its
+  /// post-processing and the devices it goes to. Returns the task for
+  /// [LedfxPool.run], or null if there is nothing to render.
+  LedfxRender? _prepareFrame() {
     if (fallbackFire) {
       setFallback();
       fallbackFire = false;
     }
 
-    if (activeEffect != null &&
-        activeEffect!.isActive &&
-        activeEffect!.pixels != null) {
-      _assembledFrame = assembleFrame();
-      if (_assembledFrame != null && !paused) {
-        if (!config.previewOnly) {
-          flush();
-        }
-        fireUpdateEvent();
-      }
+    final effect = activeEffect;
+    if (effect == null || !effect.isActive || effect.pixels == null) {
+      return null;
     }
-
-    // --- Frame Rate Adjustment (Replacing time.sleep) ---
-
-    // 4. Calculate actual runtime and adjust for the next frame.
-    // final double runTimeSeconds =
-    //     (DateTime.now().microsecondsSinceEpoch - startTime) / 1000000.0;
-
-    // // Calculate required sleep time
-    // double sleepTimeSeconds = max(0.001, _frameInterval - runTimeSeconds);
-
-    // If timing must be precise, cancel and reschedule the timer.
-    /*
-    timer.cancel();
-    _frameTimer = Timer(Duration(milliseconds: (sleepTimeSeconds * 1000).round()), () {
-        // Run the logic again
-        _threadFunction(timer); 
+    effect.render();
+    final post = effect.preparePixels();
+    if (post == null) return null;
+
+    final render = (_render ??= LedfxRender())..setFrame(post);
+    _renderedDevices.clear();
+    if (paused || config.previewOnly || _calibration) return render;
+    if (config.mapping != "span" && config.mapping != "copy") return render;
+    segmentsByDevice.forEach((deviceID, segments) {
+      final device = ledfx.devices.devices[deviceID];
+      if (device == null || !device.isActive) return;
+      final mapping = _mapping(device, segments, post.pixelCount);
+      final output = device.targetFor(id, mapping);
+      if (output == null) return;
+      render.addTarget(mapping, output);
+      _renderedDevices.add(device);
     });
-    */
+    return render;
+  }
+
+  /// Flushes the devices and fires the update event once the task of
+  /// [_prepareFrame] has run.
+  void _finishFrame() {
+    _assembledFrame = activeEffect?.processedPixels;
+    if (paused) return;
+    for (final device in _renderedDevices) {
+      device.flushPixels(id);
+    }
+    fireUpdateEvent();
   }
 
   void invalidateCache() {
@@ -316,6 +338,12 @@ class Virtual {
     _cachedSegmentByDevice = null;
     _cachedEffectivePixelCount = null;
     _cachedGroupSize = null;
+    _disposeMappings();
+  }
+
+  void _disposeMappings() {
+    _cachedMappings?.forEach((_, mapping) => mapping.dispose());
+    _cachedMappings = null;
   }
 
   void activateSegments(List<SegmentConfig> segments) {
@@ -367,59 +395,83 @@ class Virtual {
   clearFrame() {}
   void reactivateEffect() {}
 
-  void flush([List<Float64List>? pixels]) {
+  void flush([PixelFrame? pixels]) {
     pixels = pixels ?? _assembledFrame;
     if (pixels == null) return;
+    if (config.mapping != "span" && config.mapping != "copy") return;
+
+    final frame = _flushFrame(pixels.length)..data.setAll(0, pixels.data);
+
     segmentsByDevice.forEach((deviceID, segments) {
-      var data = <(List<Float64List>, int, int)>[];
       final device = ledfx.devices.devices[deviceID];
 
       if (device != null && device.isActive) {
         if (_calibration) {
           // renderCalibration(data, device, segments, deviceID);
-        } else if (config.mapping == "span") {
-          for (final (start, stop, step, devStart, devEnd) in segments) {
-            final seg = getSlice(pixels!, start, stop, step);
-            data.add((seg, devStart, devEnd));
-          }
-        } else if (config.mapping == "copy") {
-          for (final (start, stop, step, devStart, devEnd) in segments) {
-            final targetPhysicalLen = devEnd - devStart + 1;
-            final targetEffectLen = _getEffectivePixelCount(targetPhysicalLen);
-            var seg = getSlice(pixels!, start, stop, step);
-
-            seg = effectiveToPhysicalPixels(seg, targetPhysicalLen);
-            data.add((seg, devStart, devEnd));
-          }
+        } else {
+          final mapping = _mapping(device, segments, frame.pixelCount);
+          device.updatePixels(id, mapping, frame);
         }
-
-        device.updatePixels(id, data);
       }
     });
   }
 
+  // Native copy of the frame for the mappings, reused while its size holds.
+  LedfxPixels _flushFrame(int pixelCount) {
+    final frame = _flushPixels;
+    if (frame != null && frame.pixelCount == pixelCount) return frame;
+    frame?.dispose();
+    return _flushPixels = LedfxPixels(pixelCount);
+  }
+
+  /// Compiles the segments of [device] into its [LedfxMapping] for frames of
+  /// [framePixels] pixels, reused until [invalidateCache] or the frame or
+  /// device size changes.
+  LedfxMapping _mapping(
+    Device device,
+    List<(int, int, int, int, int)> segments,
+    int framePixels,
+  ) {
+    final mappings = _cachedMappings ??= {};
+    final cached = mappings[device.id];
+    if (cached != null &&
+        cached.inputPixels == framePixels &&
+        cached.outputPixels == device.pixelCount) {
+      return cached;
+    }
+    cached?.dispose();
+    return mappings[device.id] = LedfxMapping(
+      mode: config.mapping == "copy"
+          ? LedfxMappingMode.copy
+          : LedfxMappingMode.span,
+      inputPixels: framePixels,
+      virtualPixels: pixelCount,
+      outputPixels: device.pixelCount,
+      groupSize: groupSize,
+      centerOffset: max(0, device.centerOffset),
+      segments: [
+        for (final (start, stop, step, devStart, devEnd) in segments)
+          (step > 0 ? start : stop + 1, devStart, devEnd, step < 0),
+      ],
+    );
+  }
+
   void renderCalibration() {}
 
-  List<Float64List>? _assembledFrame;
-  List<Float64List>? assembleFrame() {
+  PixelFrame? _assembledFrame;
+  PixelFrame? assembleFrame() {
     activeEffect?.render();
     final frame = activeEffect?.getPixels();
 
     if (frame != null) {
       // clamp value
-      for (final row in frame) {
-        for (int j = 0; j < row.length; j++) {
-          double value = row[j];
-          row[j] = value.clamp(0.0, 255.0);
-        }
-      }
-
+      frame.clamp(0.0, 255.0);
       return frame;
     }
     return null;
   }
 
-  void fireUpdateEvent([List<Float64List>? frame]) {
+  void fireUpdateEvent([PixelFrame? frame]) {
     frame = frame ?? _assembledFrame;
     if (frame == null) return;
 
@@ -428,20 +480,16 @@ class Virtual {
     );
   }
 
-  List<Float64List> effectiveToPhysicalPixels(
-    List<Float64List> effectivePixels, [
+  PixelFrame effectiveToPhysicalPixels(
+    PixelFrame effectivePixels, [
     int? pixelCount,
   ]) {
     if (groupSize <= 1) return effectivePixels;
     pixelCount = pixelCount ?? this.pixelCount;
 
-    effectivePixels = repeatAndTruncatePixels(
-      effectivePixels,
-      groupSize,
-      pixelCount,
-    );
-
-    return effectivePixels;
+    // numpy.repeat then truncate to the physical pixel count
+    pixelCount = min(pixelCount, effectivePixels.length * groupSize);
+    return effectivePixels.repeatInto(PixelFrame(pixelCount), groupSize);
   }
 
   SegmentConfig validateSegment(SegmentConfig segment) {
@@ -516,9 +564,75 @@ class Virtuals with Iterable<MapEntry<String, Virtual>> {
   final LEDFx ledfx;
   late bool _paused;
   Map<String, Virtual> virtuals = {};
+
+  // Every virtual renders on one timer, at its own deadlines on
+  // _renderClock: those due at a tick run their native tasks together on
+  // LedfxPool.shared, which returns once all are done, and the timer is
+  // armed again for the earliest deadline left. Deadlines within
+  // _renderSlackUs of a tick are rendered with it rather than a timer of
+  // their own.
+  final Stopwatch _renderClock = Stopwatch()..start();
+  static const int _renderSlackUs = 1000;
+  Timer? _renderTimer;
+  int _renderTimerUs = 0;
+
   @override
   Iterator<MapEntry<String, Virtual>> get iterator => virtuals.entries.iterator;
 
+  void _scheduleRender() {
+    int? next;
+    for (final v in virtuals.values) {
+      if (v._active && (next == null || v._nextFrameUs < next)) {
+        next = v._nextFrameUs;
+      }
+    }
+    if (next == null) {
+      _renderTimer?.cancel();
+      _renderTimer = null;
+      return;
+    }
+    if (_renderTimer != null && _renderTimerUs <= next) return;
+    _renderTimer?.cancel();
+    _renderTimerUs = next;
+    _renderTimer = Timer(
+      Duration(microseconds: max(0, next - _renderClock.elapsedMicroseconds)),
+      _renderTick,
+    );
+  }
+
+  void _renderTick() {
+    _renderTimer = null;
+    final now = _renderClock.elapsedMicroseconds;
+    bool isDue(Virtual v) =>
+        v._active && v._nextFrameUs <= now + _renderSlackUs;
+    final due = virtuals.values.where(isDue).toList();
+
+    try {
+      final rendered = <Virtual>[];
+      final renders = <LedfxRender>[];
+      for (final v in due) {
+        final render = v._prepareFrame();
+        if (render == null) continue;
+        rendered.add(v);
+        renders.add(render);
+      }
+      LedfxPool.shared.run(renders);
+      for (final v in rendered) {
+        v._finishFrame();
+      }
+    } catch (e, stackTrace) {
+      debugPrint("Render tick failed: $e\n$stackTrace");
+    } finally {
+      // Also after a failure, so that a failing frame does not stop the
+      // loop or make it spin on the same deadline. Unless a frame restarted
+      // its virtual, through activate.
+      for (final v in due) {
+        if (isDue(v)) v._advanceFrame(now);
+      }
+      _scheduleRender();
+    }
+  }
+
   fireAllFallbacks() {
     virtuals.forEach((k, v) {
       v.setFallback();
@@ -109,7 +109,7 @@ class _SettingsPageState extends State<SettingsPage> {
           });
           break;
 
-        case AudioEvent(:final data):
+        case AudioEvent():
           await VisualizerService.instance.stop();
           // Process chunks
           VisualizerService.instance.processChunk(
@@ -0,0 +1,107 @@
+/*
+  FFT backends of fft.h for sizes 512 to 8192: checks each against a
+  double-precision DFT, then times them with ooura as the baseline.
+*/
+
+#include "bench_utils.h"
+#include <math.h>
+#include <stdlib.h>
+#include "aubio.h"
+#include "ledfx.h"
+
+#define MIN_WIN_S 512
+#define MAX_WIN_S 8192
+/* total samples transformed per backend and size */
+#define SAMPLES_PER_RUN (1 << 25)
+#define TWO_PI 6.28318530717958647692
+
+/* largest error against the DFT, relative to the largest magnitude */
+static double
+dft_error (const fvec_t * input, const fvec_t * compspec)
+{
+  const uint_t n = input->length;
+  uint_t j, k;
+  double max_err = 0., max_mag = 1e-20;
+  for (k = 0; k <= n / 2; k++) {
+    double re = 0., im = 0., err;
+    for (j = 0; j < n; j++) {
+      double phase = TWO_PI * (double) ((j * k) % n) / n;
+      re += input->data[j] * cos (phase);
+      im -= input->data[j] * sin (phase);
+    }
+    err = fabs (re - compspec->data[k]);
+    if (k > 0 && k < n / 2 && fabs (im - compspec->data[n - k]) > err)
+      err = fabs (im - compspec->data[n - k]);
+    if (err > max_err)
+      max_err = err;
+    if (sqrt (re * re + im * im) > max_mag)
+      max_mag = sqrt (re * re + im * im);
+  }
+  return max_err / max_mag;
+}
+
+int
+main (void)
+{
+  uint_t win_s, i, iter;
+  int status = 0;
+  smpl_t sink = 0.;
+  ledfx_fft_t *fft = new_ledfx_fft (MIN_WIN_S);
+
+  srand (1);
+  printf ("default backend: %s\n",
+      ledfx_fft_get_backend_name (ledfx_fft_get_backend (fft)));
+  del_ledfx_fft (fft);
+
+  for (win_s = MIN_WIN_S; win_s <= MAX_WIN_S; win_s *= 2) {
+    const unsigned long iters = SAMPLES_PER_RUN / win_s;
+    fvec_t *input = new_fvec (win_s), *compspec = new_fvec (win_s);
+    double baseline_us = 0.;
+    int backend;
+
+    for (i = 0; i < win_s; i++) {
+      input->data[i] = 2. * (smpl_t) rand () / (smpl_t) RAND_MAX - 1.;
+    }
+
+    for (backend = LEDFX_FFT_OOURA; backend <= LEDFX_FFT_STOCKHAM;
+        backend++) {
+      const char_t *name =
+          ledfx_fft_get_backend_name ((ledfx_fft_backend_t) backend);
+      char label[64];
+      double err, t0, total_us;
+
+      fft = new_ledfx_fft_with_backend (win_s, (ledfx_fft_backend_t) backend);
+      if (!fft) {
+        fprintf (stderr, "fft: failed creating %s for %d\n", name, win_s);
+        status = 1;
+        continue;
+      }
+      ledfx_fft_do_complex (fft, input, compspec);
+      err = dft_error (input, compspec);
+      if (err > 1e-5)
+        status = 1;
+
+      t0 = ledfx_bench_now_us ();
+      for (iter = 0; iter < iters; iter++) {
+        ledfx_fft_do_complex (fft, input, compspec);
+        sink += compspec->data[1];
+      }
+      total_us = ledfx_bench_now_us () - t0;
+
+      snprintf (label, sizeof (label), "%s %d (err %.1e)", name, win_s,
+          err);
+      ledfx_bench_report (label, total_us, iters, baseline_us);
+      if (backend == LEDFX_FFT_OOURA)
+        baseline_us = total_us / iters;
+      del_ledfx_fft (fft);
+    }
+    del_fvec (input);
+    del_fvec (compspec);
+  }
+
+  if (sink == 42.)
+    printf ("\n");
+  if (status)
+    fprintf (stderr, "fft: output does not match the DFT\n");
+  return status;
+}
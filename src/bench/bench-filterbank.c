@@ -0,0 +1,111 @@
+/*
+  Dense aubio_filterbank_do against the sparse ledfx_filterbank for the three
+  default melbanks (24 bands each, FFT_SIZE 4096 at MIC_RATE 30000).
+*/
+
+#include "bench_utils.h"
+#include <math.h>
+#include <stdlib.h>
+#include "aubio.h"
+#include "ledfx.h"
+
+#define WIN_S 4096
+#define SAMPLERATE 30000.
+#define N_FILTERS 24
+#define N_BANKS 3
+#define MIN_FREQ 20.
+#define ITERS 20000
+
+static const smpl_t max_freqs[N_BANKS] = { 350., 2000., 15000. };
+
+/* band edges equally spaced on the matt scale, as in melbank.dart */
+static void
+matt_band_edges (fvec_t * edges, smpl_t min_freq, smpl_t max_freq)
+{
+  uint_t i;
+  double lo = 3700. * log (1. + min_freq / 230.) / log (12.);
+  double hi = 3700. * log (1. + max_freq / 230.) / log (12.);
+  for (i = 0; i < edges->length; i++) {
+    double matt = lo + (hi - lo) * i / (edges->length - 1);
+    edges->data[i] = (smpl_t) (230. * pow (12., matt / 3700.) - 230.);
+  }
+}
+
+int
+main (void)
+{
+  uint_t b, i, iter;
+  int status = 0;
+  double t0, dense_us, sparse_us, max_err = 0.;
+  smpl_t sink = 0.;
+  fvec_t *edges = new_fvec (N_FILTERS + 2);
+  cvec_t *spectrum = new_cvec (WIN_S);
+  aubio_filterbank_t *dense[N_BANKS];
+  fvec_t *dense_out[N_BANKS];
+  ledfx_filterbank_t *sparse = new_ledfx_filterbank (WIN_S);
+
+  srand (1);
+  for (i = 0; i < spectrum->length; i++) {
+    spectrum->norm[i] = (smpl_t) rand () / (smpl_t) RAND_MAX;
+  }
+
+  for (b = 0; b < N_BANKS; b++) {
+    matt_band_edges (edges, MIN_FREQ, max_freqs[b]);
+    dense[b] = new_aubio_filterbank (N_FILTERS, WIN_S);
+    aubio_filterbank_set_triangle_bands (dense[b], edges, SAMPLERATE);
+    dense_out[b] = new_fvec (N_FILTERS);
+    ledfx_filterbank_add_coeffs (sparse, aubio_filterbank_get_coeffs (dense[b]));
+  }
+
+  /* results must match the dense filterbank */
+  ledfx_filterbank_do (sparse, spectrum);
+  for (b = 0; b < N_BANKS; b++) {
+    fvec_t *out = ledfx_filterbank_get_output (sparse, b);
+    aubio_filterbank_do (dense[b], spectrum, dense_out[b]);
+    for (i = 0; i < N_FILTERS; i++) {
+      double err = fabs (out->data[i] - dense_out[b]->data[i]);
+      double ref = fabs (dense_out[b]->data[i]);
+      if (err > max_err)
+        max_err = err;
+      if (err > 1e-4 * (ref > 1. ? ref : 1.))
+        status = 1;
+    }
+  }
+
+  t0 = ledfx_bench_now_us ();
+  for (iter = 0; iter < ITERS; iter++) {
+    for (b = 0; b < N_BANKS; b++) {
+      aubio_filterbank_do (dense[b], spectrum, dense_out[b]);
+      sink += dense_out[b]->data[0];
+    }
+  }
+  dense_us = ledfx_bench_now_us () - t0;
+
+  t0 = ledfx_bench_now_us ();
+  for (iter = 0; iter < ITERS; iter++) {
+    ledfx_filterbank_do (sparse, spectrum);
+    sink += ledfx_filterbank_get_output (sparse, 0)->data[0];
+  }
+  sparse_us = ledfx_bench_now_us () - t0;
+
+  printf ("filterbank: %d banks x %d filters, %d bins, %d of %d weights"
+      " stored, max abs error %g\n", N_BANKS, N_FILTERS, WIN_S / 2 + 1,
+      ledfx_filterbank_get_n_weights (sparse),
+      N_BANKS * N_FILTERS * (WIN_S / 2 + 1), max_err);
+  ledfx_bench_report ("aubio_filterbank_do x3 (dense)", dense_us, ITERS, 0.);
+  ledfx_bench_report ("ledfx_filterbank_do (sparse)", sparse_us, ITERS,
+      dense_us / ITERS);
+  if (sink == 42.)
+    printf ("\n");
+
+  for (b = 0; b < N_BANKS; b++) {
+    del_aubio_filterbank (dense[b]);
+    del_fvec (dense_out[b]);
+  }
+  del_ledfx_filterbank (sparse);
+  del_cvec (spectrum);
+  del_fvec (edges);
+  if (status)
+    fprintf (stderr, "filterbank: sparse output does not match dense\n");
+  return status;
+}
@@ -0,0 +1,93 @@
+/*
+  Native render of 1 to 32 virtuals of 1000 pixels each, one after the other
+  against all at once on a ledfx_pool. Usage: bench-render [n_threads], the
+  number of worker threads besides the calling one, 7 by default.
+*/
+
+#include "bench_utils.h"
+#include <stdlib.h>
+#include "aubio.h"
+#include "ledfx.h"
+
+#define N_PIXELS 1000
+#define MAX_VIRTUALS 32
+#define ITERS 500
+
+int
+main (int argc, char **argv)
+{
+  uint_t i, v, iter, n_virtuals;
+  int status = 0;
+  uint_t n_threads = argc > 1 ? (uint_t) atoi (argv[1]) : 7;
+  const uint_t segment[LEDFX_MAPPING_SEGMENT_LEN] = { 0, 0, N_PIXELS - 1, 0 };
+  double t0, serial_us, pool_us;
+  char name[64];
+  ledfx_pool_t *pool = new_ledfx_pool (n_threads);
+  ledfx_mapping_t *mapping = new_ledfx_mapping (LEDFX_MAPPING_SPAN,
+      N_PIXELS, N_PIXELS, N_PIXELS, 1, 0, segment, 1);
+  fvec_t *drawn = new_fvec (3 * N_PIXELS);
+  ledfx_postprocess_t *posts[MAX_VIRTUALS];
+  fvec_t *frames[MAX_VIRTUALS];
+  fvec_t *devices[MAX_VIRTUALS];
+  ledfx_render_t *renders[MAX_VIRTUALS];
+
+  if (!pool || !mapping) {
+    fprintf (stderr, "bench-render: could not start %d threads\n", n_threads);
+    return 1;
+  }
+  srand (1);
+  for (i = 0; i < drawn->length; i++) {
+    drawn->data[i] = (smpl_t) (300. * rand () / RAND_MAX - 20.);
+  }
+  /* what a typical virtual asks for: blur and a dimmed, mirrored strip */
+  for (v = 0; v < MAX_VIRTUALS; v++) {
+    posts[v] = new_ledfx_postprocess (N_PIXELS);
+    ledfx_postprocess_set_mirror (posts[v], 1);
+    ledfx_postprocess_set_brightness (posts[v], 0.8);
+    ledfx_postprocess_set_blur (posts[v], 2.);
+    frames[v] = new_fvec (3 * N_PIXELS);
+    devices[v] = new_fvec (3 * N_PIXELS);
+    renders[v] = new_ledfx_render ();
+    ledfx_render_set_frame (renders[v], posts[v], frames[v]);
+    ledfx_render_add_target (renders[v], mapping, devices[v]);
+  }
+
+  printf ("%d worker threads\n", ledfx_pool_get_n_threads (pool));
+  for (n_virtuals = 1; n_virtuals <= MAX_VIRTUALS; n_virtuals *= 2) {
+    t0 = ledfx_bench_now_us ();
+    for (iter = 0; iter < ITERS; iter++) {
+      for (v = 0; v < n_virtuals; v++) {
+        fvec_copy (drawn, frames[v]);
+        ledfx_render_do (renders[v]);
+      }
+    }
+    serial_us = ledfx_bench_now_us () - t0;
+
+    t0 = ledfx_bench_now_us ();
+    for (iter = 0; iter < ITERS; iter++) {
+      for (v = 0; v < n_virtuals; v++) {
+        fvec_copy (drawn, frames[v]);
+      }
+      if (ledfx_render_run (pool, renders, n_virtuals) != 0) {
+        status = 1;
+      }
+    }
+    pool_us = ledfx_bench_now_us () - t0;
+
+    snprintf (name, sizeof (name), "%2d virtuals, serial", n_virtuals);
+    ledfx_bench_report (name, serial_us, ITERS, 0.);
+    snprintf (name, sizeof (name), "%2d virtuals, pool", n_virtuals);
+    ledfx_bench_report (name, pool_us, ITERS, serial_us / ITERS);
+  }
+
+  for (v = 0; v < MAX_VIRTUALS; v++) {
+    del_ledfx_render (renders[v]);
+    del_fvec (devices[v]);
+    del_fvec (frames[v]);
+    del_ledfx_postprocess (posts[v]);
+  }
+  del_fvec (drawn);
+  del_ledfx_mapping (mapping);
+  del_ledfx_pool (pool);
+  return status;
+}
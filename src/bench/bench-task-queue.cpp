@@ -0,0 +1,149 @@
+/*
+  Throughput of ledfx::TaskQueue against the mutex-guarded std::queue of
+  std::function it replaced in the Windows runner's TaskRunnerWindows: 1 to
+  8 producer threads post small tasks to a consumer woken by a simulated
+  window message.
+*/
+
+#include "bench_utils.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "task_queue.h"
+
+#define TASKS_PER_PRODUCER 200000
+#define BATCH 64
+
+// The window's message queue: a count of posted WM_NULL.
+struct Messages
+{
+  std::mutex mutex;
+  std::condition_variable cv;
+  uint64_t pending = 0;
+  uint64_t posted = 0;
+
+  void Post()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending++;
+    posted++;
+    cv.notify_one();
+  }
+
+  void Wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return pending > 0; });
+    pending--;
+  }
+};
+
+// The previous runner: one message per task, the lock held while running.
+struct LockedRunner
+{
+  Messages messages;
+  std::mutex mutex;
+  std::queue<std::function<void()>> tasks;
+
+  void Post(std::function<void()> task)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      tasks.push(task);
+    }
+    messages.Post();
+  }
+
+  void Process()
+  {
+    for (;;)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (tasks.empty())
+        break;
+      std::function<void()> task = tasks.front();
+      tasks.pop();
+      task();
+    }
+  }
+};
+
+struct QueueRunner
+{
+  Messages messages;
+  ledfx::TaskQueue tasks;
+
+  template <typename F>
+  void Post(F &&task)
+  {
+    bool wake = false;
+    tasks.Push(std::forward<F>(task), &wake);
+    if (wake)
+      messages.Post();
+  }
+
+  void Process()
+  {
+    bool wake = false;
+    tasks.Drain(BATCH, &wake);
+    if (wake)
+      messages.Post();
+  }
+};
+
+// Runs n_producers threads posting TASKS_PER_PRODUCER tasks each until all
+// ran; returns the elapsed time in microseconds.
+template <typename Runner>
+static double Run(Runner &runner, int n_producers, uint64_t *messages)
+{
+  const uint64_t total = (uint64_t)n_producers * TASKS_PER_PRODUCER;
+  uint64_t ran = 0;
+  std::vector<std::thread> producers;
+  const double t0 = ledfx_bench_now_us();
+  for (int p = 0; p < n_producers; p++)
+    producers.emplace_back(
+        [&runner, &ran]
+        {
+          for (int i = 0; i < TASKS_PER_PRODUCER; i++)
+            runner.Post([&ran] { ran++; });
+        });
+  while (ran < total)
+  {
+    runner.messages.Wait();
+    runner.Process();
+  }
+  const double elapsed = ledfx_bench_now_us() - t0;
+  for (auto &producer : producers)
+    producer.join();
+  *messages = runner.messages.posted;
+  return elapsed;
+}
+
+int main()
+{
+  char name[64];
+  for (int n_producers = 1; n_producers <= 8; n_producers *= 2)
+  {
+    const unsigned long tasks = (unsigned long)n_producers * TASKS_PER_PRODUCER;
+    uint64_t locked_messages, queue_messages;
+    LockedRunner locked;
+    QueueRunner queue;
+    const double locked_us = Run(locked, n_producers, &locked_messages);
+    const double queue_us = Run(queue, n_producers, &queue_messages);
+
+    snprintf(name, sizeof(name), "%d producers, mutex", n_producers);
+    ledfx_bench_report(name, locked_us, tasks, 0.);
+    snprintf(name, sizeof(name), "%d producers, task queue", n_producers);
+    ledfx_bench_report(name, queue_us, tasks, locked_us / tasks);
+    printf("  messages posted: %llu mutex, %llu task queue\n",
+           (unsigned long long)locked_messages,
+           (unsigned long long)queue_messages);
+  }
+  return 0;
+}
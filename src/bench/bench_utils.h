@@ -0,0 +1,48 @@
+/*
+  Timing helpers shared by the ledfx benchmarks. Include before any system
+  header.
+*/
+
+#ifndef LEDFX_BENCH_UTILS_H
+#define LEDFX_BENCH_UTILS_H
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#else
+#include <windows.h>
+#endif
+
+#include <stdio.h>
+
+/* monotonic time in microseconds */
+static inline double
+ledfx_bench_now_us (void)
+{
+#ifdef _WIN32
+  LARGE_INTEGER count, freq;
+  QueryPerformanceCounter (&count);
+  QueryPerformanceFrequency (&freq);
+  return (double) count.QuadPart * 1e6 / (double) freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec * 1e6 + (double) ts.tv_nsec * 1e-3;
+#endif
+}
+
+/* prints one result line: name, mean time per iteration, and the ratio to a
+ * baseline mean (pass 0 for the baseline itself) */
+static inline void
+ledfx_bench_report (const char *name, double total_us, unsigned long iters,
+    double baseline_us)
+{
+  double mean = total_us / (double) iters;
+  if (baseline_us > 0.) {
+    printf ("%-32s %10.3f us/iter  %6.2fx\n", name, mean, baseline_us / mean);
+  } else {
+    printf ("%-32s %10.3f us/iter\n", name, mean);
+  }
+}
+
+#endif /* LEDFX_BENCH_UTILS_H */
@@ -0,0 +1,635 @@
+/*
+  Per-hop cost of the native audio pipeline as the app configures it, on
+  synthetic or WAV input, reported as JSON.
+*/
+
+#include "bench_utils.h"
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "aubio.h"
+#include "ledfx.h"
+
+#define TWO_PI 6.28318530717958647692
+#define MAX_MELBANKS 8
+
+/* allocation counter: on glibc, malloc, calloc, realloc and the aligned
+ * allocators are interposed for the whole process, shared libraries
+ * included; elsewhere allocations are not counted and reported as null */
+#if defined(__GLIBC__)
+#define LEDFX_BENCH_COUNT_ALLOCS 1
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n, size_t size);
+extern void *__libc_realloc (void *p, size_t size);
+extern void *__libc_memalign (size_t alignment, size_t size);
+extern void __libc_free (void *p);
+
+static unsigned long n_allocs = 0;
+
+void *
+malloc (size_t size)
+{
+  n_allocs++;
+  return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n, size_t size)
+{
+  n_allocs++;
+  return __libc_calloc (n, size);
+}
+
+void *
+realloc (void *p, size_t size)
+{
+  n_allocs++;
+  return __libc_realloc (p, size);
+}
+
+int
+posix_memalign (void **p, size_t alignment, size_t size)
+{
+  void *q;
+  n_allocs++;
+  if (alignment < sizeof (void *) || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+  q = __libc_memalign (alignment, size);
+  if (!q)
+    return ENOMEM;
+  *p = q;
+  return 0;
+}
+
+void *
+aligned_alloc (size_t alignment, size_t size)
+{
+  n_allocs++;
+  return __libc_memalign (alignment, size);
+}
+
+void *memalign (size_t alignment, size_t size);
+
+void *
+memalign (size_t alignment, size_t size)
+{
+  n_allocs++;
+  return __libc_memalign (alignment, size);
+}
+
+void
+free (void *p)
+{
+  __libc_free (p);
+}
+#else
+#define LEDFX_BENCH_COUNT_ALLOCS 0
+static unsigned long n_allocs = 0;
+#endif
+
+/* settings, defaults matching the app: FFT_SIZE 4096 at MIC_RATE 30000, 60
+ * hops per second from a 48 kHz device, three 24-band melbanks */
+typedef struct {
+  uint_t win_s;
+  uint_t hop_s;
+  uint_t samplerate;
+  uint_t device_rate;
+  uint_t n_bands;
+  uint_t n_melbanks;
+  uint_t n_hops;
+  const char *wav;
+  const char *stage;
+  const char *onset;
+} bench_config_t;
+
+/* mono input, at samplerate for the hop stages and at device_rate for the
+ * resampler */
+typedef struct {
+  fvec_t *signal;
+  fvec_t *device_signal;
+  uint_t pos;
+  uint_t device_pos;
+} bench_input_t;
+
+/* one measurement */
+typedef struct {
+  const char *stage;
+  double ns_per_hop;
+  double realtime_x;
+  double allocs_per_hop;
+} bench_result_t;
+
+/* ------------------------------------------------------------------------ */
+/* input */
+
+/* sines, noise and a click every half second, so onset, tempo and pitch all
+ * have something to find */
+static fvec_t *
+synth_signal (uint_t length, uint_t samplerate)
+{
+  fvec_t *s = new_fvec (length);
+  uint_t i, click = samplerate / 2;
+  for (i = 0; i < length; i++) {
+    double t = (double) i / samplerate;
+    double v = 0.3 * sin (TWO_PI * 220. * t) + 0.2 * sin (TWO_PI * 1250. * t)
+        + 0.05 * (2. * rand () / (double) RAND_MAX - 1.);
+    if (i % click < samplerate / 100)
+      v += 0.5 * (1. - (double) (i % click) / (samplerate / 100));
+    s->data[i] = (smpl_t) v;
+  }
+  return s;
+}
+
+static uint_t
+read_le (const unsigned char *p, uint_t n)
+{
+  uint_t v = 0, i;
+  for (i = 0; i < n; i++)
+    v |= (uint_t) p[i] << (8 * i);
+  return v;
+}
+
+/* reads a 16-bit PCM or 32-bit float WAV file, downmixed to mono */
+static fvec_t *
+read_wav (const char *path, uint_t * samplerate)
+{
+  FILE *f = fopen (path, "rb");
+  unsigned char hdr[12], chunk[8], fmt[16];
+  uint_t format = 0, channels = 0, bits = 0, size, frames, i, c;
+  unsigned char *data = NULL;
+  fvec_t *out = NULL;
+
+  if (!f || fread (hdr, 1, 12, f) != 12 || memcmp (hdr, "RIFF", 4)
+      || memcmp (hdr + 8, "WAVE", 4))
+    goto beach;
+  while (fread (chunk, 1, 8, f) == 8) {
+    size = read_le (chunk + 4, 4);
+    if (!memcmp (chunk, "fmt ", 4) && size >= 16) {
+      if (fread (fmt, 1, 16, f) != 16)
+        goto beach;
+      format = read_le (fmt, 2);
+      channels = read_le (fmt + 2, 2);
+      *samplerate = read_le (fmt + 4, 4);
+      bits = read_le (fmt + 14, 2);
+      fseek (f, (long) (size - 16 + (size & 1)), SEEK_CUR);
+    } else if (!memcmp (chunk, "data", 4) && channels > 0) {
+      if (!((format == 1 && bits == 16) || (format == 3 && bits == 32)))
+        goto beach;
+      frames = size / (channels * bits / 8);
+      data = (unsigned char *) malloc (size);
+      if (!data || frames == 0 || fread (data, 1, size, f) != size)
+        goto beach;
+      out = new_fvec (frames);
+      for (i = 0; i < frames; i++) {
+        double sum = 0.;
+        for (c = 0; c < channels; c++) {
+          const unsigned char *p = data + (i * channels + c) * (bits / 8);
+          if (format == 1) {
+            sum += (short) read_le (p, 2) / 32768.;
+          } else {
+            float v;
+            memcpy (&v, p, sizeof (v));
+            sum += v;
+          }
+        }
+        out->data[i] = (smpl_t) (sum / channels);
+      }
+      break;
+    } else {
+      fseek (f, (long) (size + (size & 1)), SEEK_CUR);
+    }
+  }
+
+beach:
+  if (f)
+    fclose (f);
+  free (data);
+  return out;
+}
+
+/* copies the next hop of the input, wrapping around at the end */
+static void
+next_hop (const fvec_t * signal, uint_t * pos, fvec_t * hop)
+{
+  uint_t i;
+  for (i = 0; i < hop->length; i++) {
+    hop->data[i] = signal->data[*pos];
+    if (++*pos == signal->length)
+      *pos = 0;
+  }
+}
+
+/* ------------------------------------------------------------------------ */
+/* stages */
+
+/* everything a stage may touch, created once */
+typedef struct {
+  const bench_config_t *cfg;
+  bench_input_t *input;
+  fvec_t *hop;
+  fvec_t *device_hop;
+  ledfx_pvoc_t *pvoc;
+  cvec_t *spectrum;
+  ledfx_frontend_t *frontend;
+  ledfx_filterbank_t *filterbank;
+  ledfx_melbank_t *melbanks[MAX_MELBANKS];
+  fvec_t *mel_raw[MAX_MELBANKS];
+  fvec_t *mel_filtered[MAX_MELBANKS];
+  aubio_filter_t *biquad;
+  aubio_resampler_t *resampler;
+#ifdef LEDFX_BENCH_HAVE_ANALYSIS
+  ledfx_analysis_t *analysis;
+  ledfx_analysis_result_t result;
+#endif
+  volatile smpl_t sink;       /* keeps the results from being optimised out */
+} bench_state_t;
+
+typedef void (*bench_stage_fn) (bench_state_t * s);
+
+static void
+stage_pvoc (bench_state_t * s)
+{
+  next_hop (s->input->signal, &s->input->pos, s->hop);
+  ledfx_pvoc_do (s->pvoc, s->hop, s->spectrum);
+  s->sink += s->spectrum->norm[1];
+}
+
+static void
+stage_frontend (bench_state_t * s)
+{
+  next_hop (s->input->signal, &s->input->pos,
+      ledfx_frontend_get_input (s->frontend));
+  ledfx_frontend_do (s->frontend);
+  s->sink += ledfx_frontend_get_spectrum (s->frontend)->norm[1];
+}
+
+static void
+stage_filterbank (bench_state_t * s)
+{
+  ledfx_filterbank_do (s->filterbank, s->spectrum);
+  s->sink += ledfx_filterbank_get_output (s->filterbank, 0)->data[0];
+}
+
+static void
+stage_melbank (bench_state_t * s)
+{
+  uint_t b;
+  for (b = 0; b < s->cfg->n_melbanks; b++) {
+    ledfx_melbank_do (s->melbanks[b],
+        ledfx_filterbank_get_output (s->filterbank, b), s->mel_raw[b],
+        s->mel_filtered[b]);
+    s->sink += s->mel_raw[b]->data[0];
+  }
+}
+
+static void
+stage_biquad (bench_state_t * s)
+{
+  next_hop (s->input->signal, &s->input->pos, s->hop);
+  aubio_filter_do (s->biquad, s->hop);
+  s->sink += s->hop->data[0];
+}
+
+static void
+stage_resampler (bench_state_t * s)
+{
+  next_hop (s->input->device_signal, &s->input->device_pos, s->device_hop);
+  aubio_resampler_do (s->resampler, s->device_hop, s->hop);
+  s->sink += s->hop->data[0];
+}
+
+#ifdef LEDFX_BENCH_HAVE_ANALYSIS
+static void
+stage_analysis (bench_state_t * s)
+{
+  next_hop (s->input->signal, &s->input->pos, s->hop);
+  ledfx_analysis_do (s->analysis, s->hop, &s->result);
+  s->sink += s->result.onset_value;
+}
+#endif
+
+/* one hop through the whole chain, as AudioAnalysisSource runs it */
+static void
+stage_pipeline (bench_state_t * s)
+{
+  next_hop (s->input->device_signal, &s->input->device_pos, s->device_hop);
+  aubio_resampler_do (s->resampler, s->device_hop,
+      ledfx_frontend_get_input (s->frontend));
+  if (ledfx_frontend_do (s->frontend)) {
+    cvec_t *spectrum = ledfx_frontend_get_spectrum (s->frontend);
+    uint_t b;
+    ledfx_filterbank_do (s->filterbank, spectrum);
+    for (b = 0; b < s->cfg->n_melbanks; b++) {
+      ledfx_melbank_do (s->melbanks[b],
+          ledfx_filterbank_get_output (s->filterbank, b), s->mel_raw[b],
+          s->mel_filtered[b]);
+    }
+  }
+#ifdef LEDFX_BENCH_HAVE_ANALYSIS
+  ledfx_analysis_do (s->analysis, ledfx_frontend_get_input (s->frontend),
+      &s->result);
+#endif
+  s->sink += s->mel_raw[0]->data[0];
+}
+
+/* band edges equally spaced on the matt scale, as in melbank.dart */
+static void
+matt_band_edges (fvec_t * edges, smpl_t min_freq, smpl_t max_freq)
+{
+  uint_t i;
+  double lo = 3700. * log (1. + min_freq / 230.) / log (12.);
+  double hi = 3700. * log (1. + max_freq / 230.) / log (12.);
+  for (i = 0; i < edges->length; i++) {
+    double matt = lo + (hi - lo) * i / (edges->length - 1);
+    edges->data[i] = (smpl_t) (230. * pow (12., matt / 3700.) - 230.);
+  }
+}
+
+static int
+state_init (bench_state_t * s, const bench_config_t * cfg,
+    bench_input_t * input)
+{
+  /* upper edges of the default melbanks, extra ones spread up to 15 kHz */
+  static const smpl_t max_freqs[3] = { 350., 2000., 15000. };
+  const uint_t device_hop = cfg->hop_s * cfg->device_rate / cfg->samplerate;
+  /* power factor of the default peak isolation, 0.4 */
+  const smpl_t power = (smpl_t) tan (0.25 * TWO_PI * (0.4 + 1.) / 2.);
+  fvec_t *edges = new_fvec (cfg->n_bands + 2);
+  uint_t b;
+
+  memset (s, 0, sizeof (*s));
+  s->cfg = cfg;
+  s->input = input;
+  s->hop = new_fvec (cfg->hop_s);
+  s->device_hop = new_fvec (device_hop);
+  s->pvoc = new_ledfx_pvoc (cfg->win_s, cfg->hop_s);
+  s->spectrum = new_cvec (cfg->win_s);
+  s->frontend = new_ledfx_frontend (cfg->win_s, cfg->hop_s);
+  s->filterbank = new_ledfx_filterbank (cfg->win_s);
+  s->biquad = new_aubio_filter_biquad (0.8268, -1.6536, 0.8268, -1.6536,
+      0.6536);
+  /* 2 is SRC_SINC_FASTEST, as Aubio.createResampler() uses */
+  s->resampler = new_aubio_resampler ((smpl_t) cfg->hop_s / device_hop, 2);
+  if (!edges || !s->pvoc || !s->frontend || !s->filterbank || !s->biquad
+      || !s->resampler) {
+    del_fvec (edges);
+    return 1;
+  }
+  ledfx_frontend_set_biquad (s->frontend, 0.8268, -1.6536, 0.8268, -1.6536,
+      0.6536);
+  /* keep the volume gate open so every hop does the full work */
+  ledfx_frontend_set_min_volume (s->frontend, 0.);
+
+  for (b = 0; b < cfg->n_melbanks; b++) {
+    smpl_t max_freq = b < 3 ? max_freqs[b] : 15000. * (b + 1) / cfg->n_melbanks;
+    matt_band_edges (edges, 20., max_freq);
+    if (ledfx_filterbank_add_triangle_bands (s->filterbank, edges,
+            cfg->samplerate) < 0)
+      break;
+    s->melbanks[b] = new_ledfx_melbank (cfg->n_bands, power);
+    s->mel_raw[b] = new_fvec (cfg->n_bands);
+    s->mel_filtered[b] = new_fvec (cfg->n_bands);
+    if (!s->melbanks[b])
+      break;
+  }
+  del_fvec (edges);
+  if (b < cfg->n_melbanks)
+    return 1;
+
+  /* spectrum for the stages that start from one */
+  next_hop (input->signal, &input->pos, s->hop);
+  ledfx_pvoc_do (s->pvoc, s->hop, s->spectrum);
+
+#ifdef LEDFX_BENCH_HAVE_ANALYSIS
+  s->analysis = new_ledfx_analysis (cfg->onset, cfg->win_s, cfg->hop_s,
+      cfg->samplerate);
+  if (!s->analysis)
+    return 1;
+#endif
+  return 0;
+}
+
+static void
+state_free (bench_state_t * s)
+{
+  uint_t b;
+  if (s->hop)
+    del_fvec (s->hop);
+  if (s->device_hop)
+    del_fvec (s->device_hop);
+  if (s->pvoc)
+    del_ledfx_pvoc (s->pvoc);
+  if (s->spectrum)
+    del_cvec (s->spectrum);
+  if (s->frontend)
+    del_ledfx_frontend (s->frontend);
+  if (s->filterbank)
+    del_ledfx_filterbank (s->filterbank);
+  for (b = 0; b < MAX_MELBANKS; b++) {
+    if (s->melbanks[b])
+      del_ledfx_melbank (s->melbanks[b]);
+    if (s->mel_raw[b])
+      del_fvec (s->mel_raw[b]);
+    if (s->mel_filtered[b])
+      del_fvec (s->mel_filtered[b]);
+  }
+  if (s->biquad)
+    del_aubio_filter (s->biquad);
+  if (s->resampler)
+    del_aubio_resampler (s->resampler);
+#ifdef LEDFX_BENCH_HAVE_ANALYSIS
+  if (s->analysis)
+    del_ledfx_analysis (s->analysis);
+#endif
+}
+
+/* ------------------------------------------------------------------------ */
+/* driver */
+
+static bench_result_t
+run_stage (bench_state_t * s, const char *name, bench_stage_fn fn)
+{
+  const bench_config_t *cfg = s->cfg;
+  const uint_t warmup = cfg->n_hops / 10 + 1;
+  const double hop_ns = 1e9 * cfg->hop_s / cfg->samplerate;
+  bench_result_t r;
+  unsigned long allocs;
+  double t0, total_us;
+  uint_t i;
+
+  for (i = 0; i < warmup; i++)
+    fn (s);
+
+  allocs = n_allocs;
+  t0 = ledfx_bench_now_us ();
+  for (i = 0; i < cfg->n_hops; i++)
+    fn (s);
+  total_us = ledfx_bench_now_us () - t0;
+  allocs = n_allocs - allocs;
+
+  r.stage = name;
+  r.ns_per_hop = total_us * 1e3 / cfg->n_hops;
+  r.realtime_x = r.ns_per_hop > 0. ? hop_ns / r.ns_per_hop : 0.;
+  r.allocs_per_hop = (double) allocs / cfg->n_hops;
+  return r;
+}
+
+static void
+usage (const char *argv0)
+{
+  fprintf (stderr,
+      "usage: %s [options]\n"
+      "  --win N          window size (4096)\n"
+      "  --hop N          hop size (500)\n"
+      "  --rate N         analysis sample rate (30000)\n"
+      "  --device-rate N  resampler input rate (48000)\n"
+      "  --bands N        bands per melbank (24)\n"
+      "  --melbanks N     number of melbanks (3, at most %d)\n"
+      "  --hops N         measured hops per stage (6000)\n"
+      "  --onset NAME     onset method of the analysis stage (hfc)\n"
+      "  --stage NAME     run one stage: pvoc, frontend, filterbank, melbank,\n"
+      "                   biquad, resampler, analysis or pipeline\n"
+      "  --wav FILE       16-bit PCM or float WAV input instead of synthetic\n",
+      argv0, MAX_MELBANKS);
+}
+
+static int
+parse_args (int argc, char **argv, bench_config_t * cfg)
+{
+  int i;
+  for (i = 1; i < argc; i++) {
+    const char *arg = argv[i], *val = i + 1 < argc ? argv[i + 1] : NULL;
+    if (!val)
+      return 1;
+    if (!strcmp (arg, "--win"))
+      cfg->win_s = (uint_t) atoi (val);
+    else if (!strcmp (arg, "--hop"))
+      cfg->hop_s = (uint_t) atoi (val);
+    else if (!strcmp (arg, "--rate"))
+      cfg->samplerate = (uint_t) atoi (val);
+    else if (!strcmp (arg, "--device-rate"))
+      cfg->device_rate = (uint_t) atoi (val);
+    else if (!strcmp (arg, "--bands"))
+      cfg->n_bands = (uint_t) atoi (val);
+    else if (!strcmp (arg, "--melbanks"))
+      cfg->n_melbanks = (uint_t) atoi (val);
+    else if (!strcmp (arg, "--hops"))
+      cfg->n_hops = (uint_t) atoi (val);
+    else if (!strcmp (arg, "--onset"))
+      cfg->onset = val;
+    else if (!strcmp (arg, "--stage"))
+      cfg->stage = val;
+    else if (!strcmp (arg, "--wav"))
+      cfg->wav = val;
+    else
+      return 1;
+    i++;
+  }
+  return (int) cfg->win_s < 2 || (int) cfg->hop_s < 1
+      || cfg->hop_s > cfg->win_s || (int) cfg->samplerate < 1
+      || (int) cfg->device_rate < 1 || (int) cfg->n_bands < 1
+      || (int) cfg->n_melbanks < 1 || cfg->n_melbanks > MAX_MELBANKS
+      || (int) cfg->n_hops < 1;
+}
+
+int
+main (int argc, char **argv)
+{
+  static const struct {
+    const char *name;
+    bench_stage_fn fn;
+  } stages[] = {
+    {"pvoc", stage_pvoc},
+    {"frontend", stage_frontend},
+    {"filterbank", stage_filterbank},
+    {"melbank", stage_melbank},
+    {"biquad", stage_biquad},
+    {"resampler", stage_resampler},
+#ifdef LEDFX_BENCH_HAVE_ANALYSIS
+    {"analysis", stage_analysis},
+#endif
+    {"pipeline", stage_pipeline},
+  };
+  const uint_t n_stages = sizeof (stages) / sizeof (stages[0]);
+  bench_config_t cfg = { 4096, 500, 30000, 48000, 24, 3, 6000, NULL, NULL,
+    "hfc"
+  };
+  bench_input_t input = { NULL, NULL, 0, 0 };
+  bench_result_t results[16];
+  bench_state_t state;
+  ledfx_fft_t *fft;
+  const char_t *fft_backend;
+  uint_t i, n_results = 0;
+  int status = 0;
+
+  if (parse_args (argc, argv, &cfg)) {
+    usage (argv[0]);
+    return 2;
+  }
+
+  srand (1);
+  if (cfg.wav) {
+    uint_t wav_rate = 0;
+    input.signal = read_wav (cfg.wav, &wav_rate);
+    if (!input.signal) {
+      fprintf (stderr, "ledfx_bench: cannot read %s\n", cfg.wav);
+      return 1;
+    }
+    /* the file plays the device for the resampler and, as is, the analysis
+     * input of the other stages: content matters, not its exact rate */
+    input.device_signal = input.signal;
+  } else {
+    input.signal = synth_signal (cfg.samplerate * 10, cfg.samplerate);
+    input.device_signal = synth_signal (cfg.device_rate * 10, cfg.device_rate);
+  }
+
+  if (state_init (&state, &cfg, &input)) {
+    fprintf (stderr, "ledfx_bench: failed creating the pipeline objects\n");
+    status = 1;
+    goto beach;
+  }
+
+  for (i = 0; i < n_stages; i++) {
+    if (cfg.stage && strcmp (cfg.stage, stages[i].name))
+      continue;
+    results[n_results++] = run_stage (&state, stages[i].name, stages[i].fn);
+  }
+  if (cfg.stage && n_results == 0) {
+    fprintf (stderr, "ledfx_bench: unknown or disabled stage %s\n",
+        cfg.stage);
+    status = 2;
+  }
+
+  fft = new_ledfx_fft (cfg.win_s);
+  fft_backend = fft ? ledfx_fft_get_backend_name (ledfx_fft_get_backend (fft))
+      : "none";
+  if (fft)
+    del_ledfx_fft (fft);
+
+  printf ("{\n  \"config\": {\"win_s\": %d, \"hop_s\": %d, \"samplerate\": %d,"
+      " \"device_rate\": %d, \"bands\": %d, \"melbanks\": %d, \"hops\": %d,"
+      " \"onset\": \"%s\", \"input\": \"%s\", \"fft_backend\": \"%s\","
+      " \"kernels\": \"%s\"},\n  \"results\": [",
+      cfg.win_s, cfg.hop_s, cfg.samplerate, cfg.device_rate, cfg.n_bands,
+      cfg.n_melbanks, cfg.n_hops, cfg.onset, cfg.wav ? "wav" : "synthetic",
+      fft_backend, ledfx_kernels ()->name);
+  for (i = 0; i < n_results; i++) {
+    printf ("%s\n    {\"stage\": \"%s\", \"ns_per_hop\": %.1f,"
+        " \"realtime_x\": %.1f, \"allocs_per_hop\": ", i ? "," : "",
+        results[i].stage, results[i].ns_per_hop, results[i].realtime_x);
+    if (LEDFX_BENCH_COUNT_ALLOCS)
+      printf ("%.3f}", results[i].allocs_per_hop);
+    else
+      printf ("null}");
+  }
+  printf ("\n  ]\n}\n");
+
+beach:
+  state_free (&state);
+  if (input.device_signal && input.device_signal != input.signal)
+    del_fvec (input.device_signal);
+  if (input.signal)
+    del_fvec (input.signal);
+  return status;
+}
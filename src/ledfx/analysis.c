@@ -0,0 +1,314 @@
+/*
+  Onset, tempo and pitch analysis sharing one phase vocoder.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "mathutils.h"
+#include "spectral/specdesc.h"
+#include "spectral/awhitening.h"
+#include "onset/peakpicker.h"
+#include "tempo/beattracking.h"
+#include "pitch/pitchyinfast.h"
+#include "kernels.h"
+#include "pvoc.h"
+#include "analysis.h"
+
+/* defaults of aubio_onset_t */
+#define LEDFX_ANALYSIS_ONSET_THRESHOLD 0.3
+#define LEDFX_ANALYSIS_ONSET_DELAY 4.3
+#define LEDFX_ANALYSIS_ONSET_MINIOI_S 0.05
+#define LEDFX_ANALYSIS_ONSET_SILENCE -70.
+/* defaults of aubio_tempo_t */
+#define LEDFX_ANALYSIS_TEMPO_METHOD "specflux"
+#define LEDFX_ANALYSIS_TEMPO_THRESHOLD 0.3
+#define LEDFX_ANALYSIS_TEMPO_SILENCE -90.
+/* defaults of aubio_pitch_t with yinfast */
+#define LEDFX_ANALYSIS_PITCH_TOLERANCE 0.15
+#define LEDFX_ANALYSIS_PITCH_SILENCE -50.
+
+struct _ledfx_analysis_t {
+  uint_t win_s;             /** phase vocoder window size */
+  uint_t hop_s;             /** samples per call */
+  uint_t samplerate;        /** input sampling rate */
+  uint_t total_frames;      /** samples analysed so far */
+  ledfx_pvoc_t *pvoc;       /** phase vocoder shared by all analyses */
+  cvec_t *fftgrain;         /** spectrum of the current hop */
+  const ledfx_kernels_t *kernels; /** vector kernels for this CPU */
+
+  /* onset */
+  aubio_specdesc_t *onset_od; /** onset detection function */
+  aubio_peakpicker_t *onset_pp; /** onset peak picker */
+  aubio_spectral_whitening_t *whitening; /** whitening, NULL if unused */
+  smpl_t compression;       /** log compression, 0 if unused */
+  cvec_t *onset_grain;      /** whitened or compressed spectrum, or NULL */
+  fvec_t *onset_desc;       /** onset detection function output */
+  fvec_t *onset_out;        /** peak picker output */
+  uint_t delay;             /** onset delay in samples */
+  uint_t minioi;            /** minimum inter-onset interval in samples */
+  uint_t last_onset;        /** position of the last onset in samples */
+
+  /* tempo */
+  aubio_specdesc_t *tempo_od; /** tempo detection function */
+  aubio_peakpicker_t *tempo_pp; /** tempo peak picker */
+  aubio_beattracking_t *bt; /** beat tracker */
+  fvec_t *tempo_desc;       /** tempo detection function output */
+  fvec_t *tempo_onset;      /** tempo peak picker output */
+  fvec_t *dfframe;          /** detection function history */
+  fvec_t *bt_out;           /** predicted beats of the next step */
+  uint_t winlen;            /** length of dfframe */
+  uint_t step;              /** hops between two beat tracking passes */
+  sint_t blockpos;          /** hop within the current step */
+
+  /* pitch */
+  aubio_pitchyinfast_t *yin; /** pitch detection */
+  fvec_t *yin_out;          /** period estimate in samples */
+};
+
+ledfx_analysis_t *
+new_ledfx_analysis (const char_t * onset_method, uint_t win_s, uint_t hop_s,
+    uint_t samplerate)
+{
+  ledfx_analysis_t *a = AUBIO_NEW (ledfx_analysis_t);
+  smpl_t threshold = LEDFX_ANALYSIS_ONSET_THRESHOLD;
+  smpl_t delay = LEDFX_ANALYSIS_ONSET_DELAY;
+  uint_t whitening = 0;
+  if ((sint_t) samplerate < 1) {
+    AUBIO_ERR ("analysis: got samplerate %d\n", samplerate);
+    goto beach;
+  }
+  a->win_s = win_s;
+  a->hop_s = hop_s;
+  a->samplerate = samplerate;
+
+  a->pvoc = new_ledfx_pvoc (win_s, hop_s);
+  if (!a->pvoc)
+    goto beach;
+  a->fftgrain = new_cvec (win_s);
+  a->kernels = ledfx_kernels ();
+
+  /* onset, tuned per detection function as aubio_onset_t */
+  if (strcmp (onset_method, "hfc") == 0
+      || strcmp (onset_method, "default") == 0) {
+    onset_method = "hfc";
+    threshold = 0.058;
+  } else if (strcmp (onset_method, "complex") == 0) {
+    threshold = 0.15;
+    delay = 4.6;
+    whitening = 1;
+    a->compression = 1.;
+  }
+  a->onset_od = new_aubio_specdesc (onset_method, win_s);
+  a->onset_pp = new_aubio_peakpicker ();
+  a->onset_desc = new_fvec (1);
+  a->onset_out = new_fvec (1);
+  if (!a->fftgrain || !a->onset_od || !a->onset_pp || !a->onset_desc
+      || !a->onset_out) {
+    goto beach;
+  }
+  aubio_peakpicker_set_threshold (a->onset_pp, threshold);
+  if (whitening) {
+    a->whitening = new_aubio_spectral_whitening (win_s, hop_s, samplerate);
+    if (!a->whitening)
+      goto beach;
+  }
+  if (whitening || a->compression > 0.) {
+    a->onset_grain = new_cvec (win_s);
+    if (!a->onset_grain)
+      goto beach;
+  }
+  a->delay = (uint_t) (delay * hop_s);
+  a->minioi = (uint_t) ROUND (LEDFX_ANALYSIS_ONSET_MINIOI_S * samplerate);
+
+  /* tempo, as aubio_tempo_t */
+  a->winlen = aubio_next_power_of_two ((uint_t) (5.8 * samplerate / hop_s));
+  if (a->winlen < 4)
+    a->winlen = 4;
+  a->step = a->winlen / 4;
+  a->tempo_od = new_aubio_specdesc (LEDFX_ANALYSIS_TEMPO_METHOD, win_s);
+  a->tempo_pp = new_aubio_peakpicker ();
+  a->bt = new_aubio_beattracking (a->winlen, hop_s, samplerate);
+  a->tempo_desc = new_fvec (1);
+  a->tempo_onset = new_fvec (1);
+  a->dfframe = new_fvec (a->winlen);
+  a->bt_out = new_fvec (a->step);
+  if (!a->tempo_od || !a->tempo_pp || !a->bt || !a->tempo_desc
+      || !a->tempo_onset || !a->dfframe || !a->bt_out) {
+    goto beach;
+  }
+  aubio_peakpicker_set_threshold (a->tempo_pp,
+      LEDFX_ANALYSIS_TEMPO_THRESHOLD);
+
+  /* pitch, on the frame of the phase vocoder */
+  a->yin = new_aubio_pitchyinfast (win_s);
+  a->yin_out = new_fvec (1);
+  if (!a->yin || !a->yin_out)
+    goto beach;
+  aubio_pitchyinfast_set_tolerance (a->yin, LEDFX_ANALYSIS_PITCH_TOLERANCE);
+  return a;
+
+beach:
+  del_ledfx_analysis (a);
+  return NULL;
+}
+
+void
+del_ledfx_analysis (ledfx_analysis_t * a)
+{
+  if (!a)
+    return;
+  if (a->pvoc)
+    del_ledfx_pvoc (a->pvoc);
+  if (a->fftgrain)
+    del_cvec (a->fftgrain);
+  if (a->onset_od)
+    del_aubio_specdesc (a->onset_od);
+  if (a->onset_pp)
+    del_aubio_peakpicker (a->onset_pp);
+  if (a->whitening)
+    del_aubio_spectral_whitening (a->whitening);
+  if (a->onset_grain)
+    del_cvec (a->onset_grain);
+  if (a->onset_desc)
+    del_fvec (a->onset_desc);
+  if (a->onset_out)
+    del_fvec (a->onset_out);
+  if (a->tempo_od)
+    del_aubio_specdesc (a->tempo_od);
+  if (a->tempo_pp)
+    del_aubio_peakpicker (a->tempo_pp);
+  if (a->bt)
+    del_aubio_beattracking (a->bt);
+  if (a->tempo_desc)
+    del_fvec (a->tempo_desc);
+  if (a->tempo_onset)
+    del_fvec (a->tempo_onset);
+  if (a->dfframe)
+    del_fvec (a->dfframe);
+  if (a->bt_out)
+    del_fvec (a->bt_out);
+  if (a->yin)
+    del_aubio_pitchyinfast (a->yin);
+  if (a->yin_out)
+    del_fvec (a->yin_out);
+  AUBIO_FREE (a);
+}
+
+/* same decisions as aubio_onset_do () */
+static uint_t
+ledfx_analysis_onset (ledfx_analysis_t * a, uint_t silent)
+{
+  const cvec_t *grain = a->fftgrain;
+  smpl_t isonset;
+  if (a->onset_grain) {
+    cvec_copy (a->fftgrain, a->onset_grain);
+    if (a->whitening)
+      aubio_spectral_whitening_do (a->whitening, a->onset_grain);
+    if (a->compression > 0.)
+      cvec_logmag (a->onset_grain, a->compression);
+    grain = a->onset_grain;
+  }
+  aubio_specdesc_do (a->onset_od, grain, a->onset_desc);
+  aubio_peakpicker_do (a->onset_pp, a->onset_desc, a->onset_out);
+  isonset = a->onset_out->data[0];
+
+  if (isonset > 0.) {
+    uint_t new_onset;
+    if (silent)
+      return 0;
+    new_onset = a->total_frames + (uint_t) ROUND (isonset * a->hop_s);
+    /* too close to the last onset */
+    if (a->last_onset + a->minioi >= new_onset)
+      return 0;
+    if (a->last_onset > 0 && a->delay > new_onset)
+      return 0;
+    a->last_onset = MAX (a->delay, new_onset);
+    return 1;
+  }
+  /* sound at the very start of the stream */
+  if (a->total_frames <= a->delay && !silent
+      && (a->total_frames == 0
+          || a->last_onset + a->minioi < a->total_frames)) {
+    a->last_onset = a->total_frames + a->delay;
+    return 1;
+  }
+  return 0;
+}
+
+/* same beat tracking as aubio_tempo_do () */
+static uint_t
+ledfx_analysis_tempo (ledfx_analysis_t * a, uint_t silent)
+{
+  const uint_t winlen = a->winlen, step = a->step;
+  uint_t i, beat = 0;
+
+  aubio_specdesc_do (a->tempo_od, a->fftgrain, a->tempo_desc);
+  if (a->blockpos == (sint_t) step - 1) {
+    aubio_beattracking_do (a->bt, a->dfframe, a->bt_out);
+    /* rotate the detection function history */
+    for (i = 0; i < winlen - step; i++) {
+      a->dfframe->data[i] = a->dfframe->data[i + step];
+    }
+    for (i = winlen - step; i < winlen; i++) {
+      a->dfframe->data[i] = 0.;
+    }
+    a->blockpos = -1;
+  }
+  a->blockpos++;
+  aubio_peakpicker_do (a->tempo_pp, a->tempo_desc, a->tempo_onset);
+  a->dfframe->data[winlen - step + a->blockpos] =
+      aubio_peakpicker_get_thresholded_input (a->tempo_pp)->data[0];
+
+  /* bt_out->data[0] holds the number of predicted beats plus one */
+  for (i = 1; i < a->bt_out->data[0]; i++) {
+    if (a->blockpos == FLOOR (a->bt_out->data[i]) && !silent)
+      beat = 1;
+  }
+  return beat;
+}
+
+void
+ledfx_analysis_do (ledfx_analysis_t * a, const fvec_t * input,
+    ledfx_analysis_result_t * result)
+{
+  smpl_t period;
+
+  /* level shared by the three silence gates, as aubio_db_spl () */
+  result->db = 10. * LOG10 (a->kernels->sum_sq (input->data, a->hop_s)
+      / a->hop_s);
+
+  ledfx_pvoc_do (a->pvoc, input, a->fftgrain);
+
+  result->onset = ledfx_analysis_onset (a,
+      !(result->db >= LEDFX_ANALYSIS_ONSET_SILENCE));
+  result->onset_value = a->onset_desc->data[0];
+
+  result->beat = ledfx_analysis_tempo (a,
+      !(result->db >= LEDFX_ANALYSIS_TEMPO_SILENCE));
+  result->bpm = aubio_beattracking_get_bpm (a->bt);
+  result->tempo_confidence = aubio_beattracking_get_confidence (a->bt);
+
+  aubio_pitchyinfast_do (a->yin, ledfx_pvoc_get_frame (a->pvoc), a->yin_out);
+  period = a->yin_out->data[0];
+  if (period > 0. && result->db >= LEDFX_ANALYSIS_PITCH_SILENCE) {
+    result->pitch = a->samplerate / period;
+  } else {
+    result->pitch = 0.;
+  }
+  result->pitch_confidence = aubio_pitchyinfast_get_confidence (a->yin);
+
+  a->total_frames += a->hop_s;
+}
+
+uint_t
+ledfx_analysis_set_onset_threshold (ledfx_analysis_t * a, smpl_t threshold)
+{
+  return aubio_peakpicker_set_threshold (a->onset_pp, threshold);
+}
+
+uint_t
+ledfx_analysis_set_pitch_tolerance (ledfx_analysis_t * a, smpl_t tolerance)
+{
+  return aubio_pitchyinfast_set_tolerance (a->yin, tolerance);
+}
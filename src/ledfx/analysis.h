@@ -0,0 +1,109 @@
+/*
+  Onset, tempo and pitch analysis sharing one phase vocoder.
+*/
+
+#ifndef LEDFX_ANALYSIS_H
+#define LEDFX_ANALYSIS_H
+
+/** \file
+
+  Onset, tempo and pitch analysis running once per hop
+
+  aubio_onset_t, aubio_tempo_t and aubio_pitch_t each slide their own
+  window and run their own FFT. This object does the same analysis from a
+  single ledfx_pvoc_t (see pvoc.h) per hop:
+
+  - onset detection: the spectral descriptor given at creation ("energy",
+    "hfc" or "complex", with the thresholds, whitening and compression
+    aubio_onset_t uses for them), peak picking, a 50 ms minimum
+    inter-onset interval and a -70 dB silence gate,
+  - tempo: the "specflux" descriptor of the same spectrum, peak picked and
+    fed to aubio_beattracking_t as in aubio_tempo_do(), with a -90 dB
+    silence gate,
+  - pitch: yinfast over the unwindowed frame of the phase vocoder, with a
+    -50 dB silence gate.
+
+  The level of the hop is computed once and shared by the three gates. All
+  buffers are allocated by new_ledfx_analysis(); ledfx_analysis_do() does
+  not allocate and fills one ledfx_analysis_result_t per hop.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** analysis of one hop */
+typedef struct {
+  uint_t onset;             /**< 1 if an onset was detected in this hop */
+  uint_t beat;              /**< 1 if a beat falls in this hop */
+  smpl_t onset_value;       /**< onset detection function */
+  smpl_t bpm;               /**< tempo estimate, 0 until one is found */
+  smpl_t tempo_confidence;  /**< confidence of the tempo, between 0 and 1 */
+  smpl_t pitch;             /**< pitch in Hz, 0 if unvoiced or silent */
+  smpl_t pitch_confidence;  /**< confidence of the pitch, between 0 and 1 */
+  smpl_t db;                /**< level of the hop in dB SPL */
+} ledfx_analysis_result_t;
+
+/** analysis object */
+typedef struct _ledfx_analysis_t ledfx_analysis_t;
+
+/** create analysis
+
+  \param onset_method onset detection function, "energy", "hfc",
+  "complex" or "default" (hfc)
+  \param win_s phase vocoder window size, a power of two
+  \param hop_s number of input samples per call to ledfx_analysis_do(), at
+  most win_s
+  \param samplerate sampling rate of the input
+
+  \return newly created object, or NULL on invalid parameters
+
+*/
+ledfx_analysis_t *new_ledfx_analysis (const char_t * onset_method,
+    uint_t win_s, uint_t hop_s, uint_t samplerate);
+
+/** delete analysis
+
+  \param a object to delete, as returned by new_ledfx_analysis()
+
+*/
+void del_ledfx_analysis (ledfx_analysis_t * a);
+
+/** analyse one hop
+
+  \param a analysis object
+  \param input hop_s new samples
+  \param result output, overwritten for every hop
+
+*/
+void ledfx_analysis_do (ledfx_analysis_t * a, const fvec_t * input,
+    ledfx_analysis_result_t * result);
+
+/** set the peak picking threshold of the onset detection
+
+  \param a analysis object
+  \param threshold new threshold, 0.058 for hfc by default
+
+  \return 0 on success, non-zero otherwise
+
+*/
+uint_t ledfx_analysis_set_onset_threshold (ledfx_analysis_t * a,
+    smpl_t threshold);
+
+/** set the yinfast tolerance of the pitch detection
+
+  \param a analysis object
+  \param tolerance new tolerance, 0.15 by default
+
+  \return 0 on success, non-zero otherwise
+
+*/
+uint_t ledfx_analysis_set_pitch_tolerance (ledfx_analysis_t * a,
+    smpl_t tolerance);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_ANALYSIS_H */
@@ -0,0 +1,166 @@
+/*
+  Arena of long-lived vectors shared with the Dart side.
+*/
+
+#include <stdint.h>
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "arena.h"
+
+/* default size of the blocks requested from the system */
+#define LEDFX_ARENA_BLOCK_SIZE 65536
+/* alignment of every allocation, wide enough for any vector unit */
+#define LEDFX_ARENA_ALIGN 64
+
+typedef struct _ledfx_arena_block_t ledfx_arena_block_t;
+
+struct _ledfx_arena_block_t {
+  ledfx_arena_block_t *next; /** previously allocated block */
+  char *data;               /** first aligned byte of the block */
+  size_t size;              /** usable bytes from data */
+  size_t used;              /** bytes handed out from data */
+};
+
+struct _ledfx_arena_t {
+  size_t block_size;        /** usable bytes of a regular block */
+  ledfx_arena_block_t *blocks; /** most recent block first */
+  size_t used;              /** bytes handed out, over all blocks */
+  uint_t n_blocks;          /** number of blocks */
+};
+
+static size_t
+ledfx_arena_round (size_t size)
+{
+  return (size + LEDFX_ARENA_ALIGN - 1) & ~(size_t) (LEDFX_ARENA_ALIGN - 1);
+}
+
+static ledfx_arena_block_t *
+ledfx_arena_add_block (ledfx_arena_t * a, size_t size)
+{
+  /* the block header and its data share one allocation; the extra bytes
+   * leave room to align the data */
+  size_t header = ledfx_arena_round (sizeof (ledfx_arena_block_t));
+  char *mem = (char *) calloc (1, header + size + LEDFX_ARENA_ALIGN);
+  ledfx_arena_block_t *block = (ledfx_arena_block_t *) mem;
+  size_t offset;
+  if (!mem) {
+    AUBIO_ERR ("arena: failed allocating a block of %lu bytes\n",
+        (unsigned long) size);
+    return NULL;
+  }
+  offset = (size_t) (((uintptr_t) (mem + header)) % LEDFX_ARENA_ALIGN);
+  block->data = mem + header + (offset ? LEDFX_ARENA_ALIGN - offset : 0);
+  block->size = size;
+  block->used = 0;
+  if (a->blocks && size > a->block_size) {
+    /* oversized blocks go behind the current one, which keeps serving the
+     * small allocations */
+    block->next = a->blocks->next;
+    a->blocks->next = block;
+  } else {
+    block->next = a->blocks;
+    a->blocks = block;
+  }
+  a->n_blocks++;
+  return block;
+}
+
+/* returns size zeroed bytes aligned to LEDFX_ARENA_ALIGN */
+static void *
+ledfx_arena_alloc (ledfx_arena_t * a, size_t size)
+{
+  ledfx_arena_block_t *block = a->blocks;
+  void *ptr;
+  size = ledfx_arena_round (size);
+  if (size > a->block_size) {
+    block = ledfx_arena_add_block (a, size);
+    if (!block)
+      return NULL;
+  } else if (!block || block->size - block->used < size) {
+    block = ledfx_arena_add_block (a, a->block_size);
+    if (!block)
+      return NULL;
+  }
+  ptr = block->data + block->used;
+  block->used += size;
+  a->used += size;
+  return ptr;
+}
+
+ledfx_arena_t *
+new_ledfx_arena (uint_t block_size)
+{
+  ledfx_arena_t *a = AUBIO_NEW (ledfx_arena_t);
+  if (!a)
+    return NULL;
+  a->block_size = ledfx_arena_round (block_size ? block_size
+      : LEDFX_ARENA_BLOCK_SIZE);
+  return a;
+}
+
+void
+del_ledfx_arena (ledfx_arena_t * a)
+{
+  ledfx_arena_block_t *block;
+  if (!a)
+    return;
+  block = a->blocks;
+  while (block) {
+    ledfx_arena_block_t *next = block->next;
+    free (block);
+    block = next;
+  }
+  AUBIO_FREE (a);
+}
+
+fvec_t *
+ledfx_arena_new_fvec (ledfx_arena_t * a, uint_t length)
+{
+  fvec_t *s;
+  if ((sint_t) length <= 0) {
+    AUBIO_ERR ("arena: can not allocate a vector of length %d\n", length);
+    return NULL;
+  }
+  s = (fvec_t *) ledfx_arena_alloc (a, sizeof (fvec_t));
+  if (!s)
+    return NULL;
+  s->data = (smpl_t *) ledfx_arena_alloc (a, length * sizeof (smpl_t));
+  if (!s->data)
+    return NULL;
+  s->length = length;
+  return s;
+}
+
+cvec_t *
+ledfx_arena_new_cvec (ledfx_arena_t * a, uint_t win_s)
+{
+  cvec_t *s;
+  uint_t length = win_s / 2 + 1;
+  if ((sint_t) win_s <= 0) {
+    AUBIO_ERR ("arena: can not allocate a spectrum of size %d\n", win_s);
+    return NULL;
+  }
+  s = (cvec_t *) ledfx_arena_alloc (a, sizeof (cvec_t));
+  if (!s)
+    return NULL;
+  s->norm = (smpl_t *) ledfx_arena_alloc (a, length * sizeof (smpl_t));
+  s->phas = (smpl_t *) ledfx_arena_alloc (a, length * sizeof (smpl_t));
+  if (!s->norm || !s->phas)
+    return NULL;
+  s->length = length;
+  return s;
+}
+
+uint_t
+ledfx_arena_get_size (const ledfx_arena_t * a)
+{
+  return (uint_t) a->used;
+}
+
+uint_t
+ledfx_arena_get_n_blocks (const ledfx_arena_t * a)
+{
+  return a->n_blocks;
+}
@@ -0,0 +1,99 @@
+/*
+  Arena of long-lived vectors shared with the Dart side.
+*/
+
+#ifndef LEDFX_ARENA_H
+#define LEDFX_ARENA_H
+
+/** \file
+
+  Arena of long-lived fvec_t and cvec_t objects
+
+  Buffers that are written or read every hop, such as the input and output
+  of a resampler, are allocated once from an arena and exposed to Dart as
+  typed-data views on their storage. Samples are then exchanged in place,
+  without per-sample FFI calls, copies through temporary vectors, or
+  allocations on the audio path.
+
+  Ownership and lifetime rules:
+
+  - vectors returned by ledfx_arena_new_fvec() and ledfx_arena_new_cvec()
+    belong to the arena; they must not be passed to del_fvec() or
+    del_cvec(), and are released together by del_ledfx_arena(),
+  - a vector never moves or changes length, so a pointer or view taken on
+    its data stays valid until the arena is deleted, and no longer,
+  - the data of every vector starts on a 64 byte boundary and is zeroed,
+  - allocating from an arena is not thread-safe; reading and writing the
+    vectors follows the rules of the objects they are passed to.
+
+  Memory is taken from the system in blocks, so an arena is meant to be
+  filled when a pipeline is set up and deleted when it is torn down.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** vector arena object */
+typedef struct _ledfx_arena_t ledfx_arena_t;
+
+/** create vector arena
+
+  \param block_size size in bytes of the blocks requested from the system,
+  or 0 for the default of 64 KiB; larger vectors get a block of their own
+
+  \return newly created arena, or NULL on failure
+
+*/
+ledfx_arena_t *new_ledfx_arena (uint_t block_size);
+
+/** delete vector arena and every vector allocated from it
+
+  \param a arena to delete, as returned by new_ledfx_arena()
+
+*/
+void del_ledfx_arena (ledfx_arena_t * a);
+
+/** allocate a vector from the arena
+
+  \param a arena
+  \param length number of samples
+
+  \return zeroed vector owned by the arena, or NULL on failure
+
+*/
+fvec_t *ledfx_arena_new_fvec (ledfx_arena_t * a, uint_t length);
+
+/** allocate a spectrum from the arena
+
+  \param a arena
+  \param win_s window size; norm and phas hold win_s / 2 + 1 samples, as
+  with new_cvec()
+
+  \return zeroed spectrum owned by the arena, or NULL on failure
+
+*/
+cvec_t *ledfx_arena_new_cvec (ledfx_arena_t * a, uint_t win_s);
+
+/** get the number of bytes handed out by the arena
+
+  \param a arena
+
+  \return bytes used by the vectors and their data, including alignment
+
+*/
+uint_t ledfx_arena_get_size (const ledfx_arena_t * a);
+
+/** get the number of blocks requested from the system
+
+  \param a arena
+
+*/
+uint_t ledfx_arena_get_n_blocks (const ledfx_arena_t * a);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_ARENA_H */
@@ -0,0 +1,67 @@
+#ifndef LEDFX_AUDIO_PACKET_H_
+#define LEDFX_AUDIO_PACKET_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ledfx
+{
+
+  // Binary audio event layout shared by the platform runners and
+  // lib/src/platform/audio_bridge.dart.
+  //
+  // An audio event is a two element list: [header, samples], where |header|
+  // is a kAudioPacketHeaderSize byte Uint8List and |samples| a Float32List of
+  // interleaved frames. All header fields are little-endian:
+  //
+  //   offset  size  field
+  //        0     1  version (kAudioPacketVersion)
+  //        1     1  channel count of |samples|
+  //        2     2  flags (kAudioPacketFlag*)
+  //        4     4  sequence number, wraps at 2^32
+  //        8     8  capture timestamp in microseconds (platform clock)
+  //
+  // A runner may send several consecutive blocks in one event, [header,
+  // samples, lengths]: |samples| holds the blocks back to back, |lengths| is
+  // an Int32List of the sample count of each, and the header describes the
+  // first. Its flags are those of all the blocks.
+  constexpr uint8_t kAudioPacketVersion = 1;
+  constexpr size_t kAudioPacketHeaderSize = 16;
+
+  // The device reported the block as silent.
+  constexpr uint16_t kAudioPacketFlagSilent = 1 << 0;
+  // Samples were lost between this block and the previous one.
+  constexpr uint16_t kAudioPacketFlagDiscontinuity = 1 << 1;
+  // The samples went to the PCM sink registered with setPcmSink and the
+  // event carries none: the hops wait in the sink (see pcm.h).
+  constexpr uint16_t kAudioPacketFlagPcmSink = 1 << 2;
+
+  struct AudioPacketHeader
+  {
+    uint8_t channels = 1;
+    uint16_t flags = 0;
+    uint32_t sequence = 0;
+    uint64_t timestamp_us = 0;
+  };
+
+  // Serialises |header| into |out|, which must hold kAudioPacketHeaderSize
+  // bytes.
+  inline void WriteAudioPacketHeader(const AudioPacketHeader &header, uint8_t *out)
+  {
+    out[0] = kAudioPacketVersion;
+    out[1] = header.channels;
+    out[2] = static_cast<uint8_t>(header.flags);
+    out[3] = static_cast<uint8_t>(header.flags >> 8);
+    for (int i = 0; i < 4; i++)
+    {
+      out[4 + i] = static_cast<uint8_t>(header.sequence >> (8 * i));
+    }
+    for (int i = 0; i < 8; i++)
+    {
+      out[8 + i] = static_cast<uint8_t>(header.timestamp_us >> (8 * i));
+    }
+  }
+
+} // namespace ledfx
+
+#endif // LEDFX_AUDIO_PACKET_H_
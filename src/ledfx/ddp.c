@@ -0,0 +1,134 @@
+/*
+  DDP (Distributed Display Protocol) packetizer.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "udp.h"
+#include "ddp.h"
+
+/* largest DDP sequence number; 0 means the receiver should not check */
+#define LEDFX_DDP_MAX_SEQUENCE 15
+
+struct _ledfx_ddp_t {
+  uint_t n_pixels;          /** number of pixels of the strip */
+  uint_t n_packets;         /** packets per frame */
+  uint_t sequence;          /** sequence number of the next frame */
+  unsigned char *buffer;    /** all packets, back to back */
+  unsigned char **packets;  /** start of each packet in buffer */
+  uint_t *lengths;          /** length of each packet, header included */
+};
+
+ledfx_ddp_t *
+new_ledfx_ddp (uint_t n_pixels)
+{
+  ledfx_ddp_t *d = AUBIO_NEW (ledfx_ddp_t);
+  uint_t i, datalen, stride = LEDFX_DDP_HEADER_LEN + LEDFX_DDP_MAX_DATALEN;
+  if ((sint_t) n_pixels < 1) {
+    AUBIO_ERR ("ddp: got n_pixels %d\n", n_pixels);
+    goto beach;
+  }
+  datalen = 3 * n_pixels;
+  d->n_pixels = n_pixels;
+  d->n_packets = (datalen + LEDFX_DDP_MAX_DATALEN - 1) / LEDFX_DDP_MAX_DATALEN;
+  d->sequence = 1;
+  d->buffer = AUBIO_ARRAY (unsigned char, d->n_packets * stride);
+  d->packets = AUBIO_ARRAY (unsigned char *, d->n_packets);
+  d->lengths = AUBIO_ARRAY (uint_t, d->n_packets);
+  if (!d->buffer || !d->packets || !d->lengths) {
+    goto beach;
+  }
+
+  /* everything but the flags and the sequence number is the same for every
+   * frame */
+  for (i = 0; i < d->n_packets; i++) {
+    unsigned char *h = d->buffer + i * stride;
+    uint_t offset = i * LEDFX_DDP_MAX_DATALEN;
+    uint_t len = MIN (LEDFX_DDP_MAX_DATALEN, datalen - offset);
+    h[0] = LEDFX_DDP_VER1 | (i + 1 == d->n_packets ? LEDFX_DDP_PUSH : 0);
+    h[2] = LEDFX_DDP_TYPE_RGB8;
+    h[3] = LEDFX_DDP_ID_DISPLAY;
+    h[4] = (unsigned char) (offset >> 24);
+    h[5] = (unsigned char) (offset >> 16);
+    h[6] = (unsigned char) (offset >> 8);
+    h[7] = (unsigned char) offset;
+    h[8] = (unsigned char) (len >> 8);
+    h[9] = (unsigned char) len;
+    d->packets[i] = h;
+    d->lengths[i] = LEDFX_DDP_HEADER_LEN + len;
+  }
+  return d;
+
+beach:
+  del_ledfx_ddp (d);
+  return NULL;
+}
+
+void
+del_ledfx_ddp (ledfx_ddp_t * d)
+{
+  if (!d)
+    return;
+  if (d->buffer)
+    AUBIO_FREE (d->buffer);
+  if (d->packets)
+    AUBIO_FREE (d->packets);
+  if (d->lengths)
+    AUBIO_FREE (d->lengths);
+  AUBIO_FREE (d);
+}
+
+uint_t
+ledfx_ddp_do (ledfx_ddp_t * d, const fvec_t * rgb)
+{
+  uint_t i, j, k = 0;
+  const smpl_t *s = rgb->data;
+  if (rgb->length != 3 * d->n_pixels) {
+    AUBIO_ERR ("ddp: expected %d values, got %d\n", 3 * d->n_pixels,
+        rgb->length);
+    return AUBIO_FAIL;
+  }
+  for (i = 0; i < d->n_packets; i++) {
+    unsigned char *h = d->packets[i], *out = h + LEDFX_DDP_HEADER_LEN;
+    uint_t len = d->lengths[i] - LEDFX_DDP_HEADER_LEN;
+    h[1] = (unsigned char) d->sequence;
+    for (j = 0; j < len; j++, k++) {
+      /* written so that NaN gives 0 */
+      smpl_t v = s[k];
+      out[j] = v >= 255. ? 255 : (v > 0. ? (unsigned char) v : 0);
+    }
+  }
+  d->sequence = d->sequence % LEDFX_DDP_MAX_SEQUENCE + 1;
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_ddp_send (ledfx_ddp_t * d, ledfx_udp_t * u)
+{
+  return ledfx_udp_send (u, (const unsigned char *const *) d->packets,
+      d->lengths, d->n_packets);
+}
+
+uint_t
+ledfx_ddp_get_n_packets (const ledfx_ddp_t * d)
+{
+  return d->n_packets;
+}
+
+const unsigned char *const *
+ledfx_ddp_get_packets (const ledfx_ddp_t * d)
+{
+  return (const unsigned char *const *) d->packets;
+}
+
+const uint_t *
+ledfx_ddp_get_lengths (const ledfx_ddp_t * d)
+{
+  return d->lengths;
+}
+
+uint_t
+ledfx_ddp_get_n_pixels (const ledfx_ddp_t * d)
+{
+  return d->n_pixels;
+}
@@ -0,0 +1,126 @@
+/*
+  DDP (Distributed Display Protocol) packetizer.
+*/
+
+#ifndef LEDFX_DDP_H
+#define LEDFX_DDP_H
+
+/** \file
+
+  DDP packetizer
+
+  Encodes a strip of r, g, b values into DDP packets, as sent to WLED and
+  other DDP receivers on port ::LEDFX_DDP_PORT. Each packet starts with the
+  10 byte header of the protocol, all multi-byte fields big-endian:
+
+  - byte 0: version 1 (0x40), with the PUSH flag (0x01) on the last packet
+    of the frame so the receiver displays it,
+  - byte 1: sequence number 1 to 15 in the low nibble, the same for every
+    packet of a frame and rolling from one frame to the next,
+  - byte 2: data type, 8 bit RGB (::LEDFX_DDP_TYPE_RGB8),
+  - byte 3: destination, the default output device (1),
+  - bytes 4-7: offset of the packet's data in the frame, in bytes,
+  - bytes 8-9: length of the packet's data, at most ::LEDFX_DDP_MAX_DATALEN.
+
+  Values are truncated to bytes and clamped to 0..255 as they are copied.
+  The packets are allocated by new_ledfx_ddp() and rewritten by each call to
+  ledfx_ddp_do(); ledfx_ddp_send() hands them to a ::ledfx_udp_t in one
+  batch.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** default DDP port */
+#define LEDFX_DDP_PORT 4048
+/** size of the DDP header */
+#define LEDFX_DDP_HEADER_LEN 10
+/** data bytes per packet, 480 pixels, so packets fit an Ethernet frame */
+#define LEDFX_DDP_MAX_DATALEN 1440
+/** version 1 bits of the flags byte */
+#define LEDFX_DDP_VER1 0x40
+/** push flag of the last packet of a frame */
+#define LEDFX_DDP_PUSH 0x01
+/** data type of 8 bit RGB pixels */
+#define LEDFX_DDP_TYPE_RGB8 0x0B
+/** destination of the default output device */
+#define LEDFX_DDP_ID_DISPLAY 0x01
+
+/** DDP packetizer object */
+typedef struct _ledfx_ddp_t ledfx_ddp_t;
+
+/** create a DDP packetizer
+
+  \param n_pixels number of pixels of the strip
+
+  \return newly created object, or NULL on invalid parameters
+
+*/
+ledfx_ddp_t *new_ledfx_ddp (uint_t n_pixels);
+
+/** delete a DDP packetizer
+
+  \param d object to delete, as returned by new_ledfx_ddp()
+
+*/
+void del_ledfx_ddp (ledfx_ddp_t * d);
+
+/** encode one frame and advance the sequence number
+
+  \param d DDP packetizer
+  \param rgb 3 n_pixels interleaved r, g, b values
+
+  \return 0 on success, non-zero if rgb has the wrong length
+
+*/
+uint_t ledfx_ddp_do (ledfx_ddp_t * d, const fvec_t * rgb);
+
+/** send the packets of the last frame
+
+  \param d DDP packetizer
+  \param u UDP sender connected to the receiver
+
+  \return number of packets queued by the kernel
+
+*/
+uint_t ledfx_ddp_send (ledfx_ddp_t * d, ledfx_udp_t * u);
+
+/** get number of packets per frame
+
+  \param d DDP packetizer
+
+*/
+uint_t ledfx_ddp_get_n_packets (const ledfx_ddp_t * d);
+
+/** get the packets of the last frame
+
+  \param d DDP packetizer
+
+  \return ledfx_ddp_get_n_packets() pointers to the packets, header first
+
+*/
+const unsigned char *const *ledfx_ddp_get_packets (const ledfx_ddp_t * d);
+
+/** get the length of the packets, header included
+
+  \param d DDP packetizer
+
+  \return ledfx_ddp_get_n_packets() lengths in bytes
+
+*/
+const uint_t *ledfx_ddp_get_lengths (const ledfx_ddp_t * d);
+
+/** get number of pixels
+
+  \param d DDP packetizer
+
+*/
+uint_t ledfx_ddp_get_n_pixels (const ledfx_ddp_t * d);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_DDP_H */
@@ -0,0 +1,203 @@
+#ifndef LEDFX_DELIVERY_QUEUE_H_
+#define LEDFX_DELIVERY_QUEUE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "spsc_ring_buffer.h"
+
+namespace ledfx
+{
+
+  // What the consumer does with the items that piled up while it was busy.
+  enum class DeliveryMode : uint8_t
+  {
+    // Deliver every item, one message each.
+    kDeliverAll,
+    // Deliver the newest |max_depth| items, one message each, and drop the
+    // rest.
+    kDropOldest,
+    // Deliver the newest |coalesce| items together in one message and drop
+    // the rest.
+    kCoalesce,
+  };
+
+  struct DeliveryPolicy
+  {
+    DeliveryMode mode = DeliveryMode::kDropOldest;
+    uint32_t max_depth = 4;
+    uint32_t coalesce = 4;
+  };
+
+  struct DeliveryStats
+  {
+    uint64_t queued = 0;           // items accepted by Push()
+    uint64_t messages = 0;         // deliver() calls
+    uint64_t delivered = 0;        // items passed to deliver()
+    uint64_t dropped_oldest = 0;   // items dropped by the policy
+    uint64_t dropped_overflow = 0; // items refused because the queue was full
+    uint64_t coalesced = 0;        // items merged into another item's message
+    uint64_t wakeups = 0;          // times Push() asked for a wakeup
+    size_t high_water = 0;         // most items waiting at once
+  };
+
+  // Hands small items (handles, indices) from one producer thread to one
+  // consumer thread that is woken by a message, such as the platform thread
+  // of a window, and bounds how far the consumer can fall behind.
+  //
+  // Push() asks for a wakeup only when none is pending, so however long the
+  // consumer stalls there is at most one message in its queue for this
+  // stream. When it runs, Drain() takes everything queued at once and applies
+  // the policy: older items beyond the policy's depth are handed to drop()
+  // without being delivered, so a stall costs at most one depth's worth of
+  // latency once the consumer catches up.
+  //
+  // The policy may be changed from any thread; it takes effect on the next
+  // Drain(). Nothing allocates after construction.
+  template <typename T>
+  class DeliveryQueue
+  {
+  public:
+    explicit DeliveryQueue(size_t capacity, DeliveryPolicy policy = {})
+        : ring_(capacity, OverflowPolicy::kRejectBlock),
+          scratch_(ring_.Capacity())
+    {
+      SetPolicy(policy);
+    }
+
+    DeliveryQueue(const DeliveryQueue &) = delete;
+    DeliveryQueue &operator=(const DeliveryQueue &) = delete;
+
+    void SetPolicy(const DeliveryPolicy &policy)
+    {
+      mode_.store(policy.mode, std::memory_order_relaxed);
+      max_depth_.store(policy.max_depth > 0 ? policy.max_depth : 1,
+                       std::memory_order_relaxed);
+      coalesce_.store(policy.coalesce > 0 ? policy.coalesce : 1,
+                      std::memory_order_relaxed);
+    }
+
+    DeliveryPolicy Policy() const
+    {
+      DeliveryPolicy policy;
+      policy.mode = mode_.load(std::memory_order_relaxed);
+      policy.max_depth = max_depth_.load(std::memory_order_relaxed);
+      policy.coalesce = coalesce_.load(std::memory_order_relaxed);
+      return policy;
+    }
+
+    // ---- Producer side -------------------------------------------------------
+
+    // Queues |item|. Returns false if the queue is full; the item is then not
+    // queued and stays with the caller. |*wake| is set when the consumer must
+    // be woken; if that fails, call WakeupFailed() so the next Push() asks
+    // again.
+    bool Push(const T &item, bool *wake)
+    {
+      *wake = false;
+      if (ring_.Push(&item, 1) != 1)
+      {
+        dropped_overflow_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      if (!wake_pending_.exchange(true, std::memory_order_acq_rel))
+      {
+        wakeups_.fetch_add(1, std::memory_order_relaxed);
+        *wake = true;
+      }
+      return true;
+    }
+
+    // Counts an item the producer could not even queue, e.g. because its
+    // payload could not be allocated.
+    void CountOverflow() { dropped_overflow_.fetch_add(1, std::memory_order_relaxed); }
+
+    void WakeupFailed() { wake_pending_.store(false, std::memory_order_release); }
+
+    // ---- Consumer side -------------------------------------------------------
+
+    // Takes every queued item and applies the policy, oldest first:
+    //   drop(const T &item) for each item the policy discards, then
+    //   deliver(const T *items, size_t count, bool after_drop) per message.
+    // |after_drop| is set on the first message following dropped items.
+    // Returns the number of items taken.
+    template <typename Deliver, typename Drop>
+    size_t Drain(Deliver &&deliver, Drop &&drop)
+    {
+      // Cleared first: an item pushed from here on either is taken below or
+      // asks for a new wakeup.
+      wake_pending_.store(false, std::memory_order_release);
+      const size_t count = ring_.Pop(scratch_.data(), scratch_.size());
+      if (count == 0)
+        return 0;
+      if (count > high_water_.load(std::memory_order_relaxed))
+        high_water_.store(count, std::memory_order_relaxed);
+
+      const DeliveryMode mode = mode_.load(std::memory_order_relaxed);
+      size_t keep = count;
+      if (mode == DeliveryMode::kDropOldest)
+        keep = std::min<size_t>(count, max_depth_.load(std::memory_order_relaxed));
+      else if (mode == DeliveryMode::kCoalesce)
+        keep = std::min<size_t>(count, coalesce_.load(std::memory_order_relaxed));
+
+      const size_t dropped = count - keep;
+      for (size_t i = 0; i < dropped; i++)
+        drop(scratch_[i]);
+      dropped_oldest_.fetch_add(dropped, std::memory_order_relaxed);
+
+      const T *items = scratch_.data() + dropped;
+      if (mode == DeliveryMode::kCoalesce)
+      {
+        deliver(items, keep, dropped > 0);
+        messages_.fetch_add(1, std::memory_order_relaxed);
+        coalesced_.fetch_add(keep - 1, std::memory_order_relaxed);
+      }
+      else
+      {
+        for (size_t i = 0; i < keep; i++)
+          deliver(items + i, size_t{1}, i == 0 && dropped > 0);
+        messages_.fetch_add(keep, std::memory_order_relaxed);
+      }
+      delivered_.fetch_add(keep, std::memory_order_relaxed);
+      return count;
+    }
+
+    // May be called from any thread.
+    DeliveryStats Stats() const
+    {
+      DeliveryStats stats;
+      stats.queued = ring_.Stats().pushed;
+      stats.messages = messages_.load(std::memory_order_relaxed);
+      stats.delivered = delivered_.load(std::memory_order_relaxed);
+      stats.dropped_oldest = dropped_oldest_.load(std::memory_order_relaxed);
+      stats.dropped_overflow = dropped_overflow_.load(std::memory_order_relaxed);
+      stats.coalesced = coalesced_.load(std::memory_order_relaxed);
+      stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+      stats.high_water = high_water_.load(std::memory_order_relaxed);
+      return stats;
+    }
+
+  private:
+    SpscRingBuffer<T> ring_;
+    std::vector<T> scratch_; // items of the current Drain(), consumer only
+    std::atomic<bool> wake_pending_{false};
+
+    std::atomic<DeliveryMode> mode_{DeliveryMode::kDropOldest};
+    std::atomic<uint32_t> max_depth_{4};
+    std::atomic<uint32_t> coalesce_{4};
+
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_oldest_{0};
+    std::atomic<uint64_t> dropped_overflow_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<size_t> high_water_{0};
+  };
+
+} // namespace ledfx
+
+#endif // LEDFX_DELIVERY_QUEUE_H_
@@ -0,0 +1,299 @@
+/*
+  Real FFT with a backend selected at build time.
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "mathutils.h"
+#include "spectral/fft.h"
+#include "fft.h"
+
+/* backend of new_ledfx_fft(), set from AUBIO_FFT_BACKEND */
+#ifndef LEDFX_FFT_DEFAULT_BACKEND
+#define LEDFX_FFT_DEFAULT_BACKEND LEDFX_FFT_OOURA
+#endif
+
+/* twiddle factors of one size, shared by all the FFTs of that size */
+typedef struct _ledfx_fft_twiddles_t ledfx_fft_twiddles_t;
+
+struct _ledfx_fft_twiddles_t {
+  uint_t size;              /** real FFT size N */
+  uint_t refs;              /** number of FFTs using the table */
+  smpl_t *re;               /** cos (2 pi k / N), k < N / 2 */
+  smpl_t *im;               /** -sin (2 pi k / N), k < N / 2 */
+  ledfx_fft_twiddles_t *next; /** next table in the registry */
+};
+
+struct _ledfx_fft_t {
+  uint_t win_s;             /** FFT size */
+  ledfx_fft_backend_t backend; /** backend in use */
+  aubio_fft_t *ooura;       /** LEDFX_FFT_OOURA: aubio FFT */
+  ledfx_fft_twiddles_t *twiddles; /** LEDFX_FFT_STOCKHAM: shared twiddles */
+  smpl_t *buf[4];           /** LEDFX_FFT_STOCKHAM: re/im ping-pong */
+};
+
+/* registry of twiddle tables, guarded by ledfx_fft_lock */
+static ledfx_fft_twiddles_t *ledfx_fft_registry = NULL;
+
+#ifdef _WIN32
+static SRWLOCK ledfx_fft_lock = SRWLOCK_INIT;
+#define LEDFX_FFT_LOCK() AcquireSRWLockExclusive (&ledfx_fft_lock)
+#define LEDFX_FFT_UNLOCK() ReleaseSRWLockExclusive (&ledfx_fft_lock)
+#else
+static pthread_mutex_t ledfx_fft_lock = PTHREAD_MUTEX_INITIALIZER;
+#define LEDFX_FFT_LOCK() pthread_mutex_lock (&ledfx_fft_lock)
+#define LEDFX_FFT_UNLOCK() pthread_mutex_unlock (&ledfx_fft_lock)
+#endif
+
+static ledfx_fft_twiddles_t *
+ledfx_fft_twiddles_acquire (uint_t size)
+{
+  ledfx_fft_twiddles_t *t;
+  uint_t k;
+  LEDFX_FFT_LOCK ();
+  for (t = ledfx_fft_registry; t; t = t->next) {
+    if (t->size == size) {
+      t->refs++;
+      goto done;
+    }
+  }
+  t = AUBIO_NEW (ledfx_fft_twiddles_t);
+  if (!t)
+    goto done;
+  t->re = AUBIO_ARRAY (smpl_t, size / 2);
+  t->im = AUBIO_ARRAY (smpl_t, size / 2);
+  if (!t->re || !t->im) {
+    if (t->re)
+      AUBIO_FREE (t->re);
+    if (t->im)
+      AUBIO_FREE (t->im);
+    AUBIO_FREE (t);
+    t = NULL;
+    goto done;
+  }
+  /* computed in double precision, rounded once */
+  for (k = 0; k < size / 2; k++) {
+    double phase = 2. * PI * (double) k / (double) size;
+    t->re[k] = (smpl_t) cos (phase);
+    t->im[k] = (smpl_t) - sin (phase);
+  }
+  t->size = size;
+  t->refs = 1;
+  t->next = ledfx_fft_registry;
+  ledfx_fft_registry = t;
+done:
+  LEDFX_FFT_UNLOCK ();
+  return t;
+}
+
+static void
+ledfx_fft_twiddles_release (ledfx_fft_twiddles_t * t)
+{
+  ledfx_fft_twiddles_t **link;
+  LEDFX_FFT_LOCK ();
+  if (--t->refs == 0) {
+    for (link = &ledfx_fft_registry; *link; link = &(*link)->next) {
+      if (*link == t) {
+        *link = t->next;
+        break;
+      }
+    }
+    AUBIO_FREE (t->re);
+    AUBIO_FREE (t->im);
+    AUBIO_FREE (t);
+  }
+  LEDFX_FFT_UNLOCK ();
+}
+
+ledfx_fft_t *
+new_ledfx_fft (uint_t win_s)
+{
+  return new_ledfx_fft_with_backend (win_s, LEDFX_FFT_DEFAULT_BACKEND);
+}
+
+ledfx_fft_t *
+new_ledfx_fft_with_backend (uint_t win_s, ledfx_fft_backend_t backend)
+{
+  ledfx_fft_t *s = AUBIO_NEW (ledfx_fft_t);
+  uint_t i;
+  if ((sint_t) win_s < 2 || !aubio_is_power_of_two (win_s)) {
+    AUBIO_ERR ("fft: can only create with sizes power of two, got %d\n",
+        win_s);
+    goto beach;
+  }
+  s->win_s = win_s;
+  s->backend = backend;
+  switch (backend) {
+    case LEDFX_FFT_OOURA:
+      s->ooura = new_aubio_fft (win_s);
+      if (!s->ooura)
+        goto beach;
+      break;
+    case LEDFX_FFT_STOCKHAM:
+      s->twiddles = ledfx_fft_twiddles_acquire (win_s);
+      if (!s->twiddles)
+        goto beach;
+      for (i = 0; i < 4; i++) {
+        s->buf[i] = AUBIO_ARRAY (smpl_t, win_s / 2);
+        if (!s->buf[i])
+          goto beach;
+      }
+      break;
+    default:
+      AUBIO_ERR ("fft: unknown backend %d\n", (sint_t) backend);
+      goto beach;
+  }
+  return s;
+
+beach:
+  del_ledfx_fft (s);
+  return NULL;
+}
+
+void
+del_ledfx_fft (ledfx_fft_t * s)
+{
+  uint_t i;
+  if (!s)
+    return;
+  if (s->ooura)
+    del_aubio_fft (s->ooura);
+  if (s->twiddles)
+    ledfx_fft_twiddles_release (s->twiddles);
+  for (i = 0; i < 4; i++) {
+    if (s->buf[i])
+      AUBIO_FREE (s->buf[i]);
+  }
+  AUBIO_FREE (s);
+}
+
+/* complex FFT of n points in split format, radix-2 Stockham autosort: every
+ * pass reads one buffer pair and writes the other in natural order, with
+ * the innermost loop over contiguous samples. tw_step is the twiddle index
+ * step of the first pass; returns the index of the buffer pair holding the
+ * result, 0 for (xr, xi) or 1 for (yr, yi). */
+static uint_t
+ledfx_fft_stockham (uint_t n, smpl_t * xr, smpl_t * xi, smpl_t * yr,
+    smpl_t * yi, const smpl_t * twr, const smpl_t * twi, uint_t tw_step)
+{
+  uint_t len = n, stride = 1, p, q, out = 0;
+  while (len > 1) {
+    const uint_t half = len / 2;
+    smpl_t *tmp;
+    if (stride == 1) {
+      /* first pass: even and odd outputs are interleaved */
+      for (p = 0; p < half; p++) {
+        const smpl_t wr = twr[p * tw_step], wi = twi[p * tw_step];
+        const smpl_t ar = xr[p], ai = xi[p];
+        const smpl_t br = xr[p + half], bi = xi[p + half];
+        const smpl_t dr = ar - br, di = ai - bi;
+        yr[2 * p] = ar + br;
+        yi[2 * p] = ai + bi;
+        yr[2 * p + 1] = dr * wr - di * wi;
+        yi[2 * p + 1] = dr * wi + di * wr;
+      }
+    } else {
+      for (p = 0; p < half; p++) {
+        const smpl_t wr = twr[p * tw_step], wi = twi[p * tw_step];
+        const smpl_t *ar = xr + stride * p, *ai = xi + stride * p;
+        const smpl_t *br = xr + stride * (p + half);
+        const smpl_t *bi = xi + stride * (p + half);
+        smpl_t *sr = yr + stride * 2 * p, *si = yi + stride * 2 * p;
+        smpl_t *dr = sr + stride, *di = si + stride;
+        for (q = 0; q < stride; q++) {
+          const smpl_t tr = ar[q] - br[q], ti = ai[q] - bi[q];
+          sr[q] = ar[q] + br[q];
+          si[q] = ai[q] + bi[q];
+          dr[q] = tr * wr - ti * wi;
+          di[q] = tr * wi + ti * wr;
+        }
+      }
+    }
+    len = half;
+    stride *= 2;
+    tw_step *= 2;
+    tmp = xr;
+    xr = yr;
+    yr = tmp;
+    tmp = xi;
+    xi = yi;
+    yi = tmp;
+    out ^= 1;
+  }
+  return out;
+}
+
+/* real FFT of win_s points through a complex FFT of win_s / 2 points on
+ * the even and odd samples, then one pass splitting the two spectra */
+static void
+ledfx_fft_stockham_do (ledfx_fft_t * s, const smpl_t * in, smpl_t * out)
+{
+  const uint_t n = s->win_s, m = n / 2;
+  const smpl_t *twr = s->twiddles->re, *twi = s->twiddles->im;
+  smpl_t *zr, *zi;
+  uint_t j, k;
+
+  for (j = 0; j < m; j++) {
+    s->buf[0][j] = in[2 * j];
+    s->buf[1][j] = in[2 * j + 1];
+  }
+  /* the table holds the twiddles of n points, those of m are every other */
+  if (ledfx_fft_stockham (m, s->buf[0], s->buf[1], s->buf[2], s->buf[3],
+          twr, twi, 2) == 0) {
+    zr = s->buf[0];
+    zi = s->buf[1];
+  } else {
+    zr = s->buf[2];
+    zi = s->buf[3];
+  }
+
+  /* X[k] = E[k] + W^k O[k], with E and O recovered from Z[k] and
+   * conj (Z[m - k]) */
+  out[0] = zr[0] + zi[0];
+  out[m] = zr[0] - zi[0];
+  for (k = 1; k < m; k++) {
+    const smpl_t ar = zr[k], ai = zi[k];
+    const smpl_t br = zr[m - k], bi = -zi[m - k];
+    const smpl_t er = .5 * (ar + br), ei = .5 * (ai + bi);
+    /* O = (Z[k] - conj (Z[m - k])) / 2i */
+    const smpl_t or_ = .5 * (ai - bi), oi = -.5 * (ar - br);
+    out[k] = er + or_ * twr[k] - oi * twi[k];
+    out[n - k] = ei + or_ * twi[k] + oi * twr[k];
+  }
+}
+
+void
+ledfx_fft_do_complex (ledfx_fft_t * s, const fvec_t * input,
+    fvec_t * compspec)
+{
+  if (s->backend == LEDFX_FFT_STOCKHAM) {
+    ledfx_fft_stockham_do (s, input->data, compspec->data);
+  } else {
+    aubio_fft_do_complex (s->ooura, input, compspec);
+  }
+}
+
+ledfx_fft_backend_t
+ledfx_fft_get_backend (const ledfx_fft_t * s)
+{
+  return s->backend;
+}
+
+const char_t *
+ledfx_fft_get_backend_name (ledfx_fft_backend_t backend)
+{
+  switch (backend) {
+    case LEDFX_FFT_OOURA:
+      return "ooura";
+    case LEDFX_FFT_STOCKHAM:
+      return "stockham";
+    default:
+      return "unknown";
+  }
+}
@@ -0,0 +1,99 @@
+/*
+  Real FFT with a backend selected at build time.
+*/
+
+#ifndef LEDFX_FFT_H
+#define LEDFX_FFT_H
+
+/** \file
+
+  Forward real FFT used by the audio front-end
+
+  Two backends are built in:
+
+  - LEDFX_FFT_OOURA wraps aubio_fft_t, aubio's bundled Ooura FFT,
+  - LEDFX_FFT_STOCKHAM is a split-format Stockham autosort FFT whose
+    inner loops run over contiguous arrays, so that they vectorise. Its
+    twiddle factors are computed once per size and shared by every
+    instance of that size.
+
+  new_ledfx_fft() uses the backend chosen with the AUBIO_FFT_BACKEND CMake
+  option; new_ledfx_fft_with_backend() picks one explicitly, e.g. for
+  benchmarks.
+
+  Both write the spectrum in the layout of aubio_fft_do_complex(), so the
+  output can be converted with aubio_fft_get_spectrum() or the kernels of
+  kernels.h.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** FFT backends */
+typedef enum {
+  LEDFX_FFT_OOURA = 0,      /**< aubio_fft_t */
+  LEDFX_FFT_STOCKHAM,       /**< bundled Stockham FFT */
+} ledfx_fft_backend_t;
+
+/** FFT object */
+typedef struct _ledfx_fft_t ledfx_fft_t;
+
+/** create FFT with the default backend
+
+  \param win_s size of the FFT, a power of two
+
+  \return newly created object, or NULL on invalid size
+
+*/
+ledfx_fft_t *new_ledfx_fft (uint_t win_s);
+
+/** create FFT with a given backend
+
+  \param win_s size of the FFT, a power of two
+  \param backend backend to use
+
+  \return newly created object, or NULL on invalid size
+
+*/
+ledfx_fft_t *new_ledfx_fft_with_backend (uint_t win_s,
+    ledfx_fft_backend_t backend);
+
+/** delete FFT
+
+  \param s object to delete, as returned by new_ledfx_fft()
+
+*/
+void del_ledfx_fft (ledfx_fft_t * s);
+
+/** compute forward FFT
+
+  \param s FFT object
+  \param input real input signal, of length win_s
+  \param compspec output, of length win_s: the real parts of bins 0 to
+  win_s / 2 followed by the imaginary parts of bins win_s / 2 - 1 down to 1
+
+*/
+void ledfx_fft_do_complex (ledfx_fft_t * s, const fvec_t * input,
+    fvec_t * compspec);
+
+/** get backend of an FFT object
+
+  \param s FFT object
+
+*/
+ledfx_fft_backend_t ledfx_fft_get_backend (const ledfx_fft_t * s);
+
+/** get name of a backend, e.g. "stockham"
+
+  \param backend backend
+
+*/
+const char_t *ledfx_fft_get_backend_name (ledfx_fft_backend_t backend);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_FFT_H */
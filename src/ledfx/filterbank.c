@@ -0,0 +1,249 @@
+/*
+  Sparse triangular filterbank evaluating several filter sets per call.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "fmat.h"
+#include "spectral/filterbank.h"
+#include "spectral/filterbank_mel.h"
+#include "kernels.h"
+#include "filterbank.h"
+
+struct _ledfx_filterbank_t {
+  uint_t win_s;             /** window size of the input spectra */
+  uint_t n_bins;            /** win_s / 2 + 1 */
+  uint_t n_banks;           /** number of filter sets */
+  uint_t n_rows;            /** number of filters, over all banks */
+  uint_t n_weights;         /** number of stored weights */
+  uint_t *bank_row;         /** first row of each bank, n_banks + 1 */
+  uint_t *row_start;        /** first non-zero bin of each row */
+  uint_t *row_length;       /** number of bins covered by each row */
+  uint_t *row_offset;       /** offset of each row in weights */
+  smpl_t *weights;          /** non-zero weights, row after row */
+  fvec_t **outputs;         /** one output buffer per bank */
+  const ledfx_kernels_t *kernels; /** vector kernels for this CPU */
+};
+
+static void *
+ledfx_filterbank_grow (void *ptr, size_t size)
+{
+  void *grown = realloc (ptr, size);
+  if (!grown) {
+    AUBIO_ERR ("filterbank: failed allocating %lu bytes\n",
+        (unsigned long) size);
+  }
+  return grown;
+}
+
+/* span from the first to the last non-zero weight of a row; returns its
+ * length and writes its first bin to start */
+static uint_t
+ledfx_filterbank_row_span (const smpl_t * row, uint_t length, uint_t * start)
+{
+  uint_t j, first = 0, last = 0, found = 0;
+  for (j = 0; j < length; j++) {
+    if (row[j] != 0.) {
+      if (!found)
+        first = j;
+      last = j;
+      found = 1;
+    }
+  }
+  *start = first;
+  return found ? last - first + 1 : 0;
+}
+
+ledfx_filterbank_t *
+new_ledfx_filterbank (uint_t win_s)
+{
+  ledfx_filterbank_t *fb = AUBIO_NEW (ledfx_filterbank_t);
+  if ((sint_t) win_s < 2) {
+    AUBIO_ERR ("filterbank: got win_s %d, but can not be < 2\n", win_s);
+    AUBIO_FREE (fb);
+    return NULL;
+  }
+  fb->win_s = win_s;
+  fb->n_bins = win_s / 2 + 1;
+  fb->bank_row = AUBIO_ARRAY (uint_t, 1);
+  fb->kernels = ledfx_kernels ();
+  return fb;
+}
+
+void
+del_ledfx_filterbank (ledfx_filterbank_t * fb)
+{
+  uint_t i;
+  if (!fb)
+    return;
+  for (i = 0; i < fb->n_banks; i++) {
+    del_fvec (fb->outputs[i]);
+  }
+  free (fb->outputs);
+  free (fb->bank_row);
+  free (fb->row_start);
+  free (fb->row_length);
+  free (fb->row_offset);
+  free (fb->weights);
+  AUBIO_FREE (fb);
+}
+
+sint_t
+ledfx_filterbank_add_coeffs (ledfx_filterbank_t * fb, const fmat_t * coeffs)
+{
+  uint_t i, j, n_rows, n_weights;
+  uint_t length = MIN (coeffs->length, fb->n_bins);
+  fvec_t *output;
+  void *grown;
+
+  if (coeffs->height < 1) {
+    AUBIO_ERR ("filterbank: got an empty coefficient matrix\n");
+    return -1;
+  }
+  if (coeffs->length != fb->n_bins) {
+    AUBIO_WRN ("filterbank: got %d coefficients per filter, expected %d\n",
+        coeffs->length, fb->n_bins);
+  }
+
+  /* count the non-zero span of each row */
+  n_rows = fb->n_rows + coeffs->height;
+  n_weights = fb->n_weights;
+  for (i = 0; i < coeffs->height; i++) {
+    n_weights += ledfx_filterbank_row_span (coeffs->data[i], length, &j);
+  }
+
+  output = new_fvec (coeffs->height);
+  if (!output)
+    return -1;
+  if (!(grown = ledfx_filterbank_grow (fb->row_start, n_rows * sizeof (uint_t))))
+    goto fail;
+  fb->row_start = (uint_t *) grown;
+  if (!(grown = ledfx_filterbank_grow (fb->row_length, n_rows * sizeof (uint_t))))
+    goto fail;
+  fb->row_length = (uint_t *) grown;
+  if (!(grown = ledfx_filterbank_grow (fb->row_offset, n_rows * sizeof (uint_t))))
+    goto fail;
+  fb->row_offset = (uint_t *) grown;
+  if (!(grown = ledfx_filterbank_grow (fb->weights,
+              MAX (n_weights, 1) * sizeof (smpl_t))))
+    goto fail;
+  fb->weights = (smpl_t *) grown;
+  if (!(grown = ledfx_filterbank_grow (fb->bank_row,
+              (fb->n_banks + 2) * sizeof (uint_t))))
+    goto fail;
+  fb->bank_row = (uint_t *) grown;
+  if (!(grown = ledfx_filterbank_grow (fb->outputs,
+              (fb->n_banks + 1) * sizeof (fvec_t *))))
+    goto fail;
+  fb->outputs = (fvec_t **) grown;
+
+  /* store each row's span and weights */
+  n_weights = fb->n_weights;
+  for (i = 0; i < coeffs->height; i++) {
+    const smpl_t *row = coeffs->data[i];
+    const uint_t r = fb->n_rows + i;
+    fb->row_length[r] =
+        ledfx_filterbank_row_span (row, length, &fb->row_start[r]);
+    fb->row_offset[r] = n_weights;
+    for (j = 0; j < fb->row_length[r]; j++) {
+      fb->weights[n_weights + j] = row[fb->row_start[r] + j];
+    }
+    n_weights += fb->row_length[r];
+  }
+
+  fb->outputs[fb->n_banks] = output;
+  fb->bank_row[fb->n_banks] = fb->n_rows;
+  fb->bank_row[fb->n_banks + 1] = n_rows;
+  fb->n_rows = n_rows;
+  fb->n_weights = n_weights;
+  return (sint_t) fb->n_banks++;
+
+fail:
+  /* arrays already grown keep their old contents and stay valid */
+  del_fvec (output);
+  return -1;
+}
+
+sint_t
+ledfx_filterbank_add_triangle_bands (ledfx_filterbank_t * fb,
+    const fvec_t * freqs, smpl_t samplerate)
+{
+  sint_t bank = -1;
+  aubio_filterbank_t *dense;
+
+  if (freqs->length < 3) {
+    AUBIO_ERR ("filterbank: need at least 3 band edges, got %d\n",
+        freqs->length);
+    return -1;
+  }
+  dense = new_aubio_filterbank (freqs->length - 2, fb->win_s);
+  if (!dense)
+    return -1;
+  if (aubio_filterbank_set_triangle_bands (dense, freqs, samplerate)
+      == AUBIO_OK) {
+    bank = ledfx_filterbank_add_coeffs (fb, aubio_filterbank_get_coeffs (dense));
+  }
+  del_aubio_filterbank (dense);
+  return bank;
+}
+
+static void
+ledfx_filterbank_do_rows (const ledfx_filterbank_t * fb, uint_t row,
+    uint_t n_rows, const smpl_t * norm, smpl_t * out)
+{
+  uint_t i;
+  for (i = 0; i < n_rows; i++) {
+    const uint_t r = row + i;
+    out[i] = fb->kernels->dot (fb->weights + fb->row_offset[r],
+        norm + fb->row_start[r], fb->row_length[r]);
+  }
+}
+
+void
+ledfx_filterbank_do (ledfx_filterbank_t * fb, const cvec_t * in)
+{
+  uint_t b;
+  for (b = 0; b < fb->n_banks; b++) {
+    ledfx_filterbank_do_rows (fb, fb->bank_row[b],
+        fb->bank_row[b + 1] - fb->bank_row[b], in->norm, fb->outputs[b]->data);
+  }
+}
+
+void
+ledfx_filterbank_do_bank (ledfx_filterbank_t * fb, uint_t bank,
+    const cvec_t * in, fvec_t * out)
+{
+  uint_t n_rows;
+  if (bank >= fb->n_banks)
+    return;
+  n_rows = MIN (fb->bank_row[bank + 1] - fb->bank_row[bank], out->length);
+  ledfx_filterbank_do_rows (fb, fb->bank_row[bank], n_rows, in->norm,
+      out->data);
+}
+
+fvec_t *
+ledfx_filterbank_get_output (ledfx_filterbank_t * fb, uint_t bank)
+{
+  return bank < fb->n_banks ? fb->outputs[bank] : NULL;
+}
+
+uint_t
+ledfx_filterbank_get_n_banks (const ledfx_filterbank_t * fb)
+{
+  return fb->n_banks;
+}
+
+uint_t
+ledfx_filterbank_get_n_filters (const ledfx_filterbank_t * fb, uint_t bank)
+{
+  if (bank >= fb->n_banks)
+    return 0;
+  return fb->bank_row[bank + 1] - fb->bank_row[bank];
+}
+
+uint_t
+ledfx_filterbank_get_n_weights (const ledfx_filterbank_t * fb)
+{
+  return fb->n_weights;
+}
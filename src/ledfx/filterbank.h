@@ -0,0 +1,136 @@
+/*
+  Sparse triangular filterbank evaluating several filter sets per call.
+*/
+
+#ifndef LEDFX_FILTERBANK_H
+#define LEDFX_FILTERBANK_H
+
+/** \file
+
+  Sparse filterbank
+
+  Triangular filters, as built by aubio_filterbank_set_triangle_bands(), are
+  mostly zeros: each filter only covers the spectrum bins between its
+  neighbouring band edges. This object stores, for each filter, the first
+  non-zero bin, the number of bins covered and their weights, and skips the
+  zeros aubio_filterbank_do() multiplies through.
+
+  Several filter sets ("banks") can be added to the same object, e.g. one
+  per melbank resolution. ledfx_filterbank_do() then evaluates every bank
+  for one spectrum in a single call, writing each into its own output
+  buffer.
+
+  Banks are added once at setup; ledfx_filterbank_do() does not allocate.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** sparse filterbank object */
+typedef struct _ledfx_filterbank_t ledfx_filterbank_t;
+
+/** create an empty sparse filterbank
+
+  \param win_s window size of the spectra to process; each filter spans
+  win_s / 2 + 1 bins
+
+  \return newly created object, or NULL on invalid parameters
+
+*/
+ledfx_filterbank_t *new_ledfx_filterbank (uint_t win_s);
+
+/** delete sparse filterbank
+
+  \param fb object to delete, as returned by new_ledfx_filterbank()
+
+*/
+void del_ledfx_filterbank (ledfx_filterbank_t * fb);
+
+/** add a bank from a dense coefficient matrix
+
+  \param fb sparse filterbank
+  \param coeffs matrix of n_filters rows of win_s / 2 + 1 weights, e.g. as
+  returned by aubio_filterbank_get_coeffs()
+
+  \return index of the new bank, or -1 on error
+
+*/
+sint_t ledfx_filterbank_add_coeffs (ledfx_filterbank_t * fb,
+    const fmat_t * coeffs);
+
+/** add a bank of triangular filters
+
+  \param fb sparse filterbank
+  \param freqs band edges in Hz; freqs->length - 2 filters are created,
+  see aubio_filterbank_set_triangle_bands()
+  \param samplerate sampling rate of the analysed signal
+
+  \return index of the new bank, or -1 on error
+
+*/
+sint_t ledfx_filterbank_add_triangle_bands (ledfx_filterbank_t * fb,
+    const fvec_t * freqs, smpl_t samplerate);
+
+/** compute the output of every bank
+
+  \param fb sparse filterbank
+  \param in input spectrum, of length win_s / 2 + 1
+
+  Results are written to the buffers returned by
+  ledfx_filterbank_get_output().
+
+*/
+void ledfx_filterbank_do (ledfx_filterbank_t * fb, const cvec_t * in);
+
+/** compute the output of a single bank
+
+  \param fb sparse filterbank
+  \param bank index of the bank, as returned when it was added
+  \param in input spectrum, of length win_s / 2 + 1
+  \param out output vector; at most out->length filters are computed
+
+*/
+void ledfx_filterbank_do_bank (ledfx_filterbank_t * fb, uint_t bank,
+    const cvec_t * in, fvec_t * out);
+
+/** get the output buffer of a bank
+
+  \param fb sparse filterbank
+  \param bank index of the bank
+
+  \return buffer of one value per filter, updated by ledfx_filterbank_do(),
+  or NULL if the bank does not exist
+
+*/
+fvec_t *ledfx_filterbank_get_output (ledfx_filterbank_t * fb, uint_t bank);
+
+/** get the number of banks
+
+  \param fb sparse filterbank
+
+*/
+uint_t ledfx_filterbank_get_n_banks (const ledfx_filterbank_t * fb);
+
+/** get the number of filters in a bank
+
+  \param fb sparse filterbank
+  \param bank index of the bank
+
+*/
+uint_t ledfx_filterbank_get_n_filters (const ledfx_filterbank_t * fb,
+    uint_t bank);
+
+/** get the number of stored weights, summed over all banks
+
+  \param fb sparse filterbank
+
+*/
+uint_t ledfx_filterbank_get_n_weights (const ledfx_filterbank_t * fb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_FILTERBANK_H */
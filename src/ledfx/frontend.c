@@ -0,0 +1,155 @@
+/*
+  Fused audio front-end: pre-emphasis, volume gate and phase vocoder.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "temporal/filter.h"
+#include "temporal/biquad.h"
+#include "kernels.h"
+#include "pvoc.h"
+#include "frontend.h"
+
+/* smoothing of the volume used by the gate, rise and decay alike */
+#define LEDFX_FRONTEND_VOLUME_ALPHA 0.99
+/* initial value of the smoothed volume */
+#define LEDFX_FRONTEND_VOLUME_INIT -90.
+
+struct _ledfx_frontend_t {
+  uint_t win_s;             /** phase vocoder window size */
+  uint_t hop_s;             /** samples per call */
+  aubio_filter_t *pre_emphasis; /** pre-emphasis biquad */
+  ledfx_pvoc_t *pvoc;       /** phase vocoder */
+  fvec_t *input;            /** raw input, filled by the caller */
+  fvec_t *filtered;         /** pre-emphasised input */
+  cvec_t *spectrum;         /** phase vocoder output */
+  smpl_t min_volume;        /** volume gate threshold */
+  smpl_t db;                /** level of the last input */
+  smpl_t volume;            /** volume of the last input */
+  smpl_t volume_filtered;   /** smoothed volume */
+  const ledfx_kernels_t *kernels; /** vector kernels for this CPU */
+};
+
+ledfx_frontend_t *
+new_ledfx_frontend (uint_t win_s, uint_t hop_s)
+{
+  ledfx_frontend_t *f = AUBIO_NEW (ledfx_frontend_t);
+  if ((sint_t) hop_s < 1 || (sint_t) win_s < 2) {
+    AUBIO_ERR ("frontend: got win_s %d and hop_s %d\n", win_s, hop_s);
+    goto beach;
+  }
+  f->win_s = win_s;
+  f->hop_s = hop_s;
+
+  f->pre_emphasis = new_aubio_filter_biquad (1., 0., 0., 0., 0.);
+  f->pvoc = new_ledfx_pvoc (win_s, hop_s);
+  f->input = new_fvec (hop_s);
+  f->filtered = new_fvec (hop_s);
+  f->spectrum = new_cvec (win_s);
+  if (!f->pre_emphasis || !f->pvoc || !f->input || !f->filtered
+      || !f->spectrum) {
+    goto beach;
+  }
+
+  f->min_volume = 0.;
+  f->db = -90.;
+  f->volume = 0.;
+  f->volume_filtered = LEDFX_FRONTEND_VOLUME_INIT;
+  f->kernels = ledfx_kernels ();
+  return f;
+
+beach:
+  del_ledfx_frontend (f);
+  return NULL;
+}
+
+void
+del_ledfx_frontend (ledfx_frontend_t * f)
+{
+  if (!f)
+    return;
+  if (f->pre_emphasis)
+    del_aubio_filter (f->pre_emphasis);
+  if (f->pvoc)
+    del_ledfx_pvoc (f->pvoc);
+  if (f->input)
+    del_fvec (f->input);
+  if (f->filtered)
+    del_fvec (f->filtered);
+  if (f->spectrum)
+    del_cvec (f->spectrum);
+  AUBIO_FREE (f);
+}
+
+uint_t
+ledfx_frontend_do (ledfx_frontend_t * f)
+{
+  smpl_t volume;
+  const smpl_t alpha = LEDFX_FRONTEND_VOLUME_ALPHA;
+
+  /* volume used for silence detection, as aubio_db_spl () */
+  f->db = 10. * LOG10 (f->kernels->sum_sq (f->input->data, f->hop_s)
+      / f->hop_s);
+  volume = 1. + f->db / 100.;
+  /* also maps -inf (digital silence) and NaN to 0 */
+  if (!(volume > 0.))
+    volume = 0.;
+  if (volume > 1.)
+    volume = 1.;
+  f->volume = volume;
+  f->volume_filtered = alpha * volume + (1. - alpha) * f->volume_filtered;
+
+  if (f->volume_filtered > f->min_volume) {
+    aubio_filter_do_outplace (f->pre_emphasis, f->input, f->filtered);
+    ledfx_pvoc_do (f->pvoc, f->filtered, f->spectrum);
+    return 1;
+  }
+
+  cvec_norm_zeros (f->spectrum);
+  cvec_phas_zeros (f->spectrum);
+  return 0;
+}
+
+uint_t
+ledfx_frontend_set_biquad (ledfx_frontend_t * f, lsmp_t b0, lsmp_t b1,
+    lsmp_t b2, lsmp_t a1, lsmp_t a2)
+{
+  return aubio_filter_set_biquad (f->pre_emphasis, b0, b1, b2, a1, a2);
+}
+
+void
+ledfx_frontend_set_min_volume (ledfx_frontend_t * f, smpl_t min_volume)
+{
+  f->min_volume = min_volume;
+}
+
+fvec_t *
+ledfx_frontend_get_input (ledfx_frontend_t * f)
+{
+  return f->input;
+}
+
+fvec_t *
+ledfx_frontend_get_filtered (ledfx_frontend_t * f)
+{
+  return f->filtered;
+}
+
+cvec_t *
+ledfx_frontend_get_spectrum (ledfx_frontend_t * f)
+{
+  return f->spectrum;
+}
+
+smpl_t
+ledfx_frontend_get_db (ledfx_frontend_t * f)
+{
+  return f->db;
+}
+
+smpl_t
+ledfx_frontend_get_volume (ledfx_frontend_t * f, uint_t filtered)
+{
+  return filtered ? f->volume_filtered : f->volume;
+}
@@ -0,0 +1,138 @@
+/*
+  Fused audio front-end: pre-emphasis, volume gate and phase vocoder.
+*/
+
+#ifndef LEDFX_FRONTEND_H
+#define LEDFX_FRONTEND_H
+
+/** \file
+
+  Audio front-end running once per hop
+
+  The caller writes one hop of samples into the buffer returned by
+  ledfx_frontend_get_input() and calls ledfx_frontend_do(), which in a single
+  call:
+
+  - measures the level in dB SPL and updates the smoothed volume,
+  - applies the pre-emphasis biquad,
+  - runs the phase vocoder into a spectrum owned by the object.
+
+  The phase vocoder is the ledfx_pvoc_t of pvoc.h, which gives the same
+  output as aubio_pvoc_t.
+
+  When the smoothed volume is at or below the minimum volume, the filter and
+  phase vocoder are skipped and the spectrum is zeroed instead.
+
+  All buffers are allocated by new_ledfx_frontend(); ledfx_frontend_do() does
+  not allocate.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** audio front-end object */
+typedef struct _ledfx_frontend_t ledfx_frontend_t;
+
+/** create audio front-end
+
+  \param win_s phase vocoder window size, a power of two
+  \param hop_s number of input samples per call to ledfx_frontend_do(), at
+  most win_s
+
+  \return newly created object, or NULL on invalid parameters
+
+*/
+ledfx_frontend_t *new_ledfx_frontend (uint_t win_s, uint_t hop_s);
+
+/** delete audio front-end
+
+  \param f object to delete, as returned by new_ledfx_frontend()
+
+*/
+void del_ledfx_frontend (ledfx_frontend_t * f);
+
+/** process the current input buffer
+
+  \param f front-end object
+
+  \return 1 if the spectrum was computed, 0 if it was zeroed by the volume
+  gate
+
+*/
+uint_t ledfx_frontend_do (ledfx_frontend_t * f);
+
+/** set pre-emphasis biquad coefficients
+
+  \param f front-end object
+  \param b0 forward filter coefficient
+  \param b1 forward filter coefficient
+  \param b2 forward filter coefficient
+  \param a1 feedback filter coefficient
+  \param a2 feedback filter coefficient
+
+  \return 0 on success, non-zero otherwise
+
+*/
+uint_t ledfx_frontend_set_biquad (ledfx_frontend_t * f, lsmp_t b0, lsmp_t b1,
+    lsmp_t b2, lsmp_t a1, lsmp_t a2);
+
+/** set the smoothed volume below which the spectrum is zeroed
+
+  \param f front-end object
+  \param min_volume volume threshold, between 0 and 1
+
+*/
+void ledfx_frontend_set_min_volume (ledfx_frontend_t * f, smpl_t min_volume);
+
+/** get input buffer
+
+  \param f front-end object
+
+  \return buffer of hop_s samples to fill before ledfx_frontend_do()
+
+*/
+fvec_t *ledfx_frontend_get_input (ledfx_frontend_t * f);
+
+/** get pre-emphasised buffer
+
+  \param f front-end object
+
+  \return hop_s samples from the last call that passed the volume gate
+
+*/
+fvec_t *ledfx_frontend_get_filtered (ledfx_frontend_t * f);
+
+/** get spectrum
+
+  \param f front-end object
+
+  \return spectrum of length win_s / 2 + 1; the pointer, and its norm and
+  phas arrays, stay the same for the lifetime of the object
+
+*/
+cvec_t *ledfx_frontend_get_spectrum (ledfx_frontend_t * f);
+
+/** get level of the last input, in dB SPL
+
+  \param f front-end object
+
+*/
+smpl_t ledfx_frontend_get_db (ledfx_frontend_t * f);
+
+/** get volume of the last input
+
+  \param f front-end object
+  \param filtered non-zero for the smoothed volume, 0 for the raw volume
+
+  \return volume, mapped from dB SPL to [0, 1]
+
+*/
+smpl_t ledfx_frontend_get_volume (ledfx_frontend_t * f, uint_t filtered);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_FRONTEND_H */
@@ -0,0 +1,198 @@
+/*
+  Gradient engine: colour curve lookup, intensity and roll per frame.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "gradient.h"
+
+/* steepness of the easing between two colour stops */
+#define LEDFX_GRADIENT_EASE_SLOPE 1.5
+
+struct _ledfx_gradient_t {
+  uint_t length;            /** number of curve entries */
+  smpl_t *curve;            /** length interleaved r, g, b triplets */
+  smpl_t roll;              /** pixels per frame, see set_roll */
+  lsmp_t roll_counter;      /** fraction of a curve entry not yet rolled */
+  uint_t start;             /** curve entry read for index 0 */
+};
+
+ledfx_gradient_t *
+new_ledfx_gradient (uint_t length)
+{
+  ledfx_gradient_t *g = AUBIO_NEW (ledfx_gradient_t);
+  if ((sint_t) length < 1) {
+    AUBIO_ERR ("gradient: got length %d\n", length);
+    goto beach;
+  }
+  g->length = length;
+  g->curve = AUBIO_ARRAY (smpl_t, 3 * length);
+  if (!g->curve) {
+    goto beach;
+  }
+  return g;
+
+beach:
+  del_ledfx_gradient (g);
+  return NULL;
+}
+
+void
+del_ledfx_gradient (ledfx_gradient_t * g)
+{
+  if (!g)
+    return;
+  if (g->curve)
+    AUBIO_FREE (g->curve);
+  AUBIO_FREE (g);
+}
+
+/* fills |len| curve entries from colour |c1| to colour |c2|, x running from
+ * 0 to 1 inclusive */
+static void
+ledfx_gradient_ease (smpl_t * curve, uint_t len, const smpl_t * c1,
+    const smpl_t * c2)
+{
+  uint_t j, c;
+  for (j = 0; j < len; j++) {
+    smpl_t x = len > 1 ? (smpl_t) j / (smpl_t) (len - 1) : 0.;
+    smpl_t a = POW (x, LEDFX_GRADIENT_EASE_SLOPE);
+    smpl_t b = POW (1. - x, LEDFX_GRADIENT_EASE_SLOPE);
+    smpl_t w = a + b > 0. ? a / (a + b) : 0.;
+    for (c = 0; c < 3; c++) {
+      curve[3 * j + c] = c1[c] + w * (c2[c] - c1[c]);
+    }
+  }
+}
+
+/* colour and position of stop k of the stops given to set_colors, with a
+ * stop at 0 prepended and one at 1 appended when they are missing */
+static const smpl_t *
+ledfx_gradient_stop (const smpl_t * colors, const smpl_t * positions,
+    uint_t n_colors, uint_t prepended, uint_t k, smpl_t * position)
+{
+  if (prepended && k == 0) {
+    *position = 0.;
+    return colors;
+  }
+  k -= prepended;
+  if (k == n_colors) {
+    *position = 1.;
+    return colors + 3 * (n_colors - 1);
+  }
+  *position = positions[k];
+  return colors + 3 * k;
+}
+
+uint_t
+ledfx_gradient_set_colors (ledfx_gradient_t * g, const smpl_t * colors,
+    const smpl_t * positions, uint_t n_colors)
+{
+  uint_t j, k, c, n_stops, prepended, filled = 0, length = g->length;
+  if ((sint_t) n_colors < 1) {
+    AUBIO_ERR ("gradient: got %d colors\n", n_colors);
+    return AUBIO_FAIL;
+  }
+  for (j = 1; j < n_colors; j++) {
+    if (positions[j] < positions[j - 1]) {
+      AUBIO_ERR ("gradient: positions must be ascending\n");
+      return AUBIO_FAIL;
+    }
+  }
+  prepended = positions[0] != 0.;
+  n_stops = n_colors + prepended + (positions[n_colors - 1] != 1.);
+
+  /* each pair of consecutive stops eases over the entries up to the second
+   * stop, at round (length * position) */
+  for (k = 0; k + 1 < n_stops; k++) {
+    smpl_t p;
+    const smpl_t *c1 = ledfx_gradient_stop (colors, positions, n_colors,
+        prepended, k, &p);
+    const smpl_t *c2 = ledfx_gradient_stop (colors, positions, n_colors,
+        prepended, k + 1, &p);
+    uint_t end = p >= 1. ? length
+        : p > 0. ? MIN ((uint_t) ROUND (length * p), length) : 0;
+    if (end > filled) {
+      ledfx_gradient_ease (g->curve + 3 * filled, end - filled, c1, c2);
+      filled = end;
+    }
+  }
+  /* a single stop at 1, or rounding: repeat the last colour */
+  for (j = filled; j < length; j++) {
+    for (c = 0; c < 3; c++) {
+      g->curve[3 * j + c] = colors[3 * (n_colors - 1) + c];
+    }
+  }
+
+  g->roll_counter = 0.;
+  g->start = 0;
+  return AUBIO_OK;
+}
+
+void
+ledfx_gradient_set_roll (ledfx_gradient_t * g, smpl_t roll)
+{
+  g->roll = roll;
+}
+
+uint_t
+ledfx_gradient_do (ledfx_gradient_t * g, const fvec_t * intensity,
+    fvec_t * rgb)
+{
+  uint_t i, n = intensity->length, length = g->length, start = g->start;
+  uint_t last = length - 1;
+  const smpl_t *y = intensity->data, *curve = g->curve;
+  smpl_t *out = rgb->data;
+  if (rgb->length < 3 * n) {
+    AUBIO_ERR ("gradient: expected %d rgb values, got %d\n", 3 * n,
+        rgb->length);
+    return AUBIO_FAIL;
+  }
+  if (n == 0) {
+    return AUBIO_OK;
+  }
+
+  for (i = 0; i < n; i++) {
+    /* round (i * last / (n - 1)) in integers: exact at both ends */
+    uint_t index = n > 1 ? (uint_t) (((unsigned long long) i * last * 2
+            + (n - 1)) / (2ull * (n - 1))) : 0;
+    const smpl_t *color;
+    index += start;
+    if (index >= length) {
+      index -= length;
+    }
+    color = curve + 3 * index;
+    out[3 * i] = color[0] * y[i];
+    out[3 * i + 1] = color[1] * y[i];
+    out[3 * i + 2] = color[2] * y[i];
+  }
+
+  if (g->roll != 0.) {
+    lsmp_t whole;
+    g->roll_counter += (lsmp_t) g->roll / n * length;
+    if (fabs (g->roll_counter) >= 1.) {
+      sint_t shift;
+      whole = g->roll_counter >= 0. ? floor (g->roll_counter)
+          : ceil (g->roll_counter);
+      g->roll_counter -= whole;
+      /* rolling the curve forward by shift entries moves the entry read
+       * for index 0 back by as much */
+      shift = (sint_t) whole % (sint_t) length;
+      g->start = (uint_t) (((sint_t) start - shift + (sint_t) length)
+          % (sint_t) length);
+    }
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_gradient_get_length (ledfx_gradient_t * g)
+{
+  return g->length;
+}
+
+const smpl_t *
+ledfx_gradient_get_curve (ledfx_gradient_t * g)
+{
+  return g->curve;
+}
@@ -0,0 +1,110 @@
+/*
+  Gradient engine: colour curve lookup, intensity and roll per frame.
+*/
+
+#ifndef LEDFX_GRADIENT_H
+#define LEDFX_GRADIENT_H
+
+/** \file
+
+  Gradient colouring of an intensity strip
+
+  Holds the colour curve of a gradient as one contiguous table of
+  interleaved r, g, b values, generated once from the colour stops with the
+  same easing as the Python ledfx (slope 1.5 between consecutive stops).
+
+  ledfx_gradient_do() colours one frame in a single pass: pixel i of an
+  n pixel strip takes the curve entry at round(i * (length - 1) / (n - 1)),
+  scaled by intensity i, and is written to a caller-owned interleaved
+  r, g, b buffer. The roll is then advanced by roll / n * length curve
+  entries; whole entries shift the curve, the fraction carries over to the
+  next frame. Rolling moves a read offset, the table itself is never
+  rewritten.
+
+  All state is allocated by new_ledfx_gradient() and
+  ledfx_gradient_set_colors(); ledfx_gradient_do() does not allocate.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** gradient object */
+typedef struct _ledfx_gradient_t ledfx_gradient_t;
+
+/** create gradient
+
+  \param length number of entries of the colour curve
+
+  \return newly created object, black until ledfx_gradient_set_colors() is
+  called, or NULL on invalid parameters
+
+*/
+ledfx_gradient_t *new_ledfx_gradient (uint_t length);
+
+/** delete gradient
+
+  \param g object to delete, as returned by new_ledfx_gradient()
+
+*/
+void del_ledfx_gradient (ledfx_gradient_t * g);
+
+/** generate the colour curve from colour stops
+
+  Stops missing at 0 or 1 repeat the first or last colour there. Resets the
+  roll.
+
+  \param g gradient object
+  \param colors n_colors interleaved r, g, b triplets
+  \param positions n_colors stop positions in [0, 1], in ascending order
+  \param n_colors number of stops, at least 1
+
+  \return 0 on success, non-zero on invalid parameters
+
+*/
+uint_t ledfx_gradient_set_colors (ledfx_gradient_t * g, const smpl_t * colors,
+    const smpl_t * positions, uint_t n_colors);
+
+/** set the roll speed
+
+  \param g gradient object
+  \param roll pixels of an n pixel strip the gradient moves per frame; the
+  sign gives the direction, 0 stops it
+
+*/
+void ledfx_gradient_set_roll (ledfx_gradient_t * g, smpl_t roll);
+
+/** colour one frame and advance the roll
+
+  \param g gradient object
+  \param intensity per-pixel intensity, n pixels long
+  \param rgb output, at least 3 n long, interleaved r, g, b per pixel
+
+  \return 0 on success, non-zero if rgb is too short
+
+*/
+uint_t ledfx_gradient_do (ledfx_gradient_t * g, const fvec_t * intensity,
+    fvec_t * rgb);
+
+/** get number of entries of the colour curve
+
+  \param g gradient object
+
+*/
+uint_t ledfx_gradient_get_length (ledfx_gradient_t * g);
+
+/** get the colour curve
+
+  \param g gradient object
+
+  \return length interleaved r, g, b triplets, unrolled, owned by the object
+
+*/
+const smpl_t *ledfx_gradient_get_curve (ledfx_gradient_t * g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_GRADIENT_H */
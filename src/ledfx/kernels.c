@@ -0,0 +1,232 @@
+/*
+  Vector kernels for the hot loops, with runtime CPU dispatch.
+*/
+
+#include "aubio_priv.h"
+#include "kernels.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define LEDFX_KERNELS_X86 1
+#elif (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define LEDFX_KERNELS_X86 1
+#elif defined(__arm__) && defined(__linux__)
+#include <sys/auxv.h>
+#ifndef HWCAP_NEON
+#define HWCAP_NEON (1 << 12)
+#endif
+#endif
+
+/* variant tables, each in its own file built with the matching flags */
+#if defined(LEDFX_HAVE_SSE2) && !HAVE_AUBIO_DOUBLE
+extern const ledfx_kernels_t ledfx_kernels_sse2;
+#endif
+#if defined(LEDFX_HAVE_AVX2) && !HAVE_AUBIO_DOUBLE
+extern const ledfx_kernels_t ledfx_kernels_avx2;
+#endif
+#if defined(LEDFX_HAVE_NEON) && !HAVE_AUBIO_DOUBLE
+extern const ledfx_kernels_t ledfx_kernels_neon;
+#endif
+
+static smpl_t
+ledfx_kernels_scalar_dot (const smpl_t * a, const smpl_t * b, uint_t n)
+{
+  uint_t i;
+  smpl_t acc = 0.;
+  for (i = 0; i < n; i++) {
+    acc += a[i] * b[i];
+  }
+  return acc;
+}
+
+static smpl_t
+ledfx_kernels_scalar_sum_sq (const smpl_t * a, uint_t n)
+{
+  uint_t i;
+  smpl_t acc = 0.;
+  for (i = 0; i < n; i++) {
+    acc += a[i] * a[i];
+  }
+  return acc;
+}
+
+static void
+ledfx_kernels_scalar_weight (smpl_t * a, const smpl_t * w, uint_t n)
+{
+  uint_t i;
+  for (i = 0; i < n; i++) {
+    a[i] *= w[i];
+  }
+}
+
+static void
+ledfx_kernels_scalar_weighted_copy (smpl_t * out, const smpl_t * in,
+    const smpl_t * w, uint_t n)
+{
+  uint_t i;
+  for (i = 0; i < n; i++) {
+    out[i] = in[i] * w[i];
+  }
+}
+
+static void
+ledfx_kernels_scalar_complex_norm (smpl_t * norm, const smpl_t * compspec,
+    uint_t win_s)
+{
+  uint_t i, half = win_s / 2;
+  norm[0] = ABS (compspec[0]);
+  for (i = 1; i < half; i++) {
+    norm[i] = SQRT (compspec[i] * compspec[i]
+        + compspec[win_s - i] * compspec[win_s - i]);
+  }
+  norm[half] = ABS (compspec[half]);
+}
+
+static void
+ledfx_kernels_scalar_gather (smpl_t * out, const smpl_t * in,
+    const uint_t * idx, uint_t n)
+{
+  uint_t i;
+  for (i = 0; i < n; i++) {
+    out[i] = in[idx[i]];
+  }
+}
+
+static const ledfx_kernels_t ledfx_kernels_scalar = {
+  LEDFX_KERNELS_SCALAR,
+  "scalar",
+  ledfx_kernels_scalar_dot,
+  ledfx_kernels_scalar_sum_sq,
+  ledfx_kernels_scalar_weight,
+  ledfx_kernels_scalar_weighted_copy,
+  ledfx_kernels_scalar_complex_norm,
+  ledfx_kernels_scalar_gather,
+};
+
+#ifdef LEDFX_KERNELS_X86
+static void
+ledfx_kernels_cpuid (uint_t leaf, uint_t subleaf, uint_t regs[4])
+{
+#ifdef _MSC_VER
+  int r[4];
+  __cpuidex (r, (int) leaf, (int) subleaf);
+  regs[0] = (uint_t) r[0];
+  regs[1] = (uint_t) r[1];
+  regs[2] = (uint_t) r[2];
+  regs[3] = (uint_t) r[3];
+#else
+  unsigned int a = 0, b = 0, c = 0, d = 0;
+  if (leaf <= __get_cpuid_max (0, NULL)) {
+    __cpuid_count (leaf, subleaf, a, b, c, d);
+  }
+  regs[0] = a;
+  regs[1] = b;
+  regs[2] = c;
+  regs[3] = d;
+#endif
+}
+
+/* whether the OS saves the SSE and AVX registers on context switches */
+static uint_t
+ledfx_kernels_os_avx (void)
+{
+#ifdef _MSC_VER
+  return (_xgetbv (0) & 6) == 6;
+#else
+  unsigned int eax, edx;
+  __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+  return (eax & 6) == 6;
+#endif
+}
+#endif /* LEDFX_KERNELS_X86 */
+
+/* whether the running CPU supports a variant, compiled in or not */
+static uint_t
+ledfx_kernels_cpu_has (ledfx_kernels_level_t level)
+{
+#ifdef LEDFX_KERNELS_X86
+  uint_t regs[4];
+#endif
+  switch (level) {
+    case LEDFX_KERNELS_SCALAR:
+      return 1;
+#ifdef LEDFX_KERNELS_X86
+    case LEDFX_KERNELS_SSE2:
+      ledfx_kernels_cpuid (1, 0, regs);
+      return (regs[3] >> 26) & 1;
+    case LEDFX_KERNELS_AVX2:
+      ledfx_kernels_cpuid (1, 0, regs);
+      /* fma, osxsave and avx */
+      if (!((regs[2] >> 12) & 1) || !((regs[2] >> 27) & 1)
+          || !((regs[2] >> 28) & 1) || !ledfx_kernels_os_avx ()) {
+        return 0;
+      }
+      ledfx_kernels_cpuid (7, 0, regs);
+      return (regs[1] >> 5) & 1;
+#endif
+    case LEDFX_KERNELS_NEON:
+#if defined(__aarch64__) || defined(_M_ARM64)
+      return 1;
+#elif defined(__arm__) && defined(__linux__)
+      return (getauxval (AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+      return 0;
+#endif
+    default:
+      return 0;
+  }
+}
+
+const ledfx_kernels_t *
+ledfx_kernels_get (ledfx_kernels_level_t level)
+{
+  const ledfx_kernels_t *table = NULL;
+  switch (level) {
+    case LEDFX_KERNELS_SCALAR:
+      table = &ledfx_kernels_scalar;
+      break;
+#if defined(LEDFX_HAVE_SSE2) && !HAVE_AUBIO_DOUBLE
+    case LEDFX_KERNELS_SSE2:
+      table = &ledfx_kernels_sse2;
+      break;
+#endif
+#if defined(LEDFX_HAVE_AVX2) && !HAVE_AUBIO_DOUBLE
+    case LEDFX_KERNELS_AVX2:
+      table = &ledfx_kernels_avx2;
+      break;
+#endif
+#if defined(LEDFX_HAVE_NEON) && !HAVE_AUBIO_DOUBLE
+    case LEDFX_KERNELS_NEON:
+      table = &ledfx_kernels_neon;
+      break;
+#endif
+    default:
+      break;
+  }
+  if (table && !ledfx_kernels_cpu_has (level))
+    table = NULL;
+  return table;
+}
+
+const ledfx_kernels_t *
+ledfx_kernels (void)
+{
+  /* written once per process; concurrent first calls store the same value */
+  static const ledfx_kernels_t *volatile best = NULL;
+  const ledfx_kernels_t *table = best;
+  sint_t level;
+  if (table)
+    return table;
+  for (level = LEDFX_KERNELS_N_LEVELS - 1; level > LEDFX_KERNELS_SCALAR;
+      level--) {
+    table = ledfx_kernels_get ((ledfx_kernels_level_t) level);
+    if (table)
+      break;
+  }
+  if (!table)
+    table = &ledfx_kernels_scalar;
+  best = table;
+  return table;
+}
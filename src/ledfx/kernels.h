@@ -0,0 +1,87 @@
+/*
+  Vector kernels for the hot loops, with runtime CPU dispatch.
+*/
+
+#ifndef LEDFX_KERNELS_H
+#define LEDFX_KERNELS_H
+
+/** \file
+
+  Vector kernels for the per-hop loops of the native layer
+
+  Each kernel has a portable scalar version and, depending on the target,
+  SSE2, AVX2 (with FMA) or NEON versions compiled with their own flags. The
+  best variant supported by the running CPU is picked once at runtime, so a
+  single x86-64 build uses AVX2 where available and SSE2 elsewhere.
+
+  Vector variants may sum in a different order than the scalar version, so
+  reductions can differ in the last bits; element-wise kernels give the same
+  results. Builds with HAVE_AUBIO_DOUBLE only have the scalar variant.
+
+  Objects look the table up when they are created and keep the pointer;
+  tables are static and never freed.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** kernel variants, in order of preference on their architecture */
+typedef enum {
+  LEDFX_KERNELS_SCALAR = 0, /**< portable C */
+  LEDFX_KERNELS_SSE2,       /**< x86 SSE2 */
+  LEDFX_KERNELS_AVX2,       /**< x86 AVX2 and FMA */
+  LEDFX_KERNELS_NEON,       /**< ARM NEON */
+  LEDFX_KERNELS_N_LEVELS
+} ledfx_kernels_level_t;
+
+/** table of kernels of one variant */
+typedef struct {
+  /** variant implemented by this table */
+  ledfx_kernels_level_t level;
+  /** short name of the variant, e.g. "avx2" */
+  const char_t *name;
+  /** sum of a[i] * b[i] */
+  smpl_t (*dot) (const smpl_t * a, const smpl_t * b, uint_t n);
+  /** sum of a[i] * a[i] */
+  smpl_t (*sum_sq) (const smpl_t * a, uint_t n);
+  /** a[i] *= w[i], as fvec_weight() */
+  void (*weight) (smpl_t * a, const smpl_t * w, uint_t n);
+  /** out[i] = in[i] * w[i], as fvec_weighted_copy() */
+  void (*weighted_copy) (smpl_t * out, const smpl_t * in, const smpl_t * w,
+      uint_t n);
+  /** magnitudes of a spectrum in the layout returned by
+    aubio_fft_do_complex(): win_s values, real parts of bins 0 to win_s / 2
+    followed by the imaginary parts of bins win_s / 2 - 1 down to 1. Writes
+    win_s / 2 + 1 values to norm, as aubio_fft_get_norm(); win_s must be
+    even. */
+  void (*complex_norm) (smpl_t * norm, const smpl_t * compspec,
+      uint_t win_s);
+  /** out[i] = in[idx[i]]; every idx[i] must be below 2^31 */
+  void (*gather) (smpl_t * out, const smpl_t * in, const uint_t * idx,
+      uint_t n);
+} ledfx_kernels_t;
+
+/** get the best kernels for the running CPU
+
+  \return static table, never NULL
+
+*/
+const ledfx_kernels_t *ledfx_kernels (void);
+
+/** get the kernels of a given variant
+
+  \param level variant to look up
+
+  \return static table, or NULL if the variant was not compiled in or is not
+  supported by the running CPU
+
+*/
+const ledfx_kernels_t *ledfx_kernels_get (ledfx_kernels_level_t level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_KERNELS_H */
@@ -0,0 +1,146 @@
+/*
+  AVX2 and FMA variant of the vector kernels, see kernels.h.
+*/
+
+#include "aubio_priv.h"
+#include "kernels.h"
+
+#if defined(LEDFX_HAVE_AVX2) && !HAVE_AUBIO_DOUBLE
+
+#include <immintrin.h>
+
+static float
+ledfx_kernels_avx2_hsum (__m256 v)
+{
+  __m128 sums = _mm_add_ps (_mm256_castps256_ps128 (v),
+      _mm256_extractf128_ps (v, 1));
+  __m128 shuf = _mm_movehdup_ps (sums);
+  sums = _mm_add_ps (sums, shuf);
+  shuf = _mm_movehl_ps (shuf, sums);
+  sums = _mm_add_ss (sums, shuf);
+  return _mm_cvtss_f32 (sums);
+}
+
+static smpl_t
+ledfx_kernels_avx2_dot (const smpl_t * a, const smpl_t * b, uint_t n)
+{
+  uint_t i = 0;
+  __m256 acc0 = _mm256_setzero_ps (), acc1 = _mm256_setzero_ps ();
+  smpl_t acc;
+  for (; i + 16 <= n; i += 16) {
+    acc0 = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        acc0);
+    acc1 = _mm256_fmadd_ps (_mm256_loadu_ps (a + i + 8),
+        _mm256_loadu_ps (b + i + 8), acc1);
+  }
+  if (i + 8 <= n) {
+    acc0 = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        acc0);
+    i += 8;
+  }
+  acc = ledfx_kernels_avx2_hsum (_mm256_add_ps (acc0, acc1));
+  for (; i < n; i++) {
+    acc += a[i] * b[i];
+  }
+  return acc;
+}
+
+static smpl_t
+ledfx_kernels_avx2_sum_sq (const smpl_t * a, uint_t n)
+{
+  uint_t i = 0;
+  __m256 acc0 = _mm256_setzero_ps (), acc1 = _mm256_setzero_ps ();
+  smpl_t acc;
+  for (; i + 16 <= n; i += 16) {
+    __m256 x0 = _mm256_loadu_ps (a + i), x1 = _mm256_loadu_ps (a + i + 8);
+    acc0 = _mm256_fmadd_ps (x0, x0, acc0);
+    acc1 = _mm256_fmadd_ps (x1, x1, acc1);
+  }
+  if (i + 8 <= n) {
+    __m256 x0 = _mm256_loadu_ps (a + i);
+    acc0 = _mm256_fmadd_ps (x0, x0, acc0);
+    i += 8;
+  }
+  acc = ledfx_kernels_avx2_hsum (_mm256_add_ps (acc0, acc1));
+  for (; i < n; i++) {
+    acc += a[i] * a[i];
+  }
+  return acc;
+}
+
+static void
+ledfx_kernels_avx2_weight (smpl_t * a, const smpl_t * w, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps (a + i, _mm256_mul_ps (_mm256_loadu_ps (a + i),
+            _mm256_loadu_ps (w + i)));
+  }
+  for (; i < n; i++) {
+    a[i] *= w[i];
+  }
+}
+
+static void
+ledfx_kernels_avx2_weighted_copy (smpl_t * out, const smpl_t * in,
+    const smpl_t * w, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps (out + i, _mm256_mul_ps (_mm256_loadu_ps (in + i),
+            _mm256_loadu_ps (w + i)));
+  }
+  for (; i < n; i++) {
+    out[i] = in[i] * w[i];
+  }
+}
+
+static void
+ledfx_kernels_avx2_complex_norm (smpl_t * norm, const smpl_t * compspec,
+    uint_t win_s)
+{
+  uint_t i = 1, half = win_s / 2;
+  const __m256i reverse = _mm256_set_epi32 (0, 1, 2, 3, 4, 5, 6, 7);
+  norm[0] = ABS (compspec[0]);
+  /* the imaginary parts run backwards from the end of compspec; no fma so
+   * that the result matches the scalar kernel */
+  for (; i + 8 <= half; i += 8) {
+    __m256 re = _mm256_loadu_ps (compspec + i);
+    __m256 im = _mm256_loadu_ps (compspec + win_s - i - 7);
+    im = _mm256_permutevar8x32_ps (im, reverse);
+    _mm256_storeu_ps (norm + i, _mm256_sqrt_ps (_mm256_add_ps (
+                _mm256_mul_ps (re, re), _mm256_mul_ps (im, im))));
+  }
+  for (; i < half; i++) {
+    norm[i] = SQRT (compspec[i] * compspec[i]
+        + compspec[win_s - i] * compspec[win_s - i]);
+  }
+  norm[half] = ABS (compspec[half]);
+}
+
+static void
+ledfx_kernels_avx2_gather (smpl_t * out, const smpl_t * in,
+    const uint_t * idx, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i j = _mm256_loadu_si256 ((const __m256i *) (idx + i));
+    _mm256_storeu_ps (out + i, _mm256_i32gather_ps (in, j, 4));
+  }
+  for (; i < n; i++) {
+    out[i] = in[idx[i]];
+  }
+}
+
+const ledfx_kernels_t ledfx_kernels_avx2 = {
+  LEDFX_KERNELS_AVX2,
+  "avx2",
+  ledfx_kernels_avx2_dot,
+  ledfx_kernels_avx2_sum_sq,
+  ledfx_kernels_avx2_weight,
+  ledfx_kernels_avx2_weighted_copy,
+  ledfx_kernels_avx2_complex_norm,
+  ledfx_kernels_avx2_gather,
+};
+
+#endif /* LEDFX_HAVE_AVX2 */
@@ -0,0 +1,157 @@
+/*
+  NEON variant of the vector kernels, see kernels.h.
+*/
+
+#include "aubio_priv.h"
+#include "kernels.h"
+
+#if defined(LEDFX_HAVE_NEON) && !HAVE_AUBIO_DOUBLE
+
+#include <arm_neon.h>
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define LEDFX_NEON_A64 1
+#endif
+
+static float
+ledfx_kernels_neon_hsum (float32x4_t v)
+{
+#ifdef LEDFX_NEON_A64
+  return vaddvq_f32 (v);
+#else
+  float32x2_t sums = vadd_f32 (vget_low_f32 (v), vget_high_f32 (v));
+  sums = vpadd_f32 (sums, sums);
+  return vget_lane_f32 (sums, 0);
+#endif
+}
+
+static smpl_t
+ledfx_kernels_neon_dot (const smpl_t * a, const smpl_t * b, uint_t n)
+{
+  uint_t i = 0;
+  float32x4_t acc0 = vdupq_n_f32 (0.f), acc1 = vdupq_n_f32 (0.f);
+  smpl_t acc;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = vmlaq_f32 (acc0, vld1q_f32 (a + i), vld1q_f32 (b + i));
+    acc1 = vmlaq_f32 (acc1, vld1q_f32 (a + i + 4), vld1q_f32 (b + i + 4));
+  }
+  if (i + 4 <= n) {
+    acc0 = vmlaq_f32 (acc0, vld1q_f32 (a + i), vld1q_f32 (b + i));
+    i += 4;
+  }
+  acc = ledfx_kernels_neon_hsum (vaddq_f32 (acc0, acc1));
+  for (; i < n; i++) {
+    acc += a[i] * b[i];
+  }
+  return acc;
+}
+
+static smpl_t
+ledfx_kernels_neon_sum_sq (const smpl_t * a, uint_t n)
+{
+  uint_t i = 0;
+  float32x4_t acc0 = vdupq_n_f32 (0.f), acc1 = vdupq_n_f32 (0.f);
+  smpl_t acc;
+  for (; i + 8 <= n; i += 8) {
+    float32x4_t x0 = vld1q_f32 (a + i), x1 = vld1q_f32 (a + i + 4);
+    acc0 = vmlaq_f32 (acc0, x0, x0);
+    acc1 = vmlaq_f32 (acc1, x1, x1);
+  }
+  if (i + 4 <= n) {
+    float32x4_t x0 = vld1q_f32 (a + i);
+    acc0 = vmlaq_f32 (acc0, x0, x0);
+    i += 4;
+  }
+  acc = ledfx_kernels_neon_hsum (vaddq_f32 (acc0, acc1));
+  for (; i < n; i++) {
+    acc += a[i] * a[i];
+  }
+  return acc;
+}
+
+static void
+ledfx_kernels_neon_weight (smpl_t * a, const smpl_t * w, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32 (a + i, vmulq_f32 (vld1q_f32 (a + i), vld1q_f32 (w + i)));
+  }
+  for (; i < n; i++) {
+    a[i] *= w[i];
+  }
+}
+
+static void
+ledfx_kernels_neon_weighted_copy (smpl_t * out, const smpl_t * in,
+    const smpl_t * w, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    vst1q_f32 (out + i, vmulq_f32 (vld1q_f32 (in + i), vld1q_f32 (w + i)));
+  }
+  for (; i < n; i++) {
+    out[i] = in[i] * w[i];
+  }
+}
+
+static void
+ledfx_kernels_neon_complex_norm (smpl_t * norm, const smpl_t * compspec,
+    uint_t win_s)
+{
+  uint_t i = 1, half = win_s / 2;
+  norm[0] = ABS (compspec[0]);
+  /* the imaginary parts run backwards from the end of compspec */
+  for (; i + 4 <= half; i += 4) {
+    float32x4_t re = vld1q_f32 (compspec + i);
+    float32x4_t im = vrev64q_f32 (vld1q_f32 (compspec + win_s - i - 3));
+    float32x4_t sq;
+    im = vcombine_f32 (vget_high_f32 (im), vget_low_f32 (im));
+    sq = vaddq_f32 (vmulq_f32 (re, re), vmulq_f32 (im, im));
+#ifdef LEDFX_NEON_A64
+    vst1q_f32 (norm + i, vsqrtq_f32 (sq));
+#else
+    /* ARMv7 NEON only has a square root estimate */
+    vst1q_f32 (norm + i, sq);
+    norm[i] = SQRT (norm[i]);
+    norm[i + 1] = SQRT (norm[i + 1]);
+    norm[i + 2] = SQRT (norm[i + 2]);
+    norm[i + 3] = SQRT (norm[i + 3]);
+#endif
+  }
+  for (; i < half; i++) {
+    norm[i] = SQRT (compspec[i] * compspec[i]
+        + compspec[win_s - i] * compspec[win_s - i]);
+  }
+  norm[half] = ABS (compspec[half]);
+}
+
+/* NEON has no gather; four loads are packed into one store */
+static void
+ledfx_kernels_neon_gather (smpl_t * out, const smpl_t * in,
+    const uint_t * idx, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    float32x4_t v = vdupq_n_f32 (in[idx[i]]);
+    v = vsetq_lane_f32 (in[idx[i + 1]], v, 1);
+    v = vsetq_lane_f32 (in[idx[i + 2]], v, 2);
+    v = vsetq_lane_f32 (in[idx[i + 3]], v, 3);
+    vst1q_f32 (out + i, v);
+  }
+  for (; i < n; i++) {
+    out[i] = in[idx[i]];
+  }
+}
+
+const ledfx_kernels_t ledfx_kernels_neon = {
+  LEDFX_KERNELS_NEON,
+  "neon",
+  ledfx_kernels_neon_dot,
+  ledfx_kernels_neon_sum_sq,
+  ledfx_kernels_neon_weight,
+  ledfx_kernels_neon_weighted_copy,
+  ledfx_kernels_neon_complex_norm,
+  ledfx_kernels_neon_gather,
+};
+
+#endif /* LEDFX_HAVE_NEON */
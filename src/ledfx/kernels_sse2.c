@@ -0,0 +1,143 @@
+/*
+  SSE2 variant of the vector kernels, see kernels.h.
+*/
+
+#include "aubio_priv.h"
+#include "kernels.h"
+
+#if defined(LEDFX_HAVE_SSE2) && !HAVE_AUBIO_DOUBLE
+
+#include <emmintrin.h>
+
+static float
+ledfx_kernels_sse2_hsum (__m128 v)
+{
+  __m128 shuf = _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1));
+  __m128 sums = _mm_add_ps (v, shuf);
+  shuf = _mm_movehl_ps (shuf, sums);
+  sums = _mm_add_ss (sums, shuf);
+  return _mm_cvtss_f32 (sums);
+}
+
+static smpl_t
+ledfx_kernels_sse2_dot (const smpl_t * a, const smpl_t * b, uint_t n)
+{
+  uint_t i = 0;
+  __m128 acc0 = _mm_setzero_ps (), acc1 = _mm_setzero_ps ();
+  smpl_t acc;
+  for (; i + 8 <= n; i += 8) {
+    acc0 = _mm_add_ps (acc0, _mm_mul_ps (_mm_loadu_ps (a + i),
+            _mm_loadu_ps (b + i)));
+    acc1 = _mm_add_ps (acc1, _mm_mul_ps (_mm_loadu_ps (a + i + 4),
+            _mm_loadu_ps (b + i + 4)));
+  }
+  if (i + 4 <= n) {
+    acc0 = _mm_add_ps (acc0, _mm_mul_ps (_mm_loadu_ps (a + i),
+            _mm_loadu_ps (b + i)));
+    i += 4;
+  }
+  acc = ledfx_kernels_sse2_hsum (_mm_add_ps (acc0, acc1));
+  for (; i < n; i++) {
+    acc += a[i] * b[i];
+  }
+  return acc;
+}
+
+static smpl_t
+ledfx_kernels_sse2_sum_sq (const smpl_t * a, uint_t n)
+{
+  uint_t i = 0;
+  __m128 acc0 = _mm_setzero_ps (), acc1 = _mm_setzero_ps ();
+  smpl_t acc;
+  for (; i + 8 <= n; i += 8) {
+    __m128 x0 = _mm_loadu_ps (a + i), x1 = _mm_loadu_ps (a + i + 4);
+    acc0 = _mm_add_ps (acc0, _mm_mul_ps (x0, x0));
+    acc1 = _mm_add_ps (acc1, _mm_mul_ps (x1, x1));
+  }
+  if (i + 4 <= n) {
+    __m128 x0 = _mm_loadu_ps (a + i);
+    acc0 = _mm_add_ps (acc0, _mm_mul_ps (x0, x0));
+    i += 4;
+  }
+  acc = ledfx_kernels_sse2_hsum (_mm_add_ps (acc0, acc1));
+  for (; i < n; i++) {
+    acc += a[i] * a[i];
+  }
+  return acc;
+}
+
+static void
+ledfx_kernels_sse2_weight (smpl_t * a, const smpl_t * w, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps (a + i, _mm_mul_ps (_mm_loadu_ps (a + i),
+            _mm_loadu_ps (w + i)));
+  }
+  for (; i < n; i++) {
+    a[i] *= w[i];
+  }
+}
+
+static void
+ledfx_kernels_sse2_weighted_copy (smpl_t * out, const smpl_t * in,
+    const smpl_t * w, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps (out + i, _mm_mul_ps (_mm_loadu_ps (in + i),
+            _mm_loadu_ps (w + i)));
+  }
+  for (; i < n; i++) {
+    out[i] = in[i] * w[i];
+  }
+}
+
+static void
+ledfx_kernels_sse2_complex_norm (smpl_t * norm, const smpl_t * compspec,
+    uint_t win_s)
+{
+  uint_t i = 1, half = win_s / 2;
+  norm[0] = ABS (compspec[0]);
+  /* the imaginary parts run backwards from the end of compspec */
+  for (; i + 4 <= half; i += 4) {
+    __m128 re = _mm_loadu_ps (compspec + i);
+    __m128 im = _mm_loadu_ps (compspec + win_s - i - 3);
+    im = _mm_shuffle_ps (im, im, _MM_SHUFFLE (0, 1, 2, 3));
+    _mm_storeu_ps (norm + i, _mm_sqrt_ps (_mm_add_ps (_mm_mul_ps (re, re),
+                _mm_mul_ps (im, im))));
+  }
+  for (; i < half; i++) {
+    norm[i] = SQRT (compspec[i] * compspec[i]
+        + compspec[win_s - i] * compspec[win_s - i]);
+  }
+  norm[half] = ABS (compspec[half]);
+}
+
+/* SSE2 has no gather; four loads are packed into one store */
+static void
+ledfx_kernels_sse2_gather (smpl_t * out, const smpl_t * in,
+    const uint_t * idx, uint_t n)
+{
+  uint_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_ps (out + i, _mm_setr_ps (in[idx[i]], in[idx[i + 1]],
+            in[idx[i + 2]], in[idx[i + 3]]));
+  }
+  for (; i < n; i++) {
+    out[i] = in[idx[i]];
+  }
+}
+
+const ledfx_kernels_t ledfx_kernels_sse2 = {
+  LEDFX_KERNELS_SSE2,
+  "sse2",
+  ledfx_kernels_sse2_dot,
+  ledfx_kernels_sse2_sum_sq,
+  ledfx_kernels_sse2_weight,
+  ledfx_kernels_sse2_weighted_copy,
+  ledfx_kernels_sse2_complex_norm,
+  ledfx_kernels_sse2_gather,
+};
+
+#endif /* LEDFX_HAVE_SSE2 */
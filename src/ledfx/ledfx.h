@@ -0,0 +1,43 @@
+/*
+  ledfx native processing layer
+
+  These objects are compiled into the aubio shared library (see
+  LEDFX_SOURCES in src/CMakeLists.txt) and follow the aubio conventions:
+  opaque objects created with new_ledfx_*, released with del_ledfx_*, and
+  processed with ledfx_*_do. Buffers returned by the getters belong to the
+  object and stay valid until it is deleted.
+*/
+
+#ifndef LEDFX_H
+#define LEDFX_H
+
+#include "aubio.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "frontend.h"
+#include "filterbank.h"
+#include "melbank.h"
+#include "arena.h"
+#include "kernels.h"
+#include "fft.h"
+#include "pvoc.h"
+#include "analysis.h"
+#include "gradient.h"
+#include "postprocess.h"
+#include "mapping.h"
+#include "udp.h"
+#include "ddp.h"
+#include "wled.h"
+#include "scheduler.h"
+#include "pool.h"
+#include "render.h"
+#include "pcm.h"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_H */
@@ -0,0 +1,156 @@
+/*
+  Virtual to device pixel mapping, compiled into gather tables.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "kernels.h"
+#include "mapping.h"
+
+struct _ledfx_mapping_t {
+  uint_t n_in;              /** effective pixels of the frame */
+  uint_t n_out;             /** pixels of the device */
+  uint_t n_mapped;          /** device pixels written per frame */
+  uint_t n_runs;            /** contiguous runs of device pixels */
+  uint_t *idx;              /** frame value of each written device value */
+  uint_t *run_dst;          /** first device value of each run */
+  uint_t *run_idx;          /** first entry of idx of each run */
+  uint_t *run_len;          /** values in each run */
+  const ledfx_kernels_t *kernels; /** vector kernels for this CPU */
+};
+
+ledfx_mapping_t *
+new_ledfx_mapping (uint_t mode, uint_t n_in, uint_t n_virtual, uint_t n_out,
+    uint_t group_size, uint_t center_offset, const uint_t * segments,
+    uint_t n_segments)
+{
+  ledfx_mapping_t *m = AUBIO_NEW (ledfx_mapping_t);
+  uint_t s, j, c, n_values = 0, n_phys, last = 0;
+  if (mode != LEDFX_MAPPING_SPAN && mode != LEDFX_MAPPING_COPY) {
+    AUBIO_ERR ("mapping: unknown mode %d\n", mode);
+    goto beach;
+  }
+  if ((sint_t) n_in < 0 || (sint_t) n_out < 1 || (sint_t) group_size < 1
+      || (n_segments > 0 && !segments)) {
+    AUBIO_ERR ("mapping: got n_in %d, n_out %d, group_size %d\n", n_in,
+        n_out, group_size);
+    goto beach;
+  }
+  /* validate and size everything before writing the table */
+  for (s = 0; s < n_segments; s++) {
+    const uint_t *seg = segments + s * LEDFX_MAPPING_SEGMENT_LEN;
+    if (seg[1] > seg[2] || seg[2] >= n_out) {
+      AUBIO_ERR ("mapping: segment %d covers pixels %d to %d of %d\n", s,
+          seg[1], seg[2], n_out);
+      goto beach;
+    }
+    n_values += 3 * (seg[2] - seg[1] + 1);
+  }
+  m->n_in = n_in;
+  m->n_out = n_out;
+  m->kernels = ledfx_kernels ();
+  m->idx = AUBIO_ARRAY (uint_t, MAX (n_values, 1));
+  /* at most one wrap around the end of the device per segment */
+  m->run_dst = AUBIO_ARRAY (uint_t, MAX (2 * n_segments, 1));
+  m->run_idx = AUBIO_ARRAY (uint_t, MAX (2 * n_segments, 1));
+  m->run_len = AUBIO_ARRAY (uint_t, MAX (2 * n_segments, 1));
+  if (!m->idx || !m->run_dst || !m->run_idx || !m->run_len) {
+    goto beach;
+  }
+
+  /* physical pixels the frame can fill, repeated group_size times */
+  n_phys = n_in * group_size;
+  if (mode == LEDFX_MAPPING_SPAN) {
+    n_phys = MIN (n_phys, n_virtual);
+  }
+  center_offset %= n_out;
+  n_values = 0;
+  for (s = 0; s < n_segments; s++) {
+    const uint_t *seg = segments + s * LEDFX_MAPPING_SEGMENT_LEN;
+    uint_t width = seg[2] - seg[1] + 1, first = 0, len;
+    if (mode == LEDFX_MAPPING_SPAN) {
+      first = seg[0];
+      len = first < n_phys ? MIN (width, n_phys - first) : 0;
+    } else {
+      len = MIN (width, n_phys);
+    }
+    for (j = 0; j < len; j++) {
+      uint_t src = (first + (seg[3] ? len - 1 - j : j)) / group_size;
+      uint_t dst = (seg[1] + j + center_offset) % n_out;
+      /* a new run at the start of each segment and where it wraps */
+      if (j == 0 || dst != last + 1) {
+        m->run_dst[m->n_runs] = 3 * dst;
+        m->run_idx[m->n_runs] = n_values;
+        m->run_len[m->n_runs] = 0;
+        m->n_runs++;
+      }
+      for (c = 0; c < 3; c++) {
+        m->idx[n_values++] = 3 * src + c;
+      }
+      m->run_len[m->n_runs - 1] += 3;
+      last = dst;
+    }
+    m->n_mapped += len;
+  }
+  return m;
+
+beach:
+  del_ledfx_mapping (m);
+  return NULL;
+}
+
+void
+del_ledfx_mapping (ledfx_mapping_t * m)
+{
+  if (!m)
+    return;
+  if (m->idx)
+    AUBIO_FREE (m->idx);
+  if (m->run_dst)
+    AUBIO_FREE (m->run_dst);
+  if (m->run_idx)
+    AUBIO_FREE (m->run_idx);
+  if (m->run_len)
+    AUBIO_FREE (m->run_len);
+  AUBIO_FREE (m);
+}
+
+uint_t
+ledfx_mapping_do (const ledfx_mapping_t * m, const fvec_t * in, fvec_t * out)
+{
+  uint_t r;
+  if (in->length != 3 * m->n_in || out->length != 3 * m->n_out) {
+    AUBIO_ERR ("mapping: expected %d and %d values, got %d and %d\n",
+        3 * m->n_in, 3 * m->n_out, in->length, out->length);
+    return AUBIO_FAIL;
+  }
+  for (r = 0; r < m->n_runs; r++) {
+    m->kernels->gather (out->data + m->run_dst[r], in->data,
+        m->idx + m->run_idx[r], m->run_len[r]);
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_mapping_get_n_in (const ledfx_mapping_t * m)
+{
+  return m->n_in;
+}
+
+uint_t
+ledfx_mapping_get_n_out (const ledfx_mapping_t * m)
+{
+  return m->n_out;
+}
+
+uint_t
+ledfx_mapping_get_n_mapped (const ledfx_mapping_t * m)
+{
+  return m->n_mapped;
+}
+
+uint_t
+ledfx_mapping_get_n_runs (const ledfx_mapping_t * m)
+{
+  return m->n_runs;
+}
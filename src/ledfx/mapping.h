@@ -0,0 +1,126 @@
+/*
+  Virtual to device pixel mapping, compiled into gather tables.
+*/
+
+#ifndef LEDFX_MAPPING_H
+#define LEDFX_MAPPING_H
+
+/** \file
+
+  Virtual to device pixel mapping
+
+  Places the frame of a virtual strip onto the pixels of one device. The
+  segments of the virtual on that device, its grouping and mapping mode and
+  the device's center offset are compiled once, by new_ledfx_mapping(), into
+  a table giving for each device value the frame value it comes from. Each
+  frame is then a single gather, ledfx_mapping_do(), per contiguous run of
+  device pixels; there is one run per segment, two when the center offset
+  wraps it around the end of the strip.
+
+  The frame holds n_in effective pixels, each repeated group_size times to
+  make the physical pixels of the virtual, at most n_virtual of them:
+
+  - with ::LEDFX_MAPPING_SPAN, the segments cover consecutive ranges of the
+    physical pixels, from their virtual_start,
+  - with ::LEDFX_MAPPING_COPY, every segment shows the whole virtual,
+    stretched by the grouping and cut to the segment's length.
+
+  Inverted segments run backwards. Device pixel p ends up at (p +
+  center_offset) modulo the device length. Device pixels outside the
+  segments, and segment pixels past the end of the frame, are left as they
+  are, so several virtuals can write to one device.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** how the segments of a virtual share its pixels */
+typedef enum
+{
+  LEDFX_MAPPING_SPAN = 0,       /**< segments split the virtual's pixels */
+  LEDFX_MAPPING_COPY = 1,       /**< each segment shows the whole virtual */
+} ledfx_mapping_mode_t;
+
+/** number of values describing one segment, see new_ledfx_mapping() */
+#define LEDFX_MAPPING_SEGMENT_LEN 4
+
+/** virtual to device mapping object */
+typedef struct _ledfx_mapping_t ledfx_mapping_t;
+
+/** compile a mapping
+
+  Each segment is ::LEDFX_MAPPING_SEGMENT_LEN values: its first physical
+  pixel in the virtual (ignored with ::LEDFX_MAPPING_COPY), its first and
+  last device pixels, inclusive, and non-zero if it is inverted.
+
+  \param mode one of ::ledfx_mapping_mode_t
+  \param n_in effective pixels of the frame
+  \param n_virtual physical pixels of the virtual
+  \param n_out pixels of the device
+  \param group_size physical pixels per effective pixel, 1 or more
+  \param center_offset pixels the device frame is rotated by
+  \param segments n_segments segments, as described above
+  \param n_segments number of segments on this device
+
+  \return newly created mapping, or NULL if a parameter is invalid or a
+  segment does not fit on the device
+
+*/
+ledfx_mapping_t *new_ledfx_mapping (uint_t mode, uint_t n_in,
+    uint_t n_virtual, uint_t n_out, uint_t group_size, uint_t center_offset,
+    const uint_t * segments, uint_t n_segments);
+
+/** delete a mapping
+
+  \param m mapping to delete, as returned by new_ledfx_mapping()
+
+*/
+void del_ledfx_mapping (ledfx_mapping_t * m);
+
+/** write a frame onto the device
+
+  \param m mapping
+  \param in frame, 3 n_in interleaved r, g, b values
+  \param out device pixels, 3 n_out interleaved r, g, b values
+
+  \return 0 on success, non-zero if in or out has the wrong length
+
+*/
+uint_t ledfx_mapping_do (const ledfx_mapping_t * m, const fvec_t * in,
+    fvec_t * out);
+
+/** get number of effective pixels of the frame
+
+  \param m mapping
+
+*/
+uint_t ledfx_mapping_get_n_in (const ledfx_mapping_t * m);
+
+/** get number of pixels of the device
+
+  \param m mapping
+
+*/
+uint_t ledfx_mapping_get_n_out (const ledfx_mapping_t * m);
+
+/** get number of device pixels written by ledfx_mapping_do()
+
+  \param m mapping
+
+*/
+uint_t ledfx_mapping_get_n_mapped (const ledfx_mapping_t * m);
+
+/** get number of contiguous runs of device pixels, one gather each
+
+  \param m mapping
+
+*/
+uint_t ledfx_mapping_get_n_runs (const ledfx_mapping_t * m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_MAPPING_H */
@@ -0,0 +1,217 @@
+/*
+  Melbank post-processing: power law, gain normalisation and smoothing.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "melbank.h"
+
+/* standard deviation of the Gaussian blur applied before taking the gain */
+#define LEDFX_MELBANK_GAIN_SIGMA 1.
+/* exponential filters, as alpha on rise and alpha on decay */
+#define LEDFX_MELBANK_GAIN_RISE 0.99
+#define LEDFX_MELBANK_GAIN_DECAY 0.01
+#define LEDFX_MELBANK_SMOOTHING_RISE 0.99
+#define LEDFX_MELBANK_SMOOTHING_DECAY 0.7
+#define LEDFX_MELBANK_COMMON_RISE 0.01
+#define LEDFX_MELBANK_COMMON_DECAY 0.99
+#define LEDFX_MELBANK_DIFF_RISE 0.99
+#define LEDFX_MELBANK_DIFF_DECAY 0.15
+/* gains below this zero the melbank instead of dividing by them */
+#define LEDFX_MELBANK_MIN_GAIN 1.e-9
+
+struct _ledfx_melbank_t {
+  uint_t n_bands;           /** number of bands */
+  smpl_t power;             /** exponent applied to the bands */
+  uint_t radius;            /** half width of the blur kernel */
+  smpl_t *kernel;           /** normalised Gaussian, 2 * radius + 1 taps */
+  smpl_t *padded;           /** bands with radius edge copies on each side */
+  smpl_t *smoothing;        /** state of the smoothing filter */
+  smpl_t *common;           /** state of the moving average */
+  smpl_t *diff;             /** state of the difference filter */
+  smpl_t gain;              /** state of the gain filter */
+  uint_t primed;            /** whether the filters hold a state */
+};
+
+/* one exponential filter step over a vector; the select keeps the loop free
+ * of branches so that it vectorises */
+static void
+ledfx_melbank_exp_filter (smpl_t * state, const smpl_t * in, uint_t length,
+    smpl_t rise, smpl_t decay)
+{
+  uint_t j;
+  for (j = 0; j < length; j++) {
+    smpl_t alpha = in[j] > state[j] ? rise : decay;
+    state[j] += alpha * (in[j] - state[j]);
+  }
+}
+
+/* maximum of the bands convolved with the blur kernel, with the edge bands
+ * repeated outside of the melbank */
+static smpl_t
+ledfx_melbank_blurred_max (ledfx_melbank_t * m, const smpl_t * bands)
+{
+  uint_t j, k, n = m->n_bands, r = m->radius, taps = 2 * r + 1;
+  smpl_t *padded = m->padded;
+  smpl_t max = 0.;
+  for (j = 0; j < r; j++) {
+    padded[j] = bands[0];
+    padded[r + n + j] = bands[n - 1];
+  }
+  for (j = 0; j < n; j++) {
+    padded[r + j] = bands[j];
+  }
+  for (j = 0; j < n; j++) {
+    smpl_t sum = 0.;
+    for (k = 0; k < taps; k++) {
+      sum += padded[j + k] * m->kernel[k];
+    }
+    max = (j == 0 || sum > max) ? sum : max;
+  }
+  return max;
+}
+
+ledfx_melbank_t *
+new_ledfx_melbank (uint_t n_bands, smpl_t power)
+{
+  ledfx_melbank_t *m = AUBIO_NEW (ledfx_melbank_t);
+  smpl_t sigma = LEDFX_MELBANK_GAIN_SIGMA, sum = 0.;
+  uint_t j, radius;
+  if ((sint_t) n_bands < 1) {
+    AUBIO_ERR ("melbank: got n_bands %d\n", n_bands);
+    goto beach;
+  }
+  m->n_bands = n_bands;
+  m->power = power;
+
+  /* same kernel as fastBlurArray: radius round(4 sigma), at most half of
+   * the melbank and at least 1 */
+  radius = (uint_t) MAX (1, ROUND (4. * sigma));
+  radius = MIN ((n_bands - 1) / 2, radius);
+  radius = MAX (1, radius);
+  m->radius = radius;
+
+  m->kernel = AUBIO_ARRAY (smpl_t, 2 * radius + 1);
+  m->padded = AUBIO_ARRAY (smpl_t, n_bands + 2 * radius);
+  m->smoothing = AUBIO_ARRAY (smpl_t, n_bands);
+  m->common = AUBIO_ARRAY (smpl_t, n_bands);
+  m->diff = AUBIO_ARRAY (smpl_t, n_bands);
+  if (!m->kernel || !m->padded || !m->smoothing || !m->common || !m->diff) {
+    goto beach;
+  }
+  for (j = 0; j < 2 * radius + 1; j++) {
+    smpl_t x = (smpl_t) j - (smpl_t) radius;
+    m->kernel[j] = EXP (-0.5 * x * x / (sigma * sigma));
+    sum += m->kernel[j];
+  }
+  for (j = 0; j < 2 * radius + 1; j++) {
+    m->kernel[j] /= sum;
+  }
+
+  ledfx_melbank_reset (m);
+  return m;
+
+beach:
+  del_ledfx_melbank (m);
+  return NULL;
+}
+
+void
+del_ledfx_melbank (ledfx_melbank_t * m)
+{
+  if (!m)
+    return;
+  if (m->kernel)
+    AUBIO_FREE (m->kernel);
+  if (m->padded)
+    AUBIO_FREE (m->padded);
+  if (m->smoothing)
+    AUBIO_FREE (m->smoothing);
+  if (m->common)
+    AUBIO_FREE (m->common);
+  if (m->diff)
+    AUBIO_FREE (m->diff);
+  AUBIO_FREE (m);
+}
+
+uint_t
+ledfx_melbank_do (ledfx_melbank_t * m, const fvec_t * in, fvec_t * raw,
+    fvec_t * filtered)
+{
+  uint_t j, n = m->n_bands;
+  smpl_t *bands = raw->data, *out = filtered->data, gain, scale;
+  if (in->length < n || raw->length < n || filtered->length < n) {
+    AUBIO_ERR ("melbank: expected buffers of %d bands, got %d, %d and %d\n",
+        n, in->length, raw->length, filtered->length);
+    return AUBIO_FAIL;
+  }
+
+  /* power law, computed in the raw output which doubles as scratch */
+  for (j = 0; j < n; j++) {
+    bands[j] = POW (in->data[j], m->power);
+  }
+
+  gain = ledfx_melbank_blurred_max (m, bands);
+  if (!m->primed) {
+    m->gain = gain;
+  } else {
+    smpl_t alpha = gain > m->gain ? LEDFX_MELBANK_GAIN_RISE
+        : LEDFX_MELBANK_GAIN_DECAY;
+    m->gain += alpha * (gain - m->gain);
+  }
+  scale = ABS (m->gain) > LEDFX_MELBANK_MIN_GAIN ? 1. / m->gain : 0.;
+  for (j = 0; j < n; j++) {
+    bands[j] *= scale;
+  }
+
+  if (!m->primed) {
+    for (j = 0; j < n; j++) {
+      m->smoothing[j] = bands[j];
+      m->common[j] = bands[j];
+      m->diff[j] = 0.;
+    }
+    m->primed = 1;
+  } else {
+    ledfx_melbank_exp_filter (m->smoothing, bands, n,
+        LEDFX_MELBANK_SMOOTHING_RISE, LEDFX_MELBANK_SMOOTHING_DECAY);
+    ledfx_melbank_exp_filter (m->common, m->smoothing, n,
+        LEDFX_MELBANK_COMMON_RISE, LEDFX_MELBANK_COMMON_DECAY);
+    /* difference to the moving average, staged in the filtered output */
+    for (j = 0; j < n; j++) {
+      out[j] = m->smoothing[j] - m->common[j];
+    }
+    ledfx_melbank_exp_filter (m->diff, out, n,
+        LEDFX_MELBANK_DIFF_RISE, LEDFX_MELBANK_DIFF_DECAY);
+  }
+
+  for (j = 0; j < n; j++) {
+    bands[j] = m->smoothing[j];
+    out[j] = m->diff[j];
+  }
+  return AUBIO_OK;
+}
+
+void
+ledfx_melbank_reset (ledfx_melbank_t * m)
+{
+  uint_t j;
+  for (j = 0; j < m->n_bands; j++) {
+    m->smoothing[j] = 0.;
+    m->common[j] = 0.;
+    m->diff[j] = 0.;
+  }
+  m->gain = 0.;
+  m->primed = 0;
+}
+
+smpl_t
+ledfx_melbank_get_gain (ledfx_melbank_t * m)
+{
+  return m->gain;
+}
+
+uint_t
+ledfx_melbank_get_n_bands (ledfx_melbank_t * m)
+{
+  return m->n_bands;
+}
@@ -0,0 +1,93 @@
+/*
+  Melbank post-processing: power law, gain normalisation and smoothing.
+*/
+
+#ifndef LEDFX_MELBANK_H
+#define LEDFX_MELBANK_H
+
+/** \file
+
+  Per-melbank post-processing running once per hop
+
+  Takes the filterbank output of one melbank (see filterbank.h) and, in a
+  single call:
+
+  - raises every band to the power factor derived from the peak isolation,
+  - tracks the gain as the maximum of the Gaussian blurred bands (sigma 1),
+    smoothed with a fast-rise slow-decay exponential filter, and divides the
+    bands by it,
+  - smooths the normalised bands into the raw melbank,
+  - subtracts a slow moving average of the raw melbank and smooths the
+    difference into the filtered melbank.
+
+  Each exponential filter is primed with its first input. All state is
+  allocated by new_ledfx_melbank(); ledfx_melbank_do() does not allocate.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** melbank post-processing object */
+typedef struct _ledfx_melbank_t ledfx_melbank_t;
+
+/** create melbank post-processing
+
+  \param n_bands number of bands of the melbank
+  \param power exponent applied to every band
+
+  \return newly created object, or NULL on invalid parameters
+
+*/
+ledfx_melbank_t *new_ledfx_melbank (uint_t n_bands, smpl_t power);
+
+/** delete melbank post-processing
+
+  \param m object to delete, as returned by new_ledfx_melbank()
+
+*/
+void del_ledfx_melbank (ledfx_melbank_t * m);
+
+/** process one hop
+
+  \param m melbank object
+  \param in filterbank output, at least n_bands long
+  \param raw output, smoothed and gain normalised melbank, n_bands long
+  \param filtered output, smoothed difference to the moving average,
+  n_bands long
+
+  \return 0 on success, non-zero if a buffer is too short
+
+*/
+uint_t ledfx_melbank_do (ledfx_melbank_t * m, const fvec_t * in,
+    fvec_t * raw, fvec_t * filtered);
+
+/** forget the filter state; the next call primes the filters again
+
+  \param m melbank object
+
+*/
+void ledfx_melbank_reset (ledfx_melbank_t * m);
+
+/** get current gain
+
+  \param m melbank object
+
+  \return smoothed maximum of the blurred bands of the last call
+
+*/
+smpl_t ledfx_melbank_get_gain (ledfx_melbank_t * m);
+
+/** get number of bands
+
+  \param m melbank object
+
+*/
+uint_t ledfx_melbank_get_n_bands (ledfx_melbank_t * m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_MELBANK_H */
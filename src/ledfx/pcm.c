@@ -0,0 +1,236 @@
+/*
+  PCM sink: downmix and reframing of captured audio into analysis hops.
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "pcm.h"
+
+#ifdef _WIN32
+typedef SRWLOCK ledfx_pcm_lock_t;
+#define LEDFX_PCM_LOCK_INIT(l) InitializeSRWLock (l)
+#define LEDFX_PCM_LOCK_DESTROY(l)
+#define LEDFX_PCM_LOCK(l) AcquireSRWLockExclusive (l)
+#define LEDFX_PCM_UNLOCK(l) ReleaseSRWLockExclusive (l)
+#else
+typedef pthread_mutex_t ledfx_pcm_lock_t;
+#define LEDFX_PCM_LOCK_INIT(l) pthread_mutex_init (l, NULL)
+#define LEDFX_PCM_LOCK_DESTROY(l) pthread_mutex_destroy (l)
+#define LEDFX_PCM_LOCK(l) pthread_mutex_lock (l)
+#define LEDFX_PCM_UNLOCK(l) pthread_mutex_unlock (l)
+#endif
+
+struct _ledfx_pcm_t {
+  uint_t hop_s;             /** samples per hop */
+  uint_t samplerate;        /** rate of the pushed blocks, in Hz */
+  uint_t max_hops;          /** hops the queue holds */
+  ledfx_pcm_lock_t lock;    /** guards the fields below */
+  smpl_t *hops;             /** max_hops queued hops of hop_s samples */
+  unsigned long long *timestamps; /** capture time of each queued hop */
+  uint_t *flags;            /** flags of each queued hop */
+  uint_t head;              /** oldest queued hop */
+  uint_t n_queued;          /** hops queued */
+  smpl_t *fill;             /** hop being filled */
+  uint_t n_fill;            /** samples in fill */
+  unsigned long long fill_timestamp; /** capture time of fill */
+  uint_t fill_silent;       /** whether fill is silence so far */
+  uint_t dropped;           /** whether hops were dropped since the last pop */
+  uint_t n_hops;            /** hops completed */
+  uint_t n_dropped;         /** hops dropped */
+};
+
+ledfx_pcm_t *
+new_ledfx_pcm (uint_t hop_s, uint_t samplerate, uint_t max_hops)
+{
+  ledfx_pcm_t *p = AUBIO_NEW (ledfx_pcm_t);
+  if ((sint_t) hop_s < 1) {
+    AUBIO_ERR ("pcm: got hop size %d, expected at least 1\n", hop_s);
+    goto beach;
+  }
+  if ((sint_t) samplerate < 1) {
+    AUBIO_ERR ("pcm: got sample rate %d, expected at least 1\n", samplerate);
+    goto beach;
+  }
+  if ((sint_t) max_hops < 1) {
+    AUBIO_ERR ("pcm: got queue of %d hops, expected at least 1\n", max_hops);
+    goto beach;
+  }
+  p->hop_s = hop_s;
+  p->samplerate = samplerate;
+  p->max_hops = max_hops;
+  LEDFX_PCM_LOCK_INIT (&p->lock);
+  p->hops = AUBIO_ARRAY (smpl_t, hop_s * max_hops);
+  p->timestamps = AUBIO_ARRAY (unsigned long long, max_hops);
+  p->flags = AUBIO_ARRAY (uint_t, max_hops);
+  p->fill = AUBIO_ARRAY (smpl_t, hop_s);
+  if (!p->hops || !p->timestamps || !p->flags || !p->fill) {
+    del_ledfx_pcm (p);
+    return NULL;
+  }
+  p->fill_silent = 1;
+  return p;
+
+beach:
+  AUBIO_FREE (p);
+  return NULL;
+}
+
+void
+del_ledfx_pcm (ledfx_pcm_t * p)
+{
+  if (!p)
+    return;
+  if (p->hops)
+    AUBIO_FREE (p->hops);
+  if (p->timestamps)
+    AUBIO_FREE (p->timestamps);
+  if (p->flags)
+    AUBIO_FREE (p->flags);
+  if (p->fill)
+    AUBIO_FREE (p->fill);
+  LEDFX_PCM_LOCK_DESTROY (&p->lock);
+  AUBIO_FREE (p);
+}
+
+/* queue the filled hop, over the oldest one if the queue is full */
+static void
+ledfx_pcm_queue (ledfx_pcm_t * p)
+{
+  uint_t slot;
+  if (p->n_queued == p->max_hops) {
+    p->head = (p->head + 1) % p->max_hops;
+    p->n_queued--;
+    p->n_dropped++;
+    p->dropped = 1;
+  }
+  slot = (p->head + p->n_queued) % p->max_hops;
+  AUBIO_MEMCPY (p->hops + (size_t) slot * p->hop_s, p->fill,
+      p->hop_s * sizeof (smpl_t));
+  p->timestamps[slot] = p->fill_timestamp;
+  p->flags[slot] = p->fill_silent ? LEDFX_PCM_SILENT : 0;
+  p->n_queued++;
+  p->n_hops++;
+  p->n_fill = 0;
+  p->fill_silent = 1;
+}
+
+uint_t
+ledfx_pcm_push (ledfx_pcm_t * p, const float *samples, uint_t frames,
+    uint_t channels, unsigned long long timestamp_us)
+{
+  uint_t i, c;
+  if (channels < 1 || channels > LEDFX_PCM_MAX_CHANNELS) {
+    AUBIO_ERR ("pcm: got %d channels, expected 1 to %d\n", channels,
+        LEDFX_PCM_MAX_CHANNELS);
+    return AUBIO_FAIL;
+  }
+  LEDFX_PCM_LOCK (&p->lock);
+  for (i = 0; i < frames; i++) {
+    if (p->n_fill == 0) {
+      p->fill_timestamp = timestamp_us == 0 ? 0 : timestamp_us
+          + (unsigned long long) i * 1000000ULL / p->samplerate;
+    }
+    if (!samples) {
+      p->fill[p->n_fill++] = 0.;
+    } else if (channels == 1) {
+      p->fill[p->n_fill++] = samples[i];
+      p->fill_silent = 0;
+    } else {
+      const float *frame = samples + (size_t) i * channels;
+      smpl_t sum = 0.;
+      for (c = 0; c < channels; c++) {
+        sum += frame[c];
+      }
+      p->fill[p->n_fill++] = sum / channels;
+      p->fill_silent = 0;
+    }
+    if (p->n_fill == p->hop_s) {
+      ledfx_pcm_queue (p);
+    }
+  }
+  LEDFX_PCM_UNLOCK (&p->lock);
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_pcm_pop (ledfx_pcm_t * p, fvec_t * hop,
+    unsigned long long *timestamp_us, uint_t * flags)
+{
+  uint_t found = 0;
+  if (hop->length != p->hop_s) {
+    AUBIO_ERR ("pcm: got a hop of %d samples, expected %d\n", hop->length,
+        p->hop_s);
+    return 0;
+  }
+  LEDFX_PCM_LOCK (&p->lock);
+  if (p->n_queued > 0) {
+    AUBIO_MEMCPY (hop->data, p->hops + (size_t) p->head * p->hop_s,
+        p->hop_s * sizeof (smpl_t));
+    if (timestamp_us) {
+      *timestamp_us = p->timestamps[p->head];
+    }
+    if (flags) {
+      *flags = p->flags[p->head] | (p->dropped ? LEDFX_PCM_DISCONTINUITY : 0);
+    }
+    p->dropped = 0;
+    p->head = (p->head + 1) % p->max_hops;
+    p->n_queued--;
+    found = 1;
+  }
+  LEDFX_PCM_UNLOCK (&p->lock);
+  return found;
+}
+
+void
+ledfx_pcm_reset (ledfx_pcm_t * p)
+{
+  LEDFX_PCM_LOCK (&p->lock);
+  p->head = 0;
+  p->n_queued = 0;
+  p->n_fill = 0;
+  p->fill_silent = 1;
+  p->dropped = 0;
+  LEDFX_PCM_UNLOCK (&p->lock);
+}
+
+uint_t
+ledfx_pcm_get_hop_size (const ledfx_pcm_t * p)
+{
+  return p->hop_s;
+}
+
+uint_t
+ledfx_pcm_get_n_queued (ledfx_pcm_t * p)
+{
+  uint_t n;
+  LEDFX_PCM_LOCK (&p->lock);
+  n = p->n_queued;
+  LEDFX_PCM_UNLOCK (&p->lock);
+  return n;
+}
+
+uint_t
+ledfx_pcm_get_n_hops (ledfx_pcm_t * p)
+{
+  uint_t n;
+  LEDFX_PCM_LOCK (&p->lock);
+  n = p->n_hops;
+  LEDFX_PCM_UNLOCK (&p->lock);
+  return n;
+}
+
+uint_t
+ledfx_pcm_get_n_dropped (ledfx_pcm_t * p)
+{
+  uint_t n;
+  LEDFX_PCM_LOCK (&p->lock);
+  n = p->n_dropped;
+  LEDFX_PCM_UNLOCK (&p->lock);
+  return n;
+}
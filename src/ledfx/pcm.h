@@ -0,0 +1,152 @@
+/*
+  PCM sink: downmix and reframing of captured audio into analysis hops.
+*/
+
+#ifndef LEDFX_PCM_H
+#define LEDFX_PCM_H
+
+/** \file
+
+  PCM sink shared by the audio capture producers
+
+  Takes blocks of interleaved float samples of any length and channel count
+  from a capture thread, with ledfx_pcm_push(), averages the channels down
+  to mono and cuts the stream into hops of hop_s samples. The analysis
+  thread takes the hops in order with ledfx_pcm_pop(), for instance straight
+  into the input of a ::ledfx_frontend_t:
+
+  \code
+  while (ledfx_pcm_pop (pcm, ledfx_frontend_get_input (f), &t, &flags)) {
+    ledfx_frontend_do (f);
+  }
+  \endcode
+
+  Each hop is dated with the capture time of its first sample, worked out
+  from the timestamp of the block it starts in and its offset in that
+  block; a timestamp of 0 means unknown and stays 0.
+
+  Up to max_hops hops wait for the analysis. When the queue is full the
+  oldest hop is dropped, so that the analysis stays on the newest audio,
+  and the next hop taken is flagged ::LEDFX_PCM_DISCONTINUITY.
+
+  The sink does not resample: producers push at the rate it was created
+  with.
+
+  One thread pushes and one thread pops, any threads. Both lock the sink
+  only while copying, and nothing is allocated after creation.
+
+  A producer outside the library, such as the Windows runner, which shares
+  the process with it, looks ledfx_pcm_push() up in the loaded library and
+  gets the handle from the side that created the sink, e.g. as an integer
+  over a method channel. An Android producer needs a JNI function calling
+  ledfx_pcm_push().
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** most channels of a pushed block */
+#define LEDFX_PCM_MAX_CHANNELS 32
+
+/** flag of a hop made only of silence, pushed with NULL samples */
+#define LEDFX_PCM_SILENT 1
+/** flag of the first hop taken after hops were dropped */
+#define LEDFX_PCM_DISCONTINUITY 2
+
+/** PCM sink object */
+typedef struct _ledfx_pcm_t ledfx_pcm_t;
+
+/** create a PCM sink
+
+  \param hop_s number of samples per hop
+  \param samplerate sample rate of the pushed blocks, in Hz
+  \param max_hops number of hops that can wait for ledfx_pcm_pop()
+
+  \return newly created object, or NULL on invalid parameters
+
+*/
+ledfx_pcm_t *new_ledfx_pcm (uint_t hop_s, uint_t samplerate,
+    uint_t max_hops);
+
+/** delete a PCM sink
+
+  \param p object to delete, as returned by new_ledfx_pcm()
+
+*/
+void del_ledfx_pcm (ledfx_pcm_t * p);
+
+/** push a block of captured samples
+
+  \param p PCM sink
+  \param samples frames interleaved frames of channels samples each, or
+  NULL for frames of silence
+  \param frames number of frames
+  \param channels number of channels, 1 to ::LEDFX_PCM_MAX_CHANNELS
+  \param timestamp_us capture time of the first frame in microseconds, 0 if
+  unknown
+
+  \return 0 on success, non-zero if channels is out of range
+
+*/
+uint_t ledfx_pcm_push (ledfx_pcm_t * p, const float *samples, uint_t frames,
+    uint_t channels, unsigned long long timestamp_us);
+
+/** take the oldest hop
+
+  \param p PCM sink
+  \param hop output, hop_s samples
+  \param timestamp_us if not NULL, set to the capture time of the first
+  sample of the hop, 0 if unknown
+  \param flags if not NULL, set to the ::LEDFX_PCM_SILENT and
+  ::LEDFX_PCM_DISCONTINUITY flags of the hop
+
+  \return 1 if a hop was taken, 0 if none is waiting or hop has the wrong
+  length
+
+*/
+uint_t ledfx_pcm_pop (ledfx_pcm_t * p, fvec_t * hop,
+    unsigned long long *timestamp_us, uint_t * flags);
+
+/** drop the waiting hops and the samples of the hop being filled, e.g.
+  when the capture restarts
+
+  \param p PCM sink
+
+*/
+void ledfx_pcm_reset (ledfx_pcm_t * p);
+
+/** get number of samples per hop
+
+  \param p PCM sink
+
+*/
+uint_t ledfx_pcm_get_hop_size (const ledfx_pcm_t * p);
+
+/** get number of hops waiting for ledfx_pcm_pop()
+
+  \param p PCM sink
+
+*/
+uint_t ledfx_pcm_get_n_queued (ledfx_pcm_t * p);
+
+/** get number of hops completed since creation
+
+  \param p PCM sink
+
+*/
+uint_t ledfx_pcm_get_n_hops (ledfx_pcm_t * p);
+
+/** get number of hops dropped because the queue was full, since creation
+
+  \param p PCM sink
+
+*/
+uint_t ledfx_pcm_get_n_dropped (ledfx_pcm_t * p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_PCM_H */
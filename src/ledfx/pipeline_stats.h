@@ -0,0 +1,221 @@
+#ifndef LEDFX_PIPELINE_STATS_H_
+#define LEDFX_PIPELINE_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <chrono>
+#endif
+
+namespace ledfx
+{
+
+  // Microseconds on the clock audio capture timestamps are taken from: the
+  // performance counter on Windows (pu64QPCPosition of
+  // IAudioCaptureClient::GetBuffer is the same counter in 100 ns units), the
+  // monotonic clock elsewhere (System.nanoTime() on Android).
+  inline int64_t NowMicros()
+  {
+#ifdef _WIN32
+    static const int64_t frequency = []
+    {
+      LARGE_INTEGER f;
+      QueryPerformanceFrequency(&f);
+      return static_cast<int64_t>(f.QuadPart);
+    }();
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    const int64_t ticks = static_cast<int64_t>(counter.QuadPart);
+    // Split to keep ticks * 1e6 from overflowing after a few days of uptime.
+    return ticks / frequency * 1000000 + ticks % frequency * 1000000 / frequency;
+#else
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  struct LatencySummary
+  {
+    uint64_t count = 0;
+    int64_t p50_us = 0;
+    int64_t p99_us = 0;
+    int64_t max_us = 0;
+    int64_t mean_us = 0;
+  };
+
+  // Histogram of latencies in microseconds with log-linear buckets: exact
+  // below 16 us, then 16 buckets per power of two, so a percentile is off by
+  // at most 1/32 of its value. Values from 2^32 us (over an hour) up land in
+  // the last bucket. Record() is lock-free and may be called from any number
+  // of threads; Summary() may run concurrently and sees a recent state.
+  class LatencyHistogram
+  {
+  public:
+    static constexpr int kSubBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBits;
+    static constexpr size_t kBuckets = (32 - kSubBits + 1) * kSubBuckets;
+
+    void Record(int64_t latency_us)
+    {
+      const uint64_t value = latency_us > 0 ? static_cast<uint64_t>(latency_us) : 0;
+      buckets_[BucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+      count_.fetch_add(1, std::memory_order_relaxed);
+      sum_.fetch_add(value, std::memory_order_relaxed);
+      uint64_t max = max_.load(std::memory_order_relaxed);
+      while (value > max &&
+             !max_.compare_exchange_weak(max, value, std::memory_order_relaxed))
+      {
+      }
+    }
+
+    LatencySummary Summary() const
+    {
+      std::array<uint64_t, kBuckets> counts;
+      uint64_t total = 0;
+      for (size_t i = 0; i < kBuckets; i++)
+      {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+      }
+      LatencySummary summary;
+      summary.count = total;
+      if (total == 0)
+        return summary;
+      summary.max_us = static_cast<int64_t>(max_.load(std::memory_order_relaxed));
+      summary.mean_us = static_cast<int64_t>(sum_.load(std::memory_order_relaxed) /
+                                             count_.load(std::memory_order_relaxed));
+      summary.p50_us = Percentile(counts, total, 0.50, summary.max_us);
+      summary.p99_us = Percentile(counts, total, 0.99, summary.max_us);
+      return summary;
+    }
+
+    void Reset()
+    {
+      for (auto &bucket : buckets_)
+        bucket.store(0, std::memory_order_relaxed);
+      count_.store(0, std::memory_order_relaxed);
+      sum_.store(0, std::memory_order_relaxed);
+      max_.store(0, std::memory_order_relaxed);
+    }
+
+    static size_t BucketOf(uint64_t value)
+    {
+      if (value < kSubBuckets)
+        return static_cast<size_t>(value);
+      int exponent = 63;
+      while (!(value >> exponent))
+        exponent--;
+      if (exponent > 31)
+        return kBuckets - 1;
+      const size_t sub = static_cast<size_t>(value >> (exponent - kSubBits)) & (kSubBuckets - 1);
+      return static_cast<size_t>(exponent - kSubBits + 1) * kSubBuckets + sub;
+    }
+
+    // Smallest value that falls into |bucket|.
+    static uint64_t BucketFloor(size_t bucket)
+    {
+      if (bucket < kSubBuckets)
+        return bucket;
+      const int exponent = static_cast<int>(bucket / kSubBuckets) + kSubBits - 1;
+      const uint64_t sub = bucket % kSubBuckets;
+      return (uint64_t{1} << exponent) + (sub << (exponent - kSubBits));
+    }
+
+  private:
+    // Middle of the bucket holding the value of rank |fraction| * total,
+    // capped at the largest value seen.
+    static int64_t Percentile(const std::array<uint64_t, kBuckets> &counts, uint64_t total,
+                              double fraction, int64_t max_us)
+    {
+      uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(total) + 0.5);
+      if (rank < 1)
+        rank = 1;
+      uint64_t seen = 0;
+      for (size_t i = 0; i < kBuckets; i++)
+      {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+          const uint64_t floor = BucketFloor(i);
+          const uint64_t width = i + 1 < kBuckets ? BucketFloor(i + 1) - floor : 1;
+          const int64_t mid = static_cast<int64_t>(floor + (width - 1) / 2);
+          return mid < max_us ? mid : max_us;
+        }
+      }
+      return max_us;
+    }
+
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+  };
+
+  // Points of the audio path at which the age of a hop is measured, counted
+  // from its capture timestamp. The values are shared with
+  // lib/src/platform/pipeline_stats.dart.
+  enum class PipelineStage : int32_t
+  {
+    kQueued = 0,    // hop ready on the capture thread, after resampling
+    kSent = 1,      // hop handed to the event channel on the platform thread
+    kAnalysed = 2,  // hop analysed by the Dart audio source
+    kSubmitted = 3, // frame of the latest analysed hop handed to the output
+                    // scheduler, which sends it at the device's next deadline
+  };
+  constexpr size_t kPipelineStageCount = 4;
+
+  inline const char *PipelineStageName(PipelineStage stage)
+  {
+    switch (stage)
+    {
+    case PipelineStage::kQueued:
+      return "queued";
+    case PipelineStage::kSent:
+      return "sent";
+    case PipelineStage::kAnalysed:
+      return "analysed";
+    case PipelineStage::kSubmitted:
+      return "submitted";
+    }
+    return "unknown";
+  }
+
+  // One latency histogram per pipeline stage.
+  class PipelineStats
+  {
+  public:
+    // Records the age of a hop captured at |capture_us| (NowMicros() clock)
+    // as it reaches |stage|. Timestamps of 0 mean "unknown" and are skipped.
+    void Record(PipelineStage stage, int64_t capture_us, int64_t now_us = NowMicros())
+    {
+      const size_t index = static_cast<size_t>(stage);
+      if (capture_us == 0 || index >= kPipelineStageCount)
+        return;
+      stages_[index].Record(now_us - capture_us);
+    }
+
+    LatencySummary Summary(PipelineStage stage) const
+    {
+      const size_t index = static_cast<size_t>(stage);
+      return index < kPipelineStageCount ? stages_[index].Summary() : LatencySummary{};
+    }
+
+    void Reset()
+    {
+      for (auto &stage : stages_)
+        stage.Reset();
+    }
+
+  private:
+    std::array<LatencyHistogram, kPipelineStageCount> stages_;
+  };
+
+} // namespace ledfx
+
+#endif // LEDFX_PIPELINE_STATS_H_
@@ -0,0 +1,316 @@
+/*
+  Fixed pool of worker threads running batches of tasks with work stealing.
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "aubio_priv.h"
+#include "pool.h"
+
+#ifdef _WIN32
+typedef SRWLOCK ledfx_pool_lock_t;
+typedef CONDITION_VARIABLE ledfx_pool_cond_t;
+#define LEDFX_POOL_LOCK_INIT(l) InitializeSRWLock (l)
+#define LEDFX_POOL_LOCK_DESTROY(l)
+#define LEDFX_POOL_LOCK(l) AcquireSRWLockExclusive (l)
+#define LEDFX_POOL_UNLOCK(l) ReleaseSRWLockExclusive (l)
+#define LEDFX_POOL_COND_INIT(c) InitializeConditionVariable (c)
+#define LEDFX_POOL_COND_DESTROY(c)
+#define LEDFX_POOL_COND_WAIT(c, l) SleepConditionVariableSRW (c, l, INFINITE, 0)
+#define LEDFX_POOL_COND_SIGNAL(c) WakeConditionVariable (c)
+#define LEDFX_POOL_COND_BROADCAST(c) WakeAllConditionVariable (c)
+#else
+typedef pthread_mutex_t ledfx_pool_lock_t;
+typedef pthread_cond_t ledfx_pool_cond_t;
+#define LEDFX_POOL_LOCK_INIT(l) pthread_mutex_init (l, NULL)
+#define LEDFX_POOL_LOCK_DESTROY(l) pthread_mutex_destroy (l)
+#define LEDFX_POOL_LOCK(l) pthread_mutex_lock (l)
+#define LEDFX_POOL_UNLOCK(l) pthread_mutex_unlock (l)
+#define LEDFX_POOL_COND_INIT(c) pthread_cond_init (c, NULL)
+#define LEDFX_POOL_COND_DESTROY(c) pthread_cond_destroy (c)
+#define LEDFX_POOL_COND_WAIT(c, l) pthread_cond_wait (c, l)
+#define LEDFX_POOL_COND_SIGNAL(c) pthread_cond_signal (c)
+#define LEDFX_POOL_COND_BROADCAST(c) pthread_cond_broadcast (c)
+#endif
+
+/* tasks dealt to one thread; the owner pops from the tail, thieves from the
+ * head */
+typedef struct {
+  ledfx_pool_lock_t lock;   /** guards the fields below */
+  uint_t *tasks;            /** indices of tasks of the batch */
+  uint_t head;              /** oldest task */
+  uint_t tail;              /** one past the newest task */
+} ledfx_pool_deque_t;
+
+typedef struct {
+  ledfx_pool_t *pool;       /** pool of the worker */
+  uint_t index;             /** deque of the worker */
+} ledfx_pool_worker_t;
+
+struct _ledfx_pool_t {
+  uint_t n_threads;         /** worker threads */
+  uint_t n_deques;          /** n_threads, plus one for the caller */
+  ledfx_pool_deque_t *deques; /** one per thread, the caller's last */
+  ledfx_pool_worker_t *workers; /** arguments of the worker threads */
+  ledfx_pool_task_t task;   /** task of the batch */
+  void *data;               /** data of the batch */
+  ledfx_pool_lock_t lock;   /** guards the fields below */
+  ledfx_pool_cond_t work;   /** signalled when a batch starts or on quit */
+  ledfx_pool_cond_t done;   /** signalled when remaining drops to 0 */
+  uint_t remaining;         /** tasks of the batch not run yet */
+  uint_t generation;        /** batches started */
+  uint_t quit;              /** set to stop the workers */
+  uint_t n_stolen;          /** tasks run by another thread than dealt */
+  uint_t n_started;         /** worker threads running */
+#ifdef _WIN32
+  HANDLE *threads;          /** worker threads */
+#else
+  pthread_t *threads;       /** worker threads */
+#endif
+};
+
+/* take a task for thread self, its own newest or another's oldest; the
+ * batch is read under the deque lock, so a worker still looking for work
+ * from the previous batch sees the one the task was dealt in */
+static uint_t
+ledfx_pool_take (ledfx_pool_t * p, uint_t self, ledfx_pool_task_t * task,
+    void **data, uint_t * i, uint_t * stolen)
+{
+  uint_t k;
+  for (k = 0; k < p->n_deques; k++) {
+    ledfx_pool_deque_t *d = &p->deques[(self + k) % p->n_deques];
+    uint_t found = 0;
+    LEDFX_POOL_LOCK (&d->lock);
+    if (d->head < d->tail) {
+      *i = k == 0 ? d->tasks[--d->tail] : d->tasks[d->head++];
+      *task = p->task;
+      *data = p->data;
+      found = 1;
+    }
+    LEDFX_POOL_UNLOCK (&d->lock);
+    if (found) {
+      *stolen = k != 0;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* run tasks as thread self until none is left to take */
+static void
+ledfx_pool_work (ledfx_pool_t * p, uint_t self)
+{
+  ledfx_pool_task_t task;
+  void *data;
+  uint_t i, stolen, n_done = 0, n_stolen = 0;
+  while (ledfx_pool_take (p, self, &task, &data, &i, &stolen)) {
+    task (data, i);
+    n_done++;
+    n_stolen += stolen;
+  }
+  if (n_done == 0) {
+    return;
+  }
+  LEDFX_POOL_LOCK (&p->lock);
+  p->n_stolen += n_stolen;
+  p->remaining -= n_done;
+  if (p->remaining == 0) {
+    LEDFX_POOL_COND_SIGNAL (&p->done);
+  }
+  LEDFX_POOL_UNLOCK (&p->lock);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI
+ledfx_pool_worker (LPVOID data)
+#else
+static void *
+ledfx_pool_worker (void *data)
+#endif
+{
+  ledfx_pool_worker_t *w = (ledfx_pool_worker_t *) data;
+  ledfx_pool_t *p = w->pool;
+  uint_t seen = 0;
+  LEDFX_POOL_LOCK (&p->lock);
+  seen = p->generation;
+  for (;;) {
+    while (!p->quit && p->generation == seen) {
+      LEDFX_POOL_COND_WAIT (&p->work, &p->lock);
+    }
+    if (p->quit) {
+      break;
+    }
+    seen = p->generation;
+    LEDFX_POOL_UNLOCK (&p->lock);
+    ledfx_pool_work (p, w->index);
+    LEDFX_POOL_LOCK (&p->lock);
+  }
+  LEDFX_POOL_UNLOCK (&p->lock);
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+ledfx_pool_t *
+new_ledfx_pool (uint_t n_threads)
+{
+  ledfx_pool_t *p = AUBIO_NEW (ledfx_pool_t);
+  uint_t i;
+  if (n_threads > LEDFX_POOL_MAX_THREADS) {
+    AUBIO_ERR ("pool: got %d threads, expected at most %d\n", n_threads,
+        LEDFX_POOL_MAX_THREADS);
+    AUBIO_FREE (p);
+    return NULL;
+  }
+  p->n_threads = n_threads;
+  p->n_deques = n_threads + 1;
+  LEDFX_POOL_LOCK_INIT (&p->lock);
+  LEDFX_POOL_COND_INIT (&p->work);
+  LEDFX_POOL_COND_INIT (&p->done);
+  p->deques = AUBIO_ARRAY (ledfx_pool_deque_t, p->n_deques);
+  p->workers = AUBIO_ARRAY (ledfx_pool_worker_t, MAX (n_threads, 1));
+#ifdef _WIN32
+  p->threads = AUBIO_ARRAY (HANDLE, MAX (n_threads, 1));
+#else
+  p->threads = AUBIO_ARRAY (pthread_t, MAX (n_threads, 1));
+#endif
+  if (!p->deques || !p->workers || !p->threads) {
+    goto beach;
+  }
+  for (i = 0; i < p->n_deques; i++) {
+    LEDFX_POOL_LOCK_INIT (&p->deques[i].lock);
+    p->deques[i].tasks = AUBIO_ARRAY (uint_t, LEDFX_POOL_MAX_TASKS);
+    if (!p->deques[i].tasks) {
+      goto beach;
+    }
+  }
+  for (i = 0; i < n_threads; i++) {
+    p->workers[i].pool = p;
+    p->workers[i].index = i;
+#ifdef _WIN32
+    p->threads[i] = CreateThread (NULL, 0, ledfx_pool_worker,
+        &p->workers[i], 0, NULL);
+    if (!p->threads[i]) {
+      AUBIO_ERR ("pool: could not start thread %d\n", i);
+      goto beach;
+    }
+#else
+    if (pthread_create (&p->threads[i], NULL, ledfx_pool_worker,
+            &p->workers[i]) != 0) {
+      AUBIO_ERR ("pool: could not start thread %d\n", i);
+      goto beach;
+    }
+#endif
+    p->n_started++;
+  }
+  return p;
+
+beach:
+  del_ledfx_pool (p);
+  return NULL;
+}
+
+void
+del_ledfx_pool (ledfx_pool_t * p)
+{
+  uint_t i;
+  if (!p)
+    return;
+  LEDFX_POOL_LOCK (&p->lock);
+  p->quit = 1;
+  LEDFX_POOL_COND_BROADCAST (&p->work);
+  LEDFX_POOL_UNLOCK (&p->lock);
+  for (i = 0; i < p->n_started; i++) {
+#ifdef _WIN32
+    WaitForSingleObject (p->threads[i], INFINITE);
+    CloseHandle (p->threads[i]);
+#else
+    pthread_join (p->threads[i], NULL);
+#endif
+  }
+  if (p->deques) {
+    for (i = 0; i < p->n_deques; i++) {
+      if (p->deques[i].tasks) {
+        AUBIO_FREE (p->deques[i].tasks);
+      }
+      LEDFX_POOL_LOCK_DESTROY (&p->deques[i].lock);
+    }
+    AUBIO_FREE (p->deques);
+  }
+  if (p->workers)
+    AUBIO_FREE (p->workers);
+  if (p->threads)
+    AUBIO_FREE (p->threads);
+  LEDFX_POOL_COND_DESTROY (&p->work);
+  LEDFX_POOL_COND_DESTROY (&p->done);
+  LEDFX_POOL_LOCK_DESTROY (&p->lock);
+  AUBIO_FREE (p);
+}
+
+uint_t
+ledfx_pool_run (ledfx_pool_t * p, ledfx_pool_task_t task, void *data,
+    uint_t n_tasks)
+{
+  uint_t i;
+  if (n_tasks > LEDFX_POOL_MAX_TASKS) {
+    AUBIO_ERR ("pool: got %d tasks, expected at most %d\n", n_tasks,
+        LEDFX_POOL_MAX_TASKS);
+    return AUBIO_FAIL;
+  }
+  if (n_tasks == 0) {
+    return AUBIO_OK;
+  }
+  /* the batch is set before any of its tasks can be taken */
+  LEDFX_POOL_LOCK (&p->lock);
+  p->task = task;
+  p->data = data;
+  p->remaining = n_tasks;
+  LEDFX_POOL_UNLOCK (&p->lock);
+  for (i = 0; i < p->n_deques; i++) {
+    ledfx_pool_deque_t *d = &p->deques[i];
+    uint_t t;
+    LEDFX_POOL_LOCK (&d->lock);
+    d->head = d->tail = 0;
+    for (t = i; t < n_tasks; t += p->n_deques) {
+      d->tasks[d->tail++] = t;
+    }
+    LEDFX_POOL_UNLOCK (&d->lock);
+  }
+  if (p->n_threads > 0) {
+    LEDFX_POOL_LOCK (&p->lock);
+    p->generation++;
+    LEDFX_POOL_COND_BROADCAST (&p->work);
+    LEDFX_POOL_UNLOCK (&p->lock);
+  }
+
+  ledfx_pool_work (p, p->n_threads);
+
+  LEDFX_POOL_LOCK (&p->lock);
+  while (p->remaining > 0) {
+    LEDFX_POOL_COND_WAIT (&p->done, &p->lock);
+  }
+  LEDFX_POOL_UNLOCK (&p->lock);
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_pool_get_n_threads (const ledfx_pool_t * p)
+{
+  return p->n_threads;
+}
+
+uint_t
+ledfx_pool_get_n_stolen (ledfx_pool_t * p)
+{
+  uint_t n;
+  LEDFX_POOL_LOCK (&p->lock);
+  n = p->n_stolen;
+  LEDFX_POOL_UNLOCK (&p->lock);
+  return n;
+}
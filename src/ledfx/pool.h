@@ -0,0 +1,94 @@
+/*
+  Fixed pool of worker threads running batches of tasks with work stealing.
+*/
+
+#ifndef LEDFX_POOL_H
+#define LEDFX_POOL_H
+
+/** \file
+
+  Worker pool
+
+  Runs a batch of independent tasks on a fixed set of worker threads
+  started by new_ledfx_pool(), and on the calling thread. ledfx_pool_run()
+  deals the tasks out round robin to one deque per thread, wakes the
+  workers and returns once every task has run, a barrier for the batch.
+
+  Each thread runs the tasks of its own deque, newest first; once it is
+  empty, it steals the oldest task of another thread's deque. Uneven tasks
+  so end up spread over the threads without any up-front balancing.
+
+  Workers sleep between batches, so an idle pool costs nothing. Only one
+  thread at a time should call ledfx_pool_run() on a pool.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** most worker threads of a pool */
+#define LEDFX_POOL_MAX_THREADS 64
+/** most tasks of one batch */
+#define LEDFX_POOL_MAX_TASKS 1024
+
+/** worker pool object */
+typedef struct _ledfx_pool_t ledfx_pool_t;
+
+/** task run by the pool, called with the data of the batch and the index
+  of the task in it */
+typedef void (*ledfx_pool_task_t) (void *data, uint_t i);
+
+/** create a worker pool and start its threads
+
+  \param n_threads number of worker threads, 0 to
+  ::LEDFX_POOL_MAX_THREADS; the thread calling ledfx_pool_run() takes part
+  too, so 0 runs every batch on that thread alone
+
+  \return newly created object, or NULL if n_threads is too large or a
+  thread could not be started
+
+*/
+ledfx_pool_t *new_ledfx_pool (uint_t n_threads);
+
+/** stop the threads and delete a worker pool
+
+  \param p object to delete, as returned by new_ledfx_pool()
+
+*/
+void del_ledfx_pool (ledfx_pool_t * p);
+
+/** run a batch of tasks and wait for all of them
+
+  \param p worker pool
+  \param task function run once for each index below n_tasks
+  \param data passed to every call of task
+  \param n_tasks number of tasks, up to ::LEDFX_POOL_MAX_TASKS
+
+  \return 0 once every task has run, non-zero if n_tasks is too large, in
+  which case no task is run
+
+*/
+uint_t ledfx_pool_run (ledfx_pool_t * p, ledfx_pool_task_t task,
+    void *data, uint_t n_tasks);
+
+/** get number of worker threads
+
+  \param p worker pool
+
+*/
+uint_t ledfx_pool_get_n_threads (const ledfx_pool_t * p);
+
+/** get number of tasks run by another thread than the one dealt them,
+  since creation
+
+  \param p worker pool
+
+*/
+uint_t ledfx_pool_get_n_stolen (ledfx_pool_t * p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_POOL_H */
@@ -0,0 +1,263 @@
+/*
+  Effect post-processing: flip, mirror, brightness and blur per frame.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "postprocess.h"
+
+/* largest kernel radius convolved directly; wider blurs use box filters */
+#define LEDFX_POSTPROCESS_MAX_RADIUS 12
+/* number of box filters approximating a wide Gaussian */
+#define LEDFX_POSTPROCESS_BOXES 3
+/* smallest sigma, as in gaussianKernel1d */
+#define LEDFX_POSTPROCESS_MIN_SIGMA 1.e-5
+
+struct _ledfx_postprocess_t {
+  uint_t n_pixels;          /** number of pixels of the strip */
+  uint_t flip;              /** whether to reverse the strip */
+  uint_t mirror;            /** whether to mirror the strip */
+  smpl_t brightness;        /** factor applied to every value */
+  uint_t radius;            /** kernel radius, 0 for no blur */
+  smpl_t kernel[2 * LEDFX_POSTPROCESS_MAX_RADIUS + 1]; /** direct taps */
+  uint_t boxes[LEDFX_POSTPROCESS_BOXES]; /** box widths, 0 for direct */
+  uint_t pad;               /** pixels the box filters reach past an end */
+  smpl_t *scratch;          /** 6 n_pixels values */
+  smpl_t *scratch2;         /** 6 n_pixels values, box filter ping-pong */
+};
+
+ledfx_postprocess_t *
+new_ledfx_postprocess (uint_t n_pixels)
+{
+  ledfx_postprocess_t *p = AUBIO_NEW (ledfx_postprocess_t);
+  if ((sint_t) n_pixels < 1) {
+    AUBIO_ERR ("postprocess: got n_pixels %d\n", n_pixels);
+    goto beach;
+  }
+  p->n_pixels = n_pixels;
+  p->brightness = 1.;
+  /* room for the strip and the zero padding of the box filters, at most
+   * half a strip on each side */
+  p->scratch = AUBIO_ARRAY (smpl_t, 6 * n_pixels);
+  p->scratch2 = AUBIO_ARRAY (smpl_t, 6 * n_pixels);
+  if (!p->scratch || !p->scratch2) {
+    goto beach;
+  }
+  return p;
+
+beach:
+  del_ledfx_postprocess (p);
+  return NULL;
+}
+
+void
+del_ledfx_postprocess (ledfx_postprocess_t * p)
+{
+  if (!p)
+    return;
+  if (p->scratch)
+    AUBIO_FREE (p->scratch);
+  if (p->scratch2)
+    AUBIO_FREE (p->scratch2);
+  AUBIO_FREE (p);
+}
+
+void
+ledfx_postprocess_set_flip (ledfx_postprocess_t * p, uint_t flip)
+{
+  p->flip = flip ? 1 : 0;
+}
+
+void
+ledfx_postprocess_set_mirror (ledfx_postprocess_t * p, uint_t mirror)
+{
+  p->mirror = mirror ? 1 : 0;
+}
+
+void
+ledfx_postprocess_set_brightness (ledfx_postprocess_t * p, smpl_t brightness)
+{
+  p->brightness = brightness;
+}
+
+uint_t
+ledfx_postprocess_set_blur (ledfx_postprocess_t * p, smpl_t sigma)
+{
+  uint_t j, radius, n = p->n_pixels;
+  smpl_t sum = 0.;
+  if (sigma < 0.) {
+    AUBIO_ERR ("postprocess: got blur %f\n", sigma);
+    return AUBIO_FAIL;
+  }
+  p->radius = 0;
+  p->pad = 0;
+  for (j = 0; j < LEDFX_POSTPROCESS_BOXES; j++) {
+    p->boxes[j] = 0;
+  }
+  if (sigma == 0. || n <= 3) {
+    return AUBIO_OK;
+  }
+
+  /* same radius as gaussianKernel1d: round(4 sigma), at most half of the
+   * strip and at least 1 */
+  sigma = MAX (LEDFX_POSTPROCESS_MIN_SIGMA, sigma);
+  radius = (uint_t) MAX (1, ROUND (4. * sigma));
+  radius = MIN ((n - 1) / 2, radius);
+  radius = MAX (1, radius);
+  p->radius = radius;
+
+  if (radius <= LEDFX_POSTPROCESS_MAX_RADIUS) {
+    for (j = 0; j < 2 * radius + 1; j++) {
+      smpl_t x = (smpl_t) j - (smpl_t) radius;
+      p->kernel[j] = EXP (-0.5 * x * x / (sigma * sigma));
+      sum += p->kernel[j];
+    }
+    for (j = 0; j < 2 * radius + 1; j++) {
+      p->kernel[j] /= sum;
+    }
+  } else {
+    /* odd box widths wl and wl + 2 whose three passes have the variance of
+     * the Gaussian (Kovesi), each at most a third of the kernel so the
+     * passes do not reach further than the truncated kernel */
+    lsmp_t var = 12. * sigma * sigma;
+    lsmp_t ideal = SQRT (var / LEDFX_POSTPROCESS_BOXES + 1.);
+    uint_t wl = (uint_t) floor (ideal), widest = 2 * (radius / 3) + 1, m;
+    if (wl % 2 == 0) {
+      wl--;
+    }
+    m = (uint_t) MAX (0, ROUND ((var - LEDFX_POSTPROCESS_BOXES * (wl * wl
+                + 4. * wl + 3.)) / (-4. * wl - 4.)));
+    for (j = 0; j < LEDFX_POSTPROCESS_BOXES; j++) {
+      p->boxes[j] = MIN (j < m ? wl : wl + 2, widest);
+      p->pad += p->boxes[j] / 2;
+    }
+  }
+  return AUBIO_OK;
+}
+
+/* convolves the strip s with the cached kernel into d, zero outside of the
+ * strip */
+static void
+ledfx_postprocess_convolve (const ledfx_postprocess_t * p, const smpl_t * s,
+    smpl_t * d)
+{
+  uint_t i, k, n = p->n_pixels, r = p->radius, taps = 2 * r + 1;
+  const smpl_t *kernel = p->kernel;
+  for (i = 0; i < n; i++) {
+    smpl_t r_sum = 0., g_sum = 0., b_sum = 0.;
+    /* taps falling outside of the strip are skipped */
+    uint_t first = i < r ? r - i : 0;
+    uint_t last = i + r >= n ? n - 1 + r - i : taps - 1;
+    const smpl_t *src = s + 3 * (i + first - r);
+    for (k = first; k <= last; k++, src += 3) {
+      r_sum += kernel[k] * src[0];
+      g_sum += kernel[k] * src[1];
+      b_sum += kernel[k] * src[2];
+    }
+    d[3 * i] = r_sum;
+    d[3 * i + 1] = g_sum;
+    d[3 * i + 2] = b_sum;
+  }
+}
+
+/* centred box filter of odd width w from s into d, zero outside of the
+ * strip, with running sums */
+static void
+ledfx_postprocess_box (uint_t n, uint_t w, const smpl_t * s, smpl_t * d)
+{
+  uint_t i, c, h = w / 2;
+  lsmp_t sum[3] = { 0., 0., 0. }, scale = 1. / w;
+  for (i = 0; i <= h && i < n; i++) {
+    for (c = 0; c < 3; c++) {
+      sum[c] += s[3 * i + c];
+    }
+  }
+  for (i = 0; i < n; i++) {
+    for (c = 0; c < 3; c++) {
+      d[3 * i + c] = (smpl_t) (sum[c] * scale);
+    }
+    for (c = 0; c < 3; c++) {
+      if (i + h + 1 < n) {
+        sum[c] += s[3 * (i + h + 1) + c];
+      }
+      if (i >= h) {
+        sum[c] -= s[3 * (i - h) + c];
+      }
+    }
+  }
+}
+
+uint_t
+ledfx_postprocess_do (ledfx_postprocess_t * p, const fvec_t * in,
+    fvec_t * out)
+{
+  uint_t i, c, n = p->n_pixels;
+  const smpl_t *s = in->data;
+  smpl_t *t = p->scratch, *d = out->data, brightness = p->brightness;
+  if (in->length != 3 * n || out->length != 3 * n) {
+    AUBIO_ERR ("postprocess: expected %d values, got %d and %d\n", 3 * n,
+        in->length, out->length);
+    return AUBIO_FAIL;
+  }
+
+  /* flip, mirror and brightness into the scratch, so that in and out may
+   * be the same vector */
+  if (p->mirror) {
+    /* pixel i of the mirrored strip is the larger of entries 2 i and
+     * 2 i + 1 of [reversed strip, strip] */
+    for (i = 0; i < n; i++) {
+      uint_t j1 = 2 * i < n ? n - 1 - 2 * i : 2 * i - n;
+      uint_t j2 = 2 * i + 1 < n ? n - 2 - 2 * i : 2 * i + 1 - n;
+      const smpl_t *a = s + 3 * (p->flip ? n - 1 - j1 : j1);
+      const smpl_t *b = s + 3 * (p->flip ? n - 1 - j2 : j2);
+      for (c = 0; c < 3; c++) {
+        t[3 * i + c] = MAX (a[c], b[c]) * brightness;
+      }
+    }
+  } else if (p->flip) {
+    for (i = 0; i < n; i++) {
+      const smpl_t *src = s + 3 * (n - 1 - i);
+      for (c = 0; c < 3; c++) {
+        t[3 * i + c] = src[c] * brightness;
+      }
+    }
+  } else {
+    for (i = 0; i < 3 * n; i++) {
+      t[i] = s[i] * brightness;
+    }
+  }
+
+  if (p->radius == 0) {
+    for (i = 0; i < 3 * n; i++) {
+      d[i] = t[i];
+    }
+  } else if (p->boxes[0] == 0) {
+    ledfx_postprocess_convolve (p, t, d);
+  } else {
+    /* the passes run over the strip padded with zeros, so that what one
+     * pass spreads past the ends is seen by the next, as with a single
+     * kernel */
+    uint_t pad = p->pad, ext = n + 2 * pad;
+    smpl_t *a = p->scratch2;
+    for (i = 0; i < 3 * pad; i++) {
+      a[i] = 0.;
+      a[3 * (pad + n) + i] = 0.;
+    }
+    for (i = 0; i < 3 * n; i++) {
+      a[3 * pad + i] = t[i];
+    }
+    ledfx_postprocess_box (ext, p->boxes[0], a, t);
+    ledfx_postprocess_box (ext, p->boxes[1], t, a);
+    ledfx_postprocess_box (ext, p->boxes[2], a, t);
+    for (i = 0; i < 3 * n; i++) {
+      d[i] = t[3 * pad + i];
+    }
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_postprocess_get_n_pixels (ledfx_postprocess_t * p)
+{
+  return p->n_pixels;
+}
@@ -0,0 +1,116 @@
+/*
+  Effect post-processing: flip, mirror, brightness and blur per frame.
+*/
+
+#ifndef LEDFX_POSTPROCESS_H
+#define LEDFX_POSTPROCESS_H
+
+/** \file
+
+  Post-processing of an effect frame
+
+  Runs the per-frame stage every effect goes through before its pixels are
+  assembled, on a strip of interleaved r, g, b values:
+
+  - flip reverses the strip,
+  - mirror folds the reversed strip followed by the strip into one strip of
+    the same length, keeping the larger value of each pair,
+  - brightness scales every value,
+  - blur convolves each channel with a Gaussian, zero outside of the strip.
+
+  The blur kernel is built by ledfx_postprocess_set_blur() and cached. It is
+  the same truncated Gaussian as gaussianKernel1d (radius round(4 sigma),
+  at most half the strip), applied directly while the radius is small. For
+  larger radii it is approximated by three box filters of running sums, so
+  the cost per pixel stays constant whatever sigma.
+
+  All state is allocated by new_ledfx_postprocess();
+  ledfx_postprocess_do() does not allocate.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** post-processing object */
+typedef struct _ledfx_postprocess_t ledfx_postprocess_t;
+
+/** create post-processing
+
+  \param n_pixels number of pixels of the strip
+
+  \return newly created object, with no flip, no mirror, brightness 1 and
+  no blur, or NULL on invalid parameters
+
+*/
+ledfx_postprocess_t *new_ledfx_postprocess (uint_t n_pixels);
+
+/** delete post-processing
+
+  \param p object to delete, as returned by new_ledfx_postprocess()
+
+*/
+void del_ledfx_postprocess (ledfx_postprocess_t * p);
+
+/** set flip
+
+  \param p post-processing object
+  \param flip 1 to reverse the strip, 0 otherwise
+
+*/
+void ledfx_postprocess_set_flip (ledfx_postprocess_t * p, uint_t flip);
+
+/** set mirror
+
+  \param p post-processing object
+  \param mirror 1 to mirror the strip, 0 otherwise
+
+*/
+void ledfx_postprocess_set_mirror (ledfx_postprocess_t * p, uint_t mirror);
+
+/** set brightness
+
+  \param p post-processing object
+  \param brightness factor applied to every value
+
+*/
+void ledfx_postprocess_set_brightness (ledfx_postprocess_t * p,
+    smpl_t brightness);
+
+/** set blur
+
+  Strips of 3 pixels or less are never blurred.
+
+  \param p post-processing object
+  \param sigma standard deviation of the Gaussian in pixels, 0 to disable
+
+  \return 0 on success, non-zero if sigma is negative
+
+*/
+uint_t ledfx_postprocess_set_blur (ledfx_postprocess_t * p, smpl_t sigma);
+
+/** process one frame
+
+  \param p post-processing object
+  \param in input, 3 n_pixels interleaved r, g, b values
+  \param out output, 3 n_pixels long; may be the same vector as in
+
+  \return 0 on success, non-zero if a buffer has the wrong length
+
+*/
+uint_t ledfx_postprocess_do (ledfx_postprocess_t * p, const fvec_t * in,
+    fvec_t * out);
+
+/** get number of pixels
+
+  \param p post-processing object
+
+*/
+uint_t ledfx_postprocess_get_n_pixels (ledfx_postprocess_t * p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_POSTPROCESS_H */
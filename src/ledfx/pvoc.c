@@ -0,0 +1,114 @@
+/*
+  Phase vocoder on the FFT backend and vector kernels of the ledfx layer.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "cvec.h"
+#include "mathutils.h"
+#include "musicutils.h"
+#include "kernels.h"
+#include "fft.h"
+#include "pvoc.h"
+
+struct _ledfx_pvoc_t {
+  uint_t win_s;             /** window size */
+  uint_t hop_s;             /** samples per call */
+  ledfx_fft_t *fft;         /** forward FFT */
+  fvec_t *window;           /** analysis window */
+  fvec_t *frame;            /** last win_s input samples */
+  fvec_t *grain;            /** windowed and shifted frame */
+  fvec_t *compspec;         /** FFT output */
+  const ledfx_kernels_t *kernels; /** vector kernels for this CPU */
+};
+
+ledfx_pvoc_t *
+new_ledfx_pvoc (uint_t win_s, uint_t hop_s)
+{
+  ledfx_pvoc_t *pv = AUBIO_NEW (ledfx_pvoc_t);
+  if ((sint_t) hop_s < 1 || (sint_t) win_s < 2 || hop_s > win_s
+      || !aubio_is_power_of_two (win_s)) {
+    AUBIO_ERR ("pvoc: got win_s %d and hop_s %d\n", win_s, hop_s);
+    goto beach;
+  }
+  pv->win_s = win_s;
+  pv->hop_s = hop_s;
+
+  pv->fft = new_ledfx_fft (win_s);
+  pv->window = new_aubio_window ("hanningz", win_s);
+  pv->frame = new_fvec (win_s);
+  pv->grain = new_fvec (win_s);
+  pv->compspec = new_fvec (win_s);
+  if (!pv->fft || !pv->window || !pv->frame || !pv->grain || !pv->compspec) {
+    goto beach;
+  }
+  pv->kernels = ledfx_kernels ();
+  return pv;
+
+beach:
+  del_ledfx_pvoc (pv);
+  return NULL;
+}
+
+void
+del_ledfx_pvoc (ledfx_pvoc_t * pv)
+{
+  if (!pv)
+    return;
+  if (pv->fft)
+    del_ledfx_fft (pv->fft);
+  if (pv->window)
+    del_fvec (pv->window);
+  if (pv->frame)
+    del_fvec (pv->frame);
+  if (pv->grain)
+    del_fvec (pv->grain);
+  if (pv->compspec)
+    del_fvec (pv->compspec);
+  AUBIO_FREE (pv);
+}
+
+void
+ledfx_pvoc_do (ledfx_pvoc_t * pv, const fvec_t * in, cvec_t * fftgrain)
+{
+  const uint_t win_s = pv->win_s, hop_s = pv->hop_s, half = win_s / 2;
+  smpl_t *frame = pv->frame->data, *w = pv->window->data;
+  smpl_t *compspec = pv->compspec->data, *phas = fftgrain->phas;
+  uint_t i;
+
+  /* slide the frame by one hop */
+  memmove (frame, frame + hop_s, (win_s - hop_s) * sizeof (smpl_t));
+  AUBIO_MEMCPY (frame + win_s - hop_s, in->data, hop_s * sizeof (smpl_t));
+
+  /* window, swapping both halves as fvec_shift () */
+  pv->kernels->weighted_copy (pv->grain->data, frame + half, w + half, half);
+  pv->kernels->weighted_copy (pv->grain->data + half, frame, w, half);
+
+  ledfx_fft_do_complex (pv->fft, pv->grain, pv->compspec);
+  pv->kernels->complex_norm (fftgrain->norm, compspec, win_s);
+
+  /* phases as aubio_fft_get_phas () */
+  phas[0] = compspec[0] < 0 ? PI : 0.;
+  for (i = 1; i < half; i++) {
+    phas[i] = ATAN2 (compspec[win_s - i], compspec[i]);
+  }
+  phas[half] = compspec[half] < 0 ? PI : 0.;
+}
+
+const fvec_t *
+ledfx_pvoc_get_frame (const ledfx_pvoc_t * pv)
+{
+  return pv->frame;
+}
+
+uint_t
+ledfx_pvoc_get_win (const ledfx_pvoc_t * pv)
+{
+  return pv->win_s;
+}
+
+uint_t
+ledfx_pvoc_get_hop (const ledfx_pvoc_t * pv)
+{
+  return pv->hop_s;
+}
@@ -0,0 +1,83 @@
+/*
+  Phase vocoder on the FFT backend and vector kernels of the ledfx layer.
+*/
+
+#ifndef LEDFX_PVOC_H
+#define LEDFX_PVOC_H
+
+/** \file
+
+  Forward phase vocoder
+
+  ledfx_pvoc_do() gives the same spectrum as aubio_pvoc_do(): the last
+  win_s input samples are weighted by a hanningz window, their two halves
+  swapped, and transformed with the FFT of fft.h.
+
+  The unwindowed frame is kept and exposed with ledfx_pvoc_get_frame(), so
+  time-domain analysis over the same window, such as pitch detection, does
+  not need its own sliding buffer.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** phase vocoder object */
+typedef struct _ledfx_pvoc_t ledfx_pvoc_t;
+
+/** create phase vocoder
+
+  \param win_s window size, a power of two
+  \param hop_s number of input samples per call to ledfx_pvoc_do(), at most
+  win_s
+
+  \return newly created object, or NULL on invalid parameters
+
+*/
+ledfx_pvoc_t *new_ledfx_pvoc (uint_t win_s, uint_t hop_s);
+
+/** delete phase vocoder
+
+  \param pv object to delete, as returned by new_ledfx_pvoc()
+
+*/
+void del_ledfx_pvoc (ledfx_pvoc_t * pv);
+
+/** slide in one hop and compute its spectrum
+
+  \param pv phase vocoder object
+  \param in hop_s new samples
+  \param fftgrain output spectrum, of length win_s / 2 + 1
+
+*/
+void ledfx_pvoc_do (ledfx_pvoc_t * pv, const fvec_t * in, cvec_t * fftgrain);
+
+/** get the current frame
+
+  \param pv phase vocoder object
+
+  \return the last win_s input samples, before windowing
+
+*/
+const fvec_t *ledfx_pvoc_get_frame (const ledfx_pvoc_t * pv);
+
+/** get window size
+
+  \param pv phase vocoder object
+
+*/
+uint_t ledfx_pvoc_get_win (const ledfx_pvoc_t * pv);
+
+/** get hop size
+
+  \param pv phase vocoder object
+
+*/
+uint_t ledfx_pvoc_get_hop (const ledfx_pvoc_t * pv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_PVOC_H */
@@ -0,0 +1,228 @@
+/*
+  Native part of rendering a virtual, run for many virtuals on a pool.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "postprocess.h"
+#include "mapping.h"
+#include "pool.h"
+#include "render.h"
+
+struct _ledfx_render_t {
+  ledfx_postprocess_t *post; /** post-processing of frame, or NULL */
+  fvec_t *frame;            /** effect frame, processed in place */
+  uint_t n_targets;         /** devices the frame is written onto */
+  uint_t max_targets;       /** allocated targets */
+  const ledfx_mapping_t **mappings; /** mapping onto each device */
+  fvec_t **pixels;          /** pixels of each device */
+  uint_t index;             /** position in the batch being run */
+  ledfx_render_t *group;    /** towards the first task of the group */
+  ledfx_render_t *next;     /** next task of the group, in batch order */
+  ledfx_render_t *last;     /** first task of a group: its last task */
+};
+
+ledfx_render_t *
+new_ledfx_render (void)
+{
+  return AUBIO_NEW (ledfx_render_t);
+}
+
+void
+del_ledfx_render (ledfx_render_t * r)
+{
+  if (!r)
+    return;
+  if (r->mappings)
+    AUBIO_FREE ((void *) r->mappings);
+  if (r->pixels)
+    AUBIO_FREE (r->pixels);
+  AUBIO_FREE (r);
+}
+
+uint_t
+ledfx_render_set_frame (ledfx_render_t * r, ledfx_postprocess_t * post,
+    fvec_t * frame)
+{
+  r->n_targets = 0;
+  if (post && frame->length != 3 * ledfx_postprocess_get_n_pixels (post)) {
+    AUBIO_ERR ("render: expected %d values, got %d\n",
+        3 * ledfx_postprocess_get_n_pixels (post), frame->length);
+    r->post = NULL;
+    r->frame = NULL;
+    return AUBIO_FAIL;
+  }
+  r->post = post;
+  r->frame = frame;
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_render_add_target (ledfx_render_t * r, const ledfx_mapping_t * m,
+    fvec_t * pixels)
+{
+  if (!r->frame || r->frame->length != 3 * ledfx_mapping_get_n_in (m)
+      || pixels->length != 3 * ledfx_mapping_get_n_out (m)) {
+    AUBIO_ERR ("render: mapping of %d onto %d pixels does not fit\n",
+        ledfx_mapping_get_n_in (m), ledfx_mapping_get_n_out (m));
+    return AUBIO_FAIL;
+  }
+  if (r->n_targets == r->max_targets) {
+    uint_t max_targets = MAX (2 * r->max_targets, 4);
+    const ledfx_mapping_t **mappings =
+        AUBIO_ARRAY (const ledfx_mapping_t *, max_targets);
+    fvec_t **targets = AUBIO_ARRAY (fvec_t *, max_targets);
+    if (!mappings || !targets) {
+      if (mappings)
+        AUBIO_FREE ((void *) mappings);
+      if (targets)
+        AUBIO_FREE (targets);
+      return AUBIO_FAIL;
+    }
+    if (r->n_targets > 0) {
+      AUBIO_MEMCPY ((void *) mappings, r->mappings,
+          r->n_targets * sizeof (*mappings));
+      AUBIO_MEMCPY (targets, r->pixels, r->n_targets * sizeof (*targets));
+    }
+    if (r->mappings)
+      AUBIO_FREE ((void *) r->mappings);
+    if (r->pixels)
+      AUBIO_FREE (r->pixels);
+    r->mappings = mappings;
+    r->pixels = targets;
+    r->max_targets = max_targets;
+  }
+  r->mappings[r->n_targets] = m;
+  r->pixels[r->n_targets] = pixels;
+  r->n_targets++;
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_render_do (ledfx_render_t * r)
+{
+  uint_t i, n;
+  smpl_t *d;
+  if (!r->frame) {
+    AUBIO_ERR ("render: no frame\n");
+    return AUBIO_FAIL;
+  }
+  if (r->post) {
+    ledfx_postprocess_do (r->post, r->frame, r->frame);
+  }
+  /* written so that NaN stays NaN, as PixelFrame.clamp */
+  d = r->frame->data;
+  n = r->frame->length;
+  for (i = 0; i < n; i++) {
+    if (d[i] < 0.) {
+      d[i] = 0.;
+    } else if (d[i] > 255.) {
+      d[i] = 255.;
+    }
+  }
+  for (i = 0; i < r->n_targets; i++) {
+    ledfx_mapping_do (r->mappings[i], r->frame, r->pixels[i]);
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_render_get_n_targets (const ledfx_render_t * r)
+{
+  return r->n_targets;
+}
+
+/* first task of the group of r, compressing the path on the way */
+static ledfx_render_t *
+ledfx_render_group (ledfx_render_t * r)
+{
+  ledfx_render_t *root = r, *up;
+  while (root->group != root) {
+    root = root->group;
+  }
+  while (r != root) {
+    up = r->group;
+    r->group = root;
+    r = up;
+  }
+  return root;
+}
+
+/* whether a and b write into the pixels of a same device */
+static uint_t
+ledfx_render_overlap (const ledfx_render_t * a, const ledfx_render_t * b)
+{
+  uint_t i, j;
+  for (i = 0; i < a->n_targets; i++) {
+    for (j = 0; j < b->n_targets; j++) {
+      if (a->pixels[i] == b->pixels[j]) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/* pool task: the whole group of a first task, nothing for the others */
+static void
+ledfx_render_run_group (void *data, uint_t i)
+{
+  ledfx_render_t *r = ((ledfx_render_t * const *) data)[i];
+  if (r->group != r) {
+    return;
+  }
+  for (; r; r = r->next) {
+    ledfx_render_do (r);
+  }
+}
+
+uint_t
+ledfx_render_run (ledfx_pool_t * p, ledfx_render_t * const *renders,
+    uint_t n_renders)
+{
+  uint_t i, j;
+  if (n_renders > LEDFX_POOL_MAX_TASKS) {
+    AUBIO_ERR ("render: got %d tasks, expected at most %d\n", n_renders,
+        LEDFX_POOL_MAX_TASKS);
+    return AUBIO_FAIL;
+  }
+  for (i = 0; i < n_renders; i++) {
+    if (!renders[i]->frame) {
+      AUBIO_ERR ("render: task %d has no frame\n", i);
+      return AUBIO_FAIL;
+    }
+  }
+
+  /* group the tasks sharing a device, each group led by its first task */
+  for (i = 0; i < n_renders; i++) {
+    ledfx_render_t *r = renders[i];
+    r->index = i;
+    r->group = r;
+    for (j = 0; j < i; j++) {
+      ledfx_render_t *a, *b;
+      if (!ledfx_render_overlap (r, renders[j])) {
+        continue;
+      }
+      a = ledfx_render_group (r);
+      b = ledfx_render_group (renders[j]);
+      if (a->index < b->index) {
+        b->group = a;
+      } else if (b->index < a->index) {
+        a->group = b;
+      }
+    }
+  }
+  /* chain each group in batch order, so it runs as written */
+  for (i = 0; i < n_renders; i++) {
+    ledfx_render_t *r = renders[i], *first = ledfx_render_group (r);
+    r->next = NULL;
+    if (first == r) {
+      r->last = r;
+    } else {
+      first->last->next = r;
+      first->last = r;
+    }
+  }
+  return ledfx_pool_run (p, ledfx_render_run_group, (void *) renders,
+      n_renders);
+}
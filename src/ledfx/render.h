@@ -0,0 +1,106 @@
+/*
+  Native part of rendering a virtual, run for many virtuals on a pool.
+*/
+
+#ifndef LEDFX_RENDER_H
+#define LEDFX_RENDER_H
+
+/** \file
+
+  Virtual render task
+
+  Holds what is left to do natively once an effect has drawn a frame of a
+  virtual: post-process it in place with a ::ledfx_postprocess_t, clamp it
+  to 0..255 and write it onto the pixels of each of the virtual's devices
+  through their ::ledfx_mapping_t. ledfx_render_do() runs one task;
+  ledfx_render_run() runs the tasks of every virtual due at an output tick
+  on a ::ledfx_pool_t, in parallel, and returns once all are done.
+
+  Virtuals sharing a device write into the same pixels. Their tasks are
+  run one after the other, in the order given, by a single thread; the
+  others run independently.
+
+  The targets are kept from one frame to the next, and their storage only
+  grows, so that a steady set of virtuals renders without allocating.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** virtual render task object */
+typedef struct _ledfx_render_t ledfx_render_t;
+
+/** create an empty render task
+
+  \return newly created object, with no frame and no target
+
+*/
+ledfx_render_t *new_ledfx_render (void);
+
+/** delete a render task
+
+  \param r object to delete, as returned by new_ledfx_render()
+
+*/
+void del_ledfx_render (ledfx_render_t * r);
+
+/** set the frame of the next renders, and remove all targets
+
+  \param r render task
+  \param post post-processing run on frame in place, or NULL for none
+  \param frame effect frame, 3 n_pixels interleaved r, g, b values
+
+  \return 0 on success, non-zero if frame does not match post
+
+*/
+uint_t ledfx_render_set_frame (ledfx_render_t * r, ledfx_postprocess_t * post,
+    fvec_t * frame);
+
+/** add a device to write the frame onto
+
+  \param r render task
+  \param m mapping of the virtual onto the device
+  \param pixels pixels of the device, 3 ledfx_mapping_get_n_out() values
+
+  \return 0 on success, non-zero if m does not match the frame or pixels
+
+*/
+uint_t ledfx_render_add_target (ledfx_render_t * r, const ledfx_mapping_t * m,
+    fvec_t * pixels);
+
+/** run a render task on the calling thread
+
+  \param r render task
+
+  \return 0 on success, non-zero if no frame is set
+
+*/
+uint_t ledfx_render_do (ledfx_render_t * r);
+
+/** run render tasks on a pool and wait for all of them
+
+  \param p worker pool
+  \param renders n_renders tasks, with distinct frames
+  \param n_renders number of tasks, up to ::LEDFX_POOL_MAX_TASKS
+
+  \return 0 on success, non-zero if n_renders is too large or a task has no
+  frame, in which case no task is run
+
+*/
+uint_t ledfx_render_run (ledfx_pool_t * p, ledfx_render_t * const *renders,
+    uint_t n_renders);
+
+/** get number of devices the frame is written onto
+
+  \param r render task
+
+*/
+uint_t ledfx_render_get_n_targets (const ledfx_render_t * r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_RENDER_H */
@@ -0,0 +1,544 @@
+/*
+  Output scheduler pacing the LED devices from one native thread.
+*/
+
+/* clock_gettime and clock_nanosleep are POSIX.1b */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#endif
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "udp.h"
+#include "ddp.h"
+#include "wled.h"
+#include "scheduler.h"
+
+#if defined(__linux__)
+#define LEDFX_HAVE_CLOCK_NANOSLEEP 1
+#endif
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+/* longest sleep, so that deletion never waits on a slow output */
+#define LEDFX_SCHEDULER_MAX_SLEEP_NS 20000000LL
+
+#define LEDFX_NS_PER_S 1000000000LL
+
+typedef long long ledfx_ns_t;
+
+typedef struct {
+  uint_t used;              /** whether the slot holds an output */
+  ledfx_ddp_t *ddp;         /** DDP packetizer, or NULL */
+  ledfx_wled_t *wled;       /** WLED realtime encoder, or NULL */
+  ledfx_udp_t *udp;         /** sender connected to the device */
+  fvec_t *frame;            /** latest submitted frame */
+  fvec_t *sending;          /** frame being sent, swapped with frame */
+  uint_t fresh;             /** whether frame was submitted since sent */
+  ledfx_ns_t period;        /** time between deadlines */
+  ledfx_ns_t deadline;      /** next deadline */
+  ledfx_ns_t keepalive;     /** WLED: time between whole frames, or 0 */
+  ledfx_ns_t last_whole;    /** WLED: when the whole frame was last sent */
+  uint_t n_ticks;           /** deadlines reached */
+  uint_t n_frames;          /** frames sent */
+  uint_t n_missed;          /** deadlines slept through */
+  ledfx_ns_t late_sum;      /** summed lateness of the reached deadlines */
+  ledfx_ns_t late_max;      /** largest lateness of a reached deadline */
+} ledfx_scheduler_output_t;
+
+/* a frame to encode and send once the lock is released */
+typedef struct {
+  ledfx_ddp_t *ddp;         /** DDP packetizer, or NULL */
+  ledfx_wled_t *wled;       /** WLED realtime encoder, or NULL */
+  ledfx_udp_t *udp;         /** sender connected to the device */
+  fvec_t *frame;            /** frame to send */
+  uint_t all;               /** WLED: whether to send the whole frame */
+} ledfx_scheduler_send_t;
+
+struct _ledfx_scheduler_t {
+  ledfx_scheduler_output_t outputs[LEDFX_SCHEDULER_MAX_OUTPUTS]; /** slots */
+  uint_t running;           /** cleared to stop the thread */
+#ifdef _WIN32
+  SRWLOCK lock;             /** guards outputs and running */
+  SRWLOCK send_lock;        /** held by the thread while sending */
+  HANDLE thread;            /** scheduler thread */
+  HANDLE timer;             /** waitable timer the thread sleeps on */
+  LARGE_INTEGER freq;       /** performance counter frequency */
+#else
+  pthread_mutex_t lock;     /** guards outputs and running */
+  pthread_mutex_t send_lock; /** held by the thread while sending */
+  pthread_t thread;         /** scheduler thread */
+#endif
+  uint_t started;           /** whether thread was started */
+};
+
+#ifdef _WIN32
+#define LEDFX_SCHEDULER_LOCK(s) AcquireSRWLockExclusive (&(s)->lock)
+#define LEDFX_SCHEDULER_UNLOCK(s) ReleaseSRWLockExclusive (&(s)->lock)
+#define LEDFX_SCHEDULER_SEND_LOCK(s) AcquireSRWLockExclusive (&(s)->send_lock)
+#define LEDFX_SCHEDULER_SEND_UNLOCK(s) \
+  ReleaseSRWLockExclusive (&(s)->send_lock)
+#else
+#define LEDFX_SCHEDULER_LOCK(s) pthread_mutex_lock (&(s)->lock)
+#define LEDFX_SCHEDULER_UNLOCK(s) pthread_mutex_unlock (&(s)->lock)
+#define LEDFX_SCHEDULER_SEND_LOCK(s) pthread_mutex_lock (&(s)->send_lock)
+#define LEDFX_SCHEDULER_SEND_UNLOCK(s) pthread_mutex_unlock (&(s)->send_lock)
+#endif
+
+static ledfx_ns_t
+ledfx_scheduler_now (const ledfx_scheduler_t * s)
+{
+#ifdef _WIN32
+  LARGE_INTEGER t;
+  QueryPerformanceCounter (&t);
+  return (ledfx_ns_t) (t.QuadPart / s->freq.QuadPart) * LEDFX_NS_PER_S
+      + (ledfx_ns_t) (t.QuadPart % s->freq.QuadPart) * LEDFX_NS_PER_S
+      / s->freq.QuadPart;
+#else
+  struct timespec t;
+  (void) s;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return (ledfx_ns_t) t.tv_sec * LEDFX_NS_PER_S + t.tv_nsec;
+#endif
+}
+
+/* sleep until the monotonic clock reads until */
+static void
+ledfx_scheduler_sleep_until (ledfx_scheduler_t * s, ledfx_ns_t until)
+{
+#if defined(_WIN32)
+  LARGE_INTEGER due;
+  ledfx_ns_t left = until - ledfx_scheduler_now (s);
+  if (left <= 0)
+    return;
+  /* relative, in 100 ns units */
+  due.QuadPart = -(left / 100);
+  if (s->timer && SetWaitableTimer (s->timer, &due, 0, NULL, NULL, FALSE)) {
+    WaitForSingleObject (s->timer, INFINITE);
+  } else {
+    Sleep ((DWORD) (left / 1000000));
+  }
+#elif defined(LEDFX_HAVE_CLOCK_NANOSLEEP)
+  struct timespec t;
+  (void) s;
+  t.tv_sec = (time_t) (until / LEDFX_NS_PER_S);
+  t.tv_nsec = (long) (until % LEDFX_NS_PER_S);
+  while (clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR);
+#else
+  /* no absolute sleep, as on Apple platforms: the deadlines stay absolute */
+  struct timespec t;
+  ledfx_ns_t left = until - ledfx_scheduler_now (s);
+  if (left <= 0)
+    return;
+  t.tv_sec = (time_t) (left / LEDFX_NS_PER_S);
+  t.tv_nsec = (long) (left % LEDFX_NS_PER_S);
+  while (nanosleep (&t, &t) == -1 && errno == EINTR);
+#endif
+}
+
+/* reach the deadline of o at now; if there is a new frame, take it and
+   fill send with it, and return 1; call with the lock held */
+static uint_t
+ledfx_scheduler_tick (ledfx_scheduler_output_t * o, ledfx_ns_t now,
+    ledfx_scheduler_send_t * send)
+{
+  fvec_t *frame;
+  ledfx_ns_t late = now - o->deadline;
+  if (late >= o->period) {
+    /* the deadlines slept through are dropped, not caught up on */
+    ledfx_ns_t skipped = late / o->period;
+    o->n_missed += (uint_t) skipped;
+    o->deadline += skipped * o->period;
+    late -= skipped * o->period;
+  }
+  o->deadline += o->period;
+  o->n_ticks++;
+  o->late_sum += late;
+  o->late_max = MAX (o->late_max, late);
+  if (!o->fresh) {
+    return 0;
+  }
+  o->fresh = 0;
+  /* submit() writes the other buffer while this one is sent */
+  frame = o->sending;
+  o->sending = o->frame;
+  o->frame = frame;
+  send->ddp = o->ddp;
+  send->wled = o->wled;
+  send->udp = o->udp;
+  send->frame = o->sending;
+  send->all = o->keepalive == 0 || now - o->last_whole >= o->keepalive;
+  if (send->all) {
+    o->last_whole = now;
+  }
+  o->n_frames++;
+  return 1;
+}
+
+/* encode and send a frame taken by ledfx_scheduler_tick() */
+static void
+ledfx_scheduler_send (const ledfx_scheduler_send_t * send)
+{
+  if (send->ddp) {
+    ledfx_ddp_do (send->ddp, send->frame);
+    ledfx_ddp_send (send->ddp, send->udp);
+  } else {
+    ledfx_wled_do (send->wled, send->frame);
+    ledfx_wled_send_changed (send->wled, send->udp, send->all);
+  }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI
+ledfx_scheduler_run (LPVOID arg)
+#else
+static void *
+ledfx_scheduler_run (void *arg)
+#endif
+{
+  ledfx_scheduler_t *s = (ledfx_scheduler_t *) arg;
+  ledfx_scheduler_send_t sends[LEDFX_SCHEDULER_MAX_OUTPUTS];
+  uint_t i, n_sends;
+  for (;;) {
+    ledfx_ns_t now = ledfx_scheduler_now (s);
+    ledfx_ns_t next = now + LEDFX_SCHEDULER_MAX_SLEEP_NS;
+    LEDFX_SCHEDULER_LOCK (s);
+    if (!s->running) {
+      LEDFX_SCHEDULER_UNLOCK (s);
+      break;
+    }
+    n_sends = 0;
+    for (i = 0; i < LEDFX_SCHEDULER_MAX_OUTPUTS; i++) {
+      ledfx_scheduler_output_t *o = &s->outputs[i];
+      if (!o->used)
+        continue;
+      if (o->deadline <= now) {
+        n_sends += ledfx_scheduler_tick (o, now, &sends[n_sends]);
+      }
+      next = MIN (next, o->deadline);
+    }
+    /* sent without the lock, so that a slow socket does not hold up
+       submit() and the getters; remove() waits on send_lock instead */
+    LEDFX_SCHEDULER_SEND_LOCK (s);
+    LEDFX_SCHEDULER_UNLOCK (s);
+    for (i = 0; i < n_sends; i++) {
+      ledfx_scheduler_send (&sends[i]);
+    }
+    LEDFX_SCHEDULER_SEND_UNLOCK (s);
+    ledfx_scheduler_sleep_until (s, next);
+  }
+#ifdef _WIN32
+  return 0;
+#else
+  return NULL;
+#endif
+}
+
+ledfx_scheduler_t *
+new_ledfx_scheduler (void)
+{
+  ledfx_scheduler_t *s = AUBIO_NEW (ledfx_scheduler_t);
+  s->running = 1;
+#ifdef _WIN32
+  InitializeSRWLock (&s->lock);
+  InitializeSRWLock (&s->send_lock);
+  QueryPerformanceFrequency (&s->freq);
+  s->timer = CreateWaitableTimerExW (NULL, NULL,
+      CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+  if (!s->timer) {
+    /* before Windows 10 1803: a plain timer, at the system timer resolution */
+    s->timer = CreateWaitableTimerW (NULL, FALSE, NULL);
+  }
+  s->thread = CreateThread (NULL, 0, ledfx_scheduler_run, s, 0, NULL);
+  if (!s->thread) {
+    AUBIO_ERR ("scheduler: could not start thread\n");
+    goto beach;
+  }
+  SetThreadPriority (s->thread, THREAD_PRIORITY_TIME_CRITICAL);
+#else
+  pthread_mutex_init (&s->lock, NULL);
+  pthread_mutex_init (&s->send_lock, NULL);
+  if (pthread_create (&s->thread, NULL, ledfx_scheduler_run, s) != 0) {
+    AUBIO_ERR ("scheduler: could not start thread\n");
+    goto beach;
+  }
+#endif
+  s->started = 1;
+  return s;
+
+beach:
+  del_ledfx_scheduler (s);
+  return NULL;
+}
+
+void
+del_ledfx_scheduler (ledfx_scheduler_t * s)
+{
+  uint_t i;
+  if (!s)
+    return;
+  if (s->started) {
+    LEDFX_SCHEDULER_LOCK (s);
+    s->running = 0;
+    LEDFX_SCHEDULER_UNLOCK (s);
+#ifdef _WIN32
+    WaitForSingleObject (s->thread, INFINITE);
+#else
+    pthread_join (s->thread, NULL);
+#endif
+  }
+#ifdef _WIN32
+  if (s->thread)
+    CloseHandle (s->thread);
+  if (s->timer)
+    CloseHandle (s->timer);
+#else
+  pthread_mutex_destroy (&s->lock);
+  pthread_mutex_destroy (&s->send_lock);
+#endif
+  for (i = 0; i < LEDFX_SCHEDULER_MAX_OUTPUTS; i++) {
+    if (s->outputs[i].frame)
+      del_fvec (s->outputs[i].frame);
+    if (s->outputs[i].sending)
+      del_fvec (s->outputs[i].sending);
+  }
+  AUBIO_FREE (s);
+}
+
+static sint_t
+ledfx_scheduler_add (ledfx_scheduler_t * s, ledfx_ddp_t * d,
+    ledfx_wled_t * w, ledfx_udp_t * u, smpl_t rate, smpl_t keepalive,
+    uint_t n_pixels)
+{
+  ledfx_scheduler_output_t *o = NULL;
+  fvec_t *frame, *sending;
+  sint_t i;
+  if (!u) {
+    return -1;
+  }
+  if (!(rate >= 1.) || rate > LEDFX_SCHEDULER_MAX_RATE
+      || !(keepalive >= 0.)) {
+    AUBIO_ERR ("scheduler: got rate %f, keepalive %f\n", rate, keepalive);
+    return -1;
+  }
+  frame = new_fvec (3 * n_pixels);
+  sending = new_fvec (3 * n_pixels);
+  if (!frame || !sending) {
+    if (frame)
+      del_fvec (frame);
+    if (sending)
+      del_fvec (sending);
+    return -1;
+  }
+  LEDFX_SCHEDULER_LOCK (s);
+  for (i = 0; i < LEDFX_SCHEDULER_MAX_OUTPUTS; i++) {
+    if (!s->outputs[i].used) {
+      o = &s->outputs[i];
+      break;
+    }
+  }
+  if (!o) {
+    LEDFX_SCHEDULER_UNLOCK (s);
+    AUBIO_ERR ("scheduler: more than %d outputs\n",
+        LEDFX_SCHEDULER_MAX_OUTPUTS);
+    del_fvec (frame);
+    del_fvec (sending);
+    return -1;
+  }
+  AUBIO_MEMSET (o, 0, sizeof (*o));
+  o->used = 1;
+  o->ddp = d;
+  o->wled = w;
+  o->udp = u;
+  o->frame = frame;
+  o->sending = sending;
+  o->period = (ledfx_ns_t) (LEDFX_NS_PER_S / (double) rate + .5);
+  o->keepalive = (ledfx_ns_t) (keepalive * (double) LEDFX_NS_PER_S + .5);
+  /* paced from now on, the first deadline ticks on the next wakeup */
+  o->deadline = ledfx_scheduler_now (s);
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return i;
+}
+
+sint_t
+ledfx_scheduler_add_ddp (ledfx_scheduler_t * s, ledfx_ddp_t * d,
+    ledfx_udp_t * u, smpl_t rate)
+{
+  if (!d) {
+    return -1;
+  }
+  return ledfx_scheduler_add (s, d, NULL, u, rate, 0.,
+      ledfx_ddp_get_n_pixels (d));
+}
+
+sint_t
+ledfx_scheduler_add_wled (ledfx_scheduler_t * s, ledfx_wled_t * w,
+    ledfx_udp_t * u, smpl_t rate, smpl_t keepalive)
+{
+  if (!w) {
+    return -1;
+  }
+  return ledfx_scheduler_add (s, NULL, w, u, rate, keepalive,
+      ledfx_wled_get_n_pixels (w));
+}
+
+/* output of s at index output, or NULL; call with the lock held */
+static ledfx_scheduler_output_t *
+ledfx_scheduler_output (ledfx_scheduler_t * s, uint_t output)
+{
+  if (output >= LEDFX_SCHEDULER_MAX_OUTPUTS || !s->outputs[output].used) {
+    return NULL;
+  }
+  return &s->outputs[output];
+}
+
+uint_t
+ledfx_scheduler_remove (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  fvec_t *frame, *sending;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (!o) {
+    LEDFX_SCHEDULER_UNLOCK (s);
+    AUBIO_ERR ("scheduler: no output %d\n", output);
+    return AUBIO_FAIL;
+  }
+  frame = o->frame;
+  sending = o->sending;
+  AUBIO_MEMSET (o, 0, sizeof (*o));
+  LEDFX_SCHEDULER_UNLOCK (s);
+  /* wait for a send of this output started before it was removed */
+  LEDFX_SCHEDULER_SEND_LOCK (s);
+  LEDFX_SCHEDULER_SEND_UNLOCK (s);
+  del_fvec (frame);
+  del_fvec (sending);
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_scheduler_submit (ledfx_scheduler_t * s, uint_t output,
+    const fvec_t * rgb)
+{
+  ledfx_scheduler_output_t *o;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (!o || rgb->length != o->frame->length) {
+    LEDFX_SCHEDULER_UNLOCK (s);
+    AUBIO_ERR ("scheduler: no output %d of %d values\n", output,
+        rgb->length);
+    return AUBIO_FAIL;
+  }
+  AUBIO_MEMCPY (o->frame->data, rgb->data, rgb->length * sizeof (smpl_t));
+  o->fresh = 1;
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_scheduler_get_n_ticks (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  uint_t n = 0;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (o)
+    n = o->n_ticks;
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return n;
+}
+
+uint_t
+ledfx_scheduler_get_n_frames (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  uint_t n = 0;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (o)
+    n = o->n_frames;
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return n;
+}
+
+uint_t
+ledfx_scheduler_get_n_missed (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  uint_t n = 0;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (o)
+    n = o->n_missed;
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return n;
+}
+
+smpl_t
+ledfx_scheduler_get_jitter_mean_ms (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  smpl_t ms = 0.;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (o && o->n_ticks > 0)
+    ms = (smpl_t) (o->late_sum / (double) o->n_ticks * 1e-6);
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return ms;
+}
+
+smpl_t
+ledfx_scheduler_get_jitter_max_ms (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  smpl_t ms = 0.;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (o)
+    ms = (smpl_t) (o->late_max * 1e-6);
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return ms;
+}
+
+uint_t
+ledfx_scheduler_get_n_skipped_packets (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  uint_t n = 0;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (o && o->wled) {
+    /* counted by the sends, which hold send_lock */
+    LEDFX_SCHEDULER_SEND_LOCK (s);
+    n = ledfx_wled_get_n_skipped_packets (o->wled);
+    LEDFX_SCHEDULER_SEND_UNLOCK (s);
+  }
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return n;
+}
+
+uint_t
+ledfx_scheduler_get_n_skipped_bytes (ledfx_scheduler_t * s, uint_t output)
+{
+  ledfx_scheduler_output_t *o;
+  uint_t n = 0;
+  LEDFX_SCHEDULER_LOCK (s);
+  o = ledfx_scheduler_output (s, output);
+  if (o && o->wled) {
+    LEDFX_SCHEDULER_SEND_LOCK (s);
+    n = ledfx_wled_get_n_skipped_bytes (o->wled);
+    LEDFX_SCHEDULER_SEND_UNLOCK (s);
+  }
+  LEDFX_SCHEDULER_UNLOCK (s);
+  return n;
+}
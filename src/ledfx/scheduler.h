@@ -0,0 +1,201 @@
+/*
+  Output scheduler pacing the LED devices from one native thread.
+*/
+
+#ifndef LEDFX_SCHEDULER_H
+#define LEDFX_SCHEDULER_H
+
+/** \file
+
+  Output scheduler
+
+  Owns the send deadlines of every LED device. Each output pairs an encoder,
+  ::ledfx_ddp_t or ::ledfx_wled_t, with the ::ledfx_udp_t it sends through
+  and a refresh rate. ledfx_scheduler_submit() copies the latest frame of an
+  output; the scheduler thread started by new_ledfx_scheduler() encodes and
+  sends it at the output's next deadline. Frames submitted faster than the
+  refresh rate replace each other, and a deadline without a new frame sends
+  nothing.
+
+  The thread sleeps until the earliest deadline on an absolute monotonic
+  clock, clock_nanosleep() with TIMER_ABSTIME on Linux and Android, a high
+  resolution waitable timer on Windows. Each deadline is the previous one
+  plus the period, so wakeup latency does not accumulate into the rate.
+  When the thread wakes more than a period late, the deadlines it slept
+  through are counted as missed and the output is paced again from the
+  next one.
+
+  For each output the scheduler measures the number of deadlines reached,
+  frames sent and deadlines missed, and the mean and largest lateness of
+  the wakeups, its jitter.
+
+  Once added, the encoder and UDP sender of an output belong to the
+  scheduler thread until ledfx_scheduler_remove() returns; they should not
+  be used or deleted before that.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** most outputs a scheduler can pace */
+#define LEDFX_SCHEDULER_MAX_OUTPUTS 64
+/** highest refresh rate of an output, in Hz */
+#define LEDFX_SCHEDULER_MAX_RATE 1000
+
+/** output scheduler object */
+typedef struct _ledfx_scheduler_t ledfx_scheduler_t;
+
+/** create an output scheduler and start its thread
+
+  \return newly created object, or NULL if the thread could not be started
+
+*/
+ledfx_scheduler_t *new_ledfx_scheduler (void);
+
+/** stop the thread and delete an output scheduler
+
+  The encoders and UDP senders of the remaining outputs are not deleted.
+
+  \param s object to delete, as returned by new_ledfx_scheduler()
+
+*/
+void del_ledfx_scheduler (ledfx_scheduler_t * s);
+
+/** add a DDP device
+
+  \param s output scheduler
+  \param d DDP packetizer of the device
+  \param u UDP sender connected to the device
+  \param rate frames per second, 1 to ::LEDFX_SCHEDULER_MAX_RATE
+
+  \return index of the new output, or -1 if a parameter is invalid or the
+  scheduler is full
+
+*/
+sint_t ledfx_scheduler_add_ddp (ledfx_scheduler_t * s, ledfx_ddp_t * d,
+    ledfx_udp_t * u, smpl_t rate);
+
+/** add a WLED realtime device
+
+  Only the packets that changed since they were last sent go out, see
+  ledfx_wled_send_changed(), except every keepalive seconds when the whole
+  frame is sent to keep WLED in realtime mode.
+
+  \param s output scheduler
+  \param w WLED realtime encoder of the device
+  \param u UDP sender connected to the device
+  \param rate frames per second, 1 to ::LEDFX_SCHEDULER_MAX_RATE
+  \param keepalive seconds between whole frames, 0 to always send the whole
+  frame
+
+  \return index of the new output, or -1 if a parameter is invalid or the
+  scheduler is full
+
+*/
+sint_t ledfx_scheduler_add_wled (ledfx_scheduler_t * s, ledfx_wled_t * w,
+    ledfx_udp_t * u, smpl_t rate, smpl_t keepalive);
+
+/** remove an output
+
+  Returns once the scheduler thread is done with the output's encoder and
+  UDP sender, which the caller can then delete.
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+  \return 0 on success, non-zero if output is not in use
+
+*/
+uint_t ledfx_scheduler_remove (ledfx_scheduler_t * s, uint_t output);
+
+/** submit the latest frame of an output
+
+  \param s output scheduler
+  \param output index returned when the output was added
+  \param rgb 3 n_pixels interleaved r, g, b values, copied
+
+  \return 0 on success, non-zero if output is not in use or rgb has the
+  wrong length
+
+*/
+uint_t ledfx_scheduler_submit (ledfx_scheduler_t * s, uint_t output,
+    const fvec_t * rgb);
+
+/** get number of deadlines reached by an output
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+*/
+uint_t ledfx_scheduler_get_n_ticks (ledfx_scheduler_t * s, uint_t output);
+
+/** get number of frames sent by an output
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+*/
+uint_t ledfx_scheduler_get_n_frames (ledfx_scheduler_t * s, uint_t output);
+
+/** get number of deadlines of an output missed as the thread woke too late
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+*/
+uint_t ledfx_scheduler_get_n_missed (ledfx_scheduler_t * s, uint_t output);
+
+/** get mean lateness of the deadlines of an output, in milliseconds
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+*/
+smpl_t ledfx_scheduler_get_jitter_mean_ms (ledfx_scheduler_t * s,
+    uint_t output);
+
+/** get largest lateness of the deadlines of an output, in milliseconds
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+*/
+smpl_t ledfx_scheduler_get_jitter_max_ms (ledfx_scheduler_t * s,
+    uint_t output);
+
+/** get number of packets of a WLED output left out as unchanged
+
+  Reads ledfx_wled_get_n_skipped_packets() of the output's encoder between
+  two sends of the scheduler thread.
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+  \return packets skipped since the encoder was created, 0 for a DDP
+  output
+
+*/
+uint_t ledfx_scheduler_get_n_skipped_packets (ledfx_scheduler_t * s,
+    uint_t output);
+
+/** get number of bytes of a WLED output left out as unchanged
+
+  Reads ledfx_wled_get_n_skipped_bytes() of the output's encoder between
+  two sends of the scheduler thread.
+
+  \param s output scheduler
+  \param output index returned when the output was added
+
+  \return bytes skipped since the encoder was created, 0 for a DDP output
+
+*/
+uint_t ledfx_scheduler_get_n_skipped_bytes (ledfx_scheduler_t * s,
+    uint_t output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_SCHEDULER_H */
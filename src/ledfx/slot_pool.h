@@ -0,0 +1,149 @@
+#ifndef LEDFX_SLOT_POOL_H_
+#define LEDFX_SLOT_POOL_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace ledfx
+{
+
+  // Fixed-size pool of payload slots addressed by generation-tagged handles.
+  //
+  // Made for handing payloads to another thread through a channel that only
+  // carries an integer, such as the WPARAM of a posted window message: the
+  // sender Acquire()s a slot, fills it and posts the handle; the receiver
+  // Get()s the payload and Release()s the handle.
+  //
+  // All slots are constructed once in the constructor and reused, so a
+  // payload that keeps its capacity (a std::vector, a std::string) stops
+  // allocating once it has grown to its working size. Free slots sit on a
+  // lock-free stack whose head carries an ABA tag, so Acquire() and
+  // Release() are O(1), never lock, and may be called from any thread.
+  //
+  // A handle is the slot index in the low 32 bits and the slot generation in
+  // the high 32 bits. Release() bumps the generation, so Get() and Release()
+  // on a handle that was already released fail instead of touching a slot
+  // that now belongs to someone else. Generations skip 0, so a valid handle
+  // is never kInvalidHandle.
+  template <typename T>
+  class SlotPool
+  {
+  public:
+    using Handle = uint64_t;
+    static constexpr Handle kInvalidHandle = 0;
+
+    explicit SlotPool(uint32_t capacity)
+        : capacity_(capacity > 0 ? capacity : 1),
+          slots_(new Slot[capacity_])
+    {
+      for (uint32_t i = 0; i < capacity_; i++)
+        slots_[i].next.store(i + 1 < capacity_ ? i + 1 : kEnd, std::memory_order_relaxed);
+      free_head_.store(Pack(0, 0), std::memory_order_release);
+    }
+
+    SlotPool(const SlotPool &) = delete;
+    SlotPool &operator=(const SlotPool &) = delete;
+
+    uint32_t Capacity() const { return capacity_; }
+    // Slots acquired and not yet released.
+    uint32_t InUse() const { return in_use_.load(std::memory_order_relaxed); }
+    // Acquire() calls that found the pool empty.
+    uint64_t Exhausted() const { return exhausted_.load(std::memory_order_relaxed); }
+
+    // Takes a free slot, or returns kInvalidHandle when every slot is in
+    // flight. The payload keeps whatever its previous user left in it.
+    Handle Acquire()
+    {
+      uint64_t head = free_head_.load(std::memory_order_acquire);
+      uint32_t index;
+      for (;;)
+      {
+        index = IndexOf(head);
+        if (index == kEnd)
+        {
+          exhausted_.fetch_add(1, std::memory_order_relaxed);
+          return kInvalidHandle;
+        }
+        const uint32_t next = slots_[index].next.load(std::memory_order_relaxed);
+        if (free_head_.compare_exchange_weak(head, Pack(next, TagOf(head) + 1),
+                                             std::memory_order_acquire,
+                                             std::memory_order_acquire))
+          break;
+      }
+      in_use_.fetch_add(1, std::memory_order_relaxed);
+      const uint32_t generation = slots_[index].generation.load(std::memory_order_relaxed);
+      return (static_cast<Handle>(generation) << 32) | index;
+    }
+
+    // The payload of |handle|, or nullptr if the handle is invalid or was
+    // already released.
+    T *Get(Handle handle)
+    {
+      const uint32_t index = static_cast<uint32_t>(handle);
+      if (index >= capacity_ ||
+          slots_[index].generation.load(std::memory_order_acquire) != GenerationOf(handle))
+        return nullptr;
+      return &slots_[index].value;
+    }
+
+    // Returns the slot of |handle| to the pool. Returns false, and does
+    // nothing, if the handle is invalid or was already released.
+    bool Release(Handle handle)
+    {
+      const uint32_t index = static_cast<uint32_t>(handle);
+      if (index >= capacity_)
+        return false;
+      Slot &slot = slots_[index];
+      uint32_t expected = GenerationOf(handle);
+      uint32_t bumped = expected + 1;
+      if (bumped == 0)
+        bumped = 1;
+      if (expected == 0 ||
+          !slot.generation.compare_exchange_strong(expected, bumped,
+                                                   std::memory_order_acq_rel))
+        return false;
+
+      uint64_t head = free_head_.load(std::memory_order_relaxed);
+      do
+      {
+        slot.next.store(IndexOf(head), std::memory_order_relaxed);
+      } while (!free_head_.compare_exchange_weak(head, Pack(index, TagOf(head) + 1),
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+      in_use_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+
+  private:
+    static constexpr uint32_t kEnd = 0xffffffffu;
+
+    struct Slot
+    {
+      T value{};
+      std::atomic<uint32_t> generation{1};
+      std::atomic<uint32_t> next{kEnd}; // next free slot while on the stack
+    };
+
+    // The free stack head is the top slot index in the low 32 bits and a tag
+    // in the high 32 bits, bumped on every change so a stale head never
+    // compares equal.
+    static uint64_t Pack(uint32_t index, uint32_t tag)
+    {
+      return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+    static uint32_t IndexOf(uint64_t packed) { return static_cast<uint32_t>(packed); }
+    static uint32_t TagOf(uint64_t packed) { return static_cast<uint32_t>(packed >> 32); }
+    static uint32_t GenerationOf(Handle handle) { return static_cast<uint32_t>(handle >> 32); }
+
+    const uint32_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> free_head_{0};
+    std::atomic<uint32_t> in_use_{0};
+    std::atomic<uint64_t> exhausted_{0};
+  };
+
+} // namespace ledfx
+
+#endif // LEDFX_SLOT_POOL_H_
@@ -0,0 +1,273 @@
+#ifndef LEDFX_SPSC_RING_BUFFER_H_
+#define LEDFX_SPSC_RING_BUFFER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#ifdef _MSC_VER
+#pragma warning(push)
+// The cache-line alignment below intentionally pads the class.
+#pragma warning(disable : 4324)
+#endif
+
+namespace ledfx
+{
+
+  // Cache line size used to keep the producer and consumer indices apart.
+  constexpr size_t kCacheLineSize = 64;
+
+  // What Push() does when the incoming block does not fit.
+  enum class OverflowPolicy
+  {
+    // Write as many samples as fit and drop the tail of the block.
+    kDropIncoming,
+    // Drop the whole block so interleaved frames never get split.
+    kRejectBlock,
+  };
+
+  struct RingBufferStats
+  {
+    uint64_t pushed = 0;    // elements accepted by the producer
+    uint64_t popped = 0;    // elements consumed
+    uint64_t dropped = 0;   // elements discarded by the overflow policy
+    uint64_t overflows = 0; // Push() calls that hit the overflow policy
+    size_t high_water = 0;  // largest fill level seen by the producer
+  };
+
+  // Fixed-capacity single-producer / single-consumer ring buffer.
+  //
+  // Capacity is rounded up to a power of two and allocated once in the
+  // constructor, so neither side ever allocates or locks. Exactly one thread
+  // may call the producer methods and exactly one (possibly the same) thread
+  // may call the consumer methods. Stats() may be called from anywhere.
+  template <typename T>
+  class SpscRingBuffer
+  {
+  public:
+    // A contiguous run of elements inside the ring.
+    template <typename U>
+    struct Span
+    {
+      U *data = nullptr;
+      size_t size = 0;
+    };
+
+    // A logical range split at the wrap point; |second| is empty unless the
+    // range wraps around the end of the storage.
+    template <typename U>
+    struct SpanPair
+    {
+      Span<U> first;
+      Span<U> second;
+      size_t size() const { return first.size + second.size; }
+    };
+
+    explicit SpscRingBuffer(size_t min_capacity,
+                            OverflowPolicy policy = OverflowPolicy::kRejectBlock)
+        : capacity_(RoundUpToPowerOfTwo(min_capacity)),
+          mask_(capacity_ - 1),
+          policy_(policy),
+          storage_(new T[capacity_]()) {}
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    size_t Capacity() const { return capacity_; }
+    OverflowPolicy Policy() const { return policy_; }
+
+    // ---- Producer side -------------------------------------------------------
+
+    // Number of elements that can be written without overflowing.
+    size_t WriteAvailable()
+    {
+      const size_t head = head_.load(std::memory_order_relaxed);
+      producer_tail_cache_ = tail_.load(std::memory_order_acquire);
+      return capacity_ - (head - producer_tail_cache_);
+    }
+
+    // Returns writable storage for up to |count| elements. Nothing becomes
+    // visible to the consumer until CommitWrite().
+    SpanPair<T> WriteSpans(size_t count)
+    {
+      const size_t head = head_.load(std::memory_order_relaxed);
+      size_t free_space = capacity_ - (head - producer_tail_cache_);
+      if (free_space < count)
+      {
+        free_space = WriteAvailable();
+      }
+      return MakeSpans<T>(head, std::min(count, free_space));
+    }
+
+    void CommitWrite(size_t count)
+    {
+      const size_t head = head_.load(std::memory_order_relaxed) + count;
+      head_.store(head, std::memory_order_release);
+
+      pushed_.store(pushed_.load(std::memory_order_relaxed) + count,
+                    std::memory_order_relaxed);
+      const size_t fill = head - producer_tail_cache_;
+      if (fill > high_water_.load(std::memory_order_relaxed))
+      {
+        high_water_.store(fill, std::memory_order_relaxed);
+      }
+    }
+
+    // Copies |count| elements in, applying the overflow policy. Returns the
+    // number of elements actually written.
+    size_t Push(const T *src, size_t count)
+    {
+      const size_t accepted = Admit(count);
+      if (accepted == 0)
+        return 0;
+      auto spans = MakeSpans<T>(head_.load(std::memory_order_relaxed), accepted);
+      std::copy(src, src + spans.first.size, spans.first.data);
+      std::copy(src + spans.first.size, src + accepted, spans.second.data);
+      CommitWrite(accepted);
+      return accepted;
+    }
+
+    // Writes |count| copies of |value| (e.g. silence), applying the overflow
+    // policy. Returns the number of elements actually written.
+    size_t PushFill(const T &value, size_t count)
+    {
+      const size_t accepted = Admit(count);
+      if (accepted == 0)
+        return 0;
+      auto spans = MakeSpans<T>(head_.load(std::memory_order_relaxed), accepted);
+      std::fill(spans.first.data, spans.first.data + spans.first.size, value);
+      std::fill(spans.second.data, spans.second.data + spans.second.size, value);
+      CommitWrite(accepted);
+      return accepted;
+    }
+
+    // ---- Consumer side -------------------------------------------------------
+
+    // Number of elements ready to be read.
+    size_t ReadAvailable()
+    {
+      const size_t tail = tail_.load(std::memory_order_relaxed);
+      consumer_head_cache_ = head_.load(std::memory_order_acquire);
+      return consumer_head_cache_ - tail;
+    }
+
+    // Returns readable storage for up to |count| elements. The data stays
+    // valid until CommitRead().
+    SpanPair<const T> ReadSpans(size_t count)
+    {
+      const size_t tail = tail_.load(std::memory_order_relaxed);
+      size_t ready = consumer_head_cache_ - tail;
+      if (ready < count)
+      {
+        ready = ReadAvailable();
+      }
+      return MakeSpans<const T>(tail, std::min(count, ready));
+    }
+
+    void CommitRead(size_t count)
+    {
+      tail_.store(tail_.load(std::memory_order_relaxed) + count,
+                  std::memory_order_release);
+      popped_.store(popped_.load(std::memory_order_relaxed) + count,
+                    std::memory_order_relaxed);
+    }
+
+    // Copies up to |count| elements out. Returns the number copied.
+    size_t Pop(T *dst, size_t count)
+    {
+      auto spans = ReadSpans(count);
+      std::copy(spans.first.data, spans.first.data + spans.first.size, dst);
+      std::copy(spans.second.data, spans.second.data + spans.second.size,
+                dst + spans.first.size);
+      CommitRead(spans.size());
+      return spans.size();
+    }
+
+    // Discards everything currently readable. Consumer side only.
+    void Clear() { CommitRead(ReadAvailable()); }
+
+    RingBufferStats Stats() const
+    {
+      RingBufferStats stats;
+      stats.pushed = pushed_.load(std::memory_order_relaxed);
+      stats.popped = popped_.load(std::memory_order_relaxed);
+      stats.dropped = dropped_.load(std::memory_order_relaxed);
+      stats.overflows = overflows_.load(std::memory_order_relaxed);
+      stats.high_water = high_water_.load(std::memory_order_relaxed);
+      return stats;
+    }
+
+  private:
+    static size_t RoundUpToPowerOfTwo(size_t value)
+    {
+      size_t capacity = 1;
+      while (capacity < value)
+      {
+        capacity <<= 1;
+      }
+      return capacity;
+    }
+
+    template <typename U>
+    SpanPair<U> MakeSpans(size_t index, size_t count) const
+    {
+      SpanPair<U> spans;
+      const size_t offset = index & mask_;
+      const size_t first = std::min(count, capacity_ - offset);
+      spans.first = {storage_.get() + offset, first};
+      spans.second = {storage_.get(), count - first};
+      return spans;
+    }
+
+    // Applies the overflow policy and returns how many of |count| elements
+    // may be written.
+    size_t Admit(size_t count)
+    {
+      size_t free_space = capacity_ - (head_.load(std::memory_order_relaxed) -
+                                       producer_tail_cache_);
+      if (free_space < count)
+      {
+        free_space = WriteAvailable();
+      }
+      if (free_space >= count)
+        return count;
+
+      const size_t accepted =
+          policy_ == OverflowPolicy::kDropIncoming ? free_space : 0;
+      dropped_.store(dropped_.load(std::memory_order_relaxed) + (count - accepted),
+                     std::memory_order_relaxed);
+      overflows_.store(overflows_.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+      return accepted;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    const OverflowPolicy policy_;
+    std::unique_ptr<T[]> storage_;
+
+    // Written by the producer, read by the consumer.
+    alignas(kCacheLineSize) std::atomic<size_t> head_{0};
+    // Producer-private copy of tail_, refreshed only when space looks short.
+    size_t producer_tail_cache_ = 0;
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<size_t> high_water_{0};
+
+    // Written by the consumer, read by the producer.
+    alignas(kCacheLineSize) std::atomic<size_t> tail_{0};
+    // Consumer-private copy of head_, refreshed only when data looks short.
+    size_t consumer_head_cache_ = 0;
+    std::atomic<uint64_t> popped_{0};
+  };
+
+} // namespace ledfx
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#endif // LEDFX_SPSC_RING_BUFFER_H_
@@ -0,0 +1,196 @@
+#ifndef LEDFX_STREAM_RESAMPLER_H_
+#define LEDFX_STREAM_RESAMPLER_H_
+
+#include <samplerate.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ledfx
+{
+
+  // Turns device blocks of any length into mono hops of a fixed size at
+  // another sample rate.
+  //
+  // Interleaved frames are averaged down to mono and fed to libsamplerate's
+  // streaming API (src_process() with end_of_input unset), so the converter
+  // keeps its filter history from one block to the next and block edges
+  // leave no seams. Output accumulates in a hop-sized buffer and every
+  // complete hop is handed to the callback given to Push(). When both rates
+  // are equal no converter is created and samples are copied through.
+  //
+  // Buffers are sized in the constructor; Push() only allocates when a block
+  // is longer than any seen before. Not thread-safe: the capture thread owns
+  // the instance.
+  class StreamResampler
+  {
+  public:
+    StreamResampler(double input_rate, double output_rate, size_t channels,
+                    size_t hop_frames, int converter = SRC_SINC_FASTEST,
+                    size_t max_block_frames = 4096)
+        : ratio_(output_rate / input_rate),
+          channels_(std::max<size_t>(channels, 1)),
+          hop_(std::max<size_t>(hop_frames, 1)),
+          mono_(max_block_frames)
+    {
+      if (input_rate <= 0. || output_rate <= 0.)
+      {
+        error_ = SRC_ERR_BAD_SRC_RATIO;
+        return;
+      }
+      if (input_rate != output_rate)
+      {
+        if (!src_is_valid_ratio(ratio_))
+        {
+          error_ = SRC_ERR_BAD_SRC_RATIO;
+          return;
+        }
+        state_ = src_new(converter, 1, &error_);
+      }
+    }
+
+    ~StreamResampler()
+    {
+      if (state_)
+        src_delete(state_);
+    }
+
+    StreamResampler(const StreamResampler &) = delete;
+    StreamResampler &operator=(const StreamResampler &) = delete;
+
+    // False if the converter could not be created; Push() then does nothing.
+    bool Ok() const { return error_ == 0; }
+    const char *Error() const { return src_strerror(error_); }
+
+    double Ratio() const { return ratio_; }
+    size_t Channels() const { return channels_; }
+    size_t HopFrames() const { return hop_.size(); }
+    // Output frames waiting for the next hop to complete.
+    size_t Pending() const { return fill_; }
+    // Input frames fed since construction or the last Reset().
+    uint64_t InputFrames() const { return fed_; }
+    // Where the next hop starts, counted in input frames like InputFrames();
+    // inside on_hop, where the hop being delivered starts. The converter's
+    // output lines up with its input, so this trails InputFrames() by the
+    // converter latency plus the pending partial hop, and a hop may start
+    // in an earlier block than the one that completed it.
+    double HopInputPosition() const { return static_cast<double>(emitted_) / ratio_; }
+
+    // Feeds |frames| interleaved frames and calls
+    // on_hop(const float *hop, size_t hop_frames) once per completed hop.
+    // Returns the number of hops emitted.
+    template <typename OnHop>
+    size_t Push(const float *interleaved, size_t frames, OnHop &&on_hop)
+    {
+      if (!Ok() || frames == 0)
+        return 0;
+      if (mono_.size() < frames)
+        mono_.resize(frames);
+      if (channels_ == 1)
+      {
+        std::copy(interleaved, interleaved + frames, mono_.begin());
+      }
+      else
+      {
+        const float scale = 1.0f / static_cast<float>(channels_);
+        for (size_t i = 0; i < frames; i++)
+        {
+          float sum = 0.0f;
+          for (size_t c = 0; c < channels_; c++)
+            sum += interleaved[i * channels_ + c];
+          mono_[i] = sum * scale;
+        }
+      }
+      return Process(frames, on_hop);
+    }
+
+    // Feeds |frames| frames of silence, as for a packet flagged silent.
+    template <typename OnHop>
+    size_t PushSilence(size_t frames, OnHop &&on_hop)
+    {
+      if (!Ok() || frames == 0)
+        return 0;
+      if (mono_.size() < frames)
+        mono_.resize(frames);
+      std::fill(mono_.begin(), mono_.begin() + frames, 0.0f);
+      return Process(frames, on_hop);
+    }
+
+    // Drops the converter history and any partial hop, e.g. after a
+    // discontinuity in the input.
+    void Reset()
+    {
+      if (state_)
+        src_reset(state_);
+      fill_ = 0;
+      fed_ = 0;
+      emitted_ = 0;
+    }
+
+  private:
+    template <typename OnHop>
+    size_t Process(size_t frames, OnHop &on_hop)
+    {
+      const float *in = mono_.data();
+      size_t hops = 0;
+      fed_ += frames;
+      for (;;)
+      {
+        size_t used, generated;
+        if (state_)
+        {
+          SRC_DATA data = {};
+          data.data_in = in;
+          data.input_frames = static_cast<long>(frames);
+          data.data_out = hop_.data() + fill_;
+          data.output_frames = static_cast<long>(hop_.size() - fill_);
+          data.end_of_input = 0;
+          data.src_ratio = ratio_;
+          error_ = src_process(state_, &data);
+          if (error_)
+            return hops;
+          used = static_cast<size_t>(data.input_frames_used);
+          generated = static_cast<size_t>(data.output_frames_gen);
+        }
+        else
+        {
+          used = generated = std::min(frames, hop_.size() - fill_);
+          std::copy(in, in + used, hop_.begin() + fill_);
+        }
+        in += used;
+        frames -= used;
+        fill_ += generated;
+
+        if (fill_ == hop_.size())
+        {
+          on_hop(static_cast<const float *>(hop_.data()), hop_.size());
+          emitted_ += hop_.size();
+          fill_ = 0;
+          hops++;
+          // The converter may still hold output for consumed input, so go
+          // round again even when |frames| is zero.
+        }
+        else if (frames == 0 || (used == 0 && generated == 0))
+        {
+          break;
+        }
+      }
+      return hops;
+    }
+
+    double ratio_;
+    size_t channels_;
+    std::vector<float> hop_;
+    std::vector<float> mono_;
+    size_t fill_ = 0;
+    uint64_t fed_ = 0;
+    uint64_t emitted_ = 0;
+    SRC_STATE *state_ = nullptr;
+    int error_ = 0;
+  };
+
+} // namespace ledfx
+
+#endif // LEDFX_STREAM_RESAMPLER_H_
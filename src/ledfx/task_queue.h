@@ -0,0 +1,191 @@
+#ifndef LEDFX_TASK_QUEUE_H_
+#define LEDFX_TASK_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ledfx
+{
+
+  struct TaskQueueStats
+  {
+    uint64_t queued = 0;  // tasks accepted by Push()
+    uint64_t run = 0;     // tasks run by Drain()
+    uint64_t drains = 0;  // Drain() calls that found work
+    uint64_t wakeups = 0; // times Push() or Drain() asked for a wakeup
+  };
+
+  // Runs closures posted from any thread on one consumer thread that is
+  // woken by a message, such as the platform thread of a window.
+  //
+  // Producers never lock: each task is one heap node holding the closure and
+  // the link, appended with a single atomic exchange (Vyukov's intrusive
+  // MPSC queue). Closures are moved in and may be move-only.
+  //
+  // As with DeliveryQueue, a wakeup is asked for only when none is pending,
+  // so a burst of tasks costs one message. Drain() runs at most |max_tasks|
+  // of them, oldest first, so that other messages are not starved; if more
+  // are left, it asks for another wakeup itself. No lock is held while a
+  // task runs, so tasks may Push() more tasks.
+  class TaskQueue
+  {
+  public:
+    TaskQueue() : head_(&stub_), tail_(&stub_) {}
+
+    TaskQueue(const TaskQueue &) = delete;
+    TaskQueue &operator=(const TaskQueue &) = delete;
+
+    // Tasks never run are destroyed with the queue.
+    ~TaskQueue()
+    {
+      while (Node *node = Pop())
+        delete node;
+    }
+
+    // ---- Producer side -------------------------------------------------------
+
+    // Queues |task|, any callable taking no argument. |*wake| is set when the
+    // consumer must be woken; if that fails, call WakeupFailed() so the next
+    // Push() asks again.
+    template <typename F>
+    void Push(F &&task, bool *wake)
+    {
+      Node *node = new Task<typename std::decay<F>::type>(std::forward<F>(task));
+      Link(node);
+      queued_.fetch_add(1, std::memory_order_relaxed);
+      // After the link: a Drain() that cleared the flag before seeing this
+      // task is followed by a wakeup.
+      *wake = RequestWakeup();
+    }
+
+    void WakeupFailed() { wake_pending_.store(false, std::memory_order_release); }
+
+    // ---- Consumer side -------------------------------------------------------
+
+    // Runs up to |max_tasks| queued tasks, oldest first, and returns how many
+    // ran. |*wake| is set when tasks are left over and the consumer must be
+    // woken again.
+    size_t Drain(size_t max_tasks, bool *wake)
+    {
+      *wake = false;
+      // Cleared first: a task pushed from here on either runs below or asks
+      // for a new wakeup. Acquire, so the tasks of the wakeups it consumes
+      // are seen.
+      wake_pending_.exchange(false, std::memory_order_acq_rel);
+      size_t count = 0;
+      while (count < max_tasks)
+      {
+        std::unique_ptr<Node> node(Pop());
+        if (!node)
+          break;
+        count++;
+        node->Run();
+      }
+      if (count == max_tasks && !Empty())
+        *wake = RequestWakeup();
+      if (count > 0)
+      {
+        run_.fetch_add(count, std::memory_order_relaxed);
+        drains_.fetch_add(1, std::memory_order_relaxed);
+      }
+      return count;
+    }
+
+    // May be called from any thread.
+    TaskQueueStats Stats() const
+    {
+      TaskQueueStats stats;
+      stats.queued = queued_.load(std::memory_order_relaxed);
+      stats.run = run_.load(std::memory_order_relaxed);
+      stats.drains = drains_.load(std::memory_order_relaxed);
+      stats.wakeups = wakeups_.load(std::memory_order_relaxed);
+      return stats;
+    }
+
+  private:
+    struct Node
+    {
+      std::atomic<Node *> next{nullptr};
+      virtual ~Node() = default;
+      virtual void Run() {}
+    };
+
+    template <typename F>
+    struct Task final : Node
+    {
+      template <typename G>
+      explicit Task(G &&g) : task(std::forward<G>(g)) {}
+      void Run() override { task(); }
+      F task;
+    };
+
+    bool RequestWakeup()
+    {
+      if (wake_pending_.exchange(true, std::memory_order_acq_rel))
+        return false;
+      wakeups_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+
+    void Link(Node *node)
+    {
+      node->next.store(nullptr, std::memory_order_relaxed);
+      Node *prev = tail_.exchange(node, std::memory_order_acq_rel);
+      prev->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only. Whether no task is queued, or one is still being
+    // linked by its producer.
+    bool Empty() const
+    {
+      return head_ == &stub_ && !stub_.next.load(std::memory_order_acquire) &&
+             tail_.load(std::memory_order_acquire) == &stub_;
+    }
+
+    // Consumer only. The oldest task, or nullptr if there is none or its
+    // producer has not linked it yet; that producer then asks for a wakeup.
+    Node *Pop()
+    {
+      Node *head = head_;
+      Node *next = head->next.load(std::memory_order_acquire);
+      if (head == &stub_)
+      {
+        if (!next)
+          return nullptr;
+        head_ = head = next;
+        next = next->next.load(std::memory_order_acquire);
+      }
+      if (next)
+      {
+        head_ = next;
+        return head;
+      }
+      if (head != tail_.load(std::memory_order_acquire))
+        return nullptr;
+      // head is the last task: put the stub behind it so it can be taken.
+      Link(&stub_);
+      next = head->next.load(std::memory_order_acquire);
+      if (!next)
+        return nullptr;
+      head_ = next;
+      return head;
+    }
+
+    Node stub_;
+    Node *head_; // consumer only
+    std::atomic<Node *> tail_;
+    std::atomic<bool> wake_pending_{false};
+
+    std::atomic<uint64_t> queued_{0};
+    std::atomic<uint64_t> run_{0};
+    std::atomic<uint64_t> drains_{0};
+    std::atomic<uint64_t> wakeups_{0};
+  };
+
+} // namespace ledfx
+
+#endif // LEDFX_TASK_QUEUE_H_
@@ -0,0 +1,190 @@
+/*
+  Batched UDP sender for the LED output protocols.
+*/
+
+/* sendmmsg is a GNU extension in glibc */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET ledfx_socket_t;
+#define LEDFX_INVALID_SOCKET INVALID_SOCKET
+#define LEDFX_CLOSE_SOCKET closesocket
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+typedef int ledfx_socket_t;
+#define LEDFX_INVALID_SOCKET (-1)
+#define LEDFX_CLOSE_SOCKET close
+#endif
+
+#include "aubio_priv.h"
+#include "udp.h"
+
+#if defined(__linux__)
+#define LEDFX_HAVE_SENDMMSG 1
+#endif
+
+struct _ledfx_udp_t {
+  ledfx_socket_t sock;      /** connected, non-blocking socket */
+  uint_t n_sent;            /** packets queued by the kernel */
+  uint_t n_dropped;         /** packets that could not be sent */
+  uint_t n_syscalls;        /** send calls made */
+#ifdef _WIN32
+  uint_t wsa_started;       /** whether WSAStartup succeeded */
+#endif
+#ifdef LEDFX_HAVE_SENDMMSG
+  struct mmsghdr msgs[LEDFX_UDP_BATCH]; /** headers of one batch */
+  struct iovec iovs[LEDFX_UDP_BATCH];   /** payloads of one batch */
+#endif
+};
+
+ledfx_udp_t *
+new_ledfx_udp (const char_t * host, uint_t port)
+{
+  ledfx_udp_t *u = AUBIO_NEW (ledfx_udp_t);
+  struct addrinfo hints, *res = NULL, *ai;
+  char_t service[16];
+  u->sock = LEDFX_INVALID_SOCKET;
+#ifdef _WIN32
+  {
+    WSADATA wsa;
+    if (WSAStartup (MAKEWORD (2, 2), &wsa) != 0) {
+      AUBIO_ERR ("udp: could not start winsock\n");
+      goto beach;
+    }
+    u->wsa_started = 1;
+  }
+#endif
+  if (!host || port == 0 || port > 65535) {
+    AUBIO_ERR ("udp: got host %s and port %d\n", host ? host : "(null)",
+        port);
+    goto beach;
+  }
+
+  AUBIO_MEMSET (&hints, 0, sizeof (hints));
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_DGRAM;
+  hints.ai_flags = AI_NUMERICSERV;
+  snprintf (service, sizeof (service), "%u", port);
+  if (getaddrinfo (host, service, &hints, &res) != 0 || !res) {
+    AUBIO_ERR ("udp: could not resolve %s\n", host);
+    goto beach;
+  }
+  /* first address a socket can be connected to */
+  for (ai = res; ai; ai = ai->ai_next) {
+    u->sock = socket (ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (u->sock == LEDFX_INVALID_SOCKET) {
+      continue;
+    }
+    if (connect (u->sock, ai->ai_addr, (int) ai->ai_addrlen) == 0) {
+      break;
+    }
+    LEDFX_CLOSE_SOCKET (u->sock);
+    u->sock = LEDFX_INVALID_SOCKET;
+  }
+  freeaddrinfo (res);
+  if (u->sock == LEDFX_INVALID_SOCKET) {
+    AUBIO_ERR ("udp: could not connect to %s:%d\n", host, port);
+    goto beach;
+  }
+
+#ifdef _WIN32
+  {
+    u_long non_blocking = 1;
+    ioctlsocket (u->sock, FIONBIO, &non_blocking);
+  }
+#else
+  fcntl (u->sock, F_SETFL, fcntl (u->sock, F_GETFL, 0) | O_NONBLOCK);
+#endif
+  return u;
+
+beach:
+  del_ledfx_udp (u);
+  return NULL;
+}
+
+void
+del_ledfx_udp (ledfx_udp_t * u)
+{
+  if (!u)
+    return;
+  if (u->sock != LEDFX_INVALID_SOCKET)
+    LEDFX_CLOSE_SOCKET (u->sock);
+#ifdef _WIN32
+  if (u->wsa_started)
+    WSACleanup ();
+#endif
+  AUBIO_FREE (u);
+}
+
+uint_t
+ledfx_udp_send (ledfx_udp_t * u, const unsigned char *const *packets,
+    const uint_t * lengths, uint_t n_packets)
+{
+  uint_t i = 0, sent = 0;
+#ifdef LEDFX_HAVE_SENDMMSG
+  while (i < n_packets) {
+    uint_t j, batch = MIN (n_packets - i, LEDFX_UDP_BATCH);
+    int r;
+    for (j = 0; j < batch; j++) {
+      u->iovs[j].iov_base = (void *) packets[i + j];
+      u->iovs[j].iov_len = lengths[i + j];
+      AUBIO_MEMSET (&u->msgs[j], 0, sizeof (u->msgs[j]));
+      u->msgs[j].msg_hdr.msg_iov = &u->iovs[j];
+      u->msgs[j].msg_hdr.msg_iovlen = 1;
+    }
+    r = sendmmsg (u->sock, u->msgs, batch, 0);
+    u->n_syscalls++;
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      /* the first packet of the batch failed, e.g. a full socket buffer or
+       * an ICMP error reported on the connected socket: drop it and carry
+       * on with the next one */
+      u->n_dropped++;
+      i++;
+      continue;
+    }
+    sent += (uint_t) r;
+    i += (uint_t) r;
+  }
+#else
+  for (i = 0; i < n_packets; i++) {
+    u->n_syscalls++;
+    if (send (u->sock, (const char *) packets[i], (int) lengths[i], 0) < 0) {
+      u->n_dropped++;
+    } else {
+      sent++;
+    }
+  }
+#endif
+  u->n_sent += sent;
+  return sent;
+}
+
+uint_t
+ledfx_udp_get_n_sent (const ledfx_udp_t * u)
+{
+  return u->n_sent;
+}
+
+uint_t
+ledfx_udp_get_n_dropped (const ledfx_udp_t * u)
+{
+  return u->n_dropped;
+}
+
+uint_t
+ledfx_udp_get_n_syscalls (const ledfx_udp_t * u)
+{
+  return u->n_syscalls;
+}
@@ -0,0 +1,96 @@
+/*
+  Batched UDP sender for the LED output protocols.
+*/
+
+#ifndef LEDFX_UDP_H
+#define LEDFX_UDP_H
+
+/** \file
+
+  Batched UDP sender
+
+  Sends the packets of one frame to a single destination through a
+  connected socket. The destination is resolved once, by new_ledfx_udp();
+  sending needs neither address parsing nor allocation.
+
+  On Linux and Android the packets of a frame leave in batches of up to
+  ::LEDFX_UDP_BATCH with a single sendmmsg() call. Other platforms send them
+  one by one with send().
+
+  The socket is non-blocking: a packet the kernel cannot queue is dropped
+  rather than delaying the caller, as a late LED frame is worth no more
+  than a lost one.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** largest number of packets handed to the kernel in one call */
+#define LEDFX_UDP_BATCH 64
+
+/** UDP sender object */
+typedef struct _ledfx_udp_t ledfx_udp_t;
+
+/** create a UDP sender
+
+  \param host destination, IPv4 or IPv6 address or host name
+  \param port destination port
+
+  \return newly created sender, or NULL if host can not be resolved or the
+  socket can not be created
+
+*/
+ledfx_udp_t *new_ledfx_udp (const char_t * host, uint_t port);
+
+/** delete a UDP sender
+
+  \param u sender to delete, as returned by new_ledfx_udp()
+
+*/
+void del_ledfx_udp (ledfx_udp_t * u);
+
+/** send packets
+
+  \param u UDP sender
+  \param packets packet payloads, n_packets of them
+  \param lengths length of each payload in bytes
+  \param n_packets number of packets to send
+
+  \return number of packets queued by the kernel; packets that could not be
+  sent are counted by ledfx_udp_get_n_dropped()
+
+*/
+uint_t ledfx_udp_send (ledfx_udp_t * u, const unsigned char *const *packets,
+    const uint_t * lengths, uint_t n_packets);
+
+/** get number of packets sent since creation
+
+  \param u UDP sender
+
+*/
+uint_t ledfx_udp_get_n_sent (const ledfx_udp_t * u);
+
+/** get number of packets dropped since creation
+
+  \param u UDP sender
+
+*/
+uint_t ledfx_udp_get_n_dropped (const ledfx_udp_t * u);
+
+/** get number of send calls made since creation
+
+  Each call to ledfx_udp_send() makes one call per batch with sendmmsg(),
+  or one per packet without.
+
+  \param u UDP sender
+
+*/
+uint_t ledfx_udp_get_n_syscalls (const ledfx_udp_t * u);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_UDP_H */
@@ -0,0 +1,244 @@
+/*
+  WLED realtime UDP encoder.
+*/
+
+#include "aubio_priv.h"
+#include "fvec.h"
+#include "udp.h"
+#include "wled.h"
+
+/* DNRGB start indices are 16 bit */
+#define LEDFX_WLED_DNRGB_MAX_PIXELS 65535
+
+struct _ledfx_wled_t {
+  uint_t protocol;          /** one of ledfx_wled_protocol_t */
+  uint_t n_pixels;          /** number of pixels of the strip */
+  uint_t n_packets;         /** packets per frame */
+  uint_t header_len;        /** bytes before the first LED of a packet */
+  uint_t timeout;           /** timeout byte of every packet */
+  unsigned char *buffer;    /** all packets, back to back */
+  unsigned char **packets;  /** start of each packet in buffer */
+  uint_t *lengths;          /** length of each packet, header included */
+  unsigned char *last;      /** packets as last sent, same layout as buffer */
+  uint_t stride;            /** distance between packets in buffer */
+  uint_t primed;            /** whether last holds a sent frame */
+  const unsigned char **changed; /** packets to send, scratch */
+  uint_t *changed_lengths;  /** their lengths, scratch */
+  uint_t n_skipped_packets; /** packets not sent as unchanged */
+  uint_t n_skipped_bytes;   /** bytes of those packets */
+};
+
+ledfx_wled_t *
+new_ledfx_wled (uint_t protocol, uint_t n_pixels)
+{
+  ledfx_wled_t *w = AUBIO_NEW (ledfx_wled_t);
+  uint_t i, per_packet, bytes_per_pixel = 3, max_pixels, stride;
+  switch (protocol) {
+    case LEDFX_WLED_WARLS:
+      w->header_len = 2;
+      bytes_per_pixel = 4;
+      per_packet = max_pixels = LEDFX_WLED_WARLS_MAX_PIXELS;
+      break;
+    case LEDFX_WLED_DRGB:
+      w->header_len = 2;
+      per_packet = max_pixels = LEDFX_WLED_DRGB_MAX_PIXELS;
+      break;
+    case LEDFX_WLED_DNRGB:
+      w->header_len = 4;
+      per_packet = LEDFX_WLED_DNRGB_PIXELS;
+      max_pixels = LEDFX_WLED_DNRGB_MAX_PIXELS;
+      break;
+    default:
+      AUBIO_ERR ("wled: unknown protocol %d\n", protocol);
+      goto beach;
+  }
+  if ((sint_t) n_pixels < 1 || n_pixels > max_pixels) {
+    AUBIO_ERR ("wled: got n_pixels %d, protocol %d takes 1 to %d\n",
+        n_pixels, protocol, max_pixels);
+    goto beach;
+  }
+  w->protocol = protocol;
+  w->n_pixels = n_pixels;
+  w->n_packets = (n_pixels + per_packet - 1) / per_packet;
+  w->timeout = 1;
+  stride = w->header_len + bytes_per_pixel * per_packet;
+  w->buffer = AUBIO_ARRAY (unsigned char, w->n_packets * stride);
+  w->packets = AUBIO_ARRAY (unsigned char *, w->n_packets);
+  w->lengths = AUBIO_ARRAY (uint_t, w->n_packets);
+  w->last = AUBIO_ARRAY (unsigned char, w->n_packets * stride);
+  w->changed = AUBIO_ARRAY (const unsigned char *, w->n_packets);
+  w->changed_lengths = AUBIO_ARRAY (uint_t, w->n_packets);
+  w->stride = stride;
+  if (!w->buffer || !w->packets || !w->lengths || !w->last || !w->changed
+      || !w->changed_lengths) {
+    goto beach;
+  }
+
+  /* only the LEDs change from one frame to the next; WARLS indices are
+   * written once here too */
+  for (i = 0; i < w->n_packets; i++) {
+    unsigned char *h = w->buffer + i * stride;
+    uint_t start = i * per_packet, j;
+    uint_t len = MIN (per_packet, n_pixels - start);
+    h[0] = (unsigned char) protocol;
+    h[1] = (unsigned char) w->timeout;
+    if (protocol == LEDFX_WLED_DNRGB) {
+      h[2] = (unsigned char) (start >> 8);
+      h[3] = (unsigned char) start;
+    } else if (protocol == LEDFX_WLED_WARLS) {
+      for (j = 0; j < len; j++) {
+        h[w->header_len + 4 * j] = (unsigned char) j;
+      }
+    }
+    w->packets[i] = h;
+    w->lengths[i] = w->header_len + bytes_per_pixel * len;
+  }
+  return w;
+
+beach:
+  del_ledfx_wled (w);
+  return NULL;
+}
+
+void
+del_ledfx_wled (ledfx_wled_t * w)
+{
+  if (!w)
+    return;
+  if (w->buffer)
+    AUBIO_FREE (w->buffer);
+  if (w->packets)
+    AUBIO_FREE (w->packets);
+  if (w->lengths)
+    AUBIO_FREE (w->lengths);
+  if (w->last)
+    AUBIO_FREE (w->last);
+  if (w->changed)
+    AUBIO_FREE ((void *) w->changed);
+  if (w->changed_lengths)
+    AUBIO_FREE (w->changed_lengths);
+  AUBIO_FREE (w);
+}
+
+uint_t
+ledfx_wled_set_timeout (ledfx_wled_t * w, uint_t timeout)
+{
+  uint_t i;
+  if (timeout < 1 || timeout > LEDFX_WLED_TIMEOUT_FOREVER) {
+    AUBIO_ERR ("wled: timeout should be 1 to %d, got %d\n",
+        LEDFX_WLED_TIMEOUT_FOREVER, timeout);
+    return AUBIO_FAIL;
+  }
+  w->timeout = timeout;
+  for (i = 0; i < w->n_packets; i++) {
+    w->packets[i][1] = (unsigned char) timeout;
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_wled_get_timeout (const ledfx_wled_t * w)
+{
+  return w->timeout;
+}
+
+uint_t
+ledfx_wled_do (ledfx_wled_t * w, const fvec_t * rgb)
+{
+  uint_t i, j, c, k = 0;
+  /* WARLS leaves the index byte in front of each LED as it is */
+  uint_t step = w->protocol == LEDFX_WLED_WARLS ? 4 : 3;
+  const smpl_t *s = rgb->data;
+  if (rgb->length != 3 * w->n_pixels) {
+    AUBIO_ERR ("wled: expected %d values, got %d\n", 3 * w->n_pixels,
+        rgb->length);
+    return AUBIO_FAIL;
+  }
+  for (i = 0; i < w->n_packets; i++) {
+    unsigned char *out = w->packets[i] + w->header_len;
+    uint_t len = w->lengths[i] - w->header_len;
+    for (j = step - 3; j < len; j += step) {
+      for (c = 0; c < 3; c++, k++) {
+        /* written so that NaN gives 0 */
+        smpl_t v = s[k];
+        out[j + c] = v >= 255. ? 255 : (v > 0. ? (unsigned char) v : 0);
+      }
+    }
+  }
+  return AUBIO_OK;
+}
+
+uint_t
+ledfx_wled_send (ledfx_wled_t * w, ledfx_udp_t * u)
+{
+  return ledfx_wled_send_changed (w, u, 1);
+}
+
+uint_t
+ledfx_wled_send_changed (ledfx_wled_t * w, ledfx_udp_t * u, uint_t all)
+{
+  uint_t i, n = 0;
+  if (!w->primed) {
+    all = 1;
+  }
+  for (i = 0; i < w->n_packets; i++) {
+    const unsigned char *p = w->packets[i];
+    unsigned char *last = w->last + i * w->stride;
+    if (!all && memcmp (p, last, w->lengths[i]) == 0) {
+      w->n_skipped_packets++;
+      w->n_skipped_bytes += w->lengths[i];
+      continue;
+    }
+    AUBIO_MEMCPY (last, p, w->lengths[i]);
+    w->changed[n] = p;
+    w->changed_lengths[n] = w->lengths[i];
+    n++;
+  }
+  w->primed = 1;
+  if (n == 0) {
+    return 0;
+  }
+  return ledfx_udp_send (u, w->changed, w->changed_lengths, n);
+}
+
+uint_t
+ledfx_wled_get_n_skipped_packets (const ledfx_wled_t * w)
+{
+  return w->n_skipped_packets;
+}
+
+uint_t
+ledfx_wled_get_n_skipped_bytes (const ledfx_wled_t * w)
+{
+  return w->n_skipped_bytes;
+}
+
+uint_t
+ledfx_wled_get_protocol (const ledfx_wled_t * w)
+{
+  return w->protocol;
+}
+
+uint_t
+ledfx_wled_get_n_packets (const ledfx_wled_t * w)
+{
+  return w->n_packets;
+}
+
+const unsigned char *const *
+ledfx_wled_get_packets (const ledfx_wled_t * w)
+{
+  return (const unsigned char *const *) w->packets;
+}
+
+const uint_t *
+ledfx_wled_get_lengths (const ledfx_wled_t * w)
+{
+  return w->lengths;
+}
+
+uint_t
+ledfx_wled_get_n_pixels (const ledfx_wled_t * w)
+{
+  return w->n_pixels;
+}
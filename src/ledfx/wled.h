@@ -0,0 +1,202 @@
+/*
+  WLED realtime UDP encoder.
+*/
+
+#ifndef LEDFX_WLED_H
+#define LEDFX_WLED_H
+
+/** \file
+
+  WLED realtime UDP encoder
+
+  Encodes a strip of r, g, b values into the packets of WLED's realtime UDP
+  protocols, sent to port ::LEDFX_WLED_PORT. Every packet starts with the
+  protocol byte and the timeout, in seconds, after which WLED goes back to
+  its own effects when no more packets arrive:
+
+  - WARLS (1): [1, timeout] then index, r, g, b for each LED, up to
+    ::LEDFX_WLED_WARLS_MAX_PIXELS,
+  - DRGB (2): [2, timeout] then r, g, b for each LED, up to
+    ::LEDFX_WLED_DRGB_MAX_PIXELS,
+  - DNRGB (4): [4, timeout, start high byte, start low byte] then r, g, b
+    for up to ::LEDFX_WLED_DNRGB_PIXELS LEDs from start; longer strips are
+    split over several packets.
+
+  Values are truncated to bytes and clamped to 0..255 as they are written
+  behind the headers. The packets are allocated by new_ledfx_wled() and
+  rewritten by each call to ledfx_wled_do(); ledfx_wled_send() hands them to
+  a ::ledfx_udp_t in one batch.
+
+  ledfx_wled_send_changed() compares each packet, header included, with the
+  bytes it last sent and only sends the ones that differ, so a static scene
+  costs no traffic. As each DNRGB packet carries its own start index, a
+  long strip only resends the parts that changed. WLED leaves realtime mode
+  once no packet arrived for the timeout, so callers should still send the
+  whole frame at least every half timeout.
+
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** default WLED realtime UDP port */
+#define LEDFX_WLED_PORT 21324
+/** largest strip a single WARLS packet can address */
+#define LEDFX_WLED_WARLS_MAX_PIXELS 255
+/** largest strip a single DRGB packet can carry */
+#define LEDFX_WLED_DRGB_MAX_PIXELS 490
+/** LEDs per DNRGB packet */
+#define LEDFX_WLED_DNRGB_PIXELS 489
+/** timeout value telling WLED to stay in realtime mode until told not to */
+#define LEDFX_WLED_TIMEOUT_FOREVER 255
+
+/** WLED realtime protocols, valued as their first packet byte */
+typedef enum
+{
+  LEDFX_WLED_WARLS = 1,         /**< index and r, g, b per LED */
+  LEDFX_WLED_DRGB = 2,          /**< r, g, b per LED, single packet */
+  LEDFX_WLED_DNRGB = 4,         /**< r, g, b per LED from a start index */
+} ledfx_wled_protocol_t;
+
+/** WLED realtime encoder object */
+typedef struct _ledfx_wled_t ledfx_wled_t;
+
+/** create a WLED realtime encoder
+
+  \param protocol one of ::ledfx_wled_protocol_t
+  \param n_pixels number of pixels of the strip
+
+  \return newly created object, or NULL if protocol is unknown or can not
+  address n_pixels LEDs
+
+*/
+ledfx_wled_t *new_ledfx_wled (uint_t protocol, uint_t n_pixels);
+
+/** delete a WLED realtime encoder
+
+  \param w object to delete, as returned by new_ledfx_wled()
+
+*/
+void del_ledfx_wled (ledfx_wled_t * w);
+
+/** set the timeout written in every packet
+
+  \param w WLED realtime encoder
+  \param timeout seconds, 1 to ::LEDFX_WLED_TIMEOUT_FOREVER; 1 by default
+
+  \return 0 on success, non-zero if timeout is out of range
+
+*/
+uint_t ledfx_wled_set_timeout (ledfx_wled_t * w, uint_t timeout);
+
+/** get the timeout written in every packet
+
+  \param w WLED realtime encoder
+
+*/
+uint_t ledfx_wled_get_timeout (const ledfx_wled_t * w);
+
+/** encode one frame
+
+  \param w WLED realtime encoder
+  \param rgb 3 n_pixels interleaved r, g, b values
+
+  \return 0 on success, non-zero if rgb has the wrong length
+
+*/
+uint_t ledfx_wled_do (ledfx_wled_t * w, const fvec_t * rgb);
+
+/** send all the packets of the last frame
+
+  Same as ledfx_wled_send_changed() with all set.
+
+  \param w WLED realtime encoder
+  \param u UDP sender connected to the receiver
+
+  \return number of packets queued by the kernel
+
+*/
+uint_t ledfx_wled_send (ledfx_wled_t * w, ledfx_udp_t * u);
+
+/** send the packets of the last frame that changed since they were sent
+
+  Every packet is sent on the first call, and when all is non-zero, as
+  needed for keepalives.
+
+  \param w WLED realtime encoder
+  \param u UDP sender connected to the receiver
+  \param all if non-zero, send unchanged packets too
+
+  \return number of packets queued by the kernel
+
+*/
+uint_t ledfx_wled_send_changed (ledfx_wled_t * w, ledfx_udp_t * u,
+    uint_t all);
+
+/** get number of packets left out as unchanged since creation
+
+  While the encoder is paced by a ::ledfx_scheduler_t, whose thread sends
+  its packets, read this with ledfx_scheduler_get_n_skipped_packets()
+  instead.
+
+  \param w WLED realtime encoder
+
+*/
+uint_t ledfx_wled_get_n_skipped_packets (const ledfx_wled_t * w);
+
+/** get number of bytes left out as unchanged since creation, headers
+  included
+
+  While the encoder is paced by a ::ledfx_scheduler_t, read this with
+  ledfx_scheduler_get_n_skipped_bytes() instead.
+
+  \param w WLED realtime encoder
+
+*/
+uint_t ledfx_wled_get_n_skipped_bytes (const ledfx_wled_t * w);
+
+/** get the protocol of the encoder
+
+  \param w WLED realtime encoder
+
+*/
+uint_t ledfx_wled_get_protocol (const ledfx_wled_t * w);
+
+/** get number of packets per frame
+
+  \param w WLED realtime encoder
+
+*/
+uint_t ledfx_wled_get_n_packets (const ledfx_wled_t * w);
+
+/** get the packets of the last frame
+
+  \param w WLED realtime encoder
+
+  \return ledfx_wled_get_n_packets() pointers to the packets, header first
+
+*/
+const unsigned char *const *ledfx_wled_get_packets (const ledfx_wled_t * w);
+
+/** get the length of the packets, header included
+
+  \param w WLED realtime encoder
+
+  \return ledfx_wled_get_n_packets() lengths in bytes
+
+*/
+const uint_t *ledfx_wled_get_lengths (const ledfx_wled_t * w);
+
+/** get number of pixels
+
+  \param w WLED realtime encoder
+
+*/
+uint_t ledfx_wled_get_n_pixels (const ledfx_wled_t * w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LEDFX_WLED_H */
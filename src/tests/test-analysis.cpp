@@ -0,0 +1,156 @@
+// Checks onset and pitch detection on synthetic signals, with the window,
+// hop and rate the app uses: a click train over a quiet hum, steady sines
+// and digital silence.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// FFT_SIZE and MIC_RATE of lib/src/effects/const.dart, 60 hops per second.
+static const uint_t kWinS = 4096;
+static const uint_t kRate = 30000;
+static const uint_t kHop = kRate / 60;
+static const double kPi = 3.14159265358979323846;
+
+static std::vector<float> Sine(double freq, double amplitude, uint_t frames)
+{
+  std::vector<float> out(frames);
+  for (uint_t i = 0; i < frames; i++)
+    out[i] = (float)(amplitude * std::sin(2. * kPi * freq * i / kRate));
+  return out;
+}
+
+// Runs |signal| through a new analysis object, one result per hop.
+static std::vector<ledfx_analysis_result_t> Analyse(
+    const std::vector<float> &signal)
+{
+  std::vector<ledfx_analysis_result_t> results;
+  ledfx_analysis_t *a = new_ledfx_analysis("hfc", kWinS, kHop, kRate);
+  if (!a)
+    return results;
+  fvec_t *hop = new_fvec(kHop);
+  for (size_t start = 0; start + kHop <= signal.size(); start += kHop)
+  {
+    for (uint_t i = 0; i < kHop; i++)
+      hop->data[i] = signal[start + i];
+    ledfx_analysis_result_t result;
+    ledfx_analysis_do(a, hop, &result);
+    results.push_back(result);
+  }
+  del_fvec(hop);
+  del_ledfx_analysis(a);
+  return results;
+}
+
+// Short noise bursts every half second, over a hum loud enough to keep the
+// -70 dB silence gate open between them, give one onset each.
+static int test_click_onsets()
+{
+  const uint_t frames = 4 * kRate, period = kRate / 2;
+  std::vector<float> signal = Sine(100., 0.003, frames);
+  std::mt19937 rng(17);
+  std::uniform_real_distribution<float> noise(-0.8f, 0.8f);
+  std::vector<uint_t> clicks;
+  for (uint_t click = period; click + period <= frames; click += period)
+  {
+    clicks.push_back(click);
+    for (uint_t i = 0; i < 32; i++)
+      signal[click + i] += noise(rng);
+  }
+
+  const std::vector<ledfx_analysis_result_t> results = Analyse(signal);
+  CHECK(results.size() == frames / kHop);
+  // Onsets found up to 0.25 s after each click; any other onset past the
+  // start of the stream is spurious.
+  std::vector<int> found(clicks.size());
+  for (size_t h = 0; h < results.size(); h++)
+  {
+    if (!results[h].onset || h * kHop < kRate / 10)
+      continue;
+    bool matched = false;
+    for (size_t c = 0; c < clicks.size(); c++)
+      if (h * kHop + kHop > clicks[c] && h * kHop < clicks[c] + kRate / 4)
+      {
+        found[c]++;
+        matched = true;
+      }
+    CHECK(matched);
+  }
+  int detected = 0;
+  for (int count : found)
+  {
+    CHECK(count <= 1);
+    detected += count;
+  }
+  CHECK(detected >= (int)clicks.size() - 1);
+  return 0;
+}
+
+// Steady sines are found within 1% once the window is full, confidently.
+static int test_sine_pitch()
+{
+  const double freqs[] = {110., 440., 1000.};
+  for (double freq : freqs)
+  {
+    const std::vector<ledfx_analysis_result_t> results =
+        Analyse(Sine(freq, 0.5, kRate));
+    CHECK(results.size() == kRate / kHop);
+    for (size_t h = kWinS / kHop + 1; h < results.size(); h++)
+    {
+      CHECK(std::fabs(results[h].pitch - freq) < 0.01 * freq);
+      CHECK(results[h].pitch_confidence > 0.8f);
+      CHECK(std::fabs(results[h].db - 20. * std::log10(0.5 / std::sqrt(2.))) <
+            1.);
+    }
+  }
+  return 0;
+}
+
+// Digital silence closes every gate.
+static int test_silence()
+{
+  const std::vector<ledfx_analysis_result_t> results =
+      Analyse(std::vector<float>(kRate));
+  CHECK(results.size() == kRate / kHop);
+  for (const ledfx_analysis_result_t &result : results)
+  {
+    CHECK(!result.onset);
+    CHECK(!result.beat);
+    CHECK(result.pitch == 0.f);
+    CHECK(!(result.db > -70.f));
+  }
+  return 0;
+}
+
+static int test_bad_parameters()
+{
+  CHECK(new_ledfx_analysis("hfc", kWinS, kHop, 0) == NULL);
+  CHECK(new_ledfx_analysis("hfc", 1000, kHop, kRate) == NULL);
+  CHECK(new_ledfx_analysis("hfc", kWinS, 0, kRate) == NULL);
+  CHECK(new_ledfx_analysis("hfc", 256, 512, kRate) == NULL);
+  CHECK(new_ledfx_analysis("bogus", kWinS, kHop, kRate) == NULL);
+  const char *methods[] = {"energy", "hfc", "complex", "default"};
+  for (const char *method : methods)
+  {
+    ledfx_analysis_t *a = new_ledfx_analysis(method, kWinS, kHop, kRate);
+    CHECK(a);
+    CHECK(ledfx_analysis_set_onset_threshold(a, 0.1f) == 0);
+    CHECK(ledfx_analysis_set_pitch_tolerance(a, 0.2f) == 0);
+    del_ledfx_analysis(a);
+  }
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_click_onsets();
+  failures += test_sine_pitch();
+  failures += test_silence();
+  failures += test_bad_parameters();
+  return failures;
+}
@@ -0,0 +1,149 @@
+// Checks the DDP packetizer headers and payloads, and the batched UDP
+// sender against a listener on the loopback interface.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <vector>
+
+static unsigned ReadBE(const unsigned char *p, int bytes)
+{
+  unsigned v = 0;
+  for (int i = 0; i < bytes; i++)
+    v = (v << 8) | p[i];
+  return v;
+}
+
+static smpl_t Value(uint_t k) { return (smpl_t)((k * 37) % 300) - 20.f; }
+
+static unsigned char Byte(smpl_t v)
+{
+  return v >= 255 ? 255 : (v > 0 ? (unsigned char)v : 0);
+}
+
+// Checks one frame of packets against the strip filled with Value().
+static int CheckFrame(const unsigned char *const *packets,
+                      const uint_t *lengths, uint_t n_packets, uint_t n,
+                      uint_t sequence)
+{
+  uint_t k = 0;
+  for (uint_t i = 0; i < n_packets; i++)
+  {
+    const unsigned char *h = packets[i];
+    const uint_t len = lengths[i] - LEDFX_DDP_HEADER_LEN;
+    const bool last = i + 1 == n_packets;
+    CHECK(h[0] == (LEDFX_DDP_VER1 | (last ? LEDFX_DDP_PUSH : 0)));
+    CHECK(h[1] == sequence);
+    CHECK(h[2] == LEDFX_DDP_TYPE_RGB8);
+    CHECK(h[3] == LEDFX_DDP_ID_DISPLAY);
+    CHECK(ReadBE(h + 4, 4) == k);
+    CHECK(ReadBE(h + 8, 2) == len);
+    CHECK(len == (last ? 3 * n - k : LEDFX_DDP_MAX_DATALEN));
+    for (uint_t j = 0; j < len; j++, k++)
+      CHECK(h[LEDFX_DDP_HEADER_LEN + j] == Byte(Value(k)));
+  }
+  CHECK(k == 3 * n);
+  return 0;
+}
+
+static int test_packets()
+{
+  for (uint_t n : {1u, 479u, 480u, 481u, 1000u, 4000u})
+  {
+    ledfx_ddp_t *d = new_ledfx_ddp(n);
+    CHECK(d != nullptr);
+    CHECK(ledfx_ddp_get_n_packets(d) == (3 * n + 1439) / 1440);
+    fvec_t *rgb = new_fvec(3 * n);
+    for (uint_t k = 0; k < 3 * n; k++)
+      rgb->data[k] = Value(k);
+    // The sequence number runs 1 to 15 and wraps to 1, never 0.
+    for (uint_t frame = 0; frame < 20; frame++)
+    {
+      CHECK(ledfx_ddp_do(d, rgb) == 0);
+      CHECK(CheckFrame(ledfx_ddp_get_packets(d), ledfx_ddp_get_lengths(d),
+                       ledfx_ddp_get_n_packets(d), n, frame % 15 + 1) == 0);
+    }
+    del_fvec(rgb);
+    del_ledfx_ddp(d);
+  }
+
+  CHECK(new_ledfx_ddp(0) == nullptr);
+  ledfx_ddp_t *d = new_ledfx_ddp(4);
+  fvec_t *rgb = new_fvec(11);
+  CHECK(ledfx_ddp_do(d, rgb) != 0);
+  del_fvec(rgb);
+  del_ledfx_ddp(d);
+  return 0;
+}
+
+// Every packet of several frames arrives intact, in batches of sendmmsg on
+// Linux.
+static int test_send()
+{
+  uint_t port = 0;
+  const int listener = OpenListener(port, 2000000, 4 << 20);
+  CHECK(listener >= 0);
+
+  ledfx_udp_t *u = new_ledfx_udp("127.0.0.1", port);
+  CHECK(u != nullptr);
+
+  const uint_t n = 10000; // 21 packets a frame
+  ledfx_ddp_t *d = new_ledfx_ddp(n);
+  const uint_t n_packets = ledfx_ddp_get_n_packets(d);
+  fvec_t *rgb = new_fvec(3 * n);
+  for (uint_t k = 0; k < 3 * n; k++)
+    rgb->data[k] = Value(k);
+
+  std::vector<unsigned char> packet(2048);
+  for (uint_t frame = 0; frame < 3; frame++)
+  {
+    CHECK(ledfx_ddp_do(d, rgb) == 0);
+    CHECK(ledfx_ddp_send(d, u) == n_packets);
+
+    std::vector<std::vector<unsigned char>> received;
+    std::vector<const unsigned char *> packets;
+    std::vector<uint_t> lengths;
+    for (uint_t i = 0; i < n_packets; i++)
+    {
+      const ssize_t r = recv(listener, packet.data(), packet.size(), 0);
+      CHECK(r > 0);
+      received.emplace_back(packet.begin(), packet.begin() + r);
+    }
+    for (const auto &p : received)
+    {
+      packets.push_back(p.data());
+      lengths.push_back((uint_t)p.size());
+    }
+    CHECK(CheckFrame(packets.data(), lengths.data(), n_packets, n,
+                     frame + 1) == 0);
+  }
+  CHECK(ledfx_udp_get_n_sent(u) == 3 * n_packets);
+  CHECK(ledfx_udp_get_n_dropped(u) == 0);
+#ifdef __linux__
+  CHECK(ledfx_udp_get_n_syscalls(u) == 3);
+#endif
+
+  del_fvec(rgb);
+  del_ledfx_ddp(d);
+  del_ledfx_udp(u);
+  close(listener);
+
+  CHECK(new_ledfx_udp("127.0.0.1", 0) == nullptr);
+  CHECK(new_ledfx_udp("not an address.invalid", 4048) == nullptr);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_packets();
+  failures += test_send();
+  return failures;
+}
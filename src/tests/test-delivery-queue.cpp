@@ -0,0 +1,226 @@
+// Unit and stress tests for ledfx::DeliveryQueue.
+
+#include "delivery_queue.h"
+#include "test_utils.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Queue = ledfx::DeliveryQueue<int>;
+
+struct Recorder
+{
+  std::vector<std::vector<int>> messages;
+  std::vector<bool> after_drop;
+  std::vector<int> dropped;
+
+  size_t Drain(Queue &queue)
+  {
+    return queue.Drain(
+        [&](const int *items, size_t count, bool flag)
+        {
+          messages.emplace_back(items, items + count);
+          after_drop.push_back(flag);
+        },
+        [&](const int &item) { dropped.push_back(item); });
+  }
+};
+
+static int PushRange(Queue &queue, int from, int to, int *wakeups)
+{
+  for (int i = from; i < to; i++)
+  {
+    bool wake = false;
+    CHECK(queue.Push(i, &wake));
+    *wakeups += wake;
+  }
+  return 0;
+}
+
+static int test_wakeups()
+{
+  Queue queue(16, {ledfx::DeliveryMode::kDeliverAll, 4, 4});
+  int wakeups = 0;
+  CHECK(PushRange(queue, 0, 10, &wakeups) == 0);
+  // One wakeup however many items pile up.
+  CHECK(wakeups == 1);
+
+  Recorder rec;
+  CHECK(rec.Drain(queue) == 10);
+  CHECK(rec.messages.size() == 10);
+  CHECK(rec.messages[9].size() == 1 && rec.messages[9][0] == 9);
+  CHECK(rec.dropped.empty());
+
+  CHECK(PushRange(queue, 10, 11, &wakeups) == 0);
+  CHECK(wakeups == 2);
+
+  // A failed wakeup is retried by the next push.
+  queue.WakeupFailed();
+  CHECK(PushRange(queue, 11, 12, &wakeups) == 0);
+  CHECK(wakeups == 3);
+  CHECK(queue.Stats().wakeups == 3);
+  return 0;
+}
+
+static int test_drop_oldest()
+{
+  Queue queue(16, {ledfx::DeliveryMode::kDropOldest, 3, 4});
+  int wakeups = 0;
+  CHECK(PushRange(queue, 0, 8, &wakeups) == 0);
+
+  Recorder rec;
+  CHECK(rec.Drain(queue) == 8);
+  CHECK(rec.dropped == (std::vector<int>{0, 1, 2, 3, 4}));
+  CHECK(rec.messages.size() == 3);
+  CHECK(rec.messages[0][0] == 5 && rec.messages[2][0] == 7);
+  CHECK(rec.after_drop[0] && !rec.after_drop[1] && !rec.after_drop[2]);
+
+  const ledfx::DeliveryStats stats = queue.Stats();
+  CHECK(stats.queued == 8);
+  CHECK(stats.delivered == 3);
+  CHECK(stats.messages == 3);
+  CHECK(stats.dropped_oldest == 5);
+  CHECK(stats.high_water == 8);
+  return 0;
+}
+
+static int test_coalesce()
+{
+  Queue queue(16, {ledfx::DeliveryMode::kCoalesce, 4, 3});
+  int wakeups = 0;
+  CHECK(PushRange(queue, 0, 5, &wakeups) == 0);
+
+  Recorder rec;
+  CHECK(rec.Drain(queue) == 5);
+  CHECK(rec.dropped == (std::vector<int>{0, 1}));
+  CHECK(rec.messages.size() == 1);
+  CHECK(rec.messages[0] == (std::vector<int>{2, 3, 4}));
+  CHECK(rec.after_drop[0]);
+
+  // Fewer items than the policy allows: all of them, in one message.
+  CHECK(PushRange(queue, 5, 7, &wakeups) == 0);
+  CHECK(rec.Drain(queue) == 2);
+  CHECK(rec.messages.size() == 2);
+  CHECK(rec.messages[1] == (std::vector<int>{5, 6}));
+  CHECK(!rec.after_drop[1]);
+
+  const ledfx::DeliveryStats stats = queue.Stats();
+  CHECK(stats.messages == 2);
+  CHECK(stats.delivered == 5);
+  CHECK(stats.coalesced == 3);
+  CHECK(stats.dropped_oldest == 2);
+
+  // Nothing queued, nothing delivered.
+  CHECK(rec.Drain(queue) == 0);
+  CHECK(queue.Stats().messages == 2);
+  return 0;
+}
+
+static int test_overflow()
+{
+  Queue queue(4, {ledfx::DeliveryMode::kDeliverAll, 4, 4});
+  int wakeups = 0;
+  CHECK(PushRange(queue, 0, 4, &wakeups) == 0);
+  bool wake = true;
+  CHECK(!queue.Push(4, &wake));
+  CHECK(!wake);
+  queue.CountOverflow();
+  CHECK(queue.Stats().dropped_overflow == 2);
+  return 0;
+}
+
+// A producer pushes at full speed while a slow consumer drains on wakeup:
+// every item is either delivered or dropped, in order, and no drain delivers
+// more than the policy allows.
+static int test_stress()
+{
+  constexpr int kItems = 200000;
+  Queue queue(64, {ledfx::DeliveryMode::kDropOldest, 4, 4});
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int pending_wakeups = 0;
+  bool done = false;
+
+  std::thread producer([&]
+                       {
+    for (int i = 0; i < kItems;)
+    {
+      bool wake = false;
+      if (!queue.Push(i, &wake))
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      i++;
+      if (wake)
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_wakeups++;
+        cv.notify_one();
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+    cv.notify_one(); });
+
+  long delivered = 0, dropped = 0, bad_order = 0, max_per_drain = 0;
+  int last = -1;
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&] { return pending_wakeups > 0 || done; });
+      if (pending_wakeups == 0 && done)
+        break;
+      // At most one wakeup is ever outstanding.
+      if (pending_wakeups > 1)
+        bad_order++;
+      pending_wakeups = 0;
+    }
+    long this_drain = 0;
+    queue.Drain(
+        [&](const int *items, size_t count, bool)
+        {
+          for (size_t i = 0; i < count; i++)
+          {
+            bad_order += items[i] <= last;
+            last = items[i];
+          }
+          delivered += static_cast<long>(count);
+          this_drain += static_cast<long>(count);
+        },
+        [&](const int &item)
+        {
+          bad_order += item <= last;
+          last = item;
+          dropped++;
+        });
+    max_per_drain = std::max(max_per_drain, this_drain);
+  }
+  producer.join();
+  Recorder rec;
+  rec.Drain(queue);
+  delivered += static_cast<long>(rec.messages.size());
+  dropped += static_cast<long>(rec.dropped.size());
+
+  CHECK(bad_order == 0);
+  CHECK(delivered + dropped == kItems);
+  CHECK(max_per_drain <= 4);
+  CHECK(queue.Stats().queued == static_cast<uint64_t>(kItems));
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_wakeups();
+  failures += test_drop_oldest();
+  failures += test_coalesce();
+  failures += test_overflow();
+  failures += test_stress();
+  return failures;
+}
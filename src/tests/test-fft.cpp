@@ -0,0 +1,153 @@
+// Checks both FFT backends against a double precision DFT for every power
+// of two size up to 2048, in the aubio_fft_do_complex() layout and sign
+// convention, and the sharing of twiddle tables between instances.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static const double kPi = 3.14159265358979323846;
+static const ledfx_fft_backend_t kBackends[] = {LEDFX_FFT_OOURA,
+                                                LEDFX_FFT_STOCKHAM};
+
+// X[k] = sum x[j] exp(-2 pi i j k / n), packed as the real parts of bins 0
+// to n / 2 then the imaginary parts of bins n / 2 - 1 down to 1.
+static std::vector<double> Dft(const fvec_t *x)
+{
+  const uint_t n = x->length;
+  std::vector<double> out(n);
+  for (uint_t k = 0; k <= n / 2; k++)
+  {
+    double re = 0., im = 0.;
+    for (uint_t j = 0; j < n; j++)
+    {
+      const double phase =
+          2. * kPi * (double)((unsigned long long)j * k % n) / n;
+      re += x->data[j] * std::cos(phase);
+      im -= x->data[j] * std::sin(phase);
+    }
+    out[k] = re;
+    if (k > 0 && k < n / 2)
+      out[n - k] = im;
+  }
+  return out;
+}
+
+// Largest difference to the reference, relative to the input size.
+static double Error(const fvec_t *got, const std::vector<double> &want)
+{
+  double err = 0.;
+  for (uint_t i = 0; i < got->length; i++)
+    err = std::max(err, std::fabs(got->data[i] - want[i]));
+  return err / got->length;
+}
+
+static int test_matches_dft()
+{
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> sample(-1.f, 1.f);
+  for (uint_t n = 2; n <= 2048; n *= 2)
+  {
+    fvec_t *in = new_fvec(n), *out = new_fvec(n);
+    for (ledfx_fft_backend_t backend : kBackends)
+    {
+      ledfx_fft_t *fft = new_ledfx_fft_with_backend(n, backend);
+      CHECK(fft);
+      CHECK(ledfx_fft_get_backend(fft) == backend);
+      for (int round = 0; round < 3; round++)
+      {
+        for (uint_t j = 0; j < n; j++)
+          in->data[j] = sample(rng);
+        ledfx_fft_do_complex(fft, in, out);
+        CHECK(Error(out, Dft(in)) < 1e-5);
+      }
+      del_ledfx_fft(fft);
+    }
+    del_fvec(out);
+    del_fvec(in);
+  }
+  return 0;
+}
+
+// A sine at bin 3 lands on -n / 2 in the imaginary part of bin 3, as with
+// aubio_fft_do_complex(); a conjugated spectrum would give +n / 2.
+static int test_sign_convention()
+{
+  const uint_t n = 64;
+  fvec_t *in = new_fvec(n), *out = new_fvec(n);
+  for (uint_t j = 0; j < n; j++)
+    in->data[j] = (smpl_t)std::sin(2. * kPi * 3. * j / n);
+  for (ledfx_fft_backend_t backend : kBackends)
+  {
+    ledfx_fft_t *fft = new_ledfx_fft_with_backend(n, backend);
+    CHECK(fft);
+    ledfx_fft_do_complex(fft, in, out);
+    CHECK(std::fabs(out->data[n - 3] + n / 2.) < 1e-3);
+    CHECK(std::fabs(out->data[3]) < 1e-3);
+    del_ledfx_fft(fft);
+  }
+  del_fvec(out);
+  del_fvec(in);
+  return 0;
+}
+
+// Instances of one size share their twiddles; deleting one leaves the
+// other working, and a new one after both are gone recomputes them.
+static int test_shared_twiddles()
+{
+  const uint_t n = 256;
+  std::mt19937 rng(13);
+  std::uniform_real_distribution<float> sample(-1.f, 1.f);
+  fvec_t *in = new_fvec(n), *out = new_fvec(n);
+  for (uint_t j = 0; j < n; j++)
+    in->data[j] = sample(rng);
+  const std::vector<double> want = Dft(in);
+
+  ledfx_fft_t *a = new_ledfx_fft_with_backend(n, LEDFX_FFT_STOCKHAM);
+  ledfx_fft_t *b = new_ledfx_fft_with_backend(n, LEDFX_FFT_STOCKHAM);
+  CHECK(a && b);
+  del_ledfx_fft(a);
+  ledfx_fft_do_complex(b, in, out);
+  CHECK(Error(out, want) < 1e-5);
+  del_ledfx_fft(b);
+  a = new_ledfx_fft_with_backend(n, LEDFX_FFT_STOCKHAM);
+  CHECK(a);
+  ledfx_fft_do_complex(a, in, out);
+  CHECK(Error(out, want) < 1e-5);
+  del_ledfx_fft(a);
+  del_fvec(out);
+  del_fvec(in);
+  return 0;
+}
+
+static int test_bad_parameters()
+{
+  const uint_t sizes[] = {0, 1, 3, 1000};
+  for (uint_t n : sizes)
+    for (ledfx_fft_backend_t backend : kBackends)
+      CHECK(new_ledfx_fft_with_backend(n, backend) == NULL);
+  CHECK(new_ledfx_fft_with_backend(512, (ledfx_fft_backend_t)7) == NULL);
+  CHECK(std::strcmp(ledfx_fft_get_backend_name(LEDFX_FFT_OOURA), "ooura") == 0);
+  CHECK(std::strcmp(ledfx_fft_get_backend_name(LEDFX_FFT_STOCKHAM),
+                    "stockham") == 0);
+  ledfx_fft_t *fft = new_ledfx_fft(512);
+  CHECK(fft);
+  del_ledfx_fft(fft);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_matches_dft();
+  failures += test_sign_convention();
+  failures += test_shared_twiddles();
+  failures += test_bad_parameters();
+  return failures;
+}
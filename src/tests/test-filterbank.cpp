@@ -0,0 +1,127 @@
+// Checks the sparse filterbank against aubio's dense aubio_filterbank_do()
+// on the same triangular coefficients, for one bank at a time and for
+// several banks evaluated in one call.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+static const uint_t kWinS = 1024;
+static const smpl_t kRate = 30000.f;
+
+// |n_edges| band edges spread geometrically between |lo| and |hi| Hz.
+static fvec_t *Edges(uint_t n_edges, smpl_t lo, smpl_t hi)
+{
+  fvec_t *freqs = new_fvec(n_edges);
+  for (uint_t i = 0; i < n_edges; i++)
+    freqs->data[i] = lo * std::pow(hi / lo, (smpl_t)i / (n_edges - 1));
+  return freqs;
+}
+
+static void RandomSpectrum(cvec_t *spec, std::mt19937 &rng)
+{
+  std::uniform_real_distribution<float> norm(0.f, 2.f);
+  std::uniform_real_distribution<float> phas(-3.14159f, 3.14159f);
+  for (uint_t i = 0; i < spec->length; i++)
+  {
+    spec->norm[i] = norm(rng);
+    spec->phas[i] = phas(rng);
+  }
+}
+
+// |got| and |want| agree up to float rounding of the summation order.
+static bool Close(const fvec_t *got, const fvec_t *want)
+{
+  if (got->length != want->length)
+    return false;
+  for (uint_t i = 0; i < got->length; i++)
+    if (std::fabs(got->data[i] - want->data[i]) >
+        1e-4f * (1.f + std::fabs(want->data[i])))
+      return false;
+  return true;
+}
+
+// Banks built from a dense matrix and from band edges give the dense
+// filterbank's output, through both ledfx_filterbank_do() and do_bank().
+static int test_matches_dense()
+{
+  const uint_t band_counts[] = {3, 24, 64, 128};
+  const uint_t n_sets = sizeof(band_counts) / sizeof(band_counts[0]);
+  std::mt19937 rng(7);
+
+  ledfx_filterbank_t *fb = new_ledfx_filterbank(kWinS);
+  CHECK(fb);
+  std::vector<aubio_filterbank_t *> dense(n_sets);
+  std::vector<sint_t> from_coeffs(n_sets), from_edges(n_sets);
+  for (uint_t s = 0; s < n_sets; s++)
+  {
+    fvec_t *freqs = Edges(band_counts[s] + 2, 20.f, 12000.f);
+    dense[s] = new_aubio_filterbank(band_counts[s], kWinS);
+    CHECK(aubio_filterbank_set_triangle_bands(dense[s], freqs, kRate) == 0);
+    from_coeffs[s] =
+        ledfx_filterbank_add_coeffs(fb, aubio_filterbank_get_coeffs(dense[s]));
+    from_edges[s] = ledfx_filterbank_add_triangle_bands(fb, freqs, kRate);
+    del_fvec(freqs);
+    CHECK(from_coeffs[s] >= 0 && from_edges[s] >= 0);
+    CHECK(ledfx_filterbank_get_n_filters(fb, from_coeffs[s]) == band_counts[s]);
+    CHECK(ledfx_filterbank_get_n_filters(fb, from_edges[s]) == band_counts[s]);
+  }
+  CHECK(ledfx_filterbank_get_n_banks(fb) == 2 * n_sets);
+  // Triangles only cover the bins between their neighbours' peaks.
+  uint_t dense_weights = 0;
+  for (uint_t s = 0; s < n_sets; s++)
+    dense_weights += 2 * band_counts[s] * (kWinS / 2 + 1);
+  CHECK(ledfx_filterbank_get_n_weights(fb) < dense_weights / 10);
+
+  cvec_t *spec = new_cvec(kWinS);
+  for (int round = 0; round < 20; round++)
+  {
+    RandomSpectrum(spec, rng);
+    ledfx_filterbank_do(fb, spec);
+    for (uint_t s = 0; s < n_sets; s++)
+    {
+      fvec_t *want = new_fvec(band_counts[s]);
+      fvec_t *single = new_fvec(band_counts[s]);
+      aubio_filterbank_do(dense[s], spec, want);
+      CHECK(Close(ledfx_filterbank_get_output(fb, from_coeffs[s]), want));
+      CHECK(Close(ledfx_filterbank_get_output(fb, from_edges[s]), want));
+      ledfx_filterbank_do_bank(fb, from_coeffs[s], spec, single);
+      CHECK(Close(single, want));
+      del_fvec(single);
+      del_fvec(want);
+    }
+  }
+
+  CHECK(ledfx_filterbank_get_output(fb, 2 * n_sets) == NULL);
+  del_cvec(spec);
+  for (aubio_filterbank_t *d : dense)
+    del_aubio_filterbank(d);
+  del_ledfx_filterbank(fb);
+  return 0;
+}
+
+// Too few band edges for a single filter are refused.
+static int test_bad_bands()
+{
+  CHECK(new_ledfx_filterbank(0) == NULL);
+  ledfx_filterbank_t *fb = new_ledfx_filterbank(kWinS);
+  CHECK(fb);
+  fvec_t *freqs = Edges(2, 100.f, 1000.f);
+  CHECK(ledfx_filterbank_add_triangle_bands(fb, freqs, kRate) == -1);
+  CHECK(ledfx_filterbank_get_n_banks(fb) == 0);
+  del_fvec(freqs);
+  del_ledfx_filterbank(fb);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_matches_dense();
+  failures += test_bad_bands();
+  return failures;
+}
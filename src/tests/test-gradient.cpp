@@ -0,0 +1,192 @@
+// Checks the native gradient engine against the curve generation, lookup
+// and roll of the Dart GradientAudioEffect it replaces.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// The default gradient of GradientAudioEffect.
+static const smpl_t kColors[] = {255, 0, 0, 255, 120, 0, 255, 200, 0,
+                                 0, 255, 0, 0, 199, 140, 0, 0, 255,
+                                 128, 0, 128, 255, 0, 178};
+static const smpl_t kPositions[] = {0, .14, .28, .42, .56, .70, .84, .98};
+static const uint_t kStops = 8;
+
+// Curve as generated by generateGradientCurve, 3 x length.
+static std::vector<std::vector<double>> ReferenceCurve(uint_t length)
+{
+  std::vector<const smpl_t *> colors;
+  std::vector<double> positions;
+  for (uint_t i = 0; i < kStops; i++)
+  {
+    colors.push_back(kColors + 3 * i);
+    positions.push_back(kPositions[i]);
+  }
+  if (positions.front() != 0.)
+  {
+    colors.insert(colors.begin(), colors.front());
+    positions.insert(positions.begin(), 0.);
+  }
+  if (positions.back() != 1.)
+  {
+    colors.push_back(colors.back());
+    positions.push_back(1.);
+  }
+  std::vector<int> lengths;
+  int current = 0;
+  for (double p : positions)
+  {
+    if (p > 0. && p < 1.)
+    {
+      const int split = (int)std::round(length * p);
+      lengths.push_back(split - current);
+      current = split;
+    }
+  }
+  lengths.push_back((int)length - current);
+
+  std::vector<std::vector<double>> curve(3);
+  for (size_t pair = 0; pair + 1 < colors.size(); pair++)
+  {
+    const int len = lengths[pair];
+    for (int j = 0; j < len; j++)
+    {
+      const double x = len > 1 ? (double)j / (len - 1) : 0.;
+      const double a = std::pow(x, 1.5), b = std::pow(1. - x, 1.5);
+      for (int c = 0; c < 3; c++)
+      {
+        const double diff = colors[pair + 1][c] - colors[pair][c];
+        curve[c].push_back(diff * (a / (a + b)) + colors[pair][c]);
+      }
+    }
+  }
+  return curve;
+}
+
+static bool Close(double a, double b) { return std::fabs(a - b) <= 1e-3 * (std::fabs(b) + 1.); }
+
+static int test_curve()
+{
+  const uint_t length = 256;
+  ledfx_gradient_t *g = new_ledfx_gradient(length);
+  CHECK(g != nullptr);
+  CHECK(ledfx_gradient_set_colors(g, kColors, kPositions, kStops) == 0);
+  const smpl_t *curve = ledfx_gradient_get_curve(g);
+  const auto reference = ReferenceCurve(length);
+  for (int c = 0; c < 3; c++)
+  {
+    CHECK(reference[c].size() == length);
+    for (uint_t j = 0; j < length; j++)
+      CHECK(Close(curve[3 * j + c], reference[c][j]));
+  }
+
+  // A single colour fills the whole curve.
+  const smpl_t white[] = {255, 255, 255}, zero[] = {0};
+  CHECK(ledfx_gradient_set_colors(g, white, zero, 1) == 0);
+  for (uint_t j = 0; j < 3 * length; j++)
+    CHECK(curve[j] == 255);
+
+  const smpl_t descending[] = {.5, .2};
+  CHECK(ledfx_gradient_set_colors(g, kColors, descending, 2) != 0);
+  CHECK(ledfx_gradient_set_colors(g, kColors, kPositions, 0) != 0);
+  CHECK(new_ledfx_gradient(0) == nullptr);
+  del_ledfx_gradient(g);
+  return 0;
+}
+
+// Pixel i reads curve entry round(i * (length - 1) / (n - 1)) scaled by
+// intensity i, as getGradientColors does for strips shorter than the curve.
+static int test_lookup()
+{
+  const uint_t length = 256;
+  ledfx_gradient_t *g = new_ledfx_gradient(length);
+  CHECK(ledfx_gradient_set_colors(g, kColors, kPositions, kStops) == 0);
+  const smpl_t *curve = ledfx_gradient_get_curve(g);
+
+  for (uint_t n : {1u, 2u, 3u, 60u, 255u, 256u})
+  {
+    fvec_t *y = new_fvec(n);
+    fvec_t *rgb = new_fvec(3 * n);
+    for (uint_t i = 0; i < n; i++)
+      y->data[i] = (smpl_t)(i % 5) / 4;
+    CHECK(ledfx_gradient_do(g, y, rgb) == 0);
+    for (uint_t i = 0; i < n; i++)
+    {
+      const double point = n > 1 ? (double)i / (n - 1) : 0.;
+      const uint_t index = (uint_t)std::round((length - 1) * point);
+      for (uint_t c = 0; c < 3; c++)
+        CHECK(Close(rgb->data[3 * i + c], curve[3 * index + c] * y->data[i]));
+    }
+    del_fvec(y);
+    del_fvec(rgb);
+  }
+
+  fvec_t *y = new_fvec(4), *rgb = new_fvec(11);
+  CHECK(ledfx_gradient_do(g, y, rgb) != 0);
+  del_fvec(y);
+  del_fvec(rgb);
+  del_ledfx_gradient(g);
+  return 0;
+}
+
+// rollGradient: the counter grows by roll / n * length per frame and whole
+// entries roll the curve forward, numpy.roll style, after the frame is
+// coloured.
+static int test_roll()
+{
+  const uint_t length = 256;
+  for (double roll : {1., -1., .3, -2.7, 40.})
+  {
+    for (uint_t n : {60u, 256u})
+    {
+      ledfx_gradient_t *g = new_ledfx_gradient(length);
+      CHECK(ledfx_gradient_set_colors(g, kColors, kPositions, kStops) == 0);
+      ledfx_gradient_set_roll(g, roll);
+      const smpl_t *table = ledfx_gradient_get_curve(g);
+      std::vector<smpl_t> curve(table, table + 3 * length);
+
+      fvec_t *y = new_fvec(n), *rgb = new_fvec(3 * n);
+      fvec_ones(y);
+      double counter = 0.;
+      for (int frame = 0; frame < 50; frame++)
+      {
+        CHECK(ledfx_gradient_do(g, y, rgb) == 0);
+        for (uint_t i = 0; i < n; i++)
+        {
+          const uint_t index = n > 1 ? (uint_t)std::round((length - 1) * ((double)i / (n - 1))) : 0;
+          for (uint_t c = 0; c < 3; c++)
+            CHECK(rgb->data[3 * i + c] == curve[3 * index + c]);
+        }
+
+        counter += (double)(smpl_t)roll / n * length;
+        if (std::fabs(counter) >= 1.)
+        {
+          const double whole = std::trunc(counter);
+          counter -= whole;
+          const long shift = ((long)whole % (long)length + length) % length;
+          std::vector<smpl_t> rolled(curve.size());
+          for (uint_t j = 0; j < length; j++)
+            for (uint_t c = 0; c < 3; c++)
+              rolled[3 * ((j + shift) % length) + c] = curve[3 * j + c];
+          curve.swap(rolled);
+        }
+      }
+      del_fvec(y);
+      del_fvec(rgb);
+      del_ledfx_gradient(g);
+    }
+  }
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_curve();
+  failures += test_lookup();
+  failures += test_roll();
+  return failures;
+}
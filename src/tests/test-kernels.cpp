@@ -0,0 +1,167 @@
+// Checks every vector kernel variant supported by the running CPU against
+// the scalar kernels.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Lengths around the vector widths, and the sizes used per hop.
+static const uint_t kLengths[] = {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17,
+                                  31, 33, 64, 735, 800, 4097};
+
+// Allocations are offset by one sample so that unaligned loads get tested.
+static std::vector<smpl_t> RandomVector(std::mt19937 &rng, uint_t length)
+{
+  std::uniform_real_distribution<float> dist(-1.f, 1.f);
+  std::vector<smpl_t> v(length + 1);
+  for (auto &x : v)
+    x = dist(rng);
+  return v;
+}
+
+// Reductions may be summed in another order; allow for rounding relative
+// to the sum of magnitudes.
+static bool CloseSum(smpl_t a, smpl_t b, double magnitude)
+{
+  return std::fabs((double)a - (double)b) <= 1e-5 * (magnitude + 1.);
+}
+
+static int test_dot(const ledfx_kernels_t *ref, const ledfx_kernels_t *k,
+                    std::mt19937 &rng)
+{
+  for (uint_t n : kLengths)
+  {
+    auto a = RandomVector(rng, n), b = RandomVector(rng, n);
+    double magnitude = 0.;
+    for (uint_t i = 0; i < n; i++)
+      magnitude += std::fabs(a[i + 1] * b[i + 1]);
+    CHECK(CloseSum(k->dot(&a[1], &b[1], n), ref->dot(&a[1], &b[1], n),
+                   magnitude));
+  }
+  return 0;
+}
+
+static int test_sum_sq(const ledfx_kernels_t *ref, const ledfx_kernels_t *k,
+                       std::mt19937 &rng)
+{
+  for (uint_t n : kLengths)
+  {
+    auto a = RandomVector(rng, n);
+    smpl_t expected = ref->sum_sq(&a[1], n);
+    CHECK(CloseSum(k->sum_sq(&a[1], n), expected, expected));
+  }
+  return 0;
+}
+
+static int test_weight(const ledfx_kernels_t *ref, const ledfx_kernels_t *k,
+                       std::mt19937 &rng)
+{
+  for (uint_t n : kLengths)
+  {
+    auto a = RandomVector(rng, n), w = RandomVector(rng, n);
+    auto expected = a;
+    ref->weight(&expected[1], &w[1], n);
+    k->weight(&a[1], &w[1], n);
+    CHECK(a == expected);
+  }
+  return 0;
+}
+
+static int test_weighted_copy(const ledfx_kernels_t *ref,
+                              const ledfx_kernels_t *k, std::mt19937 &rng)
+{
+  for (uint_t n : kLengths)
+  {
+    auto in = RandomVector(rng, n), w = RandomVector(rng, n);
+    std::vector<smpl_t> out(n + 1, 7.f), expected(n + 1, 7.f);
+    ref->weighted_copy(&expected[1], &in[1], &w[1], n);
+    k->weighted_copy(&out[1], &in[1], &w[1], n);
+    CHECK(out == expected);
+  }
+  return 0;
+}
+
+static int test_complex_norm(const ledfx_kernels_t *ref,
+                             const ledfx_kernels_t *k, std::mt19937 &rng)
+{
+  static const uint_t kWindows[] = {2, 4, 6, 8, 10, 16, 18, 34, 512, 4096};
+  for (uint_t win_s : kWindows)
+  {
+    auto spec = RandomVector(rng, win_s);
+    // One extra sample past the end checks that nothing else is written.
+    std::vector<smpl_t> norm(win_s / 2 + 2, 7.f), expected = norm;
+    ref->complex_norm(&expected[0], &spec[1], win_s);
+    k->complex_norm(&norm[0], &spec[1], win_s);
+    for (uint_t i = 0; i < norm.size(); i++)
+      CHECK(std::fabs(norm[i] - expected[i]) <= 1e-6f * (expected[i] + 1.f));
+    CHECK(norm[win_s / 2 + 1] == 7.f);
+  }
+  return 0;
+}
+
+static int test_gather(const ledfx_kernels_t *ref, const ledfx_kernels_t *k,
+                       std::mt19937 &rng)
+{
+  for (uint_t n : kLengths)
+  {
+    auto in = RandomVector(rng, 3 * n + 2);
+    std::uniform_int_distribution<uint_t> pick(0, 3 * n + 2);
+    std::vector<uint_t> idx(n);
+    for (auto &i : idx)
+      i = pick(rng);
+    std::vector<smpl_t> out(n + 1, 7.f), expected(n + 1, 7.f);
+    ref->gather(&expected[1], &in[0], idx.data(), n);
+    k->gather(&out[1], &in[0], idx.data(), n);
+    CHECK(out == expected);
+  }
+  return 0;
+}
+
+int main()
+{
+  const ledfx_kernels_t *ref = ledfx_kernels_get(LEDFX_KERNELS_SCALAR);
+  CHECK(ref != NULL && ref->level == LEDFX_KERNELS_SCALAR);
+
+  // The scalar kernels against plain loops.
+  {
+    smpl_t a[5] = {1.f, -2.f, 3.f, 0.5f, 2.f}, b[5] = {2.f, 1.f, -1.f, 4.f, 0.f};
+    CHECK(ref->dot(a, b, 5) == -1.f);
+    CHECK(ref->sum_sq(a, 5) == 18.25f);
+    // win_s 4: re0, re1, re2 (Nyquist), im1
+    smpl_t spec[4] = {-2.f, 3.f, -5.f, 4.f}, norm[3];
+    ref->complex_norm(norm, spec, 4);
+    CHECK(norm[0] == 2.f && norm[1] == 5.f && norm[2] == 5.f);
+    uint_t idx[4] = {4, 0, 0, 2};
+    smpl_t gathered[4];
+    ref->gather(gathered, a, idx, 4);
+    CHECK(gathered[0] == 2.f && gathered[1] == 1.f && gathered[3] == 3.f);
+  }
+
+  const ledfx_kernels_t *best = ledfx_kernels();
+  CHECK(best != NULL);
+  std::printf("selected kernels: %s\n", best->name);
+
+  int failures = 0;
+  for (int level = LEDFX_KERNELS_SCALAR + 1; level < LEDFX_KERNELS_N_LEVELS;
+       level++)
+  {
+    const ledfx_kernels_t *k =
+        ledfx_kernels_get(static_cast<ledfx_kernels_level_t>(level));
+    if (!k)
+      continue;
+    CHECK(k->level == level);
+    std::mt19937 rng(1234 + level);
+    std::printf("checking %s kernels\n", k->name);
+    failures += test_dot(ref, k, rng);
+    failures += test_sum_sq(ref, k, rng);
+    failures += test_weight(ref, k, rng);
+    failures += test_weighted_copy(ref, k, rng);
+    failures += test_complex_norm(ref, k, rng);
+    failures += test_gather(ref, k, rng);
+  }
+  return failures == 0 ? 0 : 1;
+}
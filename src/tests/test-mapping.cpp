@@ -0,0 +1,177 @@
+// Checks the compiled virtual to device mappings against a direct
+// implementation: repeat the frame by the grouping, slice or copy it per
+// segment, reverse inverted segments, then rotate by the center offset.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+struct Segment
+{
+  uint_t virtual_start, device_start, device_end, inverted;
+};
+
+// Device pixels before the center offset, -1 where nothing is written.
+static std::vector<float> Reference(uint_t mode, const std::vector<float> &in,
+                                    uint_t n_virtual, uint_t n_out,
+                                    uint_t group, uint_t offset,
+                                    const std::vector<Segment> &segments)
+{
+  const uint_t n_in = in.size() / 3;
+  std::vector<float> physical;
+  for (uint_t i = 0; i < n_in; i++)
+    for (uint_t k = 0; k < group; k++)
+      physical.insert(physical.end(), &in[3 * i], &in[3 * i + 3]);
+  const uint_t n_phys = physical.size() / 3;
+
+  std::vector<float> device(3 * n_out, -1.f);
+  for (const auto &s : segments)
+  {
+    const uint_t width = s.device_end - s.device_start + 1;
+    std::vector<float> pixels;
+    if (mode == LEDFX_MAPPING_SPAN)
+    {
+      const uint_t end = std::min(std::min(n_phys, n_virtual),
+                                  s.virtual_start + width);
+      if (s.virtual_start < end)
+        pixels.assign(&physical[3 * s.virtual_start], &physical[3 * end]);
+    }
+    else
+    {
+      pixels.assign(physical.begin(),
+                    physical.begin() + 3 * std::min(width, n_phys));
+    }
+    const uint_t len = pixels.size() / 3;
+    for (uint_t j = 0; j < len; j++)
+    {
+      const uint_t from = s.inverted ? len - 1 - j : j;
+      for (uint_t c = 0; c < 3; c++)
+        device[3 * (s.device_start + j) + c] = pixels[3 * from + c];
+    }
+  }
+  std::vector<float> rolled(3 * n_out);
+  for (uint_t p = 0; p < n_out; p++)
+    for (uint_t c = 0; c < 3; c++)
+      rolled[3 * ((p + offset) % n_out) + c] = device[3 * p + c];
+  return rolled;
+}
+
+static int Check(uint_t mode, uint_t n_in, uint_t n_virtual, uint_t n_out,
+                 uint_t group, uint_t offset,
+                 const std::vector<Segment> &segments, uint_t n_runs)
+{
+  std::vector<uint_t> table;
+  for (const auto &s : segments)
+    table.insert(table.end(), {s.virtual_start, s.device_start, s.device_end,
+                               s.inverted});
+  ledfx_mapping_t *m =
+      new_ledfx_mapping(mode, n_in, n_virtual, n_out, group, offset,
+                        table.data(), (uint_t)segments.size());
+  CHECK(m != nullptr);
+  CHECK(ledfx_mapping_get_n_in(m) == n_in);
+  CHECK(ledfx_mapping_get_n_out(m) == n_out);
+  CHECK(ledfx_mapping_get_n_runs(m) == n_runs);
+
+  fvec_t *in = new_fvec(3 * n_in), *out = new_fvec(3 * n_out);
+  std::vector<float> frame(3 * n_in);
+  for (uint_t k = 0; k < 3 * n_in; k++)
+    frame[k] = in->data[k] = (float)k;
+  for (uint_t k = 0; k < 3 * n_out; k++)
+    out->data[k] = -1.f;
+  CHECK(ledfx_mapping_do(m, in, out) == 0);
+
+  const auto expected =
+      Reference(mode, frame, n_virtual, n_out, group, offset, segments);
+  uint_t mapped = 0;
+  for (uint_t k = 0; k < 3 * n_out; k++)
+  {
+    CHECK(out->data[k] == expected[k]);
+    mapped += expected[k] >= 0.f;
+  }
+  CHECK(ledfx_mapping_get_n_mapped(m) == mapped / 3);
+
+  del_fvec(in);
+  del_fvec(out);
+  del_ledfx_mapping(m);
+  return 0;
+}
+
+static int test_span()
+{
+  // A single forward segment filling the device.
+  CHECK(Check(LEDFX_MAPPING_SPAN, 300, 300, 300, 1, 0, {{0, 0, 299, 0}}, 1)
+        == 0);
+  // Two segments of one virtual across the same device, the second one
+  // inverted, with room between them left alone.
+  CHECK(Check(LEDFX_MAPPING_SPAN, 50, 50, 100, 1, 0,
+              {{0, 0, 19, 0}, {20, 60, 89, 1}}, 2) == 0);
+  // The segment of a virtual spanning another device first.
+  CHECK(Check(LEDFX_MAPPING_SPAN, 70, 70, 40, 1, 0, {{30, 0, 39, 0}}, 1)
+        == 0);
+  // Grouping repeats each effective pixel, the last group cut short.
+  CHECK(Check(LEDFX_MAPPING_SPAN, 34, 100, 100, 3, 0,
+              {{0, 0, 49, 0}, {50, 50, 99, 1}}, 2) == 0);
+  // A frame shorter than the virtual only reaches part of the segments.
+  CHECK(Check(LEDFX_MAPPING_SPAN, 30, 100, 100, 1, 0,
+              {{0, 0, 19, 1}, {20, 20, 59, 0}, {60, 60, 99, 0}}, 2) == 0);
+  return 0;
+}
+
+static int test_copy()
+{
+  CHECK(Check(LEDFX_MAPPING_COPY, 20, 20, 60, 1, 0,
+              {{0, 0, 19, 0}, {20, 20, 39, 1}, {40, 45, 54, 0}}, 3) == 0);
+  // Grouping stretches the frame over each segment.
+  CHECK(Check(LEDFX_MAPPING_COPY, 8, 30, 60, 4, 0,
+              {{0, 0, 29, 1}, {30, 30, 59, 0}}, 2) == 0);
+  return 0;
+}
+
+static int test_center_offset()
+{
+  // Segments wrapping around the end of the device take two runs.
+  CHECK(Check(LEDFX_MAPPING_SPAN, 100, 100, 100, 1, 30, {{0, 0, 99, 0}}, 2)
+        == 0);
+  CHECK(Check(LEDFX_MAPPING_SPAN, 100, 100, 100, 2, 130,
+              {{0, 0, 49, 1}, {50, 50, 99, 0}}, 3) == 0);
+  CHECK(Check(LEDFX_MAPPING_COPY, 10, 10, 40, 1, 35,
+              {{0, 0, 9, 0}, {10, 25, 34, 1}}, 3) == 0);
+  return 0;
+}
+
+static int test_invalid()
+{
+  const uint_t segment[] = {0, 0, 10, 0};
+  CHECK(new_ledfx_mapping(2, 10, 10, 10, 1, 0, segment, 1) == nullptr);
+  CHECK(new_ledfx_mapping(0, 10, 10, 10, 1, 0, segment, 1) == nullptr);
+  CHECK(new_ledfx_mapping(0, 10, 10, 11, 0, 0, segment, 1) == nullptr);
+  CHECK(new_ledfx_mapping(0, 10, 10, 0, 1, 0, nullptr, 0) == nullptr);
+  const uint_t backwards[] = {0, 5, 4, 0};
+  CHECK(new_ledfx_mapping(0, 10, 10, 10, 1, 0, backwards, 1) == nullptr);
+
+  // No segments on the device is a mapping that writes nothing.
+  ledfx_mapping_t *m = new_ledfx_mapping(0, 10, 10, 10, 1, 0, nullptr, 0);
+  CHECK(m != nullptr && ledfx_mapping_get_n_runs(m) == 0);
+  fvec_t *in = new_fvec(30), *out = new_fvec(30), *wrong = new_fvec(33);
+  CHECK(ledfx_mapping_do(m, in, out) == 0);
+  CHECK(ledfx_mapping_do(m, wrong, out) != 0);
+  CHECK(ledfx_mapping_do(m, in, wrong) != 0);
+  del_fvec(in);
+  del_fvec(out);
+  del_fvec(wrong);
+  del_ledfx_mapping(m);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_span();
+  failures += test_copy();
+  failures += test_center_offset();
+  failures += test_invalid();
+  return failures;
+}
@@ -0,0 +1,196 @@
+// Checks the melbank post-processing against a double precision reference
+// written like the Dart code it replaces: ExpFilter objects primed with
+// their first value and fastBlurArray's edge padded Gaussian blur.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// ExpFilter of lib/src/effects/math.dart, one value per band.
+struct ExpFilter
+{
+  double decay, rise;
+  std::vector<double> value;
+
+  void Update(const std::vector<double> &x)
+  {
+    if (value.empty())
+    {
+      value = x;
+      return;
+    }
+    for (size_t i = 0; i < x.size(); i++)
+    {
+      const double alpha = x[i] > value[i] ? rise : decay;
+      value[i] = alpha * x[i] + (1. - alpha) * value[i];
+    }
+  }
+};
+
+// fastBlurArray(x, 1.0) of lib/src/effects/mel_utils.dart.
+static std::vector<double> Blur(const std::vector<double> &x)
+{
+  const double sigma = 1.;
+  const int n = (int)x.size();
+  int radius = std::max(1, (int)std::lround(4. * sigma));
+  radius = std::max(std::min((n - 1) / 2, radius), 1);
+  std::vector<double> kernel(2 * radius + 1);
+  double sum = 0.;
+  for (int k = -radius; k <= radius; k++)
+    sum += kernel[k + radius] = std::exp(-0.5 * k * k / (sigma * sigma));
+  for (double &k : kernel)
+    k /= sum;
+  std::vector<double> out(n);
+  for (int i = 0; i < n; i++)
+    for (int k = -radius; k <= radius; k++)
+      out[i] += kernel[k + radius] * x[std::min(std::max(i + k, 0), n - 1)];
+  return out;
+}
+
+// The processing order of the Dart melbank.
+struct Reference
+{
+  double power;
+  ExpFilter gain{0.01, 0.99, {}};
+  ExpFilter smoothing{0.7, 0.99, {}};
+  ExpFilter common{0.99, 0.01, {}};
+  ExpFilter diff{0.15, 0.99, {}};
+
+  void Do(const std::vector<double> &in)
+  {
+    std::vector<double> bands(in.size());
+    for (size_t i = 0; i < in.size(); i++)
+      bands[i] = std::pow(in[i], power);
+    const std::vector<double> blurred = Blur(bands);
+    gain.Update({*std::max_element(blurred.begin(), blurred.end())});
+    for (double &b : bands)
+      b = std::fabs(gain.value[0]) > 1e-9 ? b / gain.value[0] : 0.;
+    smoothing.Update(bands);
+    common.Update(smoothing.value);
+    std::vector<double> d(bands.size());
+    for (size_t i = 0; i < d.size(); i++)
+      d[i] = smoothing.value[i] - common.value[i];
+    diff.Update(d);
+  }
+};
+
+static bool Close(const fvec_t *got, const std::vector<double> &want)
+{
+  for (size_t i = 0; i < want.size(); i++)
+    if (std::fabs(got->data[i] - want[i]) > 1e-4 * (1. + std::fabs(want[i])))
+      return false;
+  return true;
+}
+
+// Hops of random bands, with silent and loud stretches so that the gain
+// both rises and decays, and a first hop of silence for the zero gain.
+static void Hop(fvec_t *in, int hop, std::mt19937 &rng)
+{
+  std::uniform_real_distribution<float> band(0.f, 1.f);
+  const float level = hop == 0 || (hop / 10) % 3 == 2 ? 0.f
+                      : (hop / 10) % 3 == 1           ? 4.f
+                                                      : 1.f;
+  for (uint_t i = 0; i < in->length; i++)
+    in->data[i] = level * band(rng);
+}
+
+static int test_matches_reference()
+{
+  const uint_t band_counts[] = {1, 4, 24, 64};
+  const smpl_t powers[] = {1.f, 1.5f, 2.5f};
+  std::mt19937 rng(3);
+  for (uint_t n : band_counts)
+    for (smpl_t power : powers)
+    {
+      ledfx_melbank_t *m = new_ledfx_melbank(n, power);
+      CHECK(m);
+      CHECK(ledfx_melbank_get_n_bands(m) == n);
+      Reference ref;
+      ref.power = power;
+      fvec_t *in = new_fvec(n), *raw = new_fvec(n), *filtered = new_fvec(n);
+      for (int hop = 0; hop < 90; hop++)
+      {
+        Hop(in, hop, rng);
+        std::vector<double> bands(in->data, in->data + n);
+        CHECK(ledfx_melbank_do(m, in, raw, filtered) == 0);
+        ref.Do(bands);
+        CHECK(std::fabs(ledfx_melbank_get_gain(m) - ref.gain.value[0]) <=
+              1e-4 * (1. + ref.gain.value[0]));
+        CHECK(Close(raw, ref.smoothing.value));
+        CHECK(Close(filtered, ref.diff.value));
+      }
+      del_fvec(filtered);
+      del_fvec(raw);
+      del_fvec(in);
+      del_ledfx_melbank(m);
+    }
+  return 0;
+}
+
+// After a reset the filters are primed again, as in a new object.
+static int test_reset()
+{
+  const uint_t n = 24;
+  std::mt19937 rng(5);
+  ledfx_melbank_t *m = new_ledfx_melbank(n, 2.f);
+  ledfx_melbank_t *fresh = new_ledfx_melbank(n, 2.f);
+  CHECK(m && fresh);
+  fvec_t *in = new_fvec(n), *raw = new_fvec(n), *filtered = new_fvec(n);
+  fvec_t *raw2 = new_fvec(n), *filtered2 = new_fvec(n);
+  for (int hop = 1; hop < 20; hop++)
+  {
+    Hop(in, hop, rng);
+    CHECK(ledfx_melbank_do(m, in, raw, filtered) == 0);
+  }
+  ledfx_melbank_reset(m);
+  CHECK(ledfx_melbank_get_gain(m) == 0.f);
+  for (int hop = 1; hop < 5; hop++)
+  {
+    Hop(in, hop, rng);
+    CHECK(ledfx_melbank_do(m, in, raw, filtered) == 0);
+    CHECK(ledfx_melbank_do(fresh, in, raw2, filtered2) == 0);
+    for (uint_t i = 0; i < n; i++)
+      CHECK(raw->data[i] == raw2->data[i] &&
+            filtered->data[i] == filtered2->data[i]);
+  }
+  del_fvec(filtered2);
+  del_fvec(raw2);
+  del_fvec(filtered);
+  del_fvec(raw);
+  del_fvec(in);
+  del_ledfx_melbank(fresh);
+  del_ledfx_melbank(m);
+  return 0;
+}
+
+// Buffers shorter than the melbank are refused and leave the state alone.
+static int test_bad_parameters()
+{
+  CHECK(new_ledfx_melbank(0, 2.f) == NULL);
+  ledfx_melbank_t *m = new_ledfx_melbank(24, 2.f);
+  CHECK(m);
+  fvec_t *in = new_fvec(24), *raw = new_fvec(24), *short_out = new_fvec(23);
+  fvec_ones(in);
+  CHECK(ledfx_melbank_do(m, in, raw, short_out) != 0);
+  CHECK(ledfx_melbank_do(m, in, short_out, raw) != 0);
+  CHECK(ledfx_melbank_get_gain(m) == 0.f);
+  del_fvec(short_out);
+  del_fvec(raw);
+  del_fvec(in);
+  del_ledfx_melbank(m);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_matches_reference();
+  failures += test_reset();
+  failures += test_bad_parameters();
+  return failures;
+}
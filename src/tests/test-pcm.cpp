@@ -0,0 +1,203 @@
+// Checks that the PCM sink downmixes and reframes blocks of any size and
+// channel count into dated hops, flags silence and dropped hops, and hands
+// a synthetic producer thread's stream over to a consumer intact.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+// 20 us per frame, so that timestamps are exact.
+static const uint_t kRate = 50000;
+static const uint_t kHop = 256;
+
+// Sample |c| of frame |i|, small integers so that averages are exact.
+static float Sample(uint_t i, uint_t c, uint_t channels)
+{
+  return (float)(i % 1000) + 2.f * c - (float)(channels - 1);
+}
+
+// Pushes |frames| frames starting at frame |first| of the stream, dated as
+// if the stream started at 1 s.
+static uint_t Push(ledfx_pcm_t *pcm, uint_t first, uint_t frames,
+                   uint_t channels)
+{
+  std::vector<float> block((size_t)frames * channels);
+  for (uint_t i = 0; i < frames; i++)
+    for (uint_t c = 0; c < channels; c++)
+      block[(size_t)i * channels + c] = Sample(first + i, c, channels);
+  return ledfx_pcm_push(pcm, block.data(), frames, channels,
+                        1000000ULL + 20ULL * first);
+}
+
+// Blocks of odd sizes, cut across hop boundaries, give the mono stream in
+// hops dated from their first sample.
+static int test_reframe()
+{
+  const uint_t channel_counts[] = {1, 2, 6};
+  for (uint_t channels : channel_counts)
+  {
+    ledfx_pcm_t *pcm = new_ledfx_pcm(kHop, kRate, 64);
+    CHECK(pcm);
+    const uint_t sizes[] = {100, 333, 7, 480, 1, 256, 1024, 13};
+    uint_t first = 0;
+    for (uint_t size : sizes)
+    {
+      CHECK(Push(pcm, first, size, channels) == 0);
+      first += size;
+    }
+    CHECK(ledfx_pcm_get_n_hops(pcm) == first / kHop);
+    CHECK(ledfx_pcm_get_n_queued(pcm) == first / kHop);
+
+    fvec_t *hop = new_fvec(kHop);
+    unsigned long long timestamp = 0;
+    uint_t flags = 99;
+    for (uint_t h = 0; h < first / kHop; h++)
+    {
+      CHECK(ledfx_pcm_pop(pcm, hop, &timestamp, &flags) == 1);
+      CHECK(timestamp == 1000000ULL + 20ULL * h * kHop);
+      CHECK(flags == 0);
+      for (uint_t j = 0; j < kHop; j++)
+        CHECK(hop->data[j] == (smpl_t)((h * kHop + j) % 1000));
+    }
+    CHECK(ledfx_pcm_pop(pcm, hop, &timestamp, &flags) == 0);
+    CHECK(ledfx_pcm_get_n_dropped(pcm) == 0);
+    del_fvec(hop);
+    del_ledfx_pcm(pcm);
+  }
+  return 0;
+}
+
+// NULL blocks are silence; a hop is flagged silent only if all of it is.
+// Unknown timestamps stay unknown.
+static int test_silence()
+{
+  ledfx_pcm_t *pcm = new_ledfx_pcm(kHop, kRate, 8);
+  fvec_t *hop = new_fvec(kHop);
+  unsigned long long timestamp = 1;
+  uint_t flags = 0;
+  CHECK(ledfx_pcm_push(pcm, NULL, kHop + kHop / 2, 2, 0) == 0);
+  std::vector<float> ones(kHop, 1.f);
+  CHECK(ledfx_pcm_push(pcm, ones.data(), kHop / 2, 1, 0) == 0);
+
+  CHECK(ledfx_pcm_pop(pcm, hop, &timestamp, &flags) == 1);
+  CHECK(flags == LEDFX_PCM_SILENT && timestamp == 0);
+  CHECK(hop->data[0] == 0. && hop->data[kHop - 1] == 0.);
+  CHECK(ledfx_pcm_pop(pcm, hop, &timestamp, &flags) == 1);
+  CHECK(flags == 0 && timestamp == 0);
+  CHECK(hop->data[0] == 0. && hop->data[kHop - 1] == 1.);
+  del_fvec(hop);
+  del_ledfx_pcm(pcm);
+  return 0;
+}
+
+// A full queue drops its oldest hops, and the next hop taken says so.
+static int test_overflow()
+{
+  ledfx_pcm_t *pcm = new_ledfx_pcm(kHop, kRate, 4);
+  fvec_t *hop = new_fvec(kHop);
+  unsigned long long timestamp = 0;
+  uint_t flags = 0;
+  CHECK(Push(pcm, 0, 10 * kHop, 2) == 0);
+  CHECK(ledfx_pcm_get_n_hops(pcm) == 10);
+  CHECK(ledfx_pcm_get_n_queued(pcm) == 4);
+  CHECK(ledfx_pcm_get_n_dropped(pcm) == 6);
+
+  CHECK(ledfx_pcm_pop(pcm, hop, &timestamp, &flags) == 1);
+  CHECK(flags == LEDFX_PCM_DISCONTINUITY);
+  CHECK(timestamp == 1000000ULL + 20ULL * 6 * kHop);
+  CHECK(hop->data[0] == (smpl_t)(6 * kHop % 1000));
+  CHECK(ledfx_pcm_pop(pcm, hop, NULL, &flags) == 1);
+  CHECK(flags == 0);
+
+  // Reset drops the queue and the partial hop.
+  CHECK(Push(pcm, 10 * kHop, kHop / 2, 2) == 0);
+  ledfx_pcm_reset(pcm);
+  CHECK(ledfx_pcm_get_n_queued(pcm) == 0);
+  CHECK(Push(pcm, 20 * kHop, kHop, 2) == 0);
+  CHECK(ledfx_pcm_pop(pcm, hop, &timestamp, NULL) == 1);
+  CHECK(timestamp == 1000000ULL + 20ULL * 20 * kHop);
+  del_fvec(hop);
+  del_ledfx_pcm(pcm);
+  return 0;
+}
+
+static int test_invalid()
+{
+  CHECK(!new_ledfx_pcm(0, kRate, 4));
+  CHECK(!new_ledfx_pcm(kHop, 0, 4));
+  CHECK(!new_ledfx_pcm(kHop, kRate, 0));
+
+  ledfx_pcm_t *pcm = new_ledfx_pcm(kHop, kRate, 4);
+  CHECK(ledfx_pcm_get_hop_size(pcm) == kHop);
+  float frame[LEDFX_PCM_MAX_CHANNELS + 1] = {0};
+  CHECK(ledfx_pcm_push(pcm, frame, 1, 0, 0) != 0);
+  CHECK(ledfx_pcm_push(pcm, frame, 1, LEDFX_PCM_MAX_CHANNELS + 1, 0) != 0);
+  CHECK(ledfx_pcm_push(pcm, frame, 0, 2, 0) == 0);
+  CHECK(Push(pcm, 0, kHop, 1) == 0);
+  fvec_t *wrong = new_fvec(kHop / 2);
+  CHECK(ledfx_pcm_pop(pcm, wrong, NULL, NULL) == 0);
+  CHECK(ledfx_pcm_get_n_queued(pcm) == 1);
+  del_fvec(wrong);
+  del_ledfx_pcm(pcm);
+  return 0;
+}
+
+// A synthetic capture thread pushes stereo blocks of random sizes while the
+// analysis thread takes hops: the stream arrives whole and in order.
+static int test_producer()
+{
+  const uint_t kHops = 2000;
+  ledfx_pcm_t *pcm = new_ledfx_pcm(kHop, kRate, kHops);
+  std::thread producer(
+      [pcm]
+      {
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<uint_t> size(1, 3 * kHop);
+        uint_t first = 0;
+        while (first < kHops * kHop)
+        {
+          uint_t frames = std::min(size(rng), kHops * kHop - first);
+          Push(pcm, first, frames, 2);
+          first += frames;
+        }
+      });
+
+  fvec_t *hop = new_fvec(kHop);
+  unsigned long long timestamp = 0;
+  uint_t flags = 0, taken = 0, bad = 0;
+  while (taken < kHops)
+  {
+    if (!ledfx_pcm_pop(pcm, hop, &timestamp, &flags))
+    {
+      std::this_thread::yield();
+      continue;
+    }
+    bad += flags != 0;
+    bad += timestamp != 1000000ULL + 20ULL * taken * kHop;
+    for (uint_t j = 0; j < kHop; j++)
+      bad += hop->data[j] != (smpl_t)((taken * kHop + j) % 1000);
+    taken++;
+  }
+  producer.join();
+  CHECK(bad == 0);
+  CHECK(ledfx_pcm_get_n_dropped(pcm) == 0);
+  del_fvec(hop);
+  del_ledfx_pcm(pcm);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_reframe();
+  failures += test_silence();
+  failures += test_overflow();
+  failures += test_invalid();
+  failures += test_producer();
+  return failures;
+}
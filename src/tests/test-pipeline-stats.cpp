@@ -0,0 +1,124 @@
+// Unit tests for the latency histograms of ledfx::PipelineStats.
+
+#include "pipeline_stats.h"
+#include "test_utils.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using ledfx::LatencyHistogram;
+
+static bool Near(int64_t value, int64_t expected)
+{
+  return std::llabs(value - expected) <= expected / 32 + 1;
+}
+
+static int test_buckets()
+{
+  // Every value lands in a bucket whose range holds it, and buckets grow.
+  uint64_t last_floor = 0;
+  for (size_t b = 1; b < LatencyHistogram::kBuckets; b++)
+  {
+    const uint64_t floor = LatencyHistogram::BucketFloor(b);
+    CHECK(floor > last_floor);
+    CHECK(LatencyHistogram::BucketOf(floor) == b);
+    CHECK(LatencyHistogram::BucketOf(floor - 1) == b - 1);
+    last_floor = floor;
+  }
+  for (uint64_t v = 0; v < 16; v++)
+    CHECK(LatencyHistogram::BucketOf(v) == v);
+  CHECK(LatencyHistogram::BucketOf(~uint64_t{0}) == LatencyHistogram::kBuckets - 1);
+  return 0;
+}
+
+static int test_percentiles()
+{
+  LatencyHistogram histogram;
+  CHECK(histogram.Summary().count == 0);
+  CHECK(histogram.Summary().p99_us == 0);
+
+  // 1..10000 us, once each.
+  for (int64_t v = 1; v <= 10000; v++)
+    histogram.Record(v);
+  ledfx::LatencySummary summary = histogram.Summary();
+  CHECK(summary.count == 10000);
+  CHECK(summary.max_us == 10000);
+  CHECK(summary.mean_us == 5000);
+  CHECK(Near(summary.p50_us, 5000));
+  CHECK(Near(summary.p99_us, 9900));
+
+  // A single outlier moves the max but not the median.
+  histogram.Record(2000000);
+  summary = histogram.Summary();
+  CHECK(summary.max_us == 2000000);
+  CHECK(Near(summary.p50_us, 5000));
+
+  // Negative latencies (clock skew) count as 0.
+  histogram.Reset();
+  histogram.Record(-5);
+  summary = histogram.Summary();
+  CHECK(summary.count == 1);
+  CHECK(summary.max_us == 0 && summary.p50_us == 0);
+  return 0;
+}
+
+static int test_pipeline()
+{
+  ledfx::PipelineStats stats;
+  stats.Record(ledfx::PipelineStage::kQueued, 1000, 3500);
+  stats.Record(ledfx::PipelineStage::kQueued, 0, 3500); // unknown capture time
+  stats.Record(ledfx::PipelineStage::kSubmitted, 1000, 41000);
+  stats.Record(static_cast<ledfx::PipelineStage>(17), 1000, 2000);
+
+  CHECK(stats.Summary(ledfx::PipelineStage::kQueued).count == 1);
+  CHECK(stats.Summary(ledfx::PipelineStage::kQueued).max_us == 2500);
+  CHECK(stats.Summary(ledfx::PipelineStage::kSent).count == 0);
+  CHECK(Near(stats.Summary(ledfx::PipelineStage::kSubmitted).p50_us, 40000));
+  CHECK(stats.Summary(static_cast<ledfx::PipelineStage>(17)).count == 0);
+  CHECK(std::string(ledfx::PipelineStageName(ledfx::PipelineStage::kAnalysed)) == "analysed");
+
+  stats.Reset();
+  CHECK(stats.Summary(ledfx::PipelineStage::kSubmitted).count == 0);
+
+  // The clock moves forward, in microseconds.
+  const int64_t t0 = ledfx::NowMicros();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const int64_t elapsed = ledfx::NowMicros() - t0;
+  CHECK(elapsed >= 19000 && elapsed < 2000000);
+  return 0;
+}
+
+static int test_concurrent_record()
+{
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 100000;
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++)
+  {
+    threads.emplace_back([&histogram, t]
+                         {
+      for (int i = 0; i < kPerThread; i++)
+        histogram.Record(t * 1000 + i % 1000); });
+  }
+  for (auto &thread : threads)
+    thread.join();
+  const ledfx::LatencySummary summary = histogram.Summary();
+  CHECK(summary.count == kThreads * kPerThread);
+  CHECK(summary.max_us == (kThreads - 1) * 1000 + 999);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_buckets();
+  failures += test_percentiles();
+  failures += test_pipeline();
+  failures += test_concurrent_record();
+  return failures;
+}
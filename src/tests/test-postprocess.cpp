@@ -0,0 +1,163 @@
+// Checks the native effect post-processing against the flip, mirror,
+// brightness and blur of the Dart Effect.getPixels it replaces.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using Strip = std::vector<std::vector<double>>; // n pixels x 3
+
+// Effect.getPixels with gaussianKernel1d and convolveSame.
+static Strip Reference(Strip pixels, bool flip, bool mirror, double brightness,
+                       double blur)
+{
+  const size_t n = pixels.size();
+  if (flip)
+    std::reverse(pixels.begin(), pixels.end());
+  if (mirror)
+  {
+    Strip mirrored(pixels.rbegin(), pixels.rend());
+    mirrored.insert(mirrored.end(), pixels.begin(), pixels.end());
+    for (size_t i = 0; i < n; i++)
+      for (int c = 0; c < 3; c++)
+        pixels[i][c] = std::max(mirrored[2 * i][c], mirrored[2 * i + 1][c]);
+  }
+  for (auto &row : pixels)
+    for (auto &v : row)
+      v *= brightness;
+  if (blur != 0 && n > 3)
+  {
+    const double sigma = std::max(0.00001, blur);
+    int radius = std::max(1, (int)std::round(4.0 * sigma));
+    radius = std::min((int)(n - 1) / 2, radius);
+    radius = std::max(radius, 1);
+    std::vector<double> kernel;
+    double sum = 0.;
+    for (int x = -radius; x <= radius; x++)
+    {
+      kernel.push_back(std::exp(-0.5 * x * x / (sigma * sigma)));
+      sum += kernel.back();
+    }
+    for (auto &k : kernel)
+      k /= sum;
+    Strip blurred(n, std::vector<double>(3, 0.));
+    for (size_t i = 0; i < n; i++)
+      for (int j = 0; j < (int)kernel.size(); j++)
+      {
+        const long index = (long)i - radius + j;
+        if (index >= 0 && index < (long)n)
+          for (int c = 0; c < 3; c++)
+            blurred[i][c] += pixels[index][c] * kernel[kernel.size() - 1 - j];
+      }
+    pixels = blurred;
+  }
+  return pixels;
+}
+
+static Strip RandomStrip(std::mt19937 &rng, size_t n)
+{
+  std::uniform_real_distribution<double> dist(0., 255.);
+  Strip strip(n, std::vector<double>(3));
+  for (auto &row : strip)
+    for (auto &v : row)
+      v = (float)dist(rng);
+  return strip;
+}
+
+static void Pack(const Strip &strip, fvec_t *v)
+{
+  for (size_t i = 0; i < strip.size(); i++)
+    for (int c = 0; c < 3; c++)
+      v->data[3 * i + c] = (smpl_t)strip[i][c];
+}
+
+static int test_matches_reference()
+{
+  std::mt19937 rng(7);
+  for (uint_t n : {1u, 2u, 3u, 4u, 7u, 8u, 60u, 301u})
+  {
+    ledfx_postprocess_t *p = new_ledfx_postprocess(n);
+    CHECK(p != nullptr);
+    fvec_t *in = new_fvec(3 * n), *out = new_fvec(3 * n);
+    for (int flip = 0; flip < 2; flip++)
+      for (int mirror = 0; mirror < 2; mirror++)
+        for (double blur : {0., 0.5, 1., 3.})
+        {
+          const Strip strip = RandomStrip(rng, n);
+          const Strip expected = Reference(strip, flip, mirror, .7, blur);
+          ledfx_postprocess_set_flip(p, flip);
+          ledfx_postprocess_set_mirror(p, mirror);
+          ledfx_postprocess_set_brightness(p, .7);
+          CHECK(ledfx_postprocess_set_blur(p, blur) == 0);
+
+          Pack(strip, in);
+          CHECK(ledfx_postprocess_do(p, in, out) == 0);
+          for (uint_t i = 0; i < n; i++)
+            for (int c = 0; c < 3; c++)
+              CHECK(std::fabs(out->data[3 * i + c] - expected[i][c]) < 1e-2);
+
+          // In place gives the same result.
+          CHECK(ledfx_postprocess_do(p, in, in) == 0);
+          for (uint_t i = 0; i < 3 * n; i++)
+            CHECK(in->data[i] == out->data[i]);
+        }
+    del_fvec(in);
+    del_fvec(out);
+    del_ledfx_postprocess(p);
+  }
+  return 0;
+}
+
+// Wide blurs run as box filters: within a few percent of the Gaussian on
+// bars of full brightness.
+static int test_wide_blur()
+{
+  const uint_t n = 10000;
+  Strip strip(n, std::vector<double>(3));
+  for (uint_t i = 0; i < n; i++)
+    for (int c = 0; c < 3; c++)
+      strip[i][c] = (i / (50 + 20 * c)) % 2 ? 255. : 0.;
+  ledfx_postprocess_t *p = new_ledfx_postprocess(n);
+  fvec_t *in = new_fvec(3 * n), *out = new_fvec(3 * n);
+  for (double blur : {4., 10., 40.})
+  {
+    const Strip expected = Reference(strip, false, false, 1., blur);
+    CHECK(ledfx_postprocess_set_blur(p, blur) == 0);
+    Pack(strip, in);
+    CHECK(ledfx_postprocess_do(p, in, out) == 0);
+    for (uint_t i = 0; i < n; i++)
+      for (int c = 0; c < 3; c++)
+        CHECK(std::fabs(out->data[3 * i + c] - expected[i][c]) < 6.);
+  }
+  CHECK(ledfx_postprocess_set_blur(p, -1.) != 0);
+  del_fvec(in);
+  del_fvec(out);
+  del_ledfx_postprocess(p);
+  return 0;
+}
+
+static int test_lengths()
+{
+  CHECK(new_ledfx_postprocess(0) == nullptr);
+  ledfx_postprocess_t *p = new_ledfx_postprocess(4);
+  fvec_t *short_in = new_fvec(11), *out = new_fvec(12);
+  CHECK(ledfx_postprocess_do(p, short_in, out) != 0);
+  del_fvec(short_in);
+  del_fvec(out);
+  del_ledfx_postprocess(p);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_matches_reference();
+  failures += test_wide_blur();
+  failures += test_lengths();
+  return failures;
+}
@@ -0,0 +1,193 @@
+// Checks that the worker pool runs every task of a batch exactly once, and
+// that rendering virtuals on it gives the same device pixels as rendering
+// them one after the other, including virtuals sharing a device.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+struct Counts
+{
+  std::vector<std::atomic<uint_t>> runs;
+  explicit Counts(uint_t n) : runs(n) {}
+};
+
+static void Count(void *data, uint_t i)
+{
+  Counts *counts = (Counts *)data;
+  // Uneven tasks, so that some are stolen.
+  volatile uint_t spin = 0;
+  for (uint_t k = 0; k < (i % 7) * 1000; k++)
+    spin = spin + k;
+  counts->runs[i]++;
+}
+
+static int test_pool()
+{
+  for (uint_t n_threads : {0u, 1u, 3u, 8u})
+  {
+    ledfx_pool_t *p = new_ledfx_pool(n_threads);
+    CHECK(p != nullptr);
+    CHECK(ledfx_pool_get_n_threads(p) == n_threads);
+    for (uint_t n : {0u, 1u, 7u, 100u, (uint_t)LEDFX_POOL_MAX_TASKS})
+    {
+      Counts counts(n);
+      // Back to back batches reuse the deques.
+      for (uint_t batch = 0; batch < 20; batch++)
+        CHECK(ledfx_pool_run(p, Count, &counts, n) == 0);
+      for (uint_t i = 0; i < n; i++)
+        CHECK(counts.runs[i] == 20);
+    }
+    if (n_threads == 0)
+      CHECK(ledfx_pool_get_n_stolen(p) == 0);
+    std::printf("pool: %u threads, %u tasks stolen\n", n_threads,
+                ledfx_pool_get_n_stolen(p));
+
+    // Too many tasks runs none of them.
+    Counts counts(LEDFX_POOL_MAX_TASKS + 1);
+    CHECK(ledfx_pool_run(p, Count, &counts, LEDFX_POOL_MAX_TASKS + 1) != 0);
+    for (auto &runs : counts.runs)
+      CHECK(runs == 0);
+    del_ledfx_pool(p);
+  }
+  CHECK(new_ledfx_pool(LEDFX_POOL_MAX_THREADS + 1) == nullptr);
+  return 0;
+}
+
+static void Fill(fvec_t *v, std::mt19937 &rng)
+{
+  // Some values out of 0..255, for the clamp.
+  std::uniform_real_distribution<float> value(-50.f, 300.f);
+  for (uint_t k = 0; k < v->length; k++)
+    v->data[k] = value(rng);
+}
+
+static int test_render()
+{
+  const uint_t n_virtuals = 12, n_pixels = 60, n_device = 200;
+  std::mt19937 rng(1);
+
+  // Virtuals 0 to 3 overlap on device 0, each writing from pixel 20 v, so
+  // that the order they are written in shows. Virtuals 4 and 5 share
+  // device 1 and no pixel. The others each have a device of their own.
+  std::vector<fvec_t *> devices, expected_devices;
+  for (uint_t d = 0; d < n_virtuals; d++)
+  {
+    devices.push_back(new_fvec(3 * n_device));
+    expected_devices.push_back(new_fvec(3 * n_device));
+  }
+  std::vector<ledfx_postprocess_t *> posts;
+  std::vector<ledfx_mapping_t *> mappings;
+  std::vector<fvec_t *> frames, expected_frames;
+  std::vector<uint_t> device_of;
+  for (uint_t v = 0; v < n_virtuals; v++)
+  {
+    ledfx_postprocess_t *post = new_ledfx_postprocess(n_pixels);
+    ledfx_postprocess_set_flip(post, v % 2);
+    ledfx_postprocess_set_mirror(post, v % 3 == 0);
+    ledfx_postprocess_set_brightness(post, 0.5 + 0.05 * v);
+    CHECK(ledfx_postprocess_set_blur(post, 0.5 * (v % 4)) == 0);
+    posts.push_back(post);
+
+    const uint_t device = v < 4 ? 0 : v < 6 ? 1 : v;
+    const uint_t first = v < 4 ? 20 * v : v < 6 ? 70 * (v - 4) : 0;
+    const uint_t segment[LEDFX_MAPPING_SEGMENT_LEN] = {
+        0, first, first + n_pixels - 1, v % 2};
+    ledfx_mapping_t *m = new_ledfx_mapping(LEDFX_MAPPING_SPAN, n_pixels,
+                                           n_pixels, n_device, 1, 0,
+                                           segment, 1);
+    CHECK(m != nullptr);
+    mappings.push_back(m);
+    device_of.push_back(device);
+    frames.push_back(new_fvec(3 * n_pixels));
+    expected_frames.push_back(new_fvec(3 * n_pixels));
+  }
+
+  std::vector<ledfx_render_t *> renders, expected_renders;
+  for (uint_t v = 0; v < n_virtuals; v++)
+  {
+    renders.push_back(new_ledfx_render());
+    expected_renders.push_back(new_ledfx_render());
+  }
+
+  for (uint_t n_threads : {0u, 2u, 5u})
+  {
+    ledfx_pool_t *p = new_ledfx_pool(n_threads);
+    CHECK(p != nullptr);
+    for (uint_t tick = 0; tick < 10; tick++)
+    {
+      for (uint_t v = 0; v < n_virtuals; v++)
+      {
+        Fill(frames[v], rng);
+        fvec_copy(frames[v], expected_frames[v]);
+        CHECK(ledfx_render_set_frame(renders[v], posts[v], frames[v]) == 0);
+        CHECK(ledfx_render_add_target(renders[v], mappings[v],
+                                      devices[device_of[v]]) == 0);
+        CHECK(ledfx_render_get_n_targets(renders[v]) == 1);
+        CHECK(ledfx_render_set_frame(expected_renders[v], posts[v],
+                                     expected_frames[v]) == 0);
+        CHECK(ledfx_render_add_target(expected_renders[v], mappings[v],
+                                      expected_devices[device_of[v]]) == 0);
+      }
+      // Post-processing keeps nothing from one frame to the next, so
+      // both sets of renders can share it.
+      for (uint_t v = 0; v < n_virtuals; v++)
+        CHECK(ledfx_render_do(expected_renders[v]) == 0);
+      CHECK(ledfx_render_run(p, renders.data(), n_virtuals) == 0);
+
+      for (uint_t v = 0; v < n_virtuals; v++)
+        for (uint_t k = 0; k < 3 * n_pixels; k++)
+        {
+          CHECK(frames[v]->data[k] == expected_frames[v]->data[k]);
+          CHECK(frames[v]->data[k] >= 0.f && frames[v]->data[k] <= 255.f);
+        }
+      for (uint_t d = 0; d < n_virtuals; d++)
+        for (uint_t k = 0; k < 3 * n_device; k++)
+          CHECK(devices[d]->data[k] == expected_devices[d]->data[k]);
+    }
+    del_ledfx_pool(p);
+  }
+
+  // A frame not matching its post-processing or its mapping is refused,
+  // and a render left without a frame stops the whole batch.
+  fvec_t *wrong = new_fvec(3 * n_pixels + 3);
+  CHECK(ledfx_render_set_frame(renders[0], posts[0], wrong) != 0);
+  CHECK(ledfx_render_do(renders[0]) != 0);
+  CHECK(ledfx_render_set_frame(renders[0], nullptr, wrong) == 0);
+  CHECK(ledfx_render_add_target(renders[0], mappings[0], devices[0]) != 0);
+  CHECK(ledfx_render_set_frame(renders[0], posts[0], frames[0]) == 0);
+  CHECK(ledfx_render_add_target(renders[0], mappings[0], wrong) != 0);
+  CHECK(ledfx_render_get_n_targets(renders[0]) == 0);
+  ledfx_render_t *no_frame = new_ledfx_render();
+  ledfx_render_t *batch[2] = {renders[0], no_frame};
+  ledfx_pool_t *p = new_ledfx_pool(1);
+  CHECK(ledfx_render_run(p, batch, 2) != 0);
+  del_ledfx_pool(p);
+  del_ledfx_render(no_frame);
+  del_fvec(wrong);
+
+  for (uint_t v = 0; v < n_virtuals; v++)
+  {
+    del_ledfx_render(renders[v]);
+    del_ledfx_render(expected_renders[v]);
+    del_fvec(frames[v]);
+    del_fvec(expected_frames[v]);
+    del_ledfx_mapping(mappings[v]);
+    del_ledfx_postprocess(posts[v]);
+    del_fvec(devices[v]);
+    del_fvec(expected_devices[v]);
+  }
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_pool();
+  failures += test_render();
+  return failures;
+}
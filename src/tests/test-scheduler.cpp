@@ -0,0 +1,228 @@
+// Checks that the output scheduler paces a device at its refresh rate on
+// the loopback interface, accounts for every deadline, sends only the
+// latest of the frames submitted between two deadlines, and rejects
+// invalid outputs.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+// Receives packets until none arrives for the listener's timeout.
+static std::vector<std::vector<unsigned char>> Drain(int listener)
+{
+  std::vector<std::vector<unsigned char>> received;
+  std::vector<unsigned char> packet(2048);
+  for (;;)
+  {
+    const ssize_t r = recv(listener, packet.data(), packet.size(), 0);
+    if (r <= 0)
+      return received;
+    received.emplace_back(packet.begin(), packet.begin() + r);
+  }
+}
+
+// A device submitted to far faster than its rate is sent one frame per
+// deadline, and every deadline is either reached or counted as missed.
+static int test_pacing()
+{
+  uint_t port;
+  const int listener = OpenListener(port, 200000);
+  CHECK(listener >= 0);
+  ledfx_udp_t *u = new_ledfx_udp("127.0.0.1", port);
+  CHECK(u != nullptr);
+  const uint_t n = 10;
+  ledfx_ddp_t *d = new_ledfx_ddp(n);
+  fvec_t *rgb = new_fvec(3 * n);
+  ledfx_scheduler_t *s = new_ledfx_scheduler();
+  CHECK(s != nullptr);
+
+  const smpl_t rate = 200;
+  const auto start = Clock::now();
+  const sint_t output = ledfx_scheduler_add_ddp(s, d, u, rate);
+  CHECK(output >= 0);
+  while (Clock::now() - start < std::chrono::milliseconds(500))
+  {
+    CHECK(ledfx_scheduler_submit(s, output, rgb) == 0);
+    std::this_thread::sleep_for(std::chrono::microseconds(500));
+  }
+  const uint_t ticks = ledfx_scheduler_get_n_ticks(s, output);
+  const uint_t frames = ledfx_scheduler_get_n_frames(s, output);
+  const uint_t missed = ledfx_scheduler_get_n_missed(s, output);
+  const smpl_t jitter_mean = ledfx_scheduler_get_jitter_mean_ms(s, output);
+  const smpl_t jitter_max = ledfx_scheduler_get_jitter_max_ms(s, output);
+  const double elapsed =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  CHECK(ledfx_scheduler_remove(s, output) == 0);
+  std::printf("pacing: %u ticks, %u frames, %u missed in %.3f s, "
+              "jitter mean %.3f ms, max %.3f ms\n",
+              ticks, frames, missed, elapsed, jitter_mean, jitter_max);
+
+  // Deadlines are absolute: no drift from the wakeup latency.
+  const double expected = elapsed * rate;
+  CHECK(std::fabs(ticks + missed - expected) <= 2 + 0.02 * expected);
+  CHECK(frames <= ticks && frames + 2 >= ticks);
+  CHECK(jitter_mean >= 0 && jitter_max >= jitter_mean);
+  CHECK(jitter_mean < 1000 / rate);
+  CHECK(Drain(listener).size() ==
+        frames * ledfx_ddp_get_n_packets(d));
+
+  // Removed outputs take no frames.
+  CHECK(ledfx_scheduler_submit(s, output, rgb) != 0);
+  CHECK(ledfx_scheduler_remove(s, output) != 0);
+  CHECK(ledfx_scheduler_get_n_ticks(s, output) == 0);
+
+  del_ledfx_scheduler(s);
+  del_fvec(rgb);
+  del_ledfx_ddp(d);
+  del_ledfx_udp(u);
+  close(listener);
+  return 0;
+}
+
+// Frames submitted between two deadlines replace each other, and nothing
+// is sent without a new frame.
+static int test_latest()
+{
+  uint_t port;
+  const int listener = OpenListener(port, 200000);
+  CHECK(listener >= 0);
+  ledfx_udp_t *u = new_ledfx_udp("127.0.0.1", port);
+  CHECK(u != nullptr);
+  const uint_t n = 4;
+  ledfx_wled_t *w = new_ledfx_wled(LEDFX_WLED_DRGB, n);
+  fvec_t *rgb = new_fvec(3 * n);
+  ledfx_scheduler_t *s = new_ledfx_scheduler();
+  CHECK(s != nullptr);
+
+  const sint_t output = ledfx_scheduler_add_wled(s, w, u, 4, 0);
+  CHECK(output >= 0);
+  // Let the first deadline go by without a frame.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  for (uint_t f = 1; f <= 3; f++)
+  {
+    for (uint_t k = 0; k < 3 * n; k++)
+      rgb->data[k] = (smpl_t)(10 * f);
+    CHECK(ledfx_scheduler_submit(s, output, rgb) == 0);
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  const auto received = Drain(listener);
+  CHECK(received.size() == 1);
+  CHECK(received[0].size() == 2 + 3 * n);
+  for (uint_t k = 0; k < 3 * n; k++)
+    CHECK(received[0][2 + k] == 30);
+  CHECK(ledfx_scheduler_get_n_frames(s, output) == 1);
+  CHECK(ledfx_scheduler_get_n_ticks(s, output) >= 2);
+
+  del_ledfx_scheduler(s);
+  del_fvec(rgb);
+  del_ledfx_wled(w);
+  del_ledfx_udp(u);
+  close(listener);
+  return 0;
+}
+
+// Skip counters of a WLED output, read while the thread sends.
+static int test_skipped()
+{
+  uint_t port;
+  const int listener = OpenListener(port, 200000);
+  CHECK(listener >= 0);
+  ledfx_udp_t *u = new_ledfx_udp("127.0.0.1", port);
+  CHECK(u != nullptr);
+  const uint_t n = 4;
+  ledfx_wled_t *w = new_ledfx_wled(LEDFX_WLED_DRGB, n);
+  ledfx_ddp_t *d = new_ledfx_ddp(n);
+  fvec_t *rgb = new_fvec(3 * n);
+  for (uint_t k = 0; k < 3 * n; k++)
+    rgb->data[k] = 20;
+  ledfx_scheduler_t *s = new_ledfx_scheduler();
+  CHECK(s != nullptr);
+
+  // Whole frames only every 10 s: the same frame again is left out.
+  const sint_t output = ledfx_scheduler_add_wled(s, w, u, 20, 10);
+  CHECK(output >= 0);
+  const sint_t ddp = ledfx_scheduler_add_ddp(s, d, u, 20);
+  CHECK(ddp >= 0);
+  for (int f = 0; f < 3; f++)
+  {
+    CHECK(ledfx_scheduler_submit(s, output, rgb) == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  CHECK(ledfx_scheduler_get_n_frames(s, output) == 3);
+  CHECK(ledfx_scheduler_get_n_skipped_packets(s, output) == 2);
+  CHECK(ledfx_scheduler_get_n_skipped_bytes(s, output) == 2 * (2 + 3 * n));
+  CHECK(Drain(listener).size() == 1);
+  CHECK(ledfx_scheduler_get_n_skipped_packets(s, ddp) == 0);
+  CHECK(ledfx_scheduler_get_n_skipped_bytes(s, LEDFX_SCHEDULER_MAX_OUTPUTS) == 0);
+
+  CHECK(ledfx_scheduler_remove(s, output) == 0);
+  CHECK(ledfx_scheduler_get_n_skipped_packets(s, output) == 0);
+  CHECK(ledfx_wled_get_n_skipped_packets(w) == 2);
+
+  del_ledfx_scheduler(s);
+  del_fvec(rgb);
+  del_ledfx_ddp(d);
+  del_ledfx_wled(w);
+  del_ledfx_udp(u);
+  close(listener);
+  return 0;
+}
+
+static int test_invalid()
+{
+  ledfx_udp_t *u = new_ledfx_udp("127.0.0.1", 9);
+  CHECK(u != nullptr);
+  ledfx_ddp_t *d = new_ledfx_ddp(8);
+  ledfx_scheduler_t *s = new_ledfx_scheduler();
+  CHECK(s != nullptr);
+
+  CHECK(ledfx_scheduler_add_ddp(s, d, u, 0) < 0);
+  CHECK(ledfx_scheduler_add_ddp(s, d, u, LEDFX_SCHEDULER_MAX_RATE + 1) < 0);
+  CHECK(ledfx_scheduler_add_ddp(s, d, u, NAN) < 0);
+  CHECK(ledfx_scheduler_add_ddp(s, nullptr, u, 60) < 0);
+  CHECK(ledfx_scheduler_add_ddp(s, d, nullptr, 60) < 0);
+  CHECK(ledfx_scheduler_add_wled(s, nullptr, u, 60, 0) < 0);
+
+  const sint_t output = ledfx_scheduler_add_ddp(s, d, u, 60);
+  CHECK(output >= 0);
+  fvec_t *wrong = new_fvec(3 * 8 + 1);
+  CHECK(ledfx_scheduler_submit(s, output, wrong) != 0);
+  CHECK(ledfx_scheduler_remove(s, LEDFX_SCHEDULER_MAX_OUTPUTS) != 0);
+
+  // Slots are reused once full.
+  for (uint_t i = 1; i < LEDFX_SCHEDULER_MAX_OUTPUTS; i++)
+    CHECK(ledfx_scheduler_add_ddp(s, d, u, 60) >= 0);
+  CHECK(ledfx_scheduler_add_ddp(s, d, u, 60) < 0);
+  CHECK(ledfx_scheduler_remove(s, output) == 0);
+  CHECK(ledfx_scheduler_add_ddp(s, d, u, 60) == output);
+
+  // Deleting the scheduler leaves the encoders and senders alone.
+  del_ledfx_scheduler(s);
+  del_fvec(wrong);
+  del_ledfx_ddp(d);
+  del_ledfx_udp(u);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_pacing();
+  failures += test_latest();
+  failures += test_skipped();
+  failures += test_invalid();
+  return failures;
+}
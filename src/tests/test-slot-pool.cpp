@@ -0,0 +1,163 @@
+// Unit and stress tests for ledfx::SlotPool.
+
+#include "slot_pool.h"
+#include "test_utils.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Pool = ledfx::SlotPool<std::vector<int>>;
+
+static int test_acquire_release()
+{
+  Pool pool(2);
+  CHECK(pool.Capacity() == 2);
+
+  const Pool::Handle a = pool.Acquire();
+  const Pool::Handle b = pool.Acquire();
+  CHECK(a != Pool::kInvalidHandle && b != Pool::kInvalidHandle && a != b);
+  CHECK(pool.InUse() == 2);
+  CHECK(pool.Acquire() == Pool::kInvalidHandle);
+  CHECK(pool.Exhausted() == 1);
+
+  pool.Get(a)->assign(4, 7);
+  CHECK(pool.Get(a)->size() == 4);
+  CHECK(pool.Release(a));
+  CHECK(pool.InUse() == 1);
+
+  // Released handles are stale, even once the slot is reused.
+  CHECK(pool.Get(a) == nullptr);
+  CHECK(!pool.Release(a));
+  const Pool::Handle c = pool.Acquire();
+  CHECK(c != Pool::kInvalidHandle && c != a);
+  CHECK(pool.Get(a) == nullptr);
+  CHECK(!pool.Release(a));
+
+  // The payload is reused as is: no reallocation once it has grown.
+  CHECK(pool.Get(c)->capacity() >= 4);
+
+  CHECK(pool.Get(Pool::kInvalidHandle) == nullptr);
+  CHECK(!pool.Release(Pool::kInvalidHandle));
+  CHECK(pool.Get(0xffffffffull) == nullptr);
+  CHECK(pool.Release(b) && pool.Release(c));
+  CHECK(pool.InUse() == 0);
+  return 0;
+}
+
+// Several producers post handles to one consumer through a queue, as the
+// capture and COM threads post messages to the UI thread, while a thief
+// thread acquires and releases directly to add contention on the free stack.
+static int test_stress()
+{
+  constexpr int kProducers = 4;
+  constexpr int kPerProducer = 100000;
+  constexpr size_t kPayload = 32;
+  Pool pool(16);
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<Pool::Handle> queue;
+  bool done = false;
+
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++)
+  {
+    producers.emplace_back([&, p]
+                           {
+      for (int i = 0; i < kPerProducer; i++)
+      {
+        Pool::Handle handle;
+        while ((handle = pool.Acquire()) == Pool::kInvalidHandle)
+          std::this_thread::yield();
+        std::vector<int> *payload = pool.Get(handle);
+        payload->assign(kPayload, p * kPerProducer + i);
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          queue.push_back(handle);
+        }
+        cv.notify_one();
+      } });
+  }
+
+  std::atomic<bool> stop_thief{false};
+  std::thread thief([&]
+                    {
+    while (!stop_thief.load())
+    {
+      const Pool::Handle handle = pool.Acquire();
+      if (handle != Pool::kInvalidHandle)
+        pool.Release(handle);
+    } });
+
+  long received = 0, corrupt = 0, stale = 0;
+  std::vector<int> next(kProducers, 0);
+  long out_of_order = 0;
+  std::thread consumer([&]
+                       {
+    for (;;)
+    {
+      Pool::Handle handle;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return !queue.empty() || done; });
+        if (queue.empty())
+          return;
+        handle = queue.front();
+        queue.pop_front();
+      }
+      std::vector<int> *payload = pool.Get(handle);
+      if (!payload)
+      {
+        stale++;
+        continue;
+      }
+      const int value = payload->empty() ? -1 : (*payload)[0];
+      for (int v : *payload)
+        corrupt += v != value;
+      corrupt += payload->size() != kPayload;
+      const int producer = value / kPerProducer;
+      if (producer < 0 || producer >= kProducers || value % kPerProducer != next[producer]++)
+        out_of_order++;
+      if (!pool.Release(handle))
+        stale++;
+      received++;
+    } });
+
+  for (auto &t : producers)
+    t.join();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done = true;
+  }
+  cv.notify_one();
+  consumer.join();
+  stop_thief = true;
+  thief.join();
+
+  CHECK(received == kProducers * kPerProducer);
+  CHECK(corrupt == 0);
+  CHECK(stale == 0);
+  CHECK(out_of_order == 0);
+  CHECK(pool.InUse() == 0);
+
+  // Every slot made it back to the free stack.
+  std::vector<Pool::Handle> all;
+  for (uint32_t i = 0; i < pool.Capacity(); i++)
+    all.push_back(pool.Acquire());
+  for (Pool::Handle handle : all)
+    CHECK(handle != Pool::kInvalidHandle);
+  CHECK(pool.Acquire() == Pool::kInvalidHandle);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_acquire_release();
+  failures += test_stress();
+  return failures;
+}
@@ -0,0 +1,136 @@
+// Unit and stress tests for ledfx::SpscRingBuffer.
+
+#include "spsc_ring_buffer.h"
+#include "test_utils.h"
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+static int test_capacity_rounding()
+{
+  ledfx::SpscRingBuffer<float> ring(1000);
+  CHECK(ring.Capacity() == 1024);
+  CHECK(ring.WriteAvailable() == 1024);
+  CHECK(ring.ReadAvailable() == 0);
+  return 0;
+}
+
+static int test_wrap_and_spans()
+{
+  ledfx::SpscRingBuffer<int> ring(8);
+  int in[6] = {0, 1, 2, 3, 4, 5};
+  int out[8] = {};
+
+  CHECK(ring.Push(in, 6) == 6);
+  CHECK(ring.Pop(out, 4) == 4);
+  CHECK(out[0] == 0 && out[3] == 3);
+
+  // Next write wraps: 2 slots at the end, 4 at the start.
+  auto spans = ring.WriteSpans(6);
+  CHECK(spans.size() == 6);
+  CHECK(spans.first.size == 2);
+  CHECK(spans.second.size == 4);
+  for (size_t i = 0; i < spans.first.size; i++)
+    spans.first.data[i] = 10 + static_cast<int>(i);
+  for (size_t i = 0; i < spans.second.size; i++)
+    spans.second.data[i] = 12 + static_cast<int>(i);
+  ring.CommitWrite(spans.size());
+
+  CHECK(ring.ReadAvailable() == 8);
+  auto read = ring.ReadSpans(8);
+  CHECK(read.size() == 8);
+  CHECK(read.first.data[0] == 4);
+  ring.CommitRead(2);
+  CHECK(ring.Pop(out, 8) == 6);
+  for (int i = 0; i < 6; i++)
+    CHECK(out[i] == 10 + i);
+  return 0;
+}
+
+static int test_reject_block_policy()
+{
+  ledfx::SpscRingBuffer<float> ring(8, ledfx::OverflowPolicy::kRejectBlock);
+  float block[6] = {};
+  CHECK(ring.Push(block, 6) == 6);
+  CHECK(ring.Push(block, 6) == 0);
+  CHECK(ring.PushFill(0.0f, 2) == 2);
+
+  auto stats = ring.Stats();
+  CHECK(stats.pushed == 8);
+  CHECK(stats.dropped == 6);
+  CHECK(stats.overflows == 1);
+  CHECK(stats.high_water == 8);
+  return 0;
+}
+
+static int test_drop_incoming_policy()
+{
+  ledfx::SpscRingBuffer<float> ring(8, ledfx::OverflowPolicy::kDropIncoming);
+  float block[6] = {1, 2, 3, 4, 5, 6};
+  float out[8] = {};
+  CHECK(ring.Push(block, 6) == 6);
+  CHECK(ring.Push(block, 6) == 2);
+  CHECK(ring.Pop(out, 8) == 8);
+  CHECK(out[6] == 1.0f && out[7] == 2.0f);
+
+  auto stats = ring.Stats();
+  CHECK(stats.popped == 8);
+  CHECK(stats.dropped == 4);
+  CHECK(stats.overflows == 1);
+  return 0;
+}
+
+// One producer pushes a counting sequence in odd-sized blocks while one
+// consumer pops in differently sized blocks and verifies ordering.
+static int test_stress()
+{
+  const uint32_t total = 2000000;
+  ledfx::SpscRingBuffer<uint32_t> ring(4096, ledfx::OverflowPolicy::kDropIncoming);
+
+  std::thread producer([&]()
+                       {
+    std::vector<uint32_t> block(733);
+    uint32_t next = 0;
+    while (next < total)
+    {
+      size_t count = std::min<size_t>(block.size(), total - next);
+      count = std::min(count, ring.WriteAvailable());
+      for (size_t i = 0; i < count; i++)
+        block[i] = next + static_cast<uint32_t>(i);
+      next += static_cast<uint32_t>(ring.Push(block.data(), count));
+    } });
+
+  std::vector<uint32_t> out(1021);
+  uint32_t expected = 0;
+  bool ordered = true;
+  while (expected < total)
+  {
+    size_t n = ring.Pop(out.data(), out.size());
+    for (size_t i = 0; i < n; i++)
+    {
+      ordered = ordered && (out[i] == expected);
+      expected++;
+    }
+  }
+  producer.join();
+
+  CHECK(ordered);
+  auto stats = ring.Stats();
+  CHECK(stats.pushed == total);
+  CHECK(stats.popped == total);
+  CHECK(stats.dropped == 0);
+  CHECK(stats.high_water <= ring.Capacity());
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_capacity_rounding();
+  failures += test_wrap_and_spans();
+  failures += test_reject_block_policy();
+  failures += test_drop_incoming_policy();
+  failures += test_stress();
+  return failures;
+}
@@ -0,0 +1,167 @@
+// Tests for ledfx::StreamResampler against libsamplerate.
+
+#include "stream_resampler.h"
+#include "test_utils.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// A 48 kHz device feeding the 30 kHz analysis rate at 60 hops per second.
+constexpr double kDeviceRate = 48000.0;
+constexpr double kMicRate = 30000.0;
+constexpr size_t kHop = 500;
+// Irregular block lengths, as WASAPI hands out.
+constexpr size_t kBlocks[] = {441, 480, 13, 1024, 1, 960, 333, 480, 2000, 7};
+
+static std::vector<float> Sine(size_t frames, size_t channels)
+{
+  std::vector<float> out(frames * channels);
+  for (size_t i = 0; i < frames; i++)
+  {
+    const float v = 0.5f * std::sin(2.0 * 3.14159265358979 * 440.0 * i / kDeviceRate);
+    for (size_t c = 0; c < channels; c++)
+      out[i * channels + c] = v;
+  }
+  return out;
+}
+
+static int test_hops_match_one_shot()
+{
+  const size_t channels = 2, frames = 48000;
+  const std::vector<float> input = Sine(frames, channels);
+
+  ledfx::StreamResampler resampler(kDeviceRate, kMicRate, channels, kHop);
+  CHECK(resampler.Ok());
+
+  std::vector<float> streamed;
+  bool sizes_ok = true, positions_ok = true;
+  size_t pos = 0, block = 0;
+  while (pos < frames)
+  {
+    const size_t n = std::min(kBlocks[block++ % 10], frames - pos);
+    resampler.Push(input.data() + pos * channels, n,
+                   [&](const float *hop, size_t hop_frames)
+                   {
+                     sizes_ok = sizes_ok && hop_frames == kHop;
+                     // Each hop starts where the output so far ends, before
+                     // the end of the input fed
+                     const double start = streamed.size() * kDeviceRate / kMicRate;
+                     positions_ok = positions_ok &&
+                                    std::fabs(resampler.HopInputPosition() - start) < 1e-6 &&
+                                    resampler.HopInputPosition() < resampler.InputFrames();
+                     streamed.insert(streamed.end(), hop, hop + hop_frames);
+                   });
+    pos += n;
+  }
+  CHECK(sizes_ok);
+  CHECK(positions_ok);
+  CHECK(resampler.InputFrames() == frames);
+
+  // Everything but the converter delay and a partial hop comes out.
+  const double expected = frames * kMicRate / kDeviceRate;
+  const double produced = static_cast<double>(streamed.size() + resampler.Pending());
+  CHECK(produced <= expected + 1.0);
+  CHECK(produced >= expected - 2.0 * kHop);
+
+  // The same signal converted in one call: block edges must not show.
+  std::vector<float> mono(frames), reference(frames);
+  for (size_t i = 0; i < frames; i++)
+    mono[i] = input[i * channels];
+  int error = 0;
+  SRC_STATE *state = src_new(SRC_SINC_FASTEST, 1, &error);
+  CHECK(state != nullptr);
+  SRC_DATA data = {};
+  data.data_in = mono.data();
+  data.input_frames = static_cast<long>(frames);
+  data.data_out = reference.data();
+  data.output_frames = static_cast<long>(reference.size());
+  data.src_ratio = kMicRate / kDeviceRate;
+  CHECK(src_process(state, &data) == 0);
+  src_delete(state);
+  CHECK(static_cast<size_t>(data.output_frames_gen) >= streamed.size());
+
+  float max_diff = 0.0f;
+  for (size_t i = 0; i < streamed.size(); i++)
+    max_diff = std::max(max_diff, std::fabs(streamed[i] - reference[i]));
+  CHECK(max_diff < 1e-4f);
+  return 0;
+}
+
+static int test_silence_and_reset()
+{
+  ledfx::StreamResampler resampler(kDeviceRate, kMicRate, 1, kHop);
+  CHECK(resampler.Ok());
+
+  size_t hops = 0;
+  bool silent = true;
+  auto on_hop = [&](const float *hop, size_t hop_frames)
+  {
+    hops++;
+    for (size_t i = 0; i < hop_frames; i++)
+      silent = silent && hop[i] == 0.0f;
+  };
+  for (int i = 0; i < 100; i++)
+    resampler.PushSilence(480, on_hop);
+  CHECK(hops >= 55 && hops <= 60);
+  CHECK(silent);
+
+  resampler.Reset();
+  CHECK(resampler.Pending() == 0);
+  CHECK(resampler.InputFrames() == 0);
+  CHECK(resampler.HopInputPosition() == 0.0);
+  return 0;
+}
+
+static int test_bypass()
+{
+  ledfx::StreamResampler resampler(kMicRate, kMicRate, 2, 7);
+  CHECK(resampler.Ok());
+
+  std::vector<float> input(2 * 23), out;
+  for (size_t i = 0; i < 23; i++)
+  {
+    input[2 * i] = static_cast<float>(i);
+    input[2 * i + 1] = static_cast<float>(i) + 1.0f;
+  }
+  size_t hops = 0;
+  std::vector<double> starts;
+  auto on_hop = [&](const float *hop, size_t hop_frames)
+  {
+    starts.push_back(resampler.HopInputPosition());
+    out.insert(out.end(), hop, hop + hop_frames);
+  };
+  hops += resampler.Push(input.data(), 3, on_hop);
+  hops += resampler.Push(input.data() + 2 * 3, 5, on_hop);
+  hops += resampler.Push(input.data() + 2 * 8, 15, on_hop);
+
+  CHECK(hops == 3);
+  CHECK(out.size() == 21);
+  CHECK(resampler.Pending() == 2);
+  CHECK(resampler.InputFrames() == 23);
+  CHECK(starts.size() == 3 && starts[0] == 0.0 && starts[1] == 7.0 && starts[2] == 14.0);
+  for (size_t i = 0; i < out.size(); i++)
+    CHECK(out[i] == static_cast<float>(i) + 0.5f);
+  return 0;
+}
+
+static int test_bad_rates()
+{
+  ledfx::StreamResampler resampler(0.0, kMicRate, 1, kHop);
+  CHECK(!resampler.Ok());
+  size_t calls = 0;
+  const float x[4] = {};
+  CHECK(resampler.Push(x, 4, [&](const float *, size_t) { calls++; }) == 0);
+  CHECK(calls == 0);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_hops_match_one_shot();
+  failures += test_silence_and_reset();
+  failures += test_bypass();
+  failures += test_bad_rates();
+  return failures;
+}
@@ -0,0 +1,214 @@
+// Unit and stress tests for ledfx::TaskQueue.
+
+#include "task_queue.h"
+#include "test_utils.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Tasks run in order, and move-only closures are accepted and run once.
+static int test_order()
+{
+  ledfx::TaskQueue queue;
+  std::vector<int> ran;
+  bool wake = false;
+  for (int i = 0; i < 10; i++)
+  {
+    auto value = std::make_unique<int>(i);
+    queue.Push([&ran, value = std::move(value)] { ran.push_back(*value); },
+               &wake);
+  }
+  CHECK(queue.Drain(100, &wake) == 10);
+  CHECK(!wake);
+  CHECK(ran.size() == 10);
+  for (int i = 0; i < 10; i++)
+    CHECK(ran[i] == i);
+  CHECK(queue.Drain(100, &wake) == 0);
+  CHECK(!wake);
+  CHECK(queue.Stats().queued == 10 && queue.Stats().run == 10);
+  return 0;
+}
+
+// A burst asks for one wakeup, and the next one comes after a drain.
+static int test_wakeups()
+{
+  ledfx::TaskQueue queue;
+  int wakeups = 0;
+  for (int i = 0; i < 100; i++)
+  {
+    bool wake = false;
+    queue.Push([] {}, &wake);
+    wakeups += wake;
+  }
+  CHECK(wakeups == 1);
+
+  bool wake = false;
+  CHECK(queue.Drain(1000, &wake) == 100);
+  queue.Push([] {}, &wake);
+  CHECK(wake);
+
+  // A wakeup that could not be delivered is asked for again.
+  queue.WakeupFailed();
+  queue.Push([] {}, &wake);
+  CHECK(wake);
+  CHECK(queue.Stats().wakeups == 3);
+  return 0;
+}
+
+// Drain() stops after its batch and asks for a wakeup for the rest.
+static int test_batches()
+{
+  ledfx::TaskQueue queue;
+  int ran = 0;
+  bool wake = false;
+  for (int i = 0; i < 10; i++)
+    queue.Push([&ran] { ran++; }, &wake);
+  CHECK(queue.Drain(4, &wake) == 4 && wake);
+  CHECK(ran == 4);
+  // That wakeup is pending, so pushing does not ask for another one.
+  queue.Push([&ran] { ran++; }, &wake);
+  CHECK(!wake);
+  CHECK(queue.Drain(4, &wake) == 4 && wake);
+  CHECK(queue.Drain(4, &wake) == 3 && !wake);
+  CHECK(ran == 11);
+
+  // A batch that ends exactly on the last task asks for nothing.
+  queue.Push([&ran] { ran++; }, &wake);
+  CHECK(queue.Drain(1, &wake) == 1 && !wake);
+  return 0;
+}
+
+// Tasks may queue tasks while the queue is being drained.
+static int test_reentrant()
+{
+  ledfx::TaskQueue queue;
+  std::vector<int> ran;
+  bool wake = false;
+  queue.Push(
+      [&]
+      {
+        ran.push_back(1);
+        bool inner_wake = false;
+        queue.Push([&] { ran.push_back(2); }, &inner_wake);
+        // The drain cleared the pending wakeup before running this task.
+        if (!inner_wake)
+          ran.push_back(-1);
+      },
+      &wake);
+  CHECK(queue.Drain(10, &wake) == 2);
+  CHECK(ran.size() == 2 && ran[0] == 1 && ran[1] == 2);
+  return 0;
+}
+
+// Tasks left in the queue are destroyed with it, without running.
+static int test_destroy()
+{
+  auto alive = std::make_shared<int>(0);
+  int ran = 0;
+  {
+    ledfx::TaskQueue queue;
+    bool wake = false;
+    for (int i = 0; i < 5; i++)
+      queue.Push([alive, &ran] { ran++; }, &wake);
+    CHECK(alive.use_count() == 6);
+    CHECK(queue.Drain(2, &wake) == 2);
+    CHECK(alive.use_count() == 4);
+  }
+  CHECK(alive.use_count() == 1);
+  CHECK(ran == 2);
+  return 0;
+}
+
+// Several producers and a consumer woken by messages, as on the platform
+// thread: every task runs once, each producer's in order, and at most one
+// wakeup is ever outstanding.
+static int test_stress()
+{
+  constexpr int kProducers = 4;
+  constexpr int kTasks = 100000;
+  constexpr size_t kBatch = 64;
+  ledfx::TaskQueue queue;
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  int pending_wakeups = 0;
+  long bad_wakeups = 0;
+
+  auto post_wakeup = [&]
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_wakeups++;
+    cv.notify_one();
+  };
+
+  std::vector<int> last(kProducers, -1);
+  long ran = 0, bad_order = 0;
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++)
+    producers.emplace_back(
+        [&, p]
+        {
+          for (int i = 0; i < kTasks; i++)
+          {
+            bool wake = false;
+            queue.Push(
+                [&, p, i]
+                {
+                  bad_order += i != last[p] + 1;
+                  last[p] = i;
+                  ran++;
+                },
+                &wake);
+            if (wake)
+              post_wakeup();
+          }
+        });
+
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (ran < static_cast<long>(kProducers) * kTasks)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      // A lost wakeup would stall here until the deadline.
+      if (!cv.wait_until(lock, deadline, [&] { return pending_wakeups > 0; }))
+        break;
+      bad_wakeups += pending_wakeups > 1;
+      pending_wakeups = 0;
+    }
+    bool wake = false;
+    CHECK(queue.Drain(kBatch, &wake) <= kBatch);
+    if (wake)
+      post_wakeup();
+  }
+  for (auto &producer : producers)
+    producer.join();
+
+  const ledfx::TaskQueueStats stats = queue.Stats();
+  std::printf("stress: %ld tasks in %llu drains, %llu wakeups\n", ran,
+              (unsigned long long)stats.drains,
+              (unsigned long long)stats.wakeups);
+  CHECK(ran == static_cast<long>(kProducers) * kTasks);
+  CHECK(bad_order == 0);
+  CHECK(bad_wakeups == 0);
+  CHECK(stats.queued == stats.run);
+  CHECK(stats.wakeups < stats.queued);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_order();
+  failures += test_wakeups();
+  failures += test_batches();
+  failures += test_reentrant();
+  failures += test_destroy();
+  failures += test_stress();
+  return failures;
+}
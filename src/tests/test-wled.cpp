@@ -0,0 +1,226 @@
+// Checks the WLED realtime encoder packets for all three protocols, that a
+// frame split over DNRGB packets arrives on the loopback interface, and that
+// unchanged packets are left out.
+
+#include "ledfx.h"
+#include "test_utils.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+static smpl_t Value(uint_t k) { return (smpl_t)((k * 37) % 300) - 20.f; }
+
+static unsigned char Byte(smpl_t v)
+{
+  return v >= 255 ? 255 : (v > 0 ? (unsigned char)v : 0);
+}
+
+// Checks one frame of packets against the strip filled with Value().
+static int CheckFrame(uint_t protocol, const unsigned char *const *packets,
+                      const uint_t *lengths, uint_t n_packets, uint_t n,
+                      uint_t timeout)
+{
+  const uint_t header = protocol == LEDFX_WLED_DNRGB ? 4 : 2;
+  const uint_t stride = protocol == LEDFX_WLED_WARLS ? 4 : 3;
+  uint_t led = 0;
+  for (uint_t i = 0; i < n_packets; i++)
+  {
+    const unsigned char *p = packets[i];
+    CHECK(p[0] == protocol);
+    CHECK(p[1] == timeout);
+    CHECK((lengths[i] - header) % stride == 0);
+    const uint_t count = (lengths[i] - header) / stride;
+    if (protocol == LEDFX_WLED_DNRGB)
+    {
+      CHECK(((uint_t)p[2] << 8 | p[3]) == led);
+      CHECK(count == std::min<uint_t>(LEDFX_WLED_DNRGB_PIXELS, n - led));
+    }
+    for (uint_t j = 0; j < count; j++, led++)
+    {
+      const unsigned char *rgb = p + header + stride * j;
+      if (protocol == LEDFX_WLED_WARLS)
+        CHECK(*rgb++ == led);
+      for (uint_t c = 0; c < 3; c++)
+        CHECK(rgb[c] == Byte(Value(3 * led + c)));
+    }
+  }
+  CHECK(led == n);
+  return 0;
+}
+
+static int test_packets()
+{
+  const struct
+  {
+    uint_t protocol, n, n_packets;
+  } kCases[] = {
+      {LEDFX_WLED_WARLS, 1, 1},   {LEDFX_WLED_WARLS, 255, 1},
+      {LEDFX_WLED_DRGB, 1, 1},    {LEDFX_WLED_DRGB, 490, 1},
+      {LEDFX_WLED_DNRGB, 1, 1},   {LEDFX_WLED_DNRGB, 489, 1},
+      {LEDFX_WLED_DNRGB, 490, 2}, {LEDFX_WLED_DNRGB, 1500, 4},
+  };
+  for (const auto &c : kCases)
+  {
+    ledfx_wled_t *w = new_ledfx_wled(c.protocol, c.n);
+    CHECK(w != nullptr);
+    CHECK(ledfx_wled_get_protocol(w) == c.protocol);
+    CHECK(ledfx_wled_get_n_pixels(w) == c.n);
+    CHECK(ledfx_wled_get_n_packets(w) == c.n_packets);
+    fvec_t *rgb = new_fvec(3 * c.n);
+    for (uint_t k = 0; k < 3 * c.n; k++)
+      rgb->data[k] = Value(k);
+    // NaN is sent as 0; the first red byte follows the header, and the
+    // index byte with WARLS.
+    const uint_t red = c.protocol == LEDFX_WLED_DNRGB   ? 4
+                       : c.protocol == LEDFX_WLED_WARLS ? 3
+                                                        : 2;
+    rgb->data[0] = NAN;
+    CHECK(ledfx_wled_do(w, rgb) == 0);
+    CHECK(ledfx_wled_get_packets(w)[0][red] == 0);
+    rgb->data[0] = Value(0);
+    CHECK(ledfx_wled_do(w, rgb) == 0);
+    CHECK(CheckFrame(c.protocol, ledfx_wled_get_packets(w),
+                     ledfx_wled_get_lengths(w), c.n_packets, c.n, 1) == 0);
+    // The timeout is rewritten in place and kept by later frames.
+    CHECK(ledfx_wled_set_timeout(w, LEDFX_WLED_TIMEOUT_FOREVER) == 0);
+    CHECK(ledfx_wled_get_timeout(w) == LEDFX_WLED_TIMEOUT_FOREVER);
+    CHECK(ledfx_wled_do(w, rgb) == 0);
+    CHECK(CheckFrame(c.protocol, ledfx_wled_get_packets(w),
+                     ledfx_wled_get_lengths(w), c.n_packets, c.n,
+                     LEDFX_WLED_TIMEOUT_FOREVER) == 0);
+    CHECK(ledfx_wled_set_timeout(w, 0) != 0);
+    CHECK(ledfx_wled_set_timeout(w, 256) != 0);
+    CHECK(ledfx_wled_get_timeout(w) == LEDFX_WLED_TIMEOUT_FOREVER);
+    del_fvec(rgb);
+    del_ledfx_wled(w);
+  }
+
+  CHECK(new_ledfx_wled(LEDFX_WLED_WARLS, 256) == nullptr);
+  CHECK(new_ledfx_wled(LEDFX_WLED_DRGB, 491) == nullptr);
+  CHECK(new_ledfx_wled(LEDFX_WLED_DNRGB, 0) == nullptr);
+  CHECK(new_ledfx_wled(3, 10) == nullptr);
+  ledfx_wled_t *w = new_ledfx_wled(LEDFX_WLED_DRGB, 4);
+  fvec_t *rgb = new_fvec(11);
+  CHECK(ledfx_wled_do(w, rgb) != 0);
+  del_fvec(rgb);
+  del_ledfx_wled(w);
+  return 0;
+}
+
+static int test_send()
+{
+  uint_t port;
+  const int listener = OpenListener(port, 2000000);
+  CHECK(listener >= 0);
+
+  ledfx_udp_t *u = new_ledfx_udp("127.0.0.1", port);
+  CHECK(u != nullptr);
+  const uint_t n = 1200; // 3 packets
+  ledfx_wled_t *w = new_ledfx_wled(LEDFX_WLED_DNRGB, n);
+  const uint_t n_packets = ledfx_wled_get_n_packets(w);
+  fvec_t *rgb = new_fvec(3 * n);
+  for (uint_t k = 0; k < 3 * n; k++)
+    rgb->data[k] = Value(k);
+  CHECK(ledfx_wled_do(w, rgb) == 0);
+  CHECK(ledfx_wled_send(w, u) == n_packets);
+
+  std::vector<std::vector<unsigned char>> received;
+  std::vector<const unsigned char *> packets;
+  std::vector<uint_t> lengths;
+  std::vector<unsigned char> packet(2048);
+  for (uint_t i = 0; i < n_packets; i++)
+  {
+    const ssize_t r = recv(listener, packet.data(), packet.size(), 0);
+    CHECK(r > 0);
+    received.emplace_back(packet.begin(), packet.begin() + r);
+  }
+  for (const auto &p : received)
+  {
+    packets.push_back(p.data());
+    lengths.push_back((uint_t)p.size());
+  }
+  CHECK(CheckFrame(LEDFX_WLED_DNRGB, packets.data(), lengths.data(),
+                   n_packets, n, 1) == 0);
+
+  del_fvec(rgb);
+  del_ledfx_wled(w);
+  del_ledfx_udp(u);
+  close(listener);
+  return 0;
+}
+
+// Only packets whose bytes changed since they were last sent go out.
+static int test_send_changed()
+{
+  uint_t port;
+  const int listener = OpenListener(port, 2000000);
+  CHECK(listener >= 0);
+  ledfx_udp_t *u = new_ledfx_udp("127.0.0.1", port);
+  CHECK(u != nullptr);
+
+  const uint_t n = 1200; // 489 + 489 + 222 LEDs
+  ledfx_wled_t *w = new_ledfx_wled(LEDFX_WLED_DNRGB, n);
+  const uint_t *lengths = ledfx_wled_get_lengths(w);
+  fvec_t *rgb = new_fvec(3 * n);
+  for (uint_t k = 0; k < 3 * n; k++)
+    rgb->data[k] = Value(k);
+
+  std::vector<unsigned char> packet(2048);
+  auto receive_start = [&]() -> int {
+    const ssize_t r = recv(listener, packet.data(), packet.size(), 0);
+    return r > 4 ? packet[2] << 8 | packet[3] : -1;
+  };
+
+  // The first frame goes out whole.
+  CHECK(ledfx_wled_do(w, rgb) == 0);
+  CHECK(ledfx_wled_send_changed(w, u, 0) == 3);
+  for (uint_t i = 0; i < 3; i++)
+    CHECK(receive_start() == (int)(i * LEDFX_WLED_DNRGB_PIXELS));
+
+  // An identical frame sends nothing.
+  CHECK(ledfx_wled_do(w, rgb) == 0);
+  CHECK(ledfx_wled_send_changed(w, u, 0) == 0);
+  CHECK(ledfx_wled_get_n_skipped_packets(w) == 3);
+  CHECK(ledfx_wled_get_n_skipped_bytes(w) ==
+        lengths[0] + lengths[1] + lengths[2]);
+
+  // Changing a LED of the second packet only resends that packet; a change
+  // below one byte is not one.
+  rgb->data[3 * 600 + 1] = 1.f;
+  rgb->data[3 * 1100] = Value(3 * 1100) + 0.25f;
+  CHECK(ledfx_wled_do(w, rgb) == 0);
+  CHECK(ledfx_wled_send_changed(w, u, 0) == 1);
+  CHECK(receive_start() == LEDFX_WLED_DNRGB_PIXELS);
+  CHECK(ledfx_wled_get_n_skipped_packets(w) == 5);
+
+  // Keepalives and the timeout byte resend everything.
+  CHECK(ledfx_wled_send_changed(w, u, 1) == 3);
+  CHECK(ledfx_wled_set_timeout(w, 2) == 0);
+  CHECK(ledfx_wled_send_changed(w, u, 0) == 3);
+  CHECK(ledfx_wled_send(w, u) == 3);
+  CHECK(ledfx_wled_get_n_skipped_packets(w) == 5);
+  CHECK(ledfx_udp_get_n_sent(u) == 13);
+
+  del_fvec(rgb);
+  del_ledfx_wled(w);
+  del_ledfx_udp(u);
+  close(listener);
+  return 0;
+}
+
+int main()
+{
+  int failures = 0;
+  failures += test_packets();
+  failures += test_send();
+  failures += test_send_changed();
+  return failures;
+}
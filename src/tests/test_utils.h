@@ -0,0 +1,57 @@
+// Helpers shared by the ledfx native tests.
+
+#ifndef LEDFX_TEST_UTILS_H_
+#define LEDFX_TEST_UTILS_H_
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+#include <cstdio>
+
+// Fails the calling test, which returns 1, when |cond| is false.
+#define CHECK(cond)                                                    \
+  do                                                                   \
+  {                                                                    \
+    if (!(cond))                                                       \
+    {                                                                  \
+      std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,      \
+                   __LINE__, #cond);                                   \
+      return 1;                                                        \
+    }                                                                  \
+  } while (0)
+
+#ifndef _WIN32
+// UDP socket bound to a free loopback port, returned in |port|, whose
+// receives time out after |timeout_us|; -1 on failure. A non-zero |rcvbuf|
+// asks for a receive buffer of that many bytes.
+static inline int OpenListener(unsigned int &port, long timeout_us,
+                               int rcvbuf = 0)
+{
+  const int listener = socket(AF_INET, SOCK_DGRAM, 0);
+  if (listener < 0)
+    return -1;
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  if (bind(listener, (sockaddr *)&addr, sizeof(addr)) != 0 ||
+      getsockname(listener, (sockaddr *)&addr, &addr_len) != 0)
+  {
+    close(listener);
+    return -1;
+  }
+  if (rcvbuf > 0)
+    setsockopt(listener, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  timeval timeout = {timeout_us / 1000000, timeout_us % 1000000};
+  setsockopt(listener, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  port = ntohs(addr.sin_port);
+  return listener;
+}
+#endif
+
+#endif // LEDFX_TEST_UTILS_H_
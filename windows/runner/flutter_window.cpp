@@ -6,6 +6,7 @@
 #include <flutter/event_stream_handler_functions.h>
 #include <windows.h>
 #include <comdef.h>
+#include "pipeline_probe.h"
 #include "utils.h"
 
 FlutterWindow::FlutterWindow(const flutter::DartProject &project)
@@ -159,38 +160,20 @@ LRESULT FlutterWindow::MessageHandler(HWND hwnd, UINT const message, WPARAM cons
 
   case WM_FLUTTER_AUDIO_DATA:
   {
-    auto float_audio_data = reinterpret_cast<std::vector<float> *>(wparam);
-
-    if (event_sink_ && float_audio_data)
-    {
-      // Convert float vector to EncodableList for Flutter
-      flutter::EncodableList audio_data;
-      audio_data.reserve(float_audio_data->size());
-
-      for (float sample : *float_audio_data)
-      {
-        audio_data.push_back(flutter::EncodableValue(static_cast<double>(sample)));
-      }
-
-      std::map<flutter::EncodableValue, flutter::EncodableValue> event_map;
-      event_map[flutter::EncodableValue("type")] = flutter::EncodableValue("audio");
-      event_map[flutter::EncodableValue("data")] = flutter::EncodableValue(audio_data);
-      event_sink_->Success(flutter::EncodableValue(event_map));
-    }
-    {
-      std::lock_guard<std::mutex> lock(events_mutex_);
-      posted_audio_events_.erase(
-          std::remove_if(posted_audio_events_.begin(), posted_audio_events_.end(),
-                         [float_audio_data](const auto &ptr)
-                         { return ptr.get() == float_audio_data; }),
-          posted_audio_events_.end());
-    }
+    // One wakeup for every block queued since the last one; the delivery
+    // policy decides which of them are sent.
+    audio_delivery_.Drain(
+        [this](const AudioHandle *handles, size_t count, bool after_drop)
+        { SendAudioPackets(handles, count, after_drop); },
+        [this](const AudioHandle &handle)
+        { posted_audio_.Release(handle); });
     return 0;
   }
 
   case WM_FLUTTER_STATE_EVENT:
   {
-    auto msg = reinterpret_cast<std::string *>(wparam);
+    const auto handle = static_cast<ledfx::SlotPool<std::string>::Handle>(wparam);
+    std::string *msg = posted_messages_.Get(handle);
     if (event_sink_ && msg)
     {
       std::map<flutter::EncodableValue, flutter::EncodableValue> map{
@@ -198,17 +181,14 @@ LRESULT FlutterWindow::MessageHandler(HWND hwnd, UINT const message, WPARAM cons
           {flutter::EncodableValue("value"), flutter::EncodableValue(*msg)}};
       event_sink_->Success(flutter::EncodableValue(map));
     }
-    posted_state_events_.erase(
-        std::remove_if(posted_state_events_.begin(), posted_state_events_.end(),
-                       [msg](const auto &ptr)
-                       { return ptr.get() == msg; }),
-        posted_state_events_.end());
+    posted_messages_.Release(handle);
     return 0;
   }
 
   case WM_FLUTTER_ERROR_EVENT:
   {
-    auto msg = reinterpret_cast<std::string *>(wparam);
+    const auto handle = static_cast<ledfx::SlotPool<std::string>::Handle>(wparam);
+    std::string *msg = posted_messages_.Get(handle);
     if (event_sink_ && msg)
     {
       std::map<flutter::EncodableValue, flutter::EncodableValue> map{
@@ -216,17 +196,14 @@ LRESULT FlutterWindow::MessageHandler(HWND hwnd, UINT const message, WPARAM cons
           {flutter::EncodableValue("message"), flutter::EncodableValue(*msg)}};
       event_sink_->Success(flutter::EncodableValue(map));
     }
-    posted_error_events_.erase(
-        std::remove_if(posted_error_events_.begin(), posted_error_events_.end(),
-                       [msg](const auto &ptr)
-                       { return ptr.get() == msg; }),
-        posted_error_events_.end());
+    posted_messages_.Release(handle);
     return 0;
   }
 
   case WM_FLUTTER_DEVICES_EVENT:
   {
-    auto data = reinterpret_cast<std::vector<flutter::EncodableValue> *>(wparam);
+    const auto handle = static_cast<ledfx::SlotPool<std::vector<flutter::EncodableValue>>::Handle>(wparam);
+    std::vector<flutter::EncodableValue> *data = posted_devices_.Get(handle);
     if (event_sink_ && data)
     {
       std::map<flutter::EncodableValue, flutter::EncodableValue> map{
@@ -234,11 +211,7 @@ LRESULT FlutterWindow::MessageHandler(HWND hwnd, UINT const message, WPARAM cons
           {flutter::EncodableValue("devices"), flutter::EncodableValue(*data)}};
       event_sink_->Success(flutter::EncodableValue(map));
     }
-    posted_devices_events_.erase(
-        std::remove_if(posted_devices_events_.begin(), posted_devices_events_.end(),
-                       [data](const auto &ptr)
-                       { return ptr.get() == data; }),
-        posted_devices_events_.end());
+    posted_devices_.Release(handle);
     return 0;
   }
   }
@@ -326,6 +299,10 @@ void FlutterWindow::HandleMethodCall(const flutter::MethodCall<flutter::Encodabl
       int sampleRate = getIntArg("sampleRate", 44100);
       int channels = getIntArg("channels", 1);
       int blocksize = getIntArg("blockSize", 0); // 0 means use default
+      // Resample on the capture thread to targetSampleRate and emit hops of
+      // hopSize frames; 0 keeps the device rate and blockSize blocks.
+      int targetSampleRate = getIntArg("targetSampleRate", 0);
+      int hopSize = getIntArg("hopSize", 0);
       std::cout << "sent blockSize: " << blocksize << " frames" << std::endl;
 
       // 4. Start recording
@@ -333,7 +310,8 @@ void FlutterWindow::HandleMethodCall(const flutter::MethodCall<flutter::Encodabl
           deviceIdOpt.value(),
           captureTypeOpt.value(),
           sampleRate,
-          channels, blocksize);
+          channels, blocksize,
+          targetSampleRate, hopSize);
       result->Success();
     }
     catch (const std::exception &e)
@@ -342,6 +320,103 @@ void FlutterWindow::HandleMethodCall(const flutter::MethodCall<flutter::Encodabl
       result->Error("CAPTURE_START_ERROR", "Failed to start capture");
     }
   }
+  else if (method_call.method_name() == "setAudioDeliveryPolicy")
+  {
+    const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments());
+    if (!args)
+    {
+      result->Error("INVALID_ARGUMENTS", "Expected argument map for setAudioDeliveryPolicy");
+      return;
+    }
+    ledfx::DeliveryPolicy policy = audio_delivery_.Policy();
+    auto mode = args->find(flutter::EncodableValue("mode"));
+    if (mode != args->end())
+    {
+      const auto *name = std::get_if<std::string>(&mode->second);
+      if (name && *name == "deliverAll")
+        policy.mode = ledfx::DeliveryMode::kDeliverAll;
+      else if (name && *name == "dropOldest")
+        policy.mode = ledfx::DeliveryMode::kDropOldest;
+      else if (name && *name == "coalesce")
+        policy.mode = ledfx::DeliveryMode::kCoalesce;
+      else
+      {
+        result->Error("INVALID_ARGUMENTS", "mode must be deliverAll, dropOldest or coalesce");
+        return;
+      }
+    }
+    auto max_depth = args->find(flutter::EncodableValue("maxDepth"));
+    if (max_depth != args->end())
+      if (const auto *value = std::get_if<int>(&max_depth->second))
+        policy.max_depth = static_cast<uint32_t>(std::max(*value, 1));
+    auto coalesce = args->find(flutter::EncodableValue("coalesceHops"));
+    if (coalesce != args->end())
+      if (const auto *value = std::get_if<int>(&coalesce->second))
+        policy.coalesce = static_cast<uint32_t>(std::max(*value, 1));
+    audio_delivery_.SetPolicy(policy);
+    result->Success();
+  }
+  else if (method_call.method_name() == "setPcmSink")
+  {
+    // {address: int}, a ledfx_pcm_t created by Dart; 0 detaches the sink
+    int64_t address = 0;
+    if (const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments()))
+    {
+      auto it = args->find(flutter::EncodableValue("address"));
+      if (it != args->end())
+        address = it->second.LongValue();
+    }
+    PcmPushFn push = nullptr;
+    if (address != 0)
+    {
+      // The sink belongs to the native library Dart loaded into this process
+      if (HMODULE library = GetModuleHandleW(L"aubio.dll"))
+        push = reinterpret_cast<PcmPushFn>(GetProcAddress(library, "ledfx_pcm_push"));
+      if (!push)
+      {
+        result->Error("PCM_SINK_UNAVAILABLE", "ledfx_pcm_push not found in aubio.dll");
+        return;
+      }
+    }
+    {
+      // Once this returns the capture thread no longer uses the old sink,
+      // which Dart may then delete
+      std::lock_guard<std::mutex> lock(pcm_lock_);
+      pcm_sink_ = reinterpret_cast<void *>(static_cast<intptr_t>(address));
+      pcm_push_ = push;
+    }
+    result->Success();
+  }
+  else if (method_call.method_name() == "getAudioDeliveryStats")
+  {
+    const ledfx::DeliveryStats stats = audio_delivery_.Stats();
+    flutter::EncodableMap map{
+        {flutter::EncodableValue("queued"), flutter::EncodableValue(static_cast<int64_t>(stats.queued))},
+        {flutter::EncodableValue("messages"), flutter::EncodableValue(static_cast<int64_t>(stats.messages))},
+        {flutter::EncodableValue("delivered"), flutter::EncodableValue(static_cast<int64_t>(stats.delivered))},
+        {flutter::EncodableValue("droppedOldest"), flutter::EncodableValue(static_cast<int64_t>(stats.dropped_oldest))},
+        {flutter::EncodableValue("droppedOverflow"), flutter::EncodableValue(static_cast<int64_t>(stats.dropped_overflow))},
+        {flutter::EncodableValue("coalesced"), flutter::EncodableValue(static_cast<int64_t>(stats.coalesced))},
+        {flutter::EncodableValue("wakeups"), flutter::EncodableValue(static_cast<int64_t>(stats.wakeups))},
+        {flutter::EncodableValue("highWater"), flutter::EncodableValue(static_cast<int64_t>(stats.high_water))}};
+    result->Success(flutter::EncodableValue(std::move(map)));
+  }
+  else if (method_call.method_name() == "getPipelineStats")
+  {
+    // Optional {reset: true} clears the histograms after reading them
+    bool reset = false;
+    if (const auto *args = std::get_if<flutter::EncodableMap>(method_call.arguments()))
+    {
+      auto it = args->find(flutter::EncodableValue("reset"));
+      if (it != args->end())
+        if (const auto *value = std::get_if<bool>(&it->second))
+          reset = *value;
+    }
+    flutter::EncodableMap stats = PipelineStatsToEncodable(GetPipelineStats());
+    if (reset)
+      GetPipelineStats().Reset();
+    result->Success(flutter::EncodableValue(std::move(stats)));
+  }
   else if (method_call.method_name() == "stopRecording")
   {
     try
@@ -369,22 +444,126 @@ void FlutterWindow::OnStreamCancel()
 
   event_sink_ = nullptr;
 }
-// Send audio data (PCM bytes) safely on platform thread
-void FlutterWindow::SendAudioDataEvent(const std::vector<float> &ieee_float_data)
+// Queue one interleaved Float32 block for the platform thread
+void FlutterWindow::SendAudioDataEvent(const float *samples, size_t count, size_t channels,
+                                       uint64_t timestamp_us, uint16_t flags)
 {
   if (!GetHandle())
     return;
 
-  auto audio_copy = std::make_shared<std::vector<float>>(ieee_float_data);
+  // Every block takes a sequence number, so a block dropped here shows up
+  // as a gap on the Dart side.
+  const uint32_t sequence = audio_sequence_++;
+  const AudioHandle handle = posted_audio_.Acquire();
+  if (handle == ledfx::SlotPool<PostedAudioPacket>::kInvalidHandle)
+  {
+    // the platform thread is behind by kPostedAudioSlots blocks
+    audio_delivery_.CountOverflow();
+    audio_dropped_ = true;
+    return;
+  }
+  // Flag the gap on the next block that gets through, as for samples lost
+  // in the capture ring
+  if (audio_dropped_)
+    flags |= ledfx::kAudioPacketFlagDiscontinuity;
+
+  // The slot's vector keeps its capacity, so this stops allocating once
+  // warmed up.
+  PostedAudioPacket *packet = posted_audio_.Get(handle);
+  packet->header.channels = static_cast<uint8_t>(channels);
+  packet->header.flags = flags;
+  packet->header.sequence = sequence;
+  packet->header.timestamp_us = timestamp_us;
+  packet->samples.assign(samples, samples + count);
+
+  GetPipelineStats().Record(ledfx::PipelineStage::kQueued, static_cast<int64_t>(timestamp_us));
+
+  bool wake = false;
+  if (!audio_delivery_.Push(handle, &wake))
+  {
+    posted_audio_.Release(handle);
+    audio_dropped_ = true;
+    return;
+  }
+  audio_dropped_ = false;
+  // Wake the platform thread, unless a wakeup is already on its way
+  if (wake && !PostMessage(GetHandle(), WM_FLUTTER_AUDIO_DATA, 0, 0))
+    audio_delivery_.WakeupFailed();
+}
 
+bool FlutterWindow::PushToPcmSink(const float *samples, size_t frames, size_t channels,
+                                  uint64_t timestamp_us, uint16_t flags)
+{
   {
-    std::lock_guard<std::mutex> lock(events_mutex_);
-    posted_audio_events_.push_back(audio_copy);
+    std::lock_guard<std::mutex> lock(pcm_lock_);
+    if (!pcm_sink_)
+      return false;
+    pcm_push_(pcm_sink_, samples, static_cast<unsigned int>(frames),
+              static_cast<unsigned int>(channels), timestamp_us);
   }
+  // The sink downmixes, frames and dates the hops: Dart only needs to know
+  // that some are waiting
+  SendAudioDataEvent(nullptr, 0, channels, timestamp_us, flags | ledfx::kAudioPacketFlagPcmSink);
+  return true;
+}
+
+// Send queued blocks as one audio event and release their slots. Several
+// blocks are concatenated, described by the header of the first, with the
+// length of each as a third list element (see audio_packet.h).
+void FlutterWindow::SendAudioPackets(const AudioHandle *handles, size_t count, bool after_drop)
+{
+  if (event_sink_)
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+      if (const PostedAudioPacket *packet = posted_audio_.Get(handles[i]))
+        total += packet->samples.size();
+
+    // Copied rather than moved so the slots keep their capacity for reuse.
+    ledfx::AudioPacketHeader header{};
+    std::vector<float> samples;
+    std::vector<int32_t> lengths;
+    samples.reserve(total);
+    for (size_t i = 0; i < count; i++)
+    {
+      const PostedAudioPacket *packet = posted_audio_.Get(handles[i]);
+      if (!packet)
+        continue;
+      if (lengths.empty())
+        header = packet->header;
+      else
+        header.flags |= packet->header.flags;
+      samples.insert(samples.end(), packet->samples.begin(), packet->samples.end());
+      lengths.push_back(static_cast<int32_t>(packet->samples.size()));
+    }
 
-  // Post to main thread
-  PostMessage(GetHandle(), WM_FLUTTER_AUDIO_DATA,
-              reinterpret_cast<WPARAM>(audio_copy.get()), 0);
+    if (!lengths.empty())
+    {
+      if (after_drop)
+        header.flags |= ledfx::kAudioPacketFlagDiscontinuity;
+
+      // Send [header, samples] as a Uint8List and a Float32List so the codec
+      // writes both as single typed blocks instead of boxing every sample.
+      std::vector<uint8_t> header_bytes(ledfx::kAudioPacketHeaderSize);
+      ledfx::WriteAudioPacketHeader(header, header_bytes.data());
+
+      flutter::EncodableList event;
+      event.reserve(3);
+      event.emplace_back(std::move(header_bytes));
+      event.emplace_back(std::move(samples));
+      if (lengths.size() > 1)
+        event.emplace_back(std::move(lengths));
+      event_sink_->Success(flutter::EncodableValue(std::move(event)));
+
+      const int64_t now_us = ledfx::NowMicros();
+      for (size_t i = 0; i < count; i++)
+        if (const PostedAudioPacket *packet = posted_audio_.Get(handles[i]))
+          GetPipelineStats().Record(ledfx::PipelineStage::kSent,
+                                    static_cast<int64_t>(packet->header.timestamp_us), now_us);
+    }
+  }
+  for (size_t i = 0; i < count; i++)
+    posted_audio_.Release(handles[i]);
 }
 
 void FlutterWindow::SendStateEvent(const std::string &state_message)
@@ -392,11 +571,8 @@ void FlutterWindow::SendStateEvent(const std::string &state_message)
   if (!GetHandle())
     return;
 
-  auto msg = std::make_shared<std::string>(state_message);
-  PostMessage(GetHandle(), WM_FLUTTER_STATE_EVENT,
-              reinterpret_cast<WPARAM>(msg.get()), 0);
-
-  posted_state_events_.push_back(msg);
+  if (!PostPayload(posted_messages_, WM_FLUTTER_STATE_EVENT, state_message))
+    std::cerr << "Dropped state event: " << state_message << std::endl;
 }
 
 void FlutterWindow::SendDevicesInfoEvent(const std::vector<flutter::EncodableValue> &devices_info)
@@ -404,11 +580,7 @@ void FlutterWindow::SendDevicesInfoEvent(const std::vector<flutter::EncodableVal
   if (!GetHandle())
     return;
 
-  auto data_copy = std::make_shared<std::vector<flutter::EncodableValue>>(devices_info);
-
-  PostMessage(GetHandle(), WM_FLUTTER_DEVICES_EVENT, reinterpret_cast<WPARAM>(data_copy.get()), 0);
-
-  posted_devices_events_.push_back(data_copy);
+  PostPayload(posted_devices_, WM_FLUTTER_DEVICES_EVENT, devices_info);
 }
 
 void FlutterWindow::SendErrorEvent(const std::string &error_message)
@@ -416,11 +588,8 @@ void FlutterWindow::SendErrorEvent(const std::string &error_message)
   if (!GetHandle())
     return;
 
-  auto msg = std::make_shared<std::string>(error_message);
-  PostMessage(GetHandle(), WM_FLUTTER_ERROR_EVENT,
-              reinterpret_cast<WPARAM>(msg.get()), 0);
-
-  posted_error_events_.push_back(msg);
+  if (!PostPayload(posted_messages_, WM_FLUTTER_ERROR_EVENT, error_message))
+    std::cerr << "Dropped error event: " << error_message << std::endl;
 }
 
 std::vector<flutter::EncodableValue> FlutterWindow::EnumerateAudioDevices()
@@ -557,7 +726,8 @@ std::vector<BYTE> FlutterWindow::GetDeviceFormatBlob(IMMDevice *device)
   return format_data;
 }
 
-void FlutterWindow::StartAudioCapture(const std::string &deviceId, const std::string &captureType, int sampleRate, int channels, int blockSize)
+void FlutterWindow::StartAudioCapture(const std::string &deviceId, const std::string &captureType, int sampleRate, int channels, int blockSize,
+                                      int targetSampleRate, int hopSize)
 {
   StopAudioCapture();
 
@@ -566,6 +736,8 @@ void FlutterWindow::StartAudioCapture(const std::string &deviceId, const std::st
   sample_rate_ = sampleRate;
   channels_ = channels;
   target_blocksize_ = blockSize;
+  target_sample_rate_ = targetSampleRate;
+  hop_size_ = hopSize;
 
   is_capturing_ = true;
   capture_thread_ = std::thread(&FlutterWindow::AudioCaptureThread, this);
@@ -733,7 +905,7 @@ void FlutterWindow::CaptureAudio(IMMDevice *device, bool loopback)
     return;
   }
   // Get actual buffer size that was allocated
-  UINT32 actual_buffer_frame_size;
+  UINT32 actual_buffer_frame_size = 0;
   hr = audio_client_->GetBufferSize(&actual_buffer_frame_size);
   if (SUCCEEDED(hr))
   {
@@ -761,13 +933,40 @@ void FlutterWindow::CaptureAudio(IMMDevice *device, bool loopback)
     return;
   }
 
-  // Clear/Reset ring buffer
+  // Allocate the ring once per session: enough headroom for several device
+  // buffers or target blocks, whichever is larger. The capture loop below is
+  // the only producer and consumer, so nothing here takes a lock.
+  const size_t channel_count = mix_format->nChannels;
+  const size_t ring_frames = std::max(static_cast<size_t>(actual_buffer_frame_size),
+                                      static_cast<size_t>(std::max(target_blocksize_, 0)));
+  audio_ring_ = std::make_unique<ledfx::SpscRingBuffer<float>>(
+      std::max(ring_frames, static_cast<size_t>(1024)) * channel_count * 8);
+  block_buffer_.reserve(ring_frames * channel_count);
+  mono_buffer_.reserve(ring_frames);
+  audio_sequence_ = 0;
+  audio_dropped_ = false;
+  uint64_t dropped_samples = 0;
+
+  // With a target rate, every packet goes straight through the resampler,
+  // which keeps its state across packets and emits exact hops; the ring is
+  // then unused.
+  resampler_.reset();
+  if (target_sample_rate_ > 0 && hop_size_ > 0)
   {
-    std::lock_guard<std::mutex> lock(ring_mutex_);
-    audio_ring_buffer_.clear();
-    audio_ring_buffer_.shrink_to_fit(); // optional
-    ring_capacity_ = 0;
-    ring_head_ = ring_tail_ = 0;
+    resampler_ = std::make_unique<ledfx::StreamResampler>(
+        static_cast<double>(device_sample_rate), static_cast<double>(target_sample_rate_),
+        channel_count, static_cast<size_t>(hop_size_), SRC_SINC_FASTEST,
+        std::max(static_cast<size_t>(actual_buffer_frame_size), static_cast<size_t>(1024)));
+    if (!resampler_->Ok())
+    {
+      SendErrorEvent(std::string("Failed to create resampler: ") + resampler_->Error());
+      resampler_.reset();
+    }
+    else
+    {
+      std::cout << "Resampling " << device_sample_rate << " Hz to " << target_sample_rate_
+                << " Hz in hops of " << hop_size_ << " frames" << std::endl;
+    }
   }
 
   // Start capture
@@ -790,60 +989,124 @@ void FlutterWindow::CaptureAudio(IMMDevice *device, bool loopback)
         UINT32 frames_available = 0;
         DWORD flags = 0;
 
-        hr = capture_client_->GetBuffer(&data, &frames_available, &flags, nullptr, nullptr);
+        UINT64 qpc_position = 0;
+        hr = capture_client_->GetBuffer(&data, &frames_available, &flags, nullptr, &qpc_position);
         if (SUCCEEDED(hr))
         {
+          // QPC position is in 100ns units; the event header carries microseconds.
+          const uint64_t timestamp_us = qpc_position / 10;
+          uint16_t packet_flags = 0;
+          if (flags & AUDCLNT_BUFFERFLAGS_SILENT)
+            packet_flags |= ledfx::kAudioPacketFlagSilent;
+          if (flags & AUDCLNT_BUFFERFLAGS_DATA_DISCONTINUITY)
+            packet_flags |= ledfx::kAudioPacketFlagDiscontinuity;
 
           UINT32 useFrames = frames_available; // use all available frames
           float *float_data = reinterpret_cast<float *>(data);
           UINT32 float_count = useFrames * mix_format->nChannels; // Number of float samples
 
+          if (resampler_)
+          {
+            // Date each hop from where it starts in the input: behind this
+            // packet by the converter latency and the partial hop carried
+            // over, then one hop further for every hop this packet completes.
+            const double packet_start = static_cast<double>(resampler_->InputFrames());
+            auto send_hop = [&](const float *hop, size_t hop_frames)
+            {
+              uint64_t hop_timestamp_us = timestamp_us;
+              if (timestamp_us != 0)
+              {
+                const int64_t offset_us = static_cast<int64_t>(
+                    (resampler_->HopInputPosition() - packet_start) * 1000000.0 / device_sample_rate);
+                hop_timestamp_us = static_cast<uint64_t>(
+                    std::max<int64_t>(static_cast<int64_t>(timestamp_us) + offset_us, 0));
+              }
+              if (!PushToPcmSink(hop, hop_frames, 1, hop_timestamp_us, packet_flags))
+                SendAudioDataEvent(hop, hop_frames, 1, hop_timestamp_us, packet_flags);
+              // A discontinuity is reported once, on the first hop after it
+              packet_flags &= static_cast<uint16_t>(~ledfx::kAudioPacketFlagDiscontinuity);
+            };
+            if (flags & AUDCLNT_BUFFERFLAGS_SILENT)
+              resampler_->PushSilence(useFrames, send_hop);
+            else
+              resampler_->Push(float_data, useFrames, send_hop);
+            capture_client_->ReleaseBuffer(frames_available);
+            hr = capture_client_->GetNextPacketSize(&packet_length);
+            continue;
+          }
+
+          // A PCM sink takes the packet as it comes, in place of the ring
+          if (PushToPcmSink((flags & AUDCLNT_BUFFERFLAGS_SILENT) ? nullptr : float_data, useFrames,
+                            channel_count, timestamp_us, packet_flags))
+          {
+            capture_client_->ReleaseBuffer(frames_available);
+            hr = capture_client_->GetNextPacketSize(&packet_length);
+            continue;
+          }
+
           if (flags & AUDCLNT_BUFFERFLAGS_SILENT)
           {
             // produce zeros
-            std::vector<float> zero_buf(float_count, 0.0f);
-            RingBufferPush(zero_buf.data(), zero_buf.size());
+            audio_ring_->PushFill(0.0f, float_count);
           }
           else if (float_count > 0)
           {
             // push whatever we have into the ring (interleaved)
-            RingBufferPush(float_data, float_count);
+            audio_ring_->Push(float_data, float_count);
           }
 
           // Release the frames we read from WASAPI
           capture_client_->ReleaseBuffer(frames_available);
 
+          const uint64_t dropped_now = audio_ring_->Stats().dropped;
+          if (dropped_now != dropped_samples)
+          {
+            packet_flags |= ledfx::kAudioPacketFlagDiscontinuity;
+            dropped_samples = dropped_now;
+          }
+
           // Now: while ring has enough samples to form one target block, pop and send
           // target_blocksize_ is frames; convert to sample count:
           size_t frames_needed = (target_blocksize_ > 0) ? target_blocksize_ : useFrames;
           if (frames_needed == 0)
             frames_needed = useFrames; // fallback
-          size_t samples_needed = frames_needed * mix_format->nChannels;
+          size_t samples_needed = frames_needed * channel_count;
+          block_buffer_.resize(samples_needed);
+
+          // Frames of earlier packets still in the ring come before this one:
+          // date the oldest from this packet's capture time.
+          const size_t queued_frames = audio_ring_->ReadAvailable() / channel_count;
+          const size_t earlier_frames = queued_frames > useFrames ? queued_frames - useFrames : 0;
+          uint64_t block_timestamp_us = timestamp_us;
+          if (timestamp_us != 0)
+            block_timestamp_us -= std::min<uint64_t>(
+                timestamp_us, earlier_frames * 1000000ull / device_sample_rate);
 
           // Loop: produce as many full blocks as available
-          while (RingBufferSize() >= samples_needed && is_capturing_)
+          while (samples_needed > 0 && audio_ring_->ReadAvailable() >= samples_needed && is_capturing_)
           {
             // Pop exactly samples_needed floats
-            std::vector<float> block = RingBufferPop(samples_needed);
+            audio_ring_->Pop(block_buffer_.data(), samples_needed);
 
             // If device is stereo and you want mono, convert here:
-            if (mix_format->nChannels == 2)
+            if (channel_count == 2)
             {
-              std::vector<float> mono_block;
-              mono_block.reserve(frames_needed);
-              for (size_t i = 0; i + 1 < block.size(); i += 2)
+              mono_buffer_.resize(frames_needed);
+              for (size_t i = 0; i < frames_needed; i++)
               {
-                float left = block[i];
-                float right = block[i + 1];
-                mono_block.push_back((left + right) * 0.5f);
+                float left = block_buffer_[2 * i];
+                float right = block_buffer_[2 * i + 1];
+                mono_buffer_[i] = (left + right) * 0.5f;
               }
-              SendAudioDataEvent(mono_block);
+              SendAudioDataEvent(mono_buffer_.data(), mono_buffer_.size(), 1, block_timestamp_us, packet_flags);
             }
             else
             {
               // If channels == 1, send as-is.
-              SendAudioDataEvent(block);
+              SendAudioDataEvent(block_buffer_.data(), samples_needed, channel_count, block_timestamp_us, packet_flags);
             }
+            if (block_timestamp_us != 0)
+              block_timestamp_us += frames_needed * 1000000ull / device_sample_rate;
           }
         }
 
@@ -854,6 +1117,7 @@ void FlutterWindow::CaptureAudio(IMMDevice *device, bool loopback)
 
   // Cleanup
   audio_client_->Stop();
+  resampler_.reset();
   CloseHandle(hEvent);
   // CoTaskMemFree(mix_format);
   if (closest_supported && mix_format == closest_supported)
@@ -877,103 +1141,3 @@ REFERENCE_TIME FlutterWindow::CalculateBufferDuration(int device_sample_rate, in
 
   return buffer_duration;
 }
-
-// Ensure ring buffer capacity >= required_capacity
-void FlutterWindow::EnsureRingCapacity(size_t required_capacity)
-{
-  std::lock_guard<std::mutex> lock(ring_mutex_);
-  if (ring_capacity_ >= required_capacity)
-    return;
-  // grow to next power-of-two-ish or just the required * 2 size
-  size_t new_capacity = required_capacity * 2;
-  std::vector<float> new_buf(new_capacity);
-  // If there is existing data, copy it into new buffer starting at 0
-  size_t current_size = 0;
-  if (ring_capacity_ > 0)
-  {
-    if (ring_head_ >= ring_tail_)
-    {
-      current_size = ring_head_ - ring_tail_;
-      std::copy(audio_ring_buffer_.begin() + ring_tail_,
-                audio_ring_buffer_.begin() + ring_head_,
-                new_buf.begin());
-    }
-    else
-    {
-      // wrapped
-      current_size = ring_capacity_ - ring_tail_ + ring_head_;
-      size_t first_part = ring_capacity_ - ring_tail_;
-      std::copy(audio_ring_buffer_.begin() + ring_tail_,
-                audio_ring_buffer_.end(),
-                new_buf.begin());
-      std::copy(audio_ring_buffer_.begin(),
-                audio_ring_buffer_.begin() + ring_head_,
-                new_buf.begin() + first_part);
-    }
-  }
-  audio_ring_buffer_.swap(new_buf);
-  ring_capacity_ = new_capacity;
-  ring_tail_ = 0;
-  ring_head_ = current_size;
-}
-// push samples into ring buffer (samples vector is float samples interleaved)
-void FlutterWindow::RingBufferPush(const float *samples, size_t count)
-{
-  std::lock_guard<std::mutex> lock(ring_mutex_);
-  if (ring_capacity_ == 0)
-  {
-    // initial allocation: keep some headroom (e.g. 8 blocks)
-    size_t desired = std::max<size_t>(count * 8, count * 2);
-    audio_ring_buffer_.assign(desired, 0.0f);
-    ring_capacity_ = desired;
-    ring_head_ = 0;
-    ring_tail_ = 0;
-  }
-  // if not enough space, grow
-  size_t free_space = (ring_tail_ <= ring_head_) ? (ring_capacity_ - (ring_head_ - ring_tail_)) : (ring_tail_ - ring_head_);
-  if (free_space <= count)
-  {
-    // grow to fit
-    EnsureRingCapacity((ring_head_ >= ring_tail_ ? (ring_head_ - ring_tail_) : (ring_capacity_ - ring_tail_ + ring_head_)) + count);
-  }
-
-  // write possibly in two parts
-  size_t first_write = std::min(count, ring_capacity_ - ring_head_);
-  std::copy(samples, samples + first_write, audio_ring_buffer_.begin() + ring_head_);
-  ring_head_ = (ring_head_ + first_write) % ring_capacity_;
-  size_t remaining = count - first_write;
-  if (remaining > 0)
-  {
-    std::copy(samples + first_write, samples + first_write + remaining, audio_ring_buffer_.begin() + ring_head_);
-    ring_head_ = (ring_head_ + remaining) % ring_capacity_;
-  }
-}
-// check how many floats currently stored
-size_t FlutterWindow::RingBufferSize()
-{
-  std::lock_guard<std::mutex> lock(ring_mutex_);
-  if (ring_capacity_ == 0)
-    return 0;
-  if (ring_head_ >= ring_tail_)
-    return ring_head_ - ring_tail_;
-  return ring_capacity_ - ring_tail_ + ring_head_;
-}
-// pop exactly 'count' floats (assumes count <= RingBufferSize()). Returned vector has length 'count'.
-std::vector<float> FlutterWindow::RingBufferPop(size_t count)
-{
-  std::lock_guard<std::mutex> lock(ring_mutex_);
-  std::vector<float> out;
-  out.resize(count);
-  if (count == 0)
-    return out;
-  size_t first_read = std::min(count, ring_capacity_ - ring_tail_);
-  std::copy(audio_ring_buffer_.begin() + ring_tail_, audio_ring_buffer_.begin() + ring_tail_ + first_read, out.begin());
-  ring_tail_ = (ring_tail_ + first_read) % ring_capacity_;
-  size_t remaining = count - first_read;
-  if (remaining > 0)
-  {
-    std::copy(audio_ring_buffer_.begin() + ring_tail_, audio_ring_buffer_.begin() + ring_tail_ + remaining, out.begin() + first_read);
-    ring_tail_ = (ring_tail_ + remaining) % ring_capacity_;
-  }
-  return out;
-}
\ No newline at end of file
@@ -14,11 +14,16 @@
 #include <audiopolicy.h>
 #include <functiondiscoverykeys_devpkey.h>
 
-#include <mutex>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <atomic>
 
+#include "audio_packet.h"
+#include "delivery_queue.h"
+#include "slot_pool.h"
+#include "spsc_ring_buffer.h"
+#include "stream_resampler.h"
 #include "win32_window.h"
 
 #define WM_FLUTTER_AUDIO_DATA (WM_APP + 236)
@@ -26,6 +31,23 @@
 #define WM_FLUTTER_ERROR_EVENT (WM_APP + 238)
 #define WM_FLUTTER_DEVICES_EVENT (WM_APP + 239)
 
+// One captured block waiting to be delivered on the platform thread.
+struct PostedAudioPacket
+{
+  ledfx::AudioPacketHeader header;
+  std::vector<float> samples;
+};
+
+using AudioHandle = ledfx::SlotPool<PostedAudioPacket>::Handle;
+
+// Slots for payloads in flight between a sending thread and the platform
+// thread. Posted messages carry a ledfx::SlotPool handle in their WPARAM.
+constexpr uint32_t kPostedAudioSlots = 64;
+constexpr uint32_t kPostedMessageSlots = 16;
+constexpr uint32_t kPostedDevicesSlots = 4;
+static_assert(sizeof(WPARAM) >= sizeof(ledfx::SlotPool<int>::Handle),
+              "slot handles are passed through WPARAM");
+
 // A window that does nothing but host a Flutter view.
 class FlutterWindow : public Win32Window
 {
@@ -56,19 +78,33 @@ private:
   int sample_rate_ = 48000;
   int channels_ = 1;
   int target_blocksize_ = 0;
-
-  // Ring buffer
-  std::vector<float> audio_ring_buffer_;
-  size_t ring_head_ = 0;     // index of next write
-  size_t ring_tail_ = 0;     // index of next read
-  size_t ring_capacity_ = 0; // capacity of audio_ring_buffer_ in floats
-  std::mutex ring_mutex_;
-
-  std::mutex events_mutex_;
-  std::vector<std::shared_ptr<std::vector<float>>> posted_audio_events_;
-  std::vector<std::shared_ptr<std::string>> posted_state_events_;
-  std::vector<std::shared_ptr<std::string>> posted_error_events_;
-  std::vector<std::shared_ptr<std::vector<flutter::EncodableValue>>> posted_devices_events_;
+  int target_sample_rate_ = 0; // rate of emitted hops, 0 to keep the device rate
+  int hop_size_ = 0;           // frames per emitted hop at target_sample_rate_
+
+  // Ring buffer, sized once per capture session in CaptureAudio()
+  std::unique_ptr<ledfx::SpscRingBuffer<float>> audio_ring_;
+  std::vector<float> block_buffer_; // one interleaved target block
+  std::vector<float> mono_buffer_;  // downmixed block
+  uint32_t audio_sequence_ = 0;     // sequence number of the next audio event
+  bool audio_dropped_ = false;      // a block was dropped before it was queued
+  // Converts device blocks into mono hops when a target rate is requested
+  std::unique_ptr<ledfx::StreamResampler> resampler_;
+
+  // PCM sink registered from Dart (src/ledfx/pcm.h) and ledfx_pcm_push() of
+  // the library it lives in. The capture thread pushes under pcm_lock_.
+  using PcmPushFn = unsigned int (*)(void *pcm, const float *samples, unsigned int frames,
+                                     unsigned int channels, unsigned long long timestamp_us);
+  std::mutex pcm_lock_;
+  void *pcm_sink_ = nullptr;
+  PcmPushFn pcm_push_ = nullptr;
+
+  // Payloads of posted events, released by the platform thread once sent
+  ledfx::SlotPool<PostedAudioPacket> posted_audio_{kPostedAudioSlots};
+  ledfx::SlotPool<std::string> posted_messages_{kPostedMessageSlots}; // state and error
+  ledfx::SlotPool<std::vector<flutter::EncodableValue>> posted_devices_{kPostedDevicesSlots};
+  // Audio blocks waiting for the platform thread; one posted message wakes
+  // it for all of them and the delivery policy picks which are sent.
+  ledfx::DeliveryQueue<AudioHandle> audio_delivery_{kPostedAudioSlots};
 
   // WASAPI interfaces
   IMMDeviceEnumerator *device_enumerator_ = nullptr;
@@ -84,11 +120,32 @@ private:
   void OnStreamCancel();
 
   // Event emission helpers
-  void SendAudioDataEvent(const std::vector<float> &ieee_float_data);
+  void SendAudioDataEvent(const float *samples, size_t count, size_t channels,
+                          uint64_t timestamp_us, uint16_t flags);
+  void SendAudioPackets(const AudioHandle *handles, size_t count, bool after_drop);
+  // Pushes interleaved frames, or silence for null |samples|, into the PCM
+  // sink and queues a notice for Dart. Returns false if no sink is set.
+  bool PushToPcmSink(const float *samples, size_t frames, size_t channels,
+                     uint64_t timestamp_us, uint16_t flags);
   void SendStateEvent(const std::string &state_message);
   void SendDevicesInfoEvent(const std::vector<flutter::EncodableValue> &devices_info);
   void SendErrorEvent(const std::string &error_message);
 
+  // Copies |payload| into a slot of |pool| and posts its handle with
+  // |message|. Returns false if every slot is in flight or posting failed.
+  template <typename T>
+  bool PostPayload(ledfx::SlotPool<T> &pool, UINT message, const T &payload)
+  {
+    const auto handle = pool.Acquire();
+    if (handle == ledfx::SlotPool<T>::kInvalidHandle)
+      return false;
+    *pool.Get(handle) = payload;
+    if (PostMessage(GetHandle(), message, static_cast<WPARAM>(handle), 0))
+      return true;
+    pool.Release(handle);
+    return false;
+  }
+
   // Audio device enumeration
   std::vector<flutter::EncodableValue> EnumerateAudioDevices();
   std::vector<flutter::EncodableValue> EnumerateDevices(EDataFlow dataFlow);
@@ -97,19 +154,14 @@ private:
 
   // Audio capture methods
   void StartAudioCapture(const std::string &deviceId, const std::string &captureType,
-                         int sampleRate, int channels, int blockSize);
+                         int sampleRate, int channels, int blockSize,
+                         int targetSampleRate, int hopSize);
   void StopAudioCapture();
   void AudioCaptureThread();
 
   // Audio capture
   void CaptureAudio(IMMDevice *device, bool loopback);
   REFERENCE_TIME CalculateBufferDuration(int device_sample_rate, int target_blocksize);
-
-  // Ring buffer
-  void EnsureRingCapacity(size_t required_capacity);
-  void RingBufferPush(const float *samples, size_t count);
-  size_t RingBufferSize();
-  std::vector<float> RingBufferPop(size_t count);
 };
 
 #endif // RUNNER_FLUTTER_WINDOW_H_
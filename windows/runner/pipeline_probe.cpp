@@ -0,0 +1,30 @@
+#include "pipeline_probe.h"
+
+ledfx::PipelineStats &GetPipelineStats()
+{
+  static ledfx::PipelineStats stats;
+  return stats;
+}
+
+flutter::EncodableMap PipelineStatsToEncodable(const ledfx::PipelineStats &stats)
+{
+  flutter::EncodableMap map;
+  for (size_t i = 0; i < ledfx::kPipelineStageCount; i++)
+  {
+    const auto stage = static_cast<ledfx::PipelineStage>(i);
+    const ledfx::LatencySummary summary = stats.Summary(stage);
+    map[flutter::EncodableValue(ledfx::PipelineStageName(stage))] =
+        flutter::EncodableValue(flutter::EncodableMap{
+            {flutter::EncodableValue("count"), flutter::EncodableValue(static_cast<int64_t>(summary.count))},
+            {flutter::EncodableValue("p50Us"), flutter::EncodableValue(summary.p50_us)},
+            {flutter::EncodableValue("p99Us"), flutter::EncodableValue(summary.p99_us)},
+            {flutter::EncodableValue("maxUs"), flutter::EncodableValue(summary.max_us)},
+            {flutter::EncodableValue("meanUs"), flutter::EncodableValue(summary.mean_us)}});
+  }
+  return map;
+}
+
+extern "C" __declspec(dllexport) void ledfx_pipeline_record(int32_t stage, int64_t capture_us)
+{
+  GetPipelineStats().Record(static_cast<ledfx::PipelineStage>(stage), capture_us);
+}
@@ -0,0 +1,22 @@
+#ifndef RUNNER_PIPELINE_PROBE_H_
+#define RUNNER_PIPELINE_PROBE_H_
+
+#include <cstdint>
+
+#include <flutter/encodable_value.h>
+
+#include "pipeline_stats.h"
+
+// Latency histograms of the audio pipeline, shared by the capture code and
+// the Dart side for the whole process.
+ledfx::PipelineStats &GetPipelineStats();
+
+// Summary of every stage as {stage: {count, p50Us, p99Us, maxUs, meanUs}},
+// the reply of the getPipelineStats method call.
+flutter::EncodableMap PipelineStatsToEncodable(const ledfx::PipelineStats &stats);
+
+// Exported for dart:ffi lookups through DynamicLibrary.executable(), so stages
+// measured in Dart share the clock and histograms of the native ones.
+extern "C" __declspec(dllexport) void ledfx_pipeline_record(int32_t stage, int64_t capture_us);
+
+#endif // RUNNER_PIPELINE_PROBE_H_
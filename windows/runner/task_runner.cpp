@@ -40,32 +40,29 @@ TaskRunnerWindows::~TaskRunnerWindows()
 
 void TaskRunnerWindows::EnqueueTask(TaskClosure task)
 {
-    {
-        std::lock_guard<std::mutex> lock(tasks_mutex_);
-        tasks_.push(task);
-    }
+    PostTask(std::move(task));
+}
+
+// Only one WM_NULL is pending at a time, however many tasks were queued.
+void TaskRunnerWindows::Wakeup()
+{
     if (!PostMessage(window_handle_, WM_NULL, 0, 0))
     {
         DWORD error_code = GetLastError();
         std::cerr << "Failed to post message to main thread; error_code: "
                   << error_code << std::endl;
+        tasks_.WakeupFailed();
     }
 }
 
 void TaskRunnerWindows::ProcessTasks()
 {
-    // Even though it would usually be sufficient to process only a single task
-    // whenever we receive the message, if the message queue happens to be full,
-    // we might not receive a message for each individual task.
-    for (;;)
-    {
-        std::lock_guard<std::mutex> lock(tasks_mutex_);
-        if (tasks_.empty())
-            break;
-        TaskClosure task = tasks_.front();
-        tasks_.pop();
-        task();
-    }
+    // Runs a bounded batch with no lock held, so tasks may queue tasks; the
+    // queue asks for another message if some are left.
+    bool wake = false;
+    tasks_.Drain(kMaxTasksPerMessage, &wake);
+    if (wake)
+        Wakeup();
 }
 
 WNDCLASS TaskRunnerWindows::RegisterWindowClass()
@@ -7,11 +7,13 @@
 #include <windows.h>
 
 #include <chrono>
+#include <cstddef>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <string>
 #include <functional>
+#include <utility>
+
+#include "task_queue.h"
 
 using TaskClosure = std::function<void()>;
 
@@ -28,10 +30,27 @@ class TaskRunnerWindows : public TaskRunner
 public:
     virtual void EnqueueTask(TaskClosure task);
 
+    // Like EnqueueTask, for any callable, including move-only ones. May be
+    // called from any thread, and from a task.
+    template <typename F>
+    void PostTask(F &&task)
+    {
+        bool wake = false;
+        tasks_.Push(std::forward<F>(task), &wake);
+        if (wake)
+            Wakeup();
+    }
+
     TaskRunnerWindows();
     ~TaskRunnerWindows();
 
 private:
+    // Tasks run per WM_NULL, so that a flood of tasks does not starve the
+    // other messages of the thread.
+    static constexpr size_t kMaxTasksPerMessage = 64;
+
+    void Wakeup();
+
     void ProcessTasks();
 
     WNDCLASS RegisterWindowClass();
@@ -46,8 +65,7 @@ private:
 
     HWND window_handle_;
     std::string window_class_name_;
-    std::mutex tasks_mutex_;
-    std::queue<TaskClosure> tasks_;
+    ledfx::TaskQueue tasks_;
 
     // Prevent copying.
     TaskRunnerWindows(TaskRunnerWindows const &) = delete;